@@ -31,11 +31,38 @@ static constexpr int INVALID_TXN_ID = -1;                                     //
 static constexpr int INVALID_TIMESTAMP = -1;                                  // invalid transaction timestamp
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                      // the header page id
-static constexpr int PAGE_SIZE = 4096;                                        // size of a data page in byte  4KB
-static constexpr int BUFFER_POOL_SIZE = 65536;                                // size of buffer pool 256MB
-// static constexpr int BUFFER_POOL_SIZE = 262144;                                // size of buffer pool 1GB
+static constexpr int PAGE_SIZE = 4096;                                        // default and smallest page size of a file in byte  4KB
+static constexpr int MAX_PAGE_SIZE = 65536;                                   // largest page size of a file, see CREATE TABLE ... PAGE_SIZE = n
+static constexpr int NUM_PAGE_SIZE_CLASSES = 5;                               // page sizes 4KB, 8KB, 16KB, 32KB and 64KB
+static constexpr int BUFFER_POOL_SIZE = 65536;                                // default size of buffer pool 256MB, see rmdb -b
+static constexpr int BUFFER_POOL_INSTANCES = 16;                              // number of buffer pool partitions
+static constexpr size_t BUFFER_POOL_CHUNK_SIZE = 1024;                        // frames are added or removed 4MB at a time on resize
+static constexpr size_t BUFFER_POOL_LARGE_PAGE_PERCENT = 25;                  // frames of each larger page size take 25% of the pool's memory
+static constexpr size_t BUFFER_POOL_MIN_CLASS_FRAMES = 64;                    // a page size class has at least this many frames
+static constexpr int BUFFER_POOL_DRAIN_INTERVAL_MS = 1;                       // poll interval while a shrink waits for pinned frames
+static constexpr int BUFFER_POOL_RESIZE_TIMEOUT_MS = 5000;                    // a shrink gives up on frames still pinned after 5s
+static constexpr bool ENABLE_PAGE_CLEANER = true;                             // write back dirty pages in a background thread
+static constexpr int PAGE_CLEANER_INTERVAL_MS = 10;                           // page cleaner wakes up every 10ms when idle
+static constexpr size_t PAGE_CLEANER_CLEAN_PERCENT = 10;                      // keep 10% of each partition clean and evictable
+static constexpr size_t PAGE_CLEANER_MAX_BATCH = 64;                          // max pages written per partition per round
+static constexpr bool ENABLE_READ_AHEAD = true;                               // prefetch pages of sequentially scanned files
+static constexpr int READ_AHEAD_MIN_PAGES = 4;                                // first read-ahead window after a sequential miss
+static constexpr int READ_AHEAD_MAX_PAGES = 64;                               // read-ahead window doubles up to this many pages
+static constexpr int READ_AHEAD_MAX_GAP = 4;                                  // misses at most this far ahead still count as sequential
+static constexpr size_t READ_AHEAD_MAX_STREAMS = 4;                           // sequential streams tracked per file
+static constexpr size_t BUFFER_RING_SIZE = 32;                                // frames recycled by a large scan's buffer ring
+static constexpr size_t BUFFER_RING_SCAN_PERCENT = 25;                        // scans of tables larger than 25% of the pool use a ring
+static constexpr bool ENABLE_DIRECT_IO = false;                               // open data files with O_DIRECT, bypassing the OS page cache
+static constexpr bool BUFFER_POOL_HUGE_PAGES = true;                          // back buffer pool frames with transparent huge pages
+static constexpr bool IX_OPTIMISTIC_READ = true;                              // B+tree readers validate node versions instead of taking read latches
+static constexpr int IX_OPTIMISTIC_READ_RETRIES = 8;                          // failed validations before a B+tree reader takes read latches
+static constexpr int IX_BULK_LOAD_FILL_PERCENT = 90;                          // bulk-loaded B+tree nodes are filled to 90% of the order
+static constexpr size_t IX_BULK_LOAD_SORT_MEMORY = 64 * 1024 * 1024;          // bulk load sorts 64MB of keys in memory before spilling a run
 static constexpr int LOG_BUFFER_SIZE = (1024 * PAGE_SIZE);                    // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr bool ASYNC_IO_USE_IO_URING = true;                           // use io_uring for async page I/O if available
+static constexpr size_t ASYNC_IO_QUEUE_DEPTH = 32;                            // max in-flight async page I/O requests
+static constexpr size_t ASYNC_IO_MAX_THREADS = 8;                             // worker threads of the thread pool fallback
 
 using frame_id_t = int32_t;  // frame id type, 帧页ID, 页在BufferPool中的存储单元称为帧,一帧对应一页
 using page_id_t = int32_t;   // page id type , 页ID
@@ -48,7 +75,18 @@ using timestamp_t = int32_t;  // timestamp type, used for transaction concurrenc
 // log file
 static const std::string LOG_FILE_NAME = "db.log";
 
-// replacer
+// free page map of a table/index file, persisted as <file name> + FREE_PAGE_MAP_SUFFIX
+static const std::string FREE_PAGE_MAP_SUFFIX = ".fpm";
+
+// free space map of a table file (fill bucket of every data page), persisted as <table name> + FREE_SPACE_MAP_SUFFIX
+static const std::string FREE_SPACE_MAP_SUFFIX = ".fsm";
+
+// replacer: "LRU", "CLOCK", "LRU-K" or "2Q"
 static const std::string REPLACER_TYPE = "LRU";
+static constexpr size_t LRUK_REPLACER_K = 2;    // LRU-K中的K
+static constexpr uint64_t LRUK_CORRELATED_PERIOD = 2;  // LRU-K中的相关访问间隔(逻辑时钟), 间隔内对同一帧的再次访问不算新的访问
 
 static const std::string DB_META_NAME = "db.meta";
+
+// page ids resident in the buffer pool at the last clean shutdown, reloaded by open_db to warm up the pool
+static const std::string BUFFER_POOL_DUMP_NAME = "buffer_pool.dump";
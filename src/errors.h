@@ -82,6 +82,11 @@ class IndexEntryNotFoundError : public RMDBError {
     IndexEntryNotFoundError() : RMDBError("Index entry not found") {}
 };
 
+class IndexDuplicateKeyError : public RMDBError {
+   public:
+    IndexDuplicateKeyError() : RMDBError("Duplicate key in index") {}
+};
+
 // SM errors
 class DatabaseNotFoundError : public RMDBError {
    public:
@@ -10,6 +10,8 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <string_view>
+
 #include "execution_defs.h"
 #include "common/common.h"
 #include "index/ix.h"
@@ -87,4 +89,29 @@ class AbstractExecutor {
                 break;
         }
     }
+
+    /**
+     * @brief 直接在记录的原始数据rec上比较字段col和值val，按字段的类型比较，结果同compare(Value, Value)，不构造Value
+     */
+    static int compare(const char *rec, const ColMeta &col, const Value &val) {
+        const char *data = rec + col.offset;
+        switch (col.type) {
+            case TYPE_INT: {
+                int a;
+                memcpy(&a, data, sizeof(int));
+                return a > val.int_val ? 1 : (a == val.int_val ? 0 : -1);
+            }
+            case TYPE_FLOAT: {
+                float a;
+                memcpy(&a, data, sizeof(float));
+                return a > val.float_val ? 1 : (a == val.float_val ? 0 : -1);
+            }
+            case TYPE_STRING: {
+                // 字段中的字符串到第一个'\0'为止，与构造Value时相同
+                int res = std::string_view(data, strnlen(data, col.len)).compare(val.str_val);
+                return res > 0 ? 1 : (res == 0 ? 0 : -1);
+            }
+        }
+        return 0;
+    }
 };
\ No newline at end of file
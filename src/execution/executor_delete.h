@@ -41,8 +41,7 @@ class DeleteExecutor : public AbstractExecutor {
     std::unique_ptr<RmRecord> Next() override {
         char *buf = new char[len_ + 1];
         for (const auto &rid : rids_) {
-            auto page_handle = fh_->fetch_page_handle(rid.page_no);
-            memcpy(buf, page_handle.get_slot(rid.slot_no), len_);
+            fh_->getRecord(buf, rid, context_, len_, false);
             auto record = RmRecord(len_, buf);
 
             std::vector<Value> values;
@@ -23,8 +23,8 @@ class IndexScanExecutor : public SeqScanExecutor {
     IndexMeta index_meta_;                      // index scan涉及到的索引元数据
 
     IxIndexHandle *ih_;
-    std::vector<Rid> rids;
-    int scan = 0;
+    std::vector<char> lk_, rk_;    // 索引扫描的范围[lk, rk]
+    bool le_ = true, ge_ = true;  // 是否包含等于lk/rk的key
 
    public:
     IndexScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds,
@@ -49,27 +49,35 @@ class IndexScanExecutor : public SeqScanExecutor {
         }
         fed_conds_ = conds_;
         ih_ = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index_col_names)).get();
-        get_rids();
+        set_range();
     }
 
+    /**
+     * @brief 在索引上开始范围扫描，扫描按需沿叶子链表读出rid，不预先物化所有满足条件的rid
+     */
     void beginTuple() override {
-        scan = 0;
-        if (rids.size()) rid_ = rids[scan ++ ];
-        else scan ++ ;
+        scan_ = std::make_unique<IxRangeScan>(ih_, lk_.data(), rk_.data(), le_, ge_, context_->txn_);
+        if (!scan_->is_end()) rid_ = scan_->rid();
     }
 
     void nextTuple() override {
-        if (!is_end()) rid_ = rids[scan ++ ];
-        else scan ++ ;
+        scan_->next();
+        if (!scan_->is_end()) rid_ = scan_->rid();
     }
 
-    bool is_end() const override {
-        return scan == rids.size() + 1;
-    }
+    bool is_end() const override { return scan_->is_end(); }
 
     Rid &rid() override { return rid_; }
 
-    void get_rids() {
+    /**
+     * @brief 索引扫描时当前记录从表中读出，加共享锁
+     */
+    RecordRef currentRecord() override { return getRecordRef(); }
+
+    /**
+     * @brief 根据扫描条件确定索引扫描的范围
+     */
+    void set_range() {
         IndexMeta now_idx;
         for (const auto &index : tab_.indexes) {
             bool is_index = true;
@@ -97,23 +105,24 @@ class IndexScanExecutor : public SeqScanExecutor {
                 is_eq = false;
                 break;
             }
+        lk_.assign(now_idx.col_tot_len + 1, 0);
+        rk_.assign(now_idx.col_tot_len + 1, 0);
+        char *lk = lk_.data(), *rk = rk_.data();
         if (is_eq) {
-            auto key = new char[now_idx.col_tot_len + 1];
             int offset = 0;
             for (const auto &col : now_idx.cols) {
                 for (const auto &cond : conds_) {
-                    if (cond.lhs_col.col_name == col.name) setKey(col.type, key, cond.rhs_val, offset, col.len);
+                    if (cond.lhs_col.col_name == col.name) setKey(col.type, lk, cond.rhs_val, offset, col.len);
                 }
                 offset += col.len;
             }
-            ih_->get_value(key, &rids, context_->txn_);
-            delete[] key;
+            memcpy(rk, lk, now_idx.col_tot_len);
+            le_ = ge_ = true;
         } else {
-            auto lk = new char[now_idx.col_tot_len + 1], rk = new char[now_idx.col_tot_len + 1];
             Value minv, maxv;
             minv.is_min = maxv.is_max = true;
             minv.int_val = INT32_MIN, minv.float_val = -1e9, minv.str_val = std::string(20, 0);
-            minv.int_val = INT32_MAX, minv.float_val = 1e9, minv.str_val = std::string(20, 127);
+            maxv.int_val = INT32_MAX, maxv.float_val = 1e9, maxv.str_val = std::string(20, 127);
             auto meta = tab_.get_col(conds_[0].lhs_col.col_name);
             if (conds_.size() == 1) {
                 auto cond = conds_[0];
@@ -122,33 +131,33 @@ class IndexScanExecutor : public SeqScanExecutor {
                     case OP_EQ:
                         setKey(meta->type, lk, val, 0, meta->len);
                         setKey(meta->type, rk, val, 0, meta->len);
-                        ih_->range_query(lk, rk, &rids, context_->txn_, 1, 1);
+                        le_ = ge_ = true;
                         break;
                     case OP_LT:
                         setKey(meta->type, lk, minv, 0, meta->len);
                         setKey(meta->type, rk, val, 0, meta->len);
-                        ih_->range_query(lk, rk, &rids, context_->txn_, 1, 0);
+                        le_ = true, ge_ = false;
                         break;
                     case OP_LE:
                         setKey(meta->type, lk, minv, 0, meta->len);
                         setKey(meta->type, rk, val, 0, meta->len);
-                        ih_->range_query(lk, rk, &rids, context_->txn_, 1, 1);
+                        le_ = ge_ = true;
                         break;
                     case OP_GT:
                         setKey(meta->type, lk, val, 0, meta->len);
                         setKey(meta->type, rk, maxv, 0, meta->len);
-                        ih_->range_query(lk, rk, &rids, context_->txn_, 0, 1);
+                        le_ = false, ge_ = true;
                         break;
                     case OP_GE:
                         setKey(meta->type, lk, val, 0, meta->len);
                         setKey(meta->type, rk, maxv, 0, meta->len);
-                        ih_->range_query(lk, rk, &rids, context_->txn_, 1, 1);
+                        le_ = ge_ = true;
                         break;
                 }
             } else {
                 setKey(meta->type, lk, conds_[0].rhs_val, 0, meta->len);
                 setKey(meta->type, rk, conds_[1].rhs_val, 0, meta->len);
-                ih_->range_query(lk, rk, &rids, context_->txn_, conds_[0].op == OP_LE, conds_[0].op == OP_GE);
+                le_ = conds_[0].op == OP_LE, ge_ = conds_[0].op == OP_GE;
             }
         }
     }
@@ -162,7 +171,9 @@ class IndexScanExecutor : public SeqScanExecutor {
                 memcpy(key + offset, (char *)&val.float_val, len);
                 break;
             case TYPE_STRING:
-                memcpy(key + offset, val.str_val.c_str(), len);
+                // 字符串比字段短时后面补'\0'，与记录中存储的字段一致
+                memset(key + offset, 0, len);
+                memcpy(key + offset, val.str_val.c_str(), std::min(static_cast<int>(val.str_val.size()), len));
                 break;
         }
     }
@@ -24,12 +24,17 @@ class SeqScanExecutor : public AbstractExecutor {
     std::vector<ColMeta> cols_;         // scan后生成的记录的字段
     size_t len_;                        // scan后生成的每条记录的长度
     std::vector<Condition> fed_conds_;  // 同conds_，两个字段相同
+    std::vector<const ColMeta *> cond_cols_;  // conds_中每个条件左边的字段，第一次判断条件时查找
     TabMeta tab_;
     bool is_read;
 
     int fd_;
     Rid rid_;
-    std::unique_ptr<RecScan> scan_;  // table_iterator
+    std::unique_ptr<RecScan> scan_;  // 索引扫描的迭代器，见IndexScanExecutor
+    std::unique_ptr<RmScan> rm_scan_;  // 顺序扫描的表迭代器，按页面批量取出满足条件的记录
+    RmScanPredicate pred_;             // 下推到表迭代器的谓词，加共享锁并判断条件
+    RmPageBatch batch_;                // 当前页面上满足条件的记录
+    size_t batch_pos_ = 0;             // 当前记录在batch_中的位置
 
     SmManager *sm_manager_;
 
@@ -54,60 +59,79 @@ class SeqScanExecutor : public AbstractExecutor {
 
     RmFileHandle *getFileHandle() const override { return fh_; }
 
-    std::vector<Value> constructVal() override {
-        char *buf = new char[len_ + 1];
-        if (!fh_->getRecord(buf, rid_, context_, len_, is_read))
+    /**
+     * @brief 获取当前记录rid_的只读视图，is_read为true时对记录加共享锁
+     */
+    RecordRef getRecordRef() {
+        RecordRef ref;
+        if (!fh_->get_record_ref(&ref, rid_, context_, is_read))
             throw TransactionAbortException(context_->txn_->get_transaction_id(), AbortReason::LOCK_ON_SHIRINKING);
+        return ref;
+    }
+
+    /**
+     * @brief 当前记录的只读视图，顺序扫描时指向batch_中已经取出的记录，不再访问页面
+     */
+    virtual RecordRef currentRecord() {
+        return RecordRef(PageGuard(), batch_.get_record(batch_pos_), batch_.record_size);
+    }
+
+    std::vector<Value> constructVal() override {
+        RecordRef ref = currentRecord();
         Value val;
         std::vector<Value> vec;
         for (const auto &col : cols_) {
-            char dest[col.len + 1];
-            memcpy(dest, buf + col.offset, col.len);
-            dest[col.len] = '\0';
+            const char *data = ref.data() + col.offset;
             val.type = col.type;
             switch (col.type) {
                 case TYPE_INT:
-                    val.set_int(*(int *)dest);
+                    memcpy(&val.int_val, data, sizeof(int));
                     break;
                 case TYPE_FLOAT:
-                    val.set_float(*(float *)dest);
+                    memcpy(&val.float_val, data, sizeof(float));
                     break;
                 case TYPE_STRING:
-                    val.set_str(dest);
+                    val.set_str(std::string(data, strnlen(data, col.len)));
                     break;
             }
             vec.emplace_back(val);
         }
-        delete[] buf;
         return vec;
     }
 
-    bool satisfyCond() {
-        auto values = constructVal();
+    /**
+     * @brief 直接在页面中的记录rec上判断是否满足所有条件，不复制记录
+     */
+    bool satisfyCond(const char *rec) {
+        if (cond_cols_.size() != conds_.size()) {
+            cond_cols_.clear();
+            for (const auto &cond : conds_) {
+                cond_cols_.push_back(&*std::find_if(cols_.begin(), cols_.end(),
+                                                    [&](ColMeta &col) { return col.name == cond.lhs_col.col_name; }));
+            }
+        }
         bool flag = true;
-        for (const auto &cond : conds_) {
-            auto condition = cond.op;
-            auto col_name = cond.lhs_col.col_name;
-            int index = std::distance(cols_.begin(), std::find_if(cols_.begin(), cols_.end(),
-                                                                  [&](ColMeta &col) { return col.name == col_name; }));
-            switch (condition) {
+        for (size_t i = 0; i < conds_.size(); i++) {
+            const auto &cond = conds_[i];
+            int res = compare(rec, *cond_cols_[i], cond.rhs_val);
+            switch (cond.op) {
                 case OP_EQ:
-                    flag = compare(values[index], cond.rhs_val) == 0;
+                    flag = res == 0;
                     break;
                 case OP_NE:
-                    flag = compare(values[index], cond.rhs_val) != 0;
+                    flag = res != 0;
                     break;
                 case OP_LT:
-                    flag = compare(values[index], cond.rhs_val) < 0;
+                    flag = res < 0;
                     break;
                 case OP_LE:
-                    flag = compare(values[index], cond.rhs_val) <= 0;
+                    flag = res <= 0;
                     break;
                 case OP_GT:
-                    flag = compare(values[index], cond.rhs_val) > 0;
+                    flag = res > 0;
                     break;
                 case OP_GE:
-                    flag = compare(values[index], cond.rhs_val) >= 0;
+                    flag = res >= 0;
                     break;
             }
             if (!flag) return false;
@@ -121,28 +145,41 @@ class SeqScanExecutor : public AbstractExecutor {
     size_t tupleLen() const override { return len_; }
 
     /**
-     * @brief 构建表迭代器scan_,并开始迭代扫描,直到扫描到第一个满足谓词条件的元组停止,并赋值给rid_
+     * @brief 构建表迭代器,并开始按页面批量扫描,取出第一个有满足谓词条件的元组的页面,第一个元组的位置赋值给rid_
      *
      */
     void beginTuple() override {
-        scan_ = std::make_unique<RmScan>(fh_);
-        rid_ = scan_->rid();
-        while (!scan_->is_end() && !satisfyCond()) {
-            scan_->next();
-            if (!scan_->is_end()) rid_ = scan_->rid();
+        rm_scan_ = std::make_unique<RmScan>(fh_);
+        pred_ = nullptr;
+        if (is_read || !conds_.empty()) {
+            pred_ = [this](const Rid &rid, const char *rec) {
+                if (is_read && !context_->lock_mgr_->lock_shared_on_record(context_->txn_, rid, fd_))
+                    throw TransactionAbortException(context_->txn_->get_transaction_id(),
+                                                    AbortReason::LOCK_ON_SHIRINKING);
+                return satisfyCond(rec);
+            };
         }
+        nextBatch();
     }
 
     /**
-     * @brief 从当前scan_指向的记录开始迭代扫描,直到扫描到第一个满足谓词条件的元组停止,并赋值给rid_
+     * @brief 移到当前页面上下一个满足谓词条件的元组,当前页面取完后再取下一个页面,并赋值给rid_
      *
      */
     void nextTuple() override {
-        do {
-            scan_->next();
-            if (scan_->is_end()) break;
-            rid_ = scan_->rid();
-        } while (!satisfyCond());
+        if (++batch_pos_ < batch_.size()) {
+            rid_ = batch_.rid(batch_pos_);
+        } else {
+            nextBatch();
+        }
+    }
+
+    /**
+     * @brief 从表迭代器取出下一个页面上所有满足谓词条件的元组，每个页面只pin一次
+     */
+    void nextBatch() {
+        batch_pos_ = 0;
+        if (rm_scan_->next_batch(&batch_, pred_)) rid_ = batch_.rid(0);
     }
 
     /**
@@ -150,22 +187,9 @@ class SeqScanExecutor : public AbstractExecutor {
      *
      * @return std::unique_ptr<RmRecord>
      */
-    std::unique_ptr<RmRecord> Next() override {
-        RmRecord rec(fh_->get_file_hdr().record_size);
-        auto values = constructVal();
-        for (size_t i = 0; i < values.size(); i++) {
-            auto &col = cols_[i];
-            auto &val = values[i];
-            if (col.type != val.type) {
-                throw IncompatibleTypeError(coltype2str(col.type), coltype2str(val.type));
-            }
-            val.init_raw(col.len);
-            memcpy(rec.data + col.offset, val.raw->data, col.len);
-        }
-        return std::make_unique<RmRecord>(rec);
-    }
+    std::unique_ptr<RmRecord> Next() override { return currentRecord().to_record(); }
 
-    bool is_end() const override { return scan_->is_end(); }
+    bool is_end() const override { return batch_pos_ >= batch_.size(); }
 
     std::string getType() { return "SeqScanExecutor"; };
 
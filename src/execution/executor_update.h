@@ -48,8 +48,7 @@ class UpdateExecutor : public AbstractExecutor {
     std::unique_ptr<RmRecord> Next() override {
         char* buf = new char[len_ + 1], *old_buf = new char[len_ + 1];
         for (const auto &rid : rids_) {
-            auto page_handle = fh_->fetch_page_handle(rid.page_no);
-            memcpy(buf, page_handle.get_slot(rid.slot_no), len_);
+            fh_->getRecord(buf, rid, context_, len_, false);
             memcpy(old_buf, buf, len_);
             auto record = RmRecord(len_, buf);
 
@@ -0,0 +1,215 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_bulk_loader.h"
+
+#include <algorithm>
+#include <queue>
+
+IxBulkLoader::IxBulkLoader(IxIndexHandle *ih, int fill_percent, size_t sort_memory) : ih_(ih) {
+    if (ih_->file_hdr_->root_page_ != IX_INIT_ROOT_PAGE || ih_->fetch_node(IX_INIT_ROOT_PAGE)->get_size() != 0) {
+        throw InternalError("IxBulkLoader: index is not empty");
+    }
+    key_len_ = ih_->file_hdr_->col_tot_len_;
+    entry_len_ = key_len_ + static_cast<int>(sizeof(Rid));
+    // 结点至少填到min_size，否则之后删除时会被当作需要合并的结点
+    int order = ih_->file_hdr_->btree_order_;
+    fill_ = std::clamp(order * fill_percent / 100, (order + 1) / 2, order);
+    max_buffered_ = std::max<size_t>(1, sort_memory / entry_len_);
+    last_key_.resize(key_len_);
+}
+
+IxBulkLoader::~IxBulkLoader() {
+    for (FILE *run : runs_) fclose(run);
+}
+
+/**
+ * @description: 添加一个(key, rid)，内存中缓存满了就排序后写成一个有序段
+ */
+void IxBulkLoader::add(const char *key, const Rid &rid) {
+    if (buffer_.size() / entry_len_ >= max_buffered_) spill_run();
+    buffer_.insert(buffer_.end(), key, key + key_len_);
+    buffer_.insert(buffer_.end(), reinterpret_cast<const char *>(&rid), reinterpret_cast<const char *>(&rid + 1));
+}
+
+/**
+ * @description: 按key的顺序构建B+树，返回写入索引的键值对数量
+ * @note 调用之后不能再add()
+ */
+int IxBulkLoader::finish() {
+    merge_runs([this](const char *entry) { append_entry(entry); });
+    if (levels_.empty()) return 0;
+
+    // 从叶子层向上，把每层最后两个结点调整到都不少于min_size，再写入上一层；只剩一个结点的最高层就是根
+    for (size_t level = 0; level < levels_.size(); level++) {
+        balance_last_two(level);
+        if (levels_[level].prev == nullptr && level + 1 == levels_.size()) break;
+        if (levels_[level].prev != nullptr) publish(level, levels_[level].prev.get());
+        publish(level, levels_[level].curr.get());
+    }
+
+    auto &root = levels_.back().curr;
+    root->set_parent_page_no(IX_NO_PAGE);
+    ih_->update_root_page_no(root->get_page_no());
+    ih_->file_hdr_->first_leaf_ = IX_INIT_ROOT_PAGE;
+    ih_->file_hdr_->last_leaf_ = levels_[0].curr->get_page_no();
+    auto leaf_header = ih_->fetch_write_node(IX_LEAF_HEADER_PAGE);
+    leaf_header->set_next_leaf(IX_INIT_ROOT_PAGE);
+    leaf_header->set_prev_leaf(ih_->file_hdr_->last_leaf_);
+    levels_.clear();
+    return num_entries_;
+}
+
+/**
+ * @description: 比较两个(key, rid)的key
+ */
+bool IxBulkLoader::entry_less(const char *a, const char *b) const {
+    return ix_compare(a, b, ih_->file_hdr_->col_types_, ih_->file_hdr_->col_lens_) < 0;
+}
+
+/**
+ * @description: 对内存中缓存的(key, rid)排序，返回按顺序排列的指针，key相同的保持add的顺序
+ */
+std::vector<const char *> IxBulkLoader::sort_buffer() const {
+    std::vector<const char *> entries;
+    entries.reserve(buffer_.size() / entry_len_);
+    for (size_t offset = 0; offset < buffer_.size(); offset += entry_len_) entries.push_back(buffer_.data() + offset);
+    std::stable_sort(entries.begin(), entries.end(),
+                     [this](const char *a, const char *b) { return entry_less(a, b); });
+    return entries;
+}
+
+/**
+ * @description: 把内存中缓存的(key, rid)排序后写到一个临时文件中，作为一个有序段
+ */
+void IxBulkLoader::spill_run() {
+    FILE *run = std::tmpfile();
+    if (run == nullptr) throw UnixError();
+    runs_.push_back(run);
+    for (const char *entry : sort_buffer()) {
+        if (fwrite(entry, entry_len_, 1, run) != 1) throw UnixError();
+    }
+    rewind(run);
+    buffer_.clear();
+}
+
+/**
+ * @description: 按key的顺序把所有(key, rid)交给emit；没有写出过有序段时直接在内存中排序
+ * key相同时先写出的有序段在前，保持add的顺序
+ */
+void IxBulkLoader::merge_runs(const std::function<void(const char *)> &emit) {
+    if (runs_.empty()) {
+        for (const char *entry : sort_buffer()) emit(entry);
+        return;
+    }
+    if (!buffer_.empty()) spill_run();
+    std::vector<std::vector<char>> heads(runs_.size(), std::vector<char>(entry_len_));
+    auto later = [&](size_t a, size_t b) {
+        if (entry_less(heads[b].data(), heads[a].data())) return true;
+        return !entry_less(heads[a].data(), heads[b].data()) && a > b;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> queue(later);
+    for (size_t i = 0; i < runs_.size(); i++) {
+        if (fread(heads[i].data(), entry_len_, 1, runs_[i]) == 1) queue.push(i);
+    }
+    while (!queue.empty()) {
+        size_t i = queue.top();
+        queue.pop();
+        emit(heads[i].data());
+        if (fread(heads[i].data(), entry_len_, 1, runs_[i]) == 1) queue.push(i);
+    }
+}
+
+/**
+ * @description: 把排好序的下一个(key, rid)追加到叶子层，key与上一个相同时抛出IndexDuplicateKeyError
+ */
+void IxBulkLoader::append_entry(const char *entry) {
+    if (has_last_key_ && !entry_less(last_key_.data(), entry)) throw IndexDuplicateKeyError();
+    memcpy(last_key_.data(), entry, key_len_);
+    has_last_key_ = true;
+    Rid rid;
+    memcpy(&rid, entry + key_len_, sizeof(Rid));
+    append(0, entry, rid);
+    num_entries_++;
+}
+
+/**
+ * @description: 在第level层(叶子层为0)的最后追加一个键值对，最后一个结点已填满时新建结点，并把倒数第二个结点写入上一层
+ */
+void IxBulkLoader::append(size_t level, const char *key, const Rid &rid) {
+    if (level == levels_.size()) levels_.emplace_back();
+    if (levels_[level].curr == nullptr) {
+        levels_[level].curr = new_node(level, nullptr);
+    } else if (levels_[level].curr->get_size() == fill_) {
+        // publish可能使levels_扩容，这里始终通过下标访问
+        if (levels_[level].prev != nullptr) publish(level, levels_[level].prev.get());
+        auto node = new_node(level, levels_[level].curr.get());
+        levels_[level].prev = std::move(levels_[level].curr);
+        levels_[level].curr = std::move(node);
+    }
+    auto &curr = levels_[level].curr;
+    curr->insert_pair(curr->get_size(), key, rid);
+}
+
+/**
+ * @description: 把第level层的结点node写入上一层，即在上一层的最后追加(node的第一个key, node的页号)
+ */
+void IxBulkLoader::publish(size_t level, IxNodeHandle *node) {
+    append(level + 1, node->get_key(0), {node->get_page_no(), 0});
+    node->set_parent_page_no(levels_[level + 1].curr->get_page_no());
+}
+
+/**
+ * @description: 在第level层新建一个结点，放在left的右边；叶子层的第一个结点使用创建索引时的根结点页面
+ */
+std::unique_ptr<IxNodeHandle> IxBulkLoader::new_node(size_t level, IxNodeHandle *left) {
+    bool is_leaf = level == 0;
+    auto node = is_leaf && left == nullptr ? ih_->fetch_write_node(IX_INIT_ROOT_PAGE) : ih_->create_node();
+    *node->page_hdr = {
+        .next_free_page_no = IX_NO_PAGE,
+        .parent = IX_NO_PAGE,
+        .num_key = 0,
+        .is_leaf = is_leaf,
+        .prev_leaf = IX_NO_PAGE,
+        .next_leaf = IX_NO_PAGE,
+    };
+    if (is_leaf) {
+        node->set_prev_leaf(left == nullptr ? IX_LEAF_HEADER_PAGE : left->get_page_no());
+        node->set_next_leaf(IX_LEAF_HEADER_PAGE);
+        if (left != nullptr) left->set_next_leaf(node->get_page_no());
+    }
+    return node;
+}
+
+/**
+ * @description: 第level层的最后一个结点不足min_size时，从倒数第二个结点移过来一部分键值对；两个结点加起来也不够时合并成一个结点
+ */
+void IxBulkLoader::balance_last_two(size_t level) {
+    auto &lv = levels_[level];
+    if (lv.prev == nullptr) return;
+    IxNodeHandle *left = lv.prev.get(), *right = lv.curr.get();
+    int min_size = right->get_min_size();
+    if (right->get_size() >= min_size) return;
+
+    int total = left->get_size() + right->get_size();
+    if (total >= 2 * min_size) {
+        int moved = left->get_size() - total / 2;
+        int pos = left->get_size() - moved;
+        right->insert_pairs(0, left->get_key(pos), left->get_rid(pos), moved);
+        left->set_size(pos);
+        for (int i = 0; i < moved; i++) ih_->maintain_child(right, i);
+    } else {
+        int pos = left->get_size();
+        left->insert_pairs(pos, right->get_key(0), right->get_rid(0), right->get_size());
+        for (int i = pos; i < total; i++) ih_->maintain_child(left, i);
+        ih_->release_node_handle(*right);
+        lv.curr = std::move(lv.prev);
+    }
+}
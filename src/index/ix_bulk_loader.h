@@ -0,0 +1,81 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdio>
+#include <functional>
+
+#include "ix_index_handle.h"
+
+/**
+ * @description: 自底向上批量构建B+树，用于在已有数据的表上创建索引
+ * 先用add()收集所有(key, rid)，内存中攒够sort_memory字节就排序后写成一个临时文件中的有序段，
+ * finish()时多路归并各有序段，按key的顺序依次填满叶子结点，每个结点写满后把它的第一个key追加到上一层，
+ * 逐层向上直到只剩一个结点作为根。每个结点只写一次，不会像逐条insert_entry那样反复分裂结点
+ * @note 只能向刚创建的空索引批量加载，期间不能有其他线程访问该索引；索引中的key不能重复，
+ *       finish()遇到重复的key时抛出IndexDuplicateKeyError，建了一半的索引由调用者删除
+ */
+class IxBulkLoader {
+   public:
+    /**
+     * @param {IxIndexHandle*} ih 刚创建的空索引
+     * @param {int} fill_percent 结点的填充率，在结点最多键值对数量的基础上计算，为之后的插入留出空位
+     * @param {size_t} sort_memory 排序时在内存中缓存的(key, rid)的字节数，超出后写到临时文件
+     */
+    IxBulkLoader(IxIndexHandle *ih, int fill_percent = IX_BULK_LOAD_FILL_PERCENT,
+                 size_t sort_memory = IX_BULK_LOAD_SORT_MEMORY);
+
+    ~IxBulkLoader();
+
+    void add(const char *key, const Rid &rid);
+
+    int finish();
+
+    // 已写到临时文件的有序段个数
+    size_t num_runs() const { return runs_.size(); }
+
+   private:
+    // B+树一层中还没有写入上一层的结点：最后两个结点在finish()时可能需要重新分配键值对，所以只有倒数第三个及之前的结点已写入上一层
+    struct Level {
+        std::unique_ptr<IxNodeHandle> prev;
+        std::unique_ptr<IxNodeHandle> curr;
+    };
+
+    IxIndexHandle *ih_;
+    int key_len_;
+    int entry_len_;     // 一个(key, rid)的长度
+    int fill_;          // 每个结点填充的键值对数量
+    size_t max_buffered_;  // 内存中最多缓存的(key, rid)个数
+    std::vector<char> buffer_;
+    std::vector<FILE *> runs_;
+    std::vector<Level> levels_;
+    std::vector<char> last_key_;
+    bool has_last_key_ = false;
+    int num_entries_ = 0;
+
+    bool entry_less(const char *a, const char *b) const;
+
+    std::vector<const char *> sort_buffer() const;
+
+    void spill_run();
+
+    void merge_runs(const std::function<void(const char *)> &emit);
+
+    void append_entry(const char *entry);
+
+    void append(size_t level, const char *key, const Rid &rid);
+
+    void publish(size_t level, IxNodeHandle *node);
+
+    std::unique_ptr<IxNodeHandle> new_node(size_t level, IxNodeHandle *left);
+
+    void balance_last_two(size_t level);
+};
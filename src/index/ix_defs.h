@@ -37,6 +37,7 @@ public:
     // first_leaf初始化之后没有进行修改，只不过是在测试文件中遍历叶子结点的时候用了
     page_id_t first_leaf_;              // 首叶节点对应的页号，在上层IxManager的open函数进行初始化，初始化为root page_no
     page_id_t last_leaf_;               // 尾叶节点对应的页号
+    int page_size_ = PAGE_SIZE;         // 文件的页面大小，创建索引时指定
     int tot_len_;                       // 记录结构体的整体长度
 
     IxFileHdr() {
@@ -52,7 +53,7 @@ public:
 
     void update_tot_len() {
         tot_len_ = 0;
-        tot_len_ += sizeof(page_id_t) * 4 + sizeof(int) * 6;
+        tot_len_ += sizeof(page_id_t) * 4 + sizeof(int) * 7;
         tot_len_ += sizeof(ColType) * col_num_ + sizeof(int) * col_num_;
     }
 
@@ -86,6 +87,8 @@ public:
         offset += sizeof(page_id_t);
         memcpy(dest + offset, &last_leaf_, sizeof(page_id_t));
         offset += sizeof(page_id_t);
+        memcpy(dest + offset, &page_size_, sizeof(int));
+        offset += sizeof(int);
         assert(offset == tot_len_);
     }
 
@@ -124,6 +127,11 @@ public:
         offset += sizeof(page_id_t);
         last_leaf_ = *reinterpret_cast<const page_id_t*>(src + offset);
         offset += sizeof(page_id_t);
+        // 没有记录页面大小的旧文件头使用PAGE_SIZE
+        if (offset < tot_len_) {
+            page_size_ = *reinterpret_cast<const int*>(src + offset);
+            offset += sizeof(int);
+        }
         assert(offset == tot_len_);
     }
 };
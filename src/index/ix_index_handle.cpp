@@ -12,45 +12,6 @@ See the Mulan PSL v2 for more details. */
 
 #include "ix_scan.h"
 
-/**
- * @brief 在当前node中查找第一个>=target的key_idx
- *
- * @return key_idx，范围为[0,num_key)，如果返回的key_idx=num_key，则表示target大于最后一个key
- * @note 返回key index（同时也是rid index），作为slot no
- */
-int IxNodeHandle::lower_bound(const char *target) const {
-    // Todo:
-    // 查找当前节点中第一个大于等于target的key，并返回key的位置给上层
-    // 提示: 可以采用多种查找方式，如顺序遍历、二分查找等；使用ix_compare()函数进行比较
-    int l = 0, r = page_hdr->num_key;
-    while (l < r) {
-        int mid = (l + r) >> 1;
-        if (ix_compare(get_key(mid), target, file_hdr->col_types_, file_hdr->col_lens_) >= 0) r = mid;
-        else l = mid + 1;
-    }
-    return r;
-}
-
-/**
- * @brief 在当前node中查找第一个>target的key_idx
- *
- * @return key_idx，范围为[1,num_key)，如果返回的key_idx=num_key，则表示target大于等于最后一个key
- * @note 注意此处的范围从1开始
- */
-int IxNodeHandle::upper_bound(const char *target) const {
-    // Todo:
-    // 查找当前节点中第一个大于target的key，并返回key的位置给上层
-    // 提示: 可以采用多种查找方式：顺序遍历、二分查找等；使用ix_compare()函数进行比较
-
-    int l = 0, r = page_hdr->num_key;
-    while (l < r) {
-        int mid = (l + r) >> 1;
-        if (ix_compare(get_key(mid), target, file_hdr->col_types_, file_hdr->col_lens_) > 0) r = mid;
-        else l = mid + 1;
-    }
-    return r;
-}
-
 /**
  * @brief 用于叶子结点根据key来查找该结点中的键值对
  * 值value作为传出参数，函数返回是否查找成功
@@ -66,7 +27,7 @@ std::pair<bool, int> IxNodeHandle::leaf_lookup(const char *key, Rid **value) {
     // 3. 如果存在，获取key对应的Rid，并赋值给传出参数value
     // 提示：可以调用lower_bound()和get_rid()函数。
     int idx = lower_bound(key);
-    if (idx != page_hdr->num_key && !ix_compare(key, get_key(idx), file_hdr->col_types_, file_hdr->col_lens_)) {
+    if (idx != get_size() && !ix_compare(key, get_key(idx), file_hdr->col_types_, file_hdr->col_lens_)) {
         *value = get_rid(idx);
         return {true, idx};
     }
@@ -141,7 +102,7 @@ std::pair<int, int> IxNodeHandle::insert(const char *key, const Rid &value) {
     // 3. 如果key不重复则插入键值对
     // 4. 返回完成插入操作之后的键值对数量
     int idx = lower_bound(key);
-    if (!page_hdr->num_key || ix_compare(get_key(idx), key, file_hdr->col_types_, file_hdr->col_lens_))
+    if (idx == page_hdr->num_key || ix_compare(get_key(idx), key, file_hdr->col_types_, file_hdr->col_lens_))
         insert_pairs(idx, key, &value, 1);
     return {page_hdr->num_key, idx};
 }
@@ -188,16 +149,15 @@ IxIndexHandle::IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffe
     disk_manager_->read_page(fd, IX_FILE_HDR_PAGE, buf, PAGE_SIZE);
     file_hdr_ = new IxFileHdr();
     file_hdr_->deserialize(buf);
+    key_search_ = ix_key_search_for(file_hdr_);
+    // 第0页总是从文件开头读取，读到文件头后才能确定其余页面的位置
+    disk_manager_->set_page_size(fd, file_hdr_->page_size_);
     
     // disk_manager管理的fd对应的文件中，设置从file_hdr_->num_pages开始分配page_no
-    int now_page_no = disk_manager_->get_fd2pageno(fd);
-    disk_manager_->set_fd2pageno(fd, now_page_no + 1);
+    disk_manager_->set_fd2pageno(fd, file_hdr_->num_pages_);
 
-    node_mutex[file_hdr_->root_page_] = new std::shared_mutex();
-    node_mutex[IX_LEAF_HEADER_PAGE] = new std::shared_mutex();
-    auto leaf_header = fetch_node(IX_LEAF_HEADER_PAGE);
+    auto leaf_header = fetch_write_node(IX_LEAF_HEADER_PAGE);
     leaf_header->set_next_leaf(2); leaf_header->set_prev_leaf(2);
-    buffer_pool_manager_->unpin_page(leaf_header->get_page_id(), true);
 }
 
 /**
@@ -206,72 +166,112 @@ IxIndexHandle::IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffe
  * @param operation 查找到目标键值对后要进行的操作类型
  * @param transaction 事务参数，如果不需要则默认传入nullptr
  * @return [leaf node] and [root_is_latched] 返回目标叶子结点以及根结点是否加锁
- * @note need to Unlatch and unpin the leaf node outside!
+ * @note need to Unlatch the leaf node outside! 查找时叶子结点在返回的句柄析构时unpin；
+ * 插入和删除时加写锁的结点连同其pin都放在事务的latch集合中，在unlock_ancestor时unpin，返回的句柄不持有pin
  * 注意：用了FindLeafPage之后一定要unlatch叶结点，否则下次latch该结点会堵塞！
  */
-IxNodeHandle * IxIndexHandle::find_leaf_page(const char *key, Operation operation, Transaction *transaction) {
+std::unique_ptr<IxNodeHandle> IxIndexHandle::find_leaf_page(const char *key, Operation operation,
+                                                            Transaction *transaction) {
     // Todo:
     // 1. 获取根节点
     // 2. 从根节点开始不断向下查找目标key
     // 3. 找到包含该key值的叶子结点停止查找，并返回叶子节点
-    auto root = fetch_node(file_hdr_->root_page_);
-    auto target = root;
+    auto target = fetch_node(file_hdr_->root_page_);
     if (operation == Operation::FIND) {
-        read_lock(target);
-        if (!target->is_root_page()) {
-            buffer_pool_manager_->unpin_page(target->get_page_id(), false);
+        read_lock(target.get());
+        // 加锁之前根结点可能已经被替换
+        while (!target->is_root_page()) {
+            read_unlock(target.get());
             target = fetch_node(file_hdr_->root_page_);
-            read_unlock(target);
+            read_lock(target.get());
         }
         while (!target->is_leaf_page()) {
-            auto parent = target;
-            target = fetch_node(target->internal_lookup(key).first);
-            read_lock(target);
-            read_unlock(parent);
-            buffer_pool_manager_->unpin_page(parent->get_page_id(), false);
+            auto parent = std::move(target);
+            target = fetch_node(parent->internal_lookup(key).first);
+            read_lock(target.get());
+            read_unlock(parent.get());
         }
+        return target;
     } else if (operation == Operation::INSERT) {
-        write_lock(target); transaction->append_index_latch_page_set(target->page);
+        write_lock(target.get()); latch_page_set_push(target.get(), transaction);
         if (!target->is_root_page()) {
-            buffer_pool_manager_->unpin_page(target->get_page_id(), false);
             unlock_ancestor(transaction);
             target = fetch_node(file_hdr_->root_page_);
-            write_lock(target); transaction->append_index_latch_page_set(target->page);
+            write_lock(target.get()); latch_page_set_push(target.get(), transaction);
         }
         while (!target->is_leaf_page()) {
-            auto parent = target;
             auto page_no_and_idx = target->internal_lookup(key);
             auto page_no = page_no_and_idx.first, idx = page_no_and_idx.second;
             target = fetch_node(page_no);
 
-            write_lock(target);
+            write_lock(target.get());
             if (idx && target->page_hdr->num_key < target->get_max_size() - 1) unlock_ancestor(transaction);
-            transaction->append_index_latch_page_set(target->page);
-            buffer_pool_manager_->unpin_page(parent->get_page_id(), false);
+            latch_page_set_push(target.get(), transaction);
         }
     } else {
-        write_lock(target); transaction->append_index_latch_page_set(target->page);
+        write_lock(target.get()); latch_page_set_push(target.get(), transaction);
         if (!target->is_root_page()) {
-            buffer_pool_manager_->unpin_page(target->get_page_id(), false);
             unlock_ancestor(transaction);
             target = fetch_node(file_hdr_->root_page_);
-            write_lock(target); transaction->append_index_latch_page_set(target->page);
+            write_lock(target.get()); latch_page_set_push(target.get(), transaction);
         }
         while (!target->is_leaf_page()) {
-            auto parent = target;
             auto page_no_and_idx = target->internal_lookup(key);
             auto page_no = page_no_and_idx.first, idx = page_no_and_idx.second;
             target = fetch_node(page_no);
 
-            write_lock(target);
+            write_lock(target.get());
             if (idx && (target->page_hdr->num_key > target->get_min_size() ||
                 (target->is_root_page() && target->page_hdr->num_key > 2)))
                     unlock_ancestor(transaction);
-            transaction->append_index_latch_page_set(target->page);
-            buffer_pool_manager_->unpin_page(parent->get_page_id(), false);
+            latch_page_set_push(target.get(), transaction);
         }
     }
+    return target;
+}
+
+/**
+ * @brief 乐观读者获取一个结点并读出其版本号：结点已在缓冲池中时不pin页面、不访问replacer，否则照常fetch并pin住
+ * @param page_no 结点所在的页面
+ * @param[out] version 结点的版本号
+ * @return 结点的句柄；结点正被加写latch时返回nullptr
+ * @note 没有pin住的结点随时可能被淘汰，读到的内容必须用version验证之后才能使用
+ */
+std::unique_ptr<IxNodeHandle> IxIndexHandle::fetch_node_optimistic(int page_no, uint64_t *version) const {
+    if (Page *page = buffer_pool_manager_->peek_page(PageId{fd_, page_no}, version)) {
+        return std::make_unique<IxNodeHandle>(file_hdr_, key_search_, page);
+    }
+    // 不在缓冲池中、正在读入或正被加写latch：pin住页面，等待读入完成
+    auto node = fetch_node(page_no);
+    if (!node->page->read_version(version)) return nullptr;
+    return node;
+}
 
+/**
+ * @brief 乐观地查找指定键所在的叶子结点(optimistic lock coupling)：自顶向下不加latch，只读取和验证结点的版本号
+ * @param key 要查找的目标key值
+ * @param[out] version 叶子结点的版本号，调用者读完叶子结点的内容后用它验证
+ * @return 目标叶子结点，没有加latch，命中缓冲池时也不pin；途中有结点正在或已经被修改时返回nullptr，由调用者重试
+ * @note 先读出孩子结点的版本号，再验证父结点的版本号，保证孩子在读出版本号时仍是父结点的孩子
+ */
+std::unique_ptr<IxNodeHandle> IxIndexHandle::find_leaf_page_optimistic(const char *key, uint64_t *version) const {
+    page_id_t root_page_no = file_hdr_->root_page_;
+    uint64_t target_version;
+    auto target = fetch_node_optimistic(root_page_no, &target_version);
+    // 根结点被替换时旧根加着写latch，读到偶数版本号之后root_page_仍相同才说明它是根结点
+    if (target == nullptr || !target->is_root_page() || file_hdr_->root_page_ != root_page_no ||
+        !target->page->validate(target_version))
+        return nullptr;
+    while (!target->is_leaf_page()) {
+        page_id_t child_page_no = target->internal_lookup(key).first;
+        if (!target->page->validate(target_version)) return nullptr;
+        uint64_t child_version;
+        auto child = fetch_node_optimistic(child_page_no, &child_version);
+        if (child == nullptr || !target->page->validate(target_version)) return nullptr;
+        target = std::move(child);
+        target_version = child_version;
+    }
+    *version = target_version;
     return target;
 }
 
@@ -289,65 +289,82 @@ bool IxIndexHandle::get_value(const char *key, std::vector<Rid> *result, Transac
     // 2. 在叶子节点中查找目标key值的位置，并读取key对应的rid
     // 3. 把rid存入result参数中.
     // 提示：使用完buffer_pool提供的page之后，记得unpin page；记得处理并发的上锁
-    auto leaf_node = find_leaf_page(key, Operation::FIND, transaction);
-    Rid **value = new Rid*();
-    if (!leaf_node->leaf_lookup(key, value).first) {
-        read_unlock(leaf_node);
-        return false;
-    }
-    read_unlock(leaf_node);
-    result->push_back(**value);
-    buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), false);
-    return true;
+    auto found_and_rid = read_leaf(key, [&](IxNodeHandle *leaf_node) {
+        Rid *value = nullptr;
+        bool found = leaf_node->leaf_lookup(key, &value).first;
+        return std::make_pair(found, found ? *value : Rid{});
+    }, transaction);
+    if (found_and_rid.first) result->push_back(found_and_rid.second);
+    return found_and_rid.first;
 }
 
-
+/**
+ * @brief 查找key在[lk, rk]范围内的所有键值对，按key的顺序把rid追加到result中
+ *
+ * @param le 是否包含等于lk的key
+ * @param ge 是否包含等于rk的key
+ * @return bool 是否找到了至少一个键值对
+ */
 bool IxIndexHandle::range_query(const char *lk, const char* rk, std::vector<Rid> *result, Transaction *transaction, bool le, bool ge) {
-    auto leaf_node = find_leaf_page(lk, Operation::FIND, transaction);
-    Rid **value = new Rid*();
-    int idx = leaf_node->leaf_lookup(lk, value).second;
-    if (idx == leaf_node->page_hdr->num_key) {
-        read_unlock(leaf_node);
-        return false;
-    }
-    if (!le && !ix_compare(leaf_node->get_key(idx), lk, file_hdr_->col_types_, file_hdr_->col_lens_)){
-        idx ++ ;
-        if (idx == leaf_node->get_max_size()) {
-            if (leaf_node->get_page_id().page_no == file_hdr_->last_leaf_)
-                    return false;
-            idx = 0;
-            read_unlock(leaf_node);
-            buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), false);
-            leaf_node = fetch_node(leaf_node->get_next_leaf());
-            read_lock(leaf_node);
+    size_t old_size = result->size();
+    if (optimistic_read_) {
+        for (int retry = 0; retry < IX_OPTIMISTIC_READ_RETRIES; retry++) {
+            if (range_query_optimistic(lk, rk, result, le, ge)) return result->size() > old_size;
+            result->resize(old_size);
         }
     }
-    while (ix_compare(leaf_node->get_key(idx), rk, file_hdr_->col_types_, file_hdr_->col_lens_) <= -(!ge)) {
-        result->push_back(*leaf_node->get_rid(idx));
-        idx ++ ;
-        if (idx == leaf_node->get_max_size()) {
-            if (leaf_node->get_page_id().page_no == file_hdr_->last_leaf_)
-                    break;
-            idx = 0;
-            read_unlock(leaf_node);
-            buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), false);
-            leaf_node = fetch_node(leaf_node->get_next_leaf());
-            read_lock(leaf_node);
-        }
+
+    auto leaf_node = find_leaf_page(lk, Operation::FIND, transaction);
+    int idx = le ? leaf_node->lower_bound(lk) : leaf_node->upper_bound(lk);
+    while (true) {
+        for (; idx < leaf_node->get_size() && key_in_range(leaf_node->get_key(idx), rk, ge); idx++)
+            result->push_back(*leaf_node->get_rid(idx));
+        page_id_t next_page_no = leaf_node->get_next_leaf();
+        if (idx < leaf_node->get_size() || next_page_no == IX_LEAF_HEADER_PAGE) break;
+        // 先释放当前叶子再锁下一个叶子，合并结点时写者会从右向左锁住两个叶子
+        read_unlock(leaf_node.get());
+        leaf_node = fetch_node(next_page_no);
+        read_lock(leaf_node.get());
+        idx = 0;
+    }
+    read_unlock(leaf_node.get());
+    return result->size() > old_size;
+}
+
+/**
+ * @brief 乐观地查找[lk, rk]范围内的键值对：沿叶子链表移动时同样先读出下一个叶子的版本号，再验证当前叶子
+ *
+ * @return bool 读过的结点是否都通过了版本号验证；验证失败时追加到result中的内容不可用，由调用者丢弃后重试
+ * @note 被合并的叶子在摘除之前已被清空，读者经过尚未摘除的旧叶子时不会重复读到合并过去的键值对
+ */
+bool IxIndexHandle::range_query_optimistic(const char *lk, const char *rk, std::vector<Rid> *result, bool le,
+                                           bool ge) const {
+    uint64_t version;
+    auto leaf_node = find_leaf_page_optimistic(lk, &version);
+    if (leaf_node == nullptr) return false;
+    int idx = le ? leaf_node->lower_bound(lk) : leaf_node->upper_bound(lk);
+    while (true) {
+        for (; idx < leaf_node->get_size() && key_in_range(leaf_node->get_key(idx), rk, ge); idx++)
+            result->push_back(*leaf_node->get_rid(idx));
+        page_id_t next_page_no = leaf_node->get_next_leaf();
+        bool done = idx < leaf_node->get_size() || next_page_no == IX_LEAF_HEADER_PAGE;
+        if (!leaf_node->page->validate(version)) return false;
+        if (done) return true;
+        uint64_t next_version;
+        auto next_node = fetch_node_optimistic(next_page_no, &next_version);
+        if (next_node == nullptr || !leaf_node->page->validate(version)) return false;
+        leaf_node = std::move(next_node);
+        version = next_version;
+        idx = 0;
     }
-    read_unlock(leaf_node);
-    buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), false);
-    return true;
 }
 
 /**
  * @brief  将传入的一个node拆分(Split)成两个结点，在node的右边生成一个新结点new node
  * @param node 需要拆分的结点
- * @return 拆分得到的new_node
- * @note need to unpin the new node outside
- * 注意：本函数执行完毕后，原node和new node都需要在函数外面进行unpin
+ * @return 拆分得到的new_node，new_node在返回的句柄析构时unpin
  */
-IxNodeHandle *IxIndexHandle::split(IxNodeHandle *node) {
+std::unique_ptr<IxNodeHandle> IxIndexHandle::split(IxNodeHandle *node) {
     // Todo:
     // 1. 将原结点的键值对平均分配，右半部分分裂为新的右兄弟结点
     //    需要初始化新节点的page_hdr内容
@@ -355,7 +372,7 @@ IxNodeHandle *IxIndexHandle::split(IxNodeHandle *node) {
     //    为新节点分配键值对，更新旧节点的键值对数记录
     // 3. 如果新的右兄弟结点不是叶子结点，更新该结点的所有孩子结点的父节点信息(使用IxIndexHandle::maintain_child())
     auto new_node = create_node();
-    write_lock(new_node);
+    write_lock(new_node.get());
     auto& new_handler = new_node->page_hdr;
     auto& handler = node->page_hdr;
 
@@ -369,21 +386,20 @@ IxNodeHandle *IxIndexHandle::split(IxNodeHandle *node) {
     new_handler->parent = handler->parent;
     new_handler->is_leaf = handler->is_leaf;
     if (new_handler->is_leaf) {
-        auto old_next_node = fetch_node(handler->next_leaf);
+        auto old_next_node = fetch_write_node(handler->next_leaf);
 
-        write_lock(old_next_node);
+        write_lock(old_next_node.get());
         new_handler->prev_leaf = node->get_page_no();
         new_handler->next_leaf = handler->next_leaf;
         handler->next_leaf = new_node->get_page_no();
         old_next_node->set_prev_leaf(new_node->get_page_no());
-        buffer_pool_manager_->unpin_page(old_next_node->get_page_id(), true);
-        write_unlock(old_next_node);
+        write_unlock(old_next_node.get());
 
         if (file_hdr_->last_leaf_ == node->get_page_no())
             file_hdr_->last_leaf_ = new_node->get_page_no();
     } else {
         for (int i = 0; i < new_handler->num_key; i ++ )
-            maintain_child(new_node, i);
+            maintain_child(new_node.get(), i);
     }
     return new_node;
 }
@@ -399,7 +415,6 @@ IxNodeHandle *IxIndexHandle::split(IxNodeHandle *node) {
  * @param key 要插入parent的key
  * @note 一个结点插入了键值对之后需要分裂，分裂后左半部分的键值对保留在原结点，在参数中称为old_node，
  * 右半部分的键值对分裂为新的右兄弟节点，在参数中称为new_node（参考Split函数来理解old_node和new_node）
- * @note 本函数执行完毕后，new node和old node都需要在函数外面进行unpin
  */
 void IxIndexHandle::insert_into_parent(IxNodeHandle *old_node, const char *key, IxNodeHandle *new_node,
                                        Transaction *transaction) {
@@ -412,32 +427,27 @@ void IxIndexHandle::insert_into_parent(IxNodeHandle *old_node, const char *key,
 
     if (old_node->is_root_page()) {
         auto root_node = create_node();
-        write_lock(root_node);
+        write_lock(root_node.get());
         root_node->page_hdr->parent = INVALID_PAGE_ID;
         root_node->insert_pair(0, old_node->get_key(0), {old_node->get_page_no(), 0});
         root_node->insert_pair(1, new_node->get_key(0), {new_node->get_page_no(), 0});
 
-        maintain_child(root_node, 0); maintain_child(root_node, 1);
+        maintain_child(root_node.get(), 0); maintain_child(root_node.get(), 1);
         update_root_page_no(root_node->get_page_no());
 
-        buffer_pool_manager_->unpin_page(root_node->get_page_id(), true);
-        write_unlock(root_node);
+        write_unlock(root_node.get());
         write_unlock(old_node); write_unlock(new_node);
         transaction->pop_index_latch_page_set();
     } else {
-        auto parent_node = fetch_node(old_node->page_hdr->parent);
+        auto parent_node = fetch_write_node(old_node->page_hdr->parent);
         int nums = parent_node->insert(key, {new_node->get_page_no(), 0}).first;
         write_unlock(old_node); write_unlock(new_node);
         transaction->pop_index_latch_page_set();
         if (nums == parent_node->get_max_size()) {
-            auto next_new_node = split(parent_node);
+            auto next_new_node = split(parent_node.get());
             auto new_key = next_new_node->get_key(0);
-            insert_into_parent(parent_node, new_key, next_new_node, transaction);
-
-            buffer_pool_manager_->unpin_page(parent_node->get_page_id(), true);
-            buffer_pool_manager_->unpin_page(next_new_node->get_page_id(), true);
+            insert_into_parent(parent_node.get(), new_key, next_new_node.get(), transaction);
         } else {
-            buffer_pool_manager_->unpin_page(parent_node->get_page_id(), true);
             unlock_ancestor(transaction);
         }
     }
@@ -456,23 +466,21 @@ page_id_t IxIndexHandle::insert_entry(const char *key, const Rid &value, Transac
     // 3. 如果结点已满，分裂结点，并把新结点的相关信息插入父节点
     // 提示：记得unpin page；若当前叶子节点是最右叶子节点，则需要更新file_hdr_.last_leaf；记得处理并发的上锁
     auto leaf_node = find_leaf_page(key, Operation::INSERT, transaction);
+    page_id_t leaf_page_no = leaf_node->get_page_no();
     auto nums_and_idx = leaf_node->insert(key, value);
     int nums = nums_and_idx.first, idx = nums_and_idx.second;
     if (!idx)
-        maintain_parent(leaf_node);
+        maintain_parent(leaf_node.get());
 
     if (nums == leaf_node->get_max_size()) {
-        auto new_node = split(leaf_node);
+        auto new_node = split(leaf_node.get());
         auto new_key = new_node->get_key(0);
-        insert_into_parent(leaf_node, new_key, new_node, transaction);
-        buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), true);
-        buffer_pool_manager_->unpin_page(new_node->get_page_id(), true);
+        insert_into_parent(leaf_node.get(), new_key, new_node.get(), transaction);
     } else {
         unlock_ancestor(transaction);
-        buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), true);
     }
 
-    return leaf_node->get_page_no();
+    return leaf_page_no;
 }
 
 /**
@@ -496,10 +504,9 @@ bool IxIndexHandle::delete_entry(const char *key, Transaction *transaction) {
     }
 
     if (!nums_and_idx.second)
-        maintain_parent(leaf_node);
+        maintain_parent(leaf_node.get());
 
-    bool is_delete = coalesce_or_redistribute(leaf_node, transaction);
-    if (!is_delete) buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), true);
+    coalesce_or_redistribute(leaf_node.get(), transaction);
     return true;
 }
 
@@ -531,28 +538,26 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *tr
         return false;
     }
 
-    auto parent_node = fetch_node(node->page_hdr->parent);
-    IxNodeHandle *neighbor_node;
+    auto parent_node = fetch_write_node(node->page_hdr->parent);
+    std::unique_ptr<IxNodeHandle> neighbor_node;
     char* key = node->get_key(0);
     int idx = parent_node->lower_bound(key);
     if (!idx) {
-        neighbor_node = fetch_node(parent_node->get_rid(idx + 1)->page_no);
+        neighbor_node = fetch_write_node(parent_node->get_rid(idx + 1)->page_no);
     } else {
-        neighbor_node = fetch_node(parent_node->get_rid(idx - 1)->page_no);
+        neighbor_node = fetch_write_node(parent_node->get_rid(idx - 1)->page_no);
     }
 
-    write_lock(neighbor_node);
+    write_lock(neighbor_node.get());
     int tot_num = node->page_hdr->num_key + neighbor_node->page_hdr->num_key;
     if (tot_num >= node->get_min_size() * 2) {
-        redistribute(neighbor_node, node, parent_node, idx);
-        buffer_pool_manager_->unpin_page(neighbor_node->get_page_id(), true);
-        buffer_pool_manager_->unpin_page(parent_node->get_page_id(), true);
+        redistribute(neighbor_node.get(), node, parent_node.get(), idx);
         unlock_ancestor(transaction);
         return false;
     } else {
-        bool is_delete_parent = coalesce(&neighbor_node, &node, &parent_node, idx, transaction);
-        buffer_pool_manager_->unpin_page(neighbor_node->get_page_id(), true);
-        if (!is_delete_parent) buffer_pool_manager_->unpin_page(parent_node->get_page_id(), true);
+        // 被删除的结点在release_node_handle中unpin，其余结点在句柄析构时unpin
+        IxNodeHandle *neighbor = neighbor_node.get(), *parent = parent_node.get();
+        coalesce(&neighbor, &node, &parent, idx, transaction);
         return true;
     }
 }
@@ -569,22 +574,16 @@ bool IxIndexHandle::adjust_root(IxNodeHandle *old_root_node, Transaction* transa
     // 2. 如果old_root_node是叶结点，且大小为0，则直接更新root page
     // 3. 除了上述两种情况，不需要进行操作
 
-    if (old_root_node->is_leaf_page()) {
-        if (!old_root_node->page_hdr->num_key) {
-            unlock_ancestor(transaction);
-            return true;
-        }
-    } else {
-        if (old_root_node->page_hdr->num_key == 1) {
-            auto new_root = fetch_node(old_root_node->get_rid(0)->page_no);
-            write_lock(new_root);
-            update_root_page_no(new_root->get_page_no());
-            new_root->page_hdr->parent = INVALID_PAGE_ID;
-            buffer_pool_manager_->unpin_page(new_root->get_page_id(), true);
-            write_unlock(new_root);
-            unlock_ancestor(transaction);
-            return true;
-        }
+    // 叶结点的根为空时仍然保留为根结点(root_page_不变)，不需要删除
+    if (!old_root_node->is_leaf_page() && old_root_node->page_hdr->num_key == 1) {
+        auto new_root = fetch_write_node(old_root_node->get_rid(0)->page_no);
+        write_lock(new_root.get());
+        update_root_page_no(new_root->get_page_no());
+        new_root->page_hdr->parent = INVALID_PAGE_ID;
+        write_unlock(new_root.get());
+        unlock_ancestor(transaction);
+        release_node_handle(*old_root_node);
+        return true;
     }
     unlock_ancestor(transaction);
     return false;
@@ -617,12 +616,14 @@ void IxIndexHandle::redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node
         node->insert_pair(0, key, *rid);
         neighbor_node->erase_pair(neighbor_nums - 1);
         parent->set_key(index, key);
+        maintain_child(node, 0);
     } else {
         auto key = neighbor_node->get_key(0);
         auto rid = neighbor_node->get_rid(0);
         node->insert_pair(node_nums, key, *rid);
         neighbor_node->erase_pair(0);
         parent->set_key(index + 1, neighbor_node->get_key(0));
+        maintain_child(node, node_nums);
     }
     write_unlock(neighbor_node);
 }
@@ -655,14 +656,15 @@ bool IxIndexHandle::coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node,
     for (int i = neighbor_nums; i < neighbor_nums + node_nums; i ++ )
         maintain_child(*neighbor_node, i);
     if ((*node)->is_leaf_page() && (*node)->get_page_no() == file_hdr_->last_leaf_)
-        file_hdr_->last_leaf_ = (*neighbor_node)->page_hdr->prev_leaf;
-    release_node_handle(**node);
+        file_hdr_->last_leaf_ = (*neighbor_node)->get_page_no();
+    // 清空被删除的结点，乐观读的读者经过它时不会重复读到已经移走的键值对
+    (*node)->set_size(0);
+    // 释放结点之后页面可能被复用，必须先解锁
+    write_unlock(*node); write_unlock(*neighbor_node);
+    release_node_handle(**node, transaction);
 
-    write_unlock(*neighbor_node);
-    write_unlock(*node); transaction->pop_index_latch_page_set();
     if (index) (*parent)->erase_pair(index);
     else (*parent)->erase_pair(index + 1);
-    file_hdr_->num_pages_ -- ;
     return coalesce_or_redistribute(*parent, transaction);
 }
 
@@ -676,14 +678,11 @@ bool IxIndexHandle::coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node,
  * @note iid和rid存的不是一个东西，rid是上层传过来的记录位置，iid是索引内部生成的索引槽位置
  */
 Rid IxIndexHandle::get_rid(const Iid &iid) const {
-    IxNodeHandle *node = fetch_node(iid.page_no);
+    auto node = fetch_node(iid.page_no);
     if (iid.slot_no >= node->get_size()) {
         auto next_node = fetch_node(node->get_next_leaf());
-        buffer_pool_manager_->unpin_page(next_node->get_page_id(), false);
-        buffer_pool_manager_->unpin_page(node->get_page_id(), false);
         return *next_node->get_rid(0);
     }
-    buffer_pool_manager_->unpin_page(node->get_page_id(), false);  // unpin it!
     return *node->get_rid(iid.slot_no);
 }
 
@@ -696,10 +695,9 @@ Rid IxIndexHandle::get_rid(const Iid &iid) const {
  * 可用*(int *)key转换回去
  */
 Iid IxIndexHandle::lower_bound(const char *key, Transaction* transaction) {
-    auto leaf_node = find_leaf_page(key, Operation::FIND, transaction);
-    unlock_ancestor(transaction);
-    int idx = leaf_node->lower_bound(key);
-    return {leaf_node->get_page_no(), idx};
+    return read_leaf(key, [&](IxNodeHandle *leaf_node) {
+        return Iid{leaf_node->get_page_no(), leaf_node->lower_bound(key)};
+    }, transaction);
 }
 
 /**
@@ -709,10 +707,9 @@ Iid IxIndexHandle::lower_bound(const char *key, Transaction* transaction) {
  * @return Iid
  */
 Iid IxIndexHandle::upper_bound(const char *key, Transaction* transaction) {
-    auto leaf_node = find_leaf_page(key, Operation::FIND, transaction);
-    unlock_ancestor(transaction);
-    int idx = leaf_node->upper_bound(key);
-    return {leaf_node->get_page_no(), idx};
+    return read_leaf(key, [&](IxNodeHandle *leaf_node) {
+        return Iid{leaf_node->get_page_no(), leaf_node->upper_bound(key)};
+    }, transaction);
 }
 
 /**
@@ -722,9 +719,8 @@ Iid IxIndexHandle::upper_bound(const char *key, Transaction* transaction) {
  * @return Iid
  */
 Iid IxIndexHandle::leaf_end() const {
-    IxNodeHandle *node = fetch_node(file_hdr_->last_leaf_);
+    auto node = fetch_node(file_hdr_->last_leaf_);
     Iid iid = {.page_no = file_hdr_->last_leaf_, .slot_no = node->get_size()};
-    buffer_pool_manager_->unpin_page(node->get_page_id(), false);  // unpin it!
     return iid;
 }
 
@@ -740,38 +736,56 @@ Iid IxIndexHandle::leaf_begin() const {
 }
 
 /**
- * @brief 获取一个指定结点
+ * @brief 获取一个指定结点，用于读取结点
  *
  * @param page_no
- * @return IxNodeHandle*
- * @note pin the page, remember to unpin it outside!
+ * @return std::unique_ptr<IxNodeHandle>
+ * @note 结点所在的页面在返回的句柄析构时unpin；句柄不加latch，由调用者按latch crabbing的顺序加锁
  */
-IxNodeHandle *IxIndexHandle::fetch_node(int page_no) const {
+std::unique_ptr<IxNodeHandle> IxIndexHandle::fetch_node(int page_no) const {
     Page *page = buffer_pool_manager_->fetch_page(PageId{fd_, page_no});
-    auto *node = new IxNodeHandle(file_hdr_, page);
-    return node;
+    return std::make_unique<IxNodeHandle>(file_hdr_, key_search_, PageGuard(buffer_pool_manager_, page, false));
+}
+
+/**
+ * @brief 获取一个指定结点，用于修改结点
+ *
+ * @param page_no
+ * @return std::unique_ptr<IxNodeHandle>
+ * @note 结点所在的页面在返回的句柄析构时unpin并标记为脏页
+ */
+std::unique_ptr<IxNodeHandle> IxIndexHandle::fetch_write_node(int page_no) const {
+    Page *page = buffer_pool_manager_->fetch_page(PageId{fd_, page_no});
+    return std::make_unique<IxNodeHandle>(file_hdr_, key_search_, PageGuard(buffer_pool_manager_, page, true));
 }
 
 /**
  * @brief 创建一个新结点
  *
- * @return IxNodeHandle*
- * @note pin the page, remember to unpin it outside!
+ * @return std::unique_ptr<IxNodeHandle>
+ * @note 结点所在的页面在返回的句柄析构时unpin并标记为脏页
  * 注意：对于Index的处理是，删除某个页面后，认为该被删除的页面是free_page
  * 而first_free_page实际上就是最新被删除的页面，初始为IX_NO_PAGE
  * 在最开始插入时，一直是create node，那么first_page_no一直没变，一直是IX_NO_PAGE
  * 与Record的处理不同，Record将未插入满的记录页认为是free_page
  */
-IxNodeHandle *IxIndexHandle::create_node() {
-    IxNodeHandle *node;
-    file_hdr_->num_pages_++;
-
+std::unique_ptr<IxNodeHandle> IxIndexHandle::create_node() {
     PageId new_page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
-    // 从3开始分配page_no，第一次分配之后，new_page_id.page_no=3，file_hdr_.num_pages=4
+    // 优先复用已释放的页面；否则从3开始分配page_no，第一次分配之后，new_page_id.page_no=3，file_hdr_.num_pages=4
     Page *page = buffer_pool_manager_->new_page(&new_page_id);
-    node = new IxNodeHandle(file_hdr_, page);
-    node_mutex[page->get_page_id().page_no] = new std::shared_mutex();
-    return node;
+    file_hdr_->num_pages_ = std::max(file_hdr_->num_pages_, new_page_id.page_no + 1);
+    return std::make_unique<IxNodeHandle>(file_hdr_, key_search_, PageGuard(buffer_pool_manager_, page, true));
+}
+
+/**
+ * @brief 截断索引文件末尾的空闲页面，结点合并时释放的页面已经交还给磁盘管理器
+ *
+ * @return int 截断后文件中的页面个数
+ * @note 调用者保证期间没有其他线程修改该索引
+ */
+int IxIndexHandle::compact() {
+    file_hdr_->num_pages_ = disk_manager_->truncate_free_pages(fd_);
+    return file_hdr_->num_pages_;
 }
 
 /**
@@ -781,20 +795,17 @@ IxNodeHandle *IxIndexHandle::create_node() {
  */
 void IxIndexHandle::maintain_parent(IxNodeHandle *node) {
     IxNodeHandle *curr = node;
+    std::unique_ptr<IxNodeHandle> curr_handle;  // 持有curr的pin，curr为node时为空
     while (curr->get_parent_page_no() != IX_NO_PAGE) {
         // Load its parent
-        IxNodeHandle *parent = fetch_node(curr->get_parent_page_no());
+        auto parent = fetch_write_node(curr->get_parent_page_no());
         int rank = parent->find_child(curr);
         char *parent_key = parent->get_key(rank);
         char *child_first_key = curr->get_key(0);
-        if (memcmp(parent_key, child_first_key, file_hdr_->col_tot_len_) == 0) {
-            assert(buffer_pool_manager_->unpin_page(parent->get_page_id(), true));
-            break;
-        }
+        if (memcmp(parent_key, child_first_key, file_hdr_->col_tot_len_) == 0) break;
         memcpy(parent_key, child_first_key, file_hdr_->col_tot_len_);  // 修改了parent node
-        curr = parent;
-
-        assert(buffer_pool_manager_->unpin_page(parent->get_page_id(), true));
+        curr = parent.get();
+        curr_handle = std::move(parent);
     }
 }
 
@@ -806,24 +817,31 @@ void IxIndexHandle::maintain_parent(IxNodeHandle *node) {
 void IxIndexHandle::erase_leaf(IxNodeHandle *leaf) {
     assert(leaf->is_leaf_page());
 
-    IxNodeHandle *prev = fetch_node(leaf->get_prev_leaf());
+    // 修改前驱和后继时加写latch，乐观读的读者据此发现叶子链表的变化
+    auto prev = fetch_write_node(leaf->get_prev_leaf());
+    write_lock(prev.get());
     prev->set_next_leaf(leaf->get_next_leaf());
-    buffer_pool_manager_->unpin_page(prev->get_page_id(), true);
+    write_unlock(prev.get());
 
-    IxNodeHandle *next = fetch_node(leaf->get_next_leaf());
+    auto next = fetch_write_node(leaf->get_next_leaf());
+    write_lock(next.get());
     next->set_prev_leaf(leaf->get_prev_leaf());  // 注意此处是SetPrevLeaf()
-    buffer_pool_manager_->unpin_page(next->get_page_id(), true);
+    write_unlock(next.get());
 }
 
 /**
- * @brief 删除node时，更新file_hdr_.num_pages
+ * @brief 删除node：unpin并从缓冲池删除结点所在的页面，再把页面交还给磁盘管理器复用
  *
- * @param node
+ * @param node 已经从树中摘除并解锁的结点，调用之后node不再持有页面，不能再使用node
+ * @param transaction 不为nullptr时，node在事务latch集合中的最后一项随之移出并unpin
+ * @note 页面仍被其他线程固定时由缓冲池推迟到最后一个固定释放时再删除和复用，不会让两个结点共用一个页面
  */
-void IxIndexHandle::release_node_handle(IxNodeHandle &node) {
+void IxIndexHandle::release_node_handle(IxNodeHandle &node, Transaction *transaction) {
     if (node.is_leaf_page()) erase_leaf(&node);
-    file_hdr_->num_pages_--;
-    buffer_pool_manager_->delete_page(node.get_page_id());
+    PageId page_id = node.get_page_id();
+    node.guard.drop();
+    if (transaction != nullptr) transaction->pop_index_latch_page_set();
+    buffer_pool_manager_->deallocate_page(page_id);
 }
 
 /**
@@ -833,23 +851,24 @@ void IxIndexHandle::maintain_child(IxNodeHandle *node, int child_idx) {
     if (!node->is_leaf_page()) {
         //  Current node is inner node, load its child and set its parent to current node
         int child_page_no = node->value_at(child_idx);
-        IxNodeHandle *child = fetch_node(child_page_no);
+        auto child = fetch_write_node(child_page_no);
         child->set_parent_page_no(node->get_page_no());
-        buffer_pool_manager_->unpin_page(child->get_page_id(), true);
     }
 }
 
 /**
- * @brief 将事务中所有祖先解锁
+ * @brief 对加了写锁的结点node，把它的pin转交给事务的latch集合，node之后不再持有pin
+ * @note 叶子结点会被插入或删除修改，unpin时标记为脏页；内部结点的修改通过另外获取的句柄标记
  */
+void IxIndexHandle::latch_page_set_push(IxNodeHandle *node, Transaction *transaction) {
+    if (node->is_leaf_page()) node->mark_dirty();
+    transaction->append_index_latch_page_set(std::move(node->guard));
+}
 
+/**
+ * @brief 将事务中所有祖先解锁，并unpin它们的页面
+ */
 void IxIndexHandle::unlock_ancestor(Transaction *transaction) {
-    auto locked_page = transaction->get_index_latch_page_set();
-    for (auto page : *locked_page) {
-        auto page_id = page->get_page_id();
-        auto node = fetch_node(page_id.page_no);
-        write_unlock(node);
-        buffer_pool_manager_->unpin_page(page_id, false);
-    }
+    for (auto &guard : *transaction->get_index_latch_page_set()) guard.get_page()->w_unlatch();
     transaction->clear_index_latch_page_set();
 }
\ No newline at end of file
@@ -10,15 +10,16 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <algorithm>
+
 #include "ix_defs.h"
+#include "ix_key_search.h"
 #include "transaction/transaction.h"
 
 enum class Operation { FIND = 0, INSERT, DELETE };  // 三种操作：查找、插入、删除
 
 class Transaction;
 
-static const bool binary_search = false;
-
 inline int ix_compare(const char *a, const char *b, ColType type, int col_len) {
     switch (type) {
         case TYPE_INT: {
@@ -49,13 +50,17 @@ inline int ix_compare(const char *a, const char *b, const std::vector<ColType> &
     return 0;
 }
 
-/* 管理B+树中的每个节点 */
+/* 管理B+树中的每个节点，句柄持有节点所在页面的pin，析构时自动unpin */
 class IxNodeHandle {
     friend class IxIndexHandle;
     friend class IxScan;
+    friend class IxRangeScan;
+    friend class IxBulkLoader;
 
    private:
-    const IxFileHdr *file_hdr;  // 节点所在文件的头部信息
+    const IxFileHdr *file_hdr;       // 节点所在文件的头部信息
+    const IxKeySearch *key_search;   // 结点内查找key的函数，由索引按key的类型选定
+    PageGuard guard;                 // 存储节点的页面的守卫
     Page *page;                 // 存储节点的页面
     IxPageHdr *page_hdr;        // page->data的第一部分，指针指向首地址，长度为sizeof(IxPageHdr)
     char *keys;  // page->data的第二部分，指针指向首地址，长度为file_hdr->keys_size，每个key的长度为file_hdr->col_len
@@ -64,17 +69,30 @@ class IxNodeHandle {
    public:
     IxNodeHandle() = default;
 
-    IxNodeHandle(const IxFileHdr *file_hdr_, Page *page_) : file_hdr(file_hdr_), page(page_) {
+    IxNodeHandle(const IxFileHdr *file_hdr_, const IxKeySearch *key_search_, PageGuard guard_)
+        : file_hdr(file_hdr_), key_search(key_search_), guard(std::move(guard_)), page(guard.get_page()) {
+        page_hdr = reinterpret_cast<IxPageHdr *>(page->get_data());
+        keys = page->get_data() + sizeof(IxPageHdr);
+        rids = reinterpret_cast<Rid *>(keys + file_hdr->keys_size_);
+    }
+
+    // 乐观读者不pin的结点, 页面随时可能被淘汰, 读到的内容只有版本号验证通过之后才可用
+    IxNodeHandle(const IxFileHdr *file_hdr_, const IxKeySearch *key_search_, Page *page_)
+        : file_hdr(file_hdr_), key_search(key_search_), page(page_) {
         page_hdr = reinterpret_cast<IxPageHdr *>(page->get_data());
         keys = page->get_data() + sizeof(IxPageHdr);
         rids = reinterpret_cast<Rid *>(keys + file_hdr->keys_size_);
     }
 
-    int get_size() { return page_hdr->num_key; }
+    // 不pin的结点所在的帧可能已经装入其他页面, num_key可能是任意值; 限制在[0, get_max_size()]内, 读者不会越过键值对数组
+    int get_size() const { return std::clamp(page_hdr->num_key, 0, get_max_size()); }
+
+    // 节点被修改过, unpin时将页面标记为脏页
+    void mark_dirty() { guard.mark_dirty(); }
 
     void set_size(int size) { page_hdr->num_key = size; }
 
-    int get_max_size() { return file_hdr->btree_order_ + 1; }
+    int get_max_size() const { return file_hdr->btree_order_ + 1; }
 
     int get_min_size() { return get_max_size() / 2; }
 
@@ -113,9 +131,15 @@ class IxNodeHandle {
 
     void set_rid(int rid_idx, const Rid &rid) { rids[rid_idx] = rid; }
 
-    int lower_bound(const char *target) const;
+    // 查找第一个>=target的key_idx，范围为[0,num_key]，返回num_key表示target大于所有key
+    int lower_bound(const char *target) const {
+        return key_search->lower_bound(keys, get_size(), target, file_hdr);
+    }
 
-    int upper_bound(const char *target) const;
+    // 查找第一个>target的key_idx，范围为[0,num_key]，返回num_key表示target大于等于所有key
+    int upper_bound(const char *target) const {
+        return key_search->upper_bound(keys, get_size(), target, file_hdr);
+    }
 
     void insert_pairs(int pos, const char *key, const Rid *rid, int n);
 
@@ -234,22 +258,26 @@ class HashMap {
 /* B+树 */
 class IxIndexHandle {
     friend class IxScan;
+    friend class IxRangeScan;
     friend class IxManager;
+    friend class IxBulkLoader;
 
    private:
     DiskManager *disk_manager_;
     BufferPoolManager *buffer_pool_manager_;
     int fd_;               // 存储B+树的文件
     IxFileHdr *file_hdr_;  // 存了root_page，但其初始化为2（第0页存FILE_HDR_PAGE，第1页存LEAF_HEADER_PAGE）
-    HashMap<int, std::shared_mutex *> node_mutex;
+    bool optimistic_read_ = IX_OPTIMISTIC_READ;  // 查找和范围查询是否先不加latch乐观地读取
+    const IxKeySearch *key_search_;              // 结点内查找key的函数，打开索引时按key的类型选定
 
-    void write_lock(IxNodeHandle *node) { node_mutex[node->get_page_no()]->lock(); }
+    // 结点的latch即其所在帧的latch，加锁期间结点必须保持被pin住
+    void write_lock(IxNodeHandle *node) { node->page->w_latch(); }
 
-    void write_unlock(IxNodeHandle *node) { node_mutex[node->get_page_no()]->unlock(); }
+    void write_unlock(IxNodeHandle *node) { node->page->w_unlatch(); }
 
-    void read_lock(IxNodeHandle *node) { node_mutex[node->get_page_no()]->lock_shared(); }
+    void read_lock(IxNodeHandle *node) { node->page->r_latch(); }
 
-    void read_unlock(IxNodeHandle *node) { node_mutex[node->get_page_no()]->unlock_shared(); }
+    void read_unlock(IxNodeHandle *node) { node->page->r_unlatch(); }
 
    public:
     IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd);
@@ -257,12 +285,12 @@ class IxIndexHandle {
     // for search
     bool get_value(const char *key, std::vector<Rid> *result, Transaction *transaction);
 
-    IxNodeHandle *find_leaf_page(const char *key, Operation operation, Transaction *transaction);
+    std::unique_ptr<IxNodeHandle> find_leaf_page(const char *key, Operation operation, Transaction *transaction);
 
     // for insert
     page_id_t insert_entry(const char *key, const Rid &value, Transaction *transaction);
 
-    IxNodeHandle *split(IxNodeHandle *node);
+    std::unique_ptr<IxNodeHandle> split(IxNodeHandle *node);
 
     void insert_into_parent(IxNodeHandle *old_node, const char *key, IxNodeHandle *new_node, Transaction *transaction);
 
@@ -287,28 +315,76 @@ class IxIndexHandle {
 
     bool range_query(const char *lk, const char *rk, std::vector<Rid> *result, Transaction *transaction, bool le, bool ge);
 
+    // 打开或关闭乐观读，关闭时读者总是自顶向下加读latch
+    void set_optimistic_read(bool optimistic_read) { optimistic_read_ = optimistic_read; }
+
+    // for compaction
+    int compact();
+
+    int get_fd() const { return fd_; }
+
+    int get_num_pages() const { return file_hdr_->num_pages_; }
+
    private:
     // 辅助函数
     void update_root_page_no(page_id_t root) { file_hdr_->root_page_ = root; }
 
     bool is_empty() const { return file_hdr_->root_page_ == IX_NO_PAGE; }
 
+    // for optimistic read
+    std::unique_ptr<IxNodeHandle> fetch_node_optimistic(int page_no, uint64_t *version) const;
+
+    std::unique_ptr<IxNodeHandle> find_leaf_page_optimistic(const char *key, uint64_t *version) const;
+
+    bool range_query_optimistic(const char *lk, const char *rk, std::vector<Rid> *result, bool le, bool ge) const;
+
+    /**
+     * @brief 对key所在的叶子结点执行只读操作read_leaf并返回其结果
+     * 先不加latch乐观地读，读完验证叶子结点的版本号；连续验证失败IX_OPTIMISTIC_READ_RETRIES次后加读latch再读，读者不会饿死
+     * @note 乐观读时read_leaf可能读到不一致的结点内容，只能把结果复制出来，验证通过之前不能产生副作用
+     */
+    template <typename ReadLeaf>
+    auto read_leaf(const char *key, ReadLeaf &&read_leaf, Transaction *transaction) {
+        if (optimistic_read_) {
+            for (int retry = 0; retry < IX_OPTIMISTIC_READ_RETRIES; retry++) {
+                uint64_t version;
+                auto leaf_node = find_leaf_page_optimistic(key, &version);
+                if (leaf_node == nullptr) continue;
+                auto res = read_leaf(leaf_node.get());
+                if (leaf_node->page->validate(version)) return res;
+            }
+        }
+        auto leaf_node = find_leaf_page(key, Operation::FIND, transaction);
+        auto res = read_leaf(leaf_node.get());
+        read_unlock(leaf_node.get());
+        return res;
+    }
+
+    bool key_in_range(const char *key, const char *rk, bool ge) const {
+        int cmp = ix_compare(key, rk, file_hdr_->col_types_, file_hdr_->col_lens_);
+        return cmp < 0 || (ge && cmp == 0);
+    }
+
     // for get/create node
-    IxNodeHandle *fetch_node(int page_no) const;
+    std::unique_ptr<IxNodeHandle> fetch_node(int page_no) const;
+
+    std::unique_ptr<IxNodeHandle> fetch_write_node(int page_no) const;
 
-    IxNodeHandle *create_node();
+    std::unique_ptr<IxNodeHandle> create_node();
 
     // for maintain data structure
     void maintain_parent(IxNodeHandle *node);
 
     void erase_leaf(IxNodeHandle *leaf);
 
-    void release_node_handle(IxNodeHandle &node);
+    void release_node_handle(IxNodeHandle &node, Transaction *transaction = nullptr);
 
     void maintain_child(IxNodeHandle *node, int child_idx);
 
     // for index test
     Rid get_rid(const Iid &iid) const;
 
+    void latch_page_set_push(IxNodeHandle *node, Transaction *transaction);
+
     void unlock_ancestor(Transaction *transaction);
 };
@@ -0,0 +1,200 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_key_search.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define IX_KEY_SEARCH_AVX2
+#endif
+
+#include "ix_index_handle.h"
+
+namespace {
+
+// 二分到剩下不超过这么多个key时改用AVX2一次比较8个key
+constexpr int SIMD_WINDOW = 16;
+
+/**
+ * @description: 无分支二分查找: 在[lo, lo + len)中找第一个使less(i)为false的位置, less(i)对i单调(先true后false)
+ * 每一步只根据一次比较的结果选择左半或右半, 编译器生成条件传送而不是分支, 不会因为分支预测失败而清空流水线
+ * 查找在区间缩小到不超过stop_len个key时停止, 返回时[lo, lo + len)为剩下的区间
+ */
+template <typename Less>
+inline void branchless_search(int &lo, int &len, int stop_len, Less less) {
+    while (len > stop_len) {
+        int half = len >> 1;
+        bool right = less(lo + half);
+        lo = right ? lo + half + 1 : lo;
+        len = right ? len - half - 1 : half;
+    }
+}
+
+/* 单个int的key */
+template <bool Upper>
+int search_int(const char *keys, int num_key, const char *target, const IxFileHdr *) {
+    const int *k = reinterpret_cast<const int *>(keys);
+    int t = *reinterpret_cast<const int *>(target);
+    int lo = 0, len = num_key;
+    branchless_search(lo, len, 0, [&](int i) { return Upper ? k[i] <= t : k[i] < t; });
+    return lo;
+}
+
+/* 单个float的key */
+template <bool Upper>
+int search_float(const char *keys, int num_key, const char *target, const IxFileHdr *) {
+    const float *k = reinterpret_cast<const float *>(keys);
+    float t = *reinterpret_cast<const float *>(target);
+    int lo = 0, len = num_key;
+    branchless_search(lo, len, 0, [&](int i) { return Upper ? k[i] <= t : k[i] < t; });
+    return lo;
+}
+
+/* 两个int组成的key, 第一个int在高32位、第二个int映射为无符号数在低32位, 按字典序比较等价于比较一个int64 */
+inline int64_t int_int_key(const char *key) {
+    const int *k = reinterpret_cast<const int *>(key);
+    return (static_cast<int64_t>(k[0]) << 32) | (static_cast<uint32_t>(k[1]) ^ 0x80000000u);
+}
+
+template <bool Upper>
+int search_int_int(const char *keys, int num_key, const char *target, const IxFileHdr *) {
+    int64_t t = int_int_key(target);
+    int lo = 0, len = num_key;
+    branchless_search(lo, len, 0, [&](int i) {
+        int64_t k = int_int_key(keys + i * 2 * sizeof(int));
+        return Upper ? k <= t : k < t;
+    });
+    return lo;
+}
+
+/* 单个定长字符串的key */
+template <bool Upper>
+int search_string(const char *keys, int num_key, const char *target, const IxFileHdr *file_hdr) {
+    int col_len = file_hdr->col_tot_len_;
+    int lo = 0, len = num_key;
+    branchless_search(lo, len, 0, [&](int i) {
+        int cmp = memcmp(keys + i * col_len, target, col_len);
+        return Upper ? cmp <= 0 : cmp < 0;
+    });
+    return lo;
+}
+
+/* 其他key, 逐字段调用ix_compare */
+template <bool Upper>
+int search_generic(const char *keys, int num_key, const char *target, const IxFileHdr *file_hdr) {
+    int col_len = file_hdr->col_tot_len_;
+    int l = 0, r = num_key;
+    while (l < r) {
+        int mid = (l + r) >> 1;
+        int cmp = ix_compare(keys + mid * col_len, target, file_hdr->col_types_, file_hdr->col_lens_);
+        if (Upper ? cmp > 0 : cmp >= 0) r = mid;
+        else l = mid + 1;
+    }
+    return r;
+}
+
+#ifdef IX_KEY_SEARCH_AVX2
+/**
+ * @description: 数出[lo, lo + len)中满足比较条件的key的个数, len不超过SIMD_WINDOW
+ * 每次读8个key, 可能读到num_key之后的key槽甚至rid数组, 这些内存都在页面之内, 多读的位被掩码去掉
+ */
+__attribute__((target("avx2"))) inline int count_less_int(const int *k, int lo, int len, int t, bool upper) {
+    __m256i tv = _mm256_set1_epi32(t);
+    int count = 0;
+    for (int i = 0; i < len; i += 8) {
+        __m256i kv = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(k + lo + i));
+        // lower_bound数k < t的个数, upper_bound数k <= t即!(k > t)的个数
+        __m256i cmp = upper ? _mm256_cmpgt_epi32(kv, tv) : _mm256_cmpgt_epi32(tv, kv);
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(cmp));
+        if (upper) mask = ~mask & 0xFFu;
+        int valid = std::min(8, len - i);
+        count += __builtin_popcount(mask & ((1u << valid) - 1));
+    }
+    return count;
+}
+
+__attribute__((target("avx2"))) inline int count_less_float(const float *k, int lo, int len, float t, bool upper) {
+    __m256 tv = _mm256_set1_ps(t);
+    int count = 0;
+    for (int i = 0; i < len; i += 8) {
+        __m256 kv = _mm256_loadu_ps(k + lo + i);
+        __m256 cmp = upper ? _mm256_cmp_ps(kv, tv, _CMP_LE_OQ) : _mm256_cmp_ps(kv, tv, _CMP_LT_OQ);
+        unsigned mask = _mm256_movemask_ps(cmp);
+        int valid = std::min(8, len - i);
+        count += __builtin_popcount(mask & ((1u << valid) - 1));
+    }
+    return count;
+}
+
+template <bool Upper>
+__attribute__((target("avx2"))) int search_int_avx2(const char *keys, int num_key, const char *target,
+                                                   const IxFileHdr *) {
+    const int *k = reinterpret_cast<const int *>(keys);
+    int t = *reinterpret_cast<const int *>(target);
+    int lo = 0, len = num_key;
+    branchless_search(lo, len, SIMD_WINDOW, [&](int i) { return Upper ? k[i] <= t : k[i] < t; });
+    return lo + count_less_int(k, lo, len, t, Upper);
+}
+
+template <bool Upper>
+__attribute__((target("avx2"))) int search_float_avx2(const char *keys, int num_key, const char *target,
+                                                     const IxFileHdr *) {
+    const float *k = reinterpret_cast<const float *>(keys);
+    float t = *reinterpret_cast<const float *>(target);
+    int lo = 0, len = num_key;
+    branchless_search(lo, len, SIMD_WINDOW, [&](int i) { return Upper ? k[i] <= t : k[i] < t; });
+    return lo + count_less_float(k, lo, len, t, Upper);
+}
+#endif
+
+const IxKeySearch INT_SEARCH = {"int", search_int<false>, search_int<true>};
+const IxKeySearch FLOAT_SEARCH = {"float", search_float<false>, search_float<true>};
+const IxKeySearch INT_INT_SEARCH = {"int+int", search_int_int<false>, search_int_int<true>};
+const IxKeySearch STRING_SEARCH = {"string", search_string<false>, search_string<true>};
+const IxKeySearch GENERIC_SEARCH = {"generic", search_generic<false>, search_generic<true>};
+#ifdef IX_KEY_SEARCH_AVX2
+const IxKeySearch INT_AVX2_SEARCH = {"int-avx2", search_int_avx2<false>, search_int_avx2<true>};
+const IxKeySearch FLOAT_AVX2_SEARCH = {"float-avx2", search_float_avx2<false>, search_float_avx2<true>};
+#endif
+
+bool cpu_has_avx2() {
+#ifdef IX_KEY_SEARCH_AVX2
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+#else
+    return false;
+#endif
+}
+
+}  // namespace
+
+const IxKeySearch *ix_key_search_for(const IxFileHdr *file_hdr, bool use_simd) {
+    const auto &types = file_hdr->col_types_;
+    const auto &lens = file_hdr->col_lens_;
+    [[maybe_unused]] bool simd = use_simd && cpu_has_avx2();
+    if (types.size() == 1 && types[0] == TYPE_INT && lens[0] == sizeof(int)) {
+#ifdef IX_KEY_SEARCH_AVX2
+        if (simd) return &INT_AVX2_SEARCH;
+#endif
+        return &INT_SEARCH;
+    }
+    if (types.size() == 1 && types[0] == TYPE_FLOAT && lens[0] == sizeof(float)) {
+#ifdef IX_KEY_SEARCH_AVX2
+        if (simd) return &FLOAT_AVX2_SEARCH;
+#endif
+        return &FLOAT_SEARCH;
+    }
+    if (types.size() == 1 && types[0] == TYPE_STRING) return &STRING_SEARCH;
+    if (types.size() == 2 && types[0] == TYPE_INT && types[1] == TYPE_INT && lens[0] == sizeof(int) &&
+        lens[1] == sizeof(int)) {
+        return &INT_INT_SEARCH;
+    }
+    return &GENERIC_SEARCH;
+}
@@ -0,0 +1,34 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "ix_defs.h"
+
+/**
+ * @description: 结点内查找key的函数, 在结点中num_key个有序的key里查找第一个>=target(lower_bound)
+ * 或>target(upper_bound)的key的位置, 返回值范围为[0, num_key]
+ */
+using IxKeySearchFn = int (*)(const char *keys, int num_key, const char *target, const IxFileHdr *file_hdr);
+
+struct IxKeySearch {
+    const char *name;  // 实现的名字, 用于测试和调试
+    IxKeySearchFn lower_bound;
+    IxKeySearchFn upper_bound;
+};
+
+/**
+ * @description: 按索引的key类型选择结点内查找key的函数, 打开索引时选定一次, 之后查找时不再按字段类型分支
+ * 单个int、单个float、单个定长字符串和两个int组成的key使用专门的无分支二分查找,
+ * CPU支持AVX2时int和float的key在二分到最后16个key以内后用向量比较一次数完; 其余key逐字段调用ix_compare
+ * @param {IxFileHdr*} file_hdr 索引的文件头, 决定key的类型和长度
+ * @param {bool} use_simd 为false时不使用AVX2, 用于测试和比较
+ */
+const IxKeySearch *ix_key_search_for(const IxFileHdr *file_hdr, bool use_simd = true);
@@ -16,7 +16,7 @@ See the Mulan PSL v2 for more details. */
  */
 void IxScan::next() {
     assert(!is_end());
-    IxNodeHandle *node = ih_->fetch_node(iid_.page_no);
+    auto node = ih_->fetch_node(iid_.page_no);
     assert(node->is_leaf_page());
     assert(iid_.slot_no < node->get_size());
     // increment slot no
@@ -26,9 +26,89 @@ void IxScan::next() {
         iid_.slot_no = 0;
         iid_.page_no = node->get_next_leaf();
     }
-    ih_->buffer_pool_manager_->unpin_page(node->get_page_id(), false);
 }
 
 Rid IxScan::rid() const {
     return ih_->get_rid(iid_);
-}
\ No newline at end of file
+}
+IxRangeScan::IxRangeScan(IxIndexHandle *ih, const char *lk, const char *rk, bool le, bool ge, Transaction *txn)
+    : ih_(ih), txn_(txn), le_(le), ge_(ge) {
+    int col_tot_len = ih_->file_hdr_->col_tot_len_;
+    lk_.assign(lk, lk + col_tot_len);
+    rk_.assign(rk, rk + col_tot_len);
+    last_key_.resize(col_tot_len);
+    seek();
+    while (pos_ == rids_.size() && !done_) next_leaf();
+}
+
+void IxRangeScan::next() {
+    assert(!is_end());
+    pos_++;
+    while (pos_ == rids_.size() && !done_) next_leaf();
+}
+
+/**
+ * @description: 自顶向下找到第一个还没有读出的key所在的叶子，并读出其中的一批rid
+ */
+void IxRangeScan::seek() {
+    const char *key = has_last_key_ ? last_key_.data() : lk_.data();
+    bool upper = has_last_key_ || !le_;
+    if (ih_->optimistic_read_) {
+        for (int retry = 0; retry < IX_OPTIMISTIC_READ_RETRIES; retry++) {
+            leaf_ = ih_->find_leaf_page_optimistic(key, &version_);
+            if (leaf_ != nullptr && read_batch(key, upper)) return;
+        }
+    }
+    // 加着读latch时叶子不会被修改，版本号不变，一定能通过验证
+    leaf_ = ih_->find_leaf_page(key, Operation::FIND, txn_);
+    leaf_->page->read_version(&version_);
+    read_batch(key, upper);
+    ih_->read_unlock(leaf_.get());
+}
+
+/**
+ * @description: 当前叶子中的rid已经读完，沿叶子链表移到后继叶子并读出下一批
+ * 先pin住后继叶子并读出它的版本号，再验证当前叶子，保证读出版本号时后继叶子仍在链表中；验证失败时重新定位
+ */
+void IxRangeScan::next_leaf() {
+    if (leaf_->page->validate(version_)) {
+        auto next_node = ih_->fetch_node(next_page_no_);
+        uint64_t next_version;
+        if (next_node->page->read_version(&next_version) && leaf_->page->validate(version_)) {
+            leaf_ = std::move(next_node);
+            version_ = next_version;
+            if (read_batch(nullptr, false)) return;
+        }
+    }
+    seek();
+}
+
+/**
+ * @description: 从当前叶子中第一个>=key(upper为true时>key)的位置开始，读出在范围内的rid，key为nullptr时从第0个开始
+ * @return {bool} 读的过程中叶子是否没有被修改；返回false时读出的内容不可用
+ */
+bool IxRangeScan::read_batch(const char *key, bool upper) {
+    IxNodeHandle *leaf = leaf_.get();
+    int col_tot_len = ih_->file_hdr_->col_tot_len_;
+    int size = leaf->get_size();
+    int idx = key == nullptr ? 0 : (upper ? leaf->upper_bound(key) : leaf->lower_bound(key));
+    rids_.clear();
+    pos_ = 0;
+    for (; idx < size && ih_->key_in_range(leaf->get_key(idx), rk_.data(), ge_); idx++)
+        rids_.push_back(*leaf->get_rid(idx));
+    std::vector<char> last_key;
+    if (!rids_.empty()) last_key.assign(leaf->get_key(idx - 1), leaf->get_key(idx - 1) + col_tot_len);
+    page_id_t next_page_no = leaf->get_next_leaf();
+    bool done = idx < size || next_page_no == IX_LEAF_HEADER_PAGE;
+    if (!leaf->page->validate(version_)) {
+        rids_.clear();
+        return false;
+    }
+    next_page_no_ = next_page_no;
+    done_ = done;
+    if (!last_key.empty()) {
+        last_key_ = std::move(last_key);
+        has_last_key_ = true;
+    }
+    return true;
+}
@@ -35,4 +35,41 @@ class IxScan : public RecScan {
     Rid rid() const override;
 
     const Iid &iid() const { return iid_; }
-};
\ No newline at end of file
+};
+
+/**
+ * @description: 按需读出key在范围内的rid的范围扫描，沿叶子链表逐个叶子向后读
+ * 任何时候只pin住当前叶子，每次从当前叶子中复制出一批在范围内的rid，读完再移到下一个叶子，内存占用不随范围大小增长
+ * 扫描在两次读之间不持有latch：读叶子时先记下版本号，读完再验证，移到下一个叶子之前验证当前叶子没有被修改过；
+ * 验证失败说明叶子在两次读之间被分裂或合并，从已经返回的最后一个key重新自顶向下定位，key唯一所以不会重复或遗漏
+ */
+class IxRangeScan : public RecScan {
+    IxIndexHandle *ih_;
+    Transaction *txn_;
+    std::vector<char> lk_, rk_;  // 扫描范围[lk, rk]
+    bool le_, ge_;               // 是否包含等于lk/rk的key
+    std::unique_ptr<IxNodeHandle> leaf_;  // 当前叶子，只pin不加latch
+    uint64_t version_;                    // 读当前叶子时的版本号
+    page_id_t next_page_no_;              // 读当前叶子时的后继叶子
+    std::vector<Rid> rids_;               // 从当前叶子中读出的rid
+    size_t pos_ = 0;
+    std::vector<char> last_key_;  // 已经读出的最后一个key，重新定位时从它之后开始
+    bool has_last_key_ = false;
+    bool done_ = false;  // 当前这批rid之后没有在范围内的key了
+
+   public:
+    IxRangeScan(IxIndexHandle *ih, const char *lk, const char *rk, bool le, bool ge, Transaction *txn);
+
+    void next() override;
+
+    bool is_end() const override { return pos_ == rids_.size() && done_; }
+
+    Rid rid() const override { return rids_[pos_]; }
+
+   private:
+    void seek();
+
+    void next_leaf();
+
+    bool read_batch(const char *key, bool upper);
+};
@@ -23,7 +23,10 @@ typedef enum PlanTag{
     T_Invalid = 1,
     T_Help,
     T_ShowTable,
+    T_ShowBufferStats,
+    T_SetBufferPoolSize,
     T_DescTable,
+    T_Compact,
     T_CreateTable,
     T_DropTable,
     T_CreateIndex,
@@ -159,17 +162,22 @@ class DMLPlan : public Plan
 class DDLPlan : public Plan
 {
     public:
-        DDLPlan(PlanTag tag, std::string tab_name, std::vector<std::string> col_names, std::vector<ColDef> cols)
+        DDLPlan(PlanTag tag, std::string tab_name, std::vector<std::string> col_names, std::vector<ColDef> cols,
+                int page_size = PAGE_SIZE, RmRecordFormat format = RM_FORMAT_FIXED)
         {
             Plan::tag = tag;
             tab_name_ = std::move(tab_name);
             cols_ = std::move(cols);
             tab_col_names_ = std::move(col_names);
+            page_size_ = page_size;
+            format_ = format;
         }
         ~DDLPlan(){}
         std::string tab_name_;
         std::vector<std::string> tab_col_names_;
         std::vector<ColDef> cols_;
+        int page_size_;     // create table/index时新文件的页面大小(字节)
+        RmRecordFormat format_;     // create table时数据文件的记录格式
 };
 
 // help; show tables; desc tables; begin; abort; commit; rollback语句对应的plan
@@ -181,8 +189,14 @@ class OtherPlan : public Plan
             Plan::tag = tag;
             tab_name_ = std::move(tab_name);            
         }
+        OtherPlan(PlanTag tag, int value)
+        {
+            Plan::tag = tag;
+            value_ = value;
+        }
         ~OtherPlan(){}
         std::string tab_name_;
+        int value_ = 0;     // set语句设置的值
 };
 
 class plannerInfo{
@@ -55,4 +55,16 @@ class Planner {
             {ast::SV_TYPE_INT, TYPE_INT}, {ast::SV_TYPE_FLOAT, TYPE_FLOAT}, {ast::SV_TYPE_STRING, TYPE_STRING}};
         return m.at(sv_type);
     }
+
+    // PAGE_SIZE = n中以KB为单位的页面大小转换为字节, 未指定时为默认的页面大小; 由SmManager检查是否合法
+    int interp_page_size(int page_size_kb) {
+        if (page_size_kb == 0) return PAGE_SIZE;
+        return page_size_kb > 0 && page_size_kb <= MAX_PAGE_SIZE / 1024 ? page_size_kb * 1024 : -1;
+    }
+
+    // FORMAT = FIXED | SLOTTED指定的记录格式(由parser检查), 未指定时有VARCHAR字段的表使用变长记录格式
+    RmRecordFormat interp_format(const std::string &format, bool has_varchar) {
+        if (format.empty()) return has_varchar ? RM_FORMAT_SLOTTED : RM_FORMAT_FIXED;
+        return strcasecmp(format.c_str(), "slotted") == 0 ? RM_FORMAT_SLOTTED : RM_FORMAT_FIXED;
+    }
 };
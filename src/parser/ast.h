@@ -43,6 +43,17 @@ struct Help : public TreeNode {
 struct ShowTables : public TreeNode {
 };
 
+// show buffer stats;
+struct ShowBufferStats : public TreeNode {
+};
+
+// set buffer_pool_size = size_mb;
+struct SetBufferPoolSize : public TreeNode {
+    int size_mb;
+
+    SetBufferPoolSize(int size_mb_) : size_mb(size_mb_) {}
+};
+
 struct TxnBegin : public TreeNode {
 };
 
@@ -58,8 +69,9 @@ struct TxnRollback : public TreeNode {
 struct TypeLen : public TreeNode {
     SvType type;
     int len;
+    bool is_var;    // VARCHAR(n)，变长记录格式的表中按实际长度存储
 
-    TypeLen(SvType type_, int len_) : type(type_), len(len_) {}
+    TypeLen(SvType type_, int len_, bool is_var_ = false) : type(type_), len(len_), is_var(is_var_) {}
 };
 
 struct Field : public TreeNode {
@@ -73,12 +85,21 @@ struct ColDef : public Field {
             col_name(std::move(col_name_)), type_len(std::move(type_len_)) {}
 };
 
+// create table的选项，可以按任意顺序给出
+struct TableOptions {
+    int page_size_kb = 0;   // PAGE_SIZE = n指定的页面大小(KB), 为0时使用默认的页面大小
+    std::string format;     // FORMAT = FIXED | SLOTTED指定的记录格式, 为空时由字段类型决定
+};
+
 struct CreateTable : public TreeNode {
     std::string tab_name;
     std::vector<std::shared_ptr<Field>> fields;
+    int page_size_kb;   // PAGE_SIZE = n指定的页面大小(KB), 为0时使用默认的页面大小
+    std::string format; // FORMAT = FIXED | SLOTTED指定的记录格式, 为空时由字段类型决定
 
-    CreateTable(std::string tab_name_, std::vector<std::shared_ptr<Field>> fields_) :
-            tab_name(std::move(tab_name_)), fields(std::move(fields_)) {}
+    CreateTable(std::string tab_name_, std::vector<std::shared_ptr<Field>> fields_, TableOptions options = {}) :
+            tab_name(std::move(tab_name_)), fields(std::move(fields_)), page_size_kb(options.page_size_kb),
+            format(std::move(options.format)) {}
 };
 
 struct DropTable : public TreeNode {
@@ -93,12 +114,20 @@ struct DescTable : public TreeNode {
     DescTable(std::string tab_name_) : tab_name(std::move(tab_name_)) {}
 };
 
+// compact [table_name]; 表名为空时整理所有表
+struct Compact : public TreeNode {
+    std::string tab_name;
+
+    Compact(std::string tab_name_) : tab_name(std::move(tab_name_)) {}
+};
+
 struct CreateIndex : public TreeNode {
     std::string tab_name;
     std::vector<std::string> col_names;
+    int page_size_kb;   // PAGE_SIZE = n指定的页面大小(KB), 为0时使用默认的页面大小
 
-    CreateIndex(std::string tab_name_, std::vector<std::string> col_names_) :
-            tab_name(std::move(tab_name_)), col_names(std::move(col_names_)) {}
+    CreateIndex(std::string tab_name_, std::vector<std::string> col_names_, int page_size_kb_ = 0) :
+            tab_name(std::move(tab_name_)), col_names(std::move(col_names_)), page_size_kb(page_size_kb_) {}
 };
 
 struct DropIndex : public TreeNode {
@@ -257,6 +286,8 @@ struct SemValue {
     std::vector<std::shared_ptr<BinaryExpr>> sv_conds;
 
     std::shared_ptr<OrderBy> sv_orderby;
+
+    TableOptions sv_table_options;
 };
 
 extern std::shared_ptr<ast::TreeNode> parse_tree;
@@ -16,10 +16,16 @@ See the Mulan PSL v2 for more details. */
 int main() {
     std::vector<std::string> sqls = {
         "show tables;",
+        "show buffer stats;",
+        "set buffer_pool_size = 64;",
         "desc tb;",
         "create table tb (a int, b float, c char(4));",
+        "create table tb (a int, b varchar(20)) format = slotted page_size = 8;",
+        "create table tb (a int, b VARCHAR(20));",
+        "create table tb (a int, b char(20)) format = fixed;",
         "drop table tb;",
         "create index tb(a);",
+        "create index tb(a) page_size = 16;",
         "create index tb(a, b, c);",
         "drop index tb(a, b, c);",
         "drop index tb(b);",
@@ -30,6 +36,8 @@ int main() {
         "select * from tb where x <> 2 and y >= 3. and z <= '123' and b < tb.a;",
         "select x.a, y.b from x, y where x.a = y.b and c = d;",
         "select x.a, y.b from x join y where x.a = y.b and c = d;",
+        "compact;",
+        "compact tb;",
         "exit;",
         "help;",
         "",
@@ -46,6 +54,22 @@ int main() {
             std::cout << "exit/EOF" << std::endl;
         }
     }
+    // 类型名、表格式等关键字拼错时是语法错误
+    std::vector<std::string> bad_sqls = {
+        "create table tb (a int, b foo(20));",
+        "create table tb (a int) format = packed;",
+        "create table tb (a int) layout = fixed;",
+        "vacuum tb;",
+        "show buffer status;",
+        "set buffer_pool = 64;",
+        "create index tb(a) pagesize = 16;",
+    };
+    for (auto &sql : bad_sqls) {
+        std::cout << sql << std::endl;
+        YY_BUFFER_STATE buf = yy_scan_string(sql.c_str());
+        assert(yyparse() != 0);
+        yy_delete_buffer(buf);
+    }
     ast::parse_tree.reset();
     return 0;
 }
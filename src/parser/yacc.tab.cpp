@@ -67,7 +67,7 @@
 
 
 /* First part of user prologue.  */
-#line 1 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+#line 1 "yacc.y"
 
 #include "ast.h"
 #include "yacc.tab.h"
@@ -82,7 +82,7 @@ void yyerror(YYLTYPE *locp, const char* s) {
 
 using namespace ast;
 
-#line 86 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 86 "yacc.tab.cpp"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -144,52 +144,63 @@ enum yysymbol_kind_t
   YYSYMBOL_TXN_ABORT = 31,                 /* TXN_ABORT  */
   YYSYMBOL_TXN_ROLLBACK = 32,              /* TXN_ROLLBACK  */
   YYSYMBOL_ORDER_BY = 33,                  /* ORDER_BY  */
-  YYSYMBOL_LEQ = 34,                       /* LEQ  */
-  YYSYMBOL_NEQ = 35,                       /* NEQ  */
-  YYSYMBOL_GEQ = 36,                       /* GEQ  */
-  YYSYMBOL_T_EOF = 37,                     /* T_EOF  */
-  YYSYMBOL_IDENTIFIER = 38,                /* IDENTIFIER  */
-  YYSYMBOL_VALUE_STRING = 39,              /* VALUE_STRING  */
-  YYSYMBOL_VALUE_INT = 40,                 /* VALUE_INT  */
-  YYSYMBOL_VALUE_FLOAT = 41,               /* VALUE_FLOAT  */
-  YYSYMBOL_42_ = 42,                       /* ';'  */
-  YYSYMBOL_43_ = 43,                       /* '('  */
-  YYSYMBOL_44_ = 44,                       /* ')'  */
-  YYSYMBOL_45_ = 45,                       /* ','  */
-  YYSYMBOL_46_ = 46,                       /* '.'  */
-  YYSYMBOL_47_ = 47,                       /* '='  */
-  YYSYMBOL_48_ = 48,                       /* '<'  */
-  YYSYMBOL_49_ = 49,                       /* '>'  */
-  YYSYMBOL_50_ = 50,                       /* '*'  */
-  YYSYMBOL_YYACCEPT = 51,                  /* $accept  */
-  YYSYMBOL_start = 52,                     /* start  */
-  YYSYMBOL_stmt = 53,                      /* stmt  */
-  YYSYMBOL_txnStmt = 54,                   /* txnStmt  */
-  YYSYMBOL_dbStmt = 55,                    /* dbStmt  */
-  YYSYMBOL_ddl = 56,                       /* ddl  */
-  YYSYMBOL_dml = 57,                       /* dml  */
-  YYSYMBOL_fieldList = 58,                 /* fieldList  */
-  YYSYMBOL_colNameList = 59,               /* colNameList  */
-  YYSYMBOL_field = 60,                     /* field  */
-  YYSYMBOL_type = 61,                      /* type  */
-  YYSYMBOL_valueList = 62,                 /* valueList  */
-  YYSYMBOL_value = 63,                     /* value  */
-  YYSYMBOL_condition = 64,                 /* condition  */
-  YYSYMBOL_optWhereClause = 65,            /* optWhereClause  */
-  YYSYMBOL_whereClause = 66,               /* whereClause  */
-  YYSYMBOL_col = 67,                       /* col  */
-  YYSYMBOL_colList = 68,                   /* colList  */
-  YYSYMBOL_op = 69,                        /* op  */
-  YYSYMBOL_expr = 70,                      /* expr  */
-  YYSYMBOL_setClauses = 71,                /* setClauses  */
-  YYSYMBOL_setClause = 72,                 /* setClause  */
-  YYSYMBOL_selector = 73,                  /* selector  */
-  YYSYMBOL_tableList = 74,                 /* tableList  */
-  YYSYMBOL_opt_order_clause = 75,          /* opt_order_clause  */
-  YYSYMBOL_order_clause = 76,              /* order_clause  */
-  YYSYMBOL_opt_asc_desc = 77,              /* opt_asc_desc  */
-  YYSYMBOL_tbName = 78,                    /* tbName  */
-  YYSYMBOL_colName = 79                    /* colName  */
+  YYSYMBOL_VARCHAR = 34,                   /* VARCHAR  */
+  YYSYMBOL_FORMAT = 35,                    /* FORMAT  */
+  YYSYMBOL_FIXED = 36,                     /* FIXED  */
+  YYSYMBOL_SLOTTED = 37,                   /* SLOTTED  */
+  YYSYMBOL_COMPACT = 38,                   /* COMPACT  */
+  YYSYMBOL_BUFFER = 39,                    /* BUFFER  */
+  YYSYMBOL_STATS = 40,                     /* STATS  */
+  YYSYMBOL_BUFFER_POOL_SIZE = 41,          /* BUFFER_POOL_SIZE  */
+  YYSYMBOL_PAGE_SIZE = 42,                 /* PAGE_SIZE  */
+  YYSYMBOL_LEQ = 43,                       /* LEQ  */
+  YYSYMBOL_NEQ = 44,                       /* NEQ  */
+  YYSYMBOL_GEQ = 45,                       /* GEQ  */
+  YYSYMBOL_T_EOF = 46,                     /* T_EOF  */
+  YYSYMBOL_IDENTIFIER = 47,                /* IDENTIFIER  */
+  YYSYMBOL_VALUE_STRING = 48,              /* VALUE_STRING  */
+  YYSYMBOL_VALUE_INT = 49,                 /* VALUE_INT  */
+  YYSYMBOL_VALUE_FLOAT = 50,               /* VALUE_FLOAT  */
+  YYSYMBOL_51_ = 51,                       /* ';'  */
+  YYSYMBOL_52_ = 52,                       /* '='  */
+  YYSYMBOL_53_ = 53,                       /* '('  */
+  YYSYMBOL_54_ = 54,                       /* ')'  */
+  YYSYMBOL_55_ = 55,                       /* ','  */
+  YYSYMBOL_56_ = 56,                       /* '.'  */
+  YYSYMBOL_57_ = 57,                       /* '<'  */
+  YYSYMBOL_58_ = 58,                       /* '>'  */
+  YYSYMBOL_59_ = 59,                       /* '*'  */
+  YYSYMBOL_YYACCEPT = 60,                  /* $accept  */
+  YYSYMBOL_start = 61,                     /* start  */
+  YYSYMBOL_stmt = 62,                      /* stmt  */
+  YYSYMBOL_txnStmt = 63,                   /* txnStmt  */
+  YYSYMBOL_dbStmt = 64,                    /* dbStmt  */
+  YYSYMBOL_ddl = 65,                       /* ddl  */
+  YYSYMBOL_dml = 66,                       /* dml  */
+  YYSYMBOL_fieldList = 67,                 /* fieldList  */
+  YYSYMBOL_optTableOptions = 68,           /* optTableOptions  */
+  YYSYMBOL_optPageSize = 69,               /* optPageSize  */
+  YYSYMBOL_colNameList = 70,               /* colNameList  */
+  YYSYMBOL_field = 71,                     /* field  */
+  YYSYMBOL_type = 72,                      /* type  */
+  YYSYMBOL_valueList = 73,                 /* valueList  */
+  YYSYMBOL_value = 74,                     /* value  */
+  YYSYMBOL_condition = 75,                 /* condition  */
+  YYSYMBOL_optWhereClause = 76,            /* optWhereClause  */
+  YYSYMBOL_whereClause = 77,               /* whereClause  */
+  YYSYMBOL_col = 78,                       /* col  */
+  YYSYMBOL_colList = 79,                   /* colList  */
+  YYSYMBOL_op = 80,                        /* op  */
+  YYSYMBOL_expr = 81,                      /* expr  */
+  YYSYMBOL_setClauses = 82,                /* setClauses  */
+  YYSYMBOL_setClause = 83,                 /* setClause  */
+  YYSYMBOL_selector = 84,                  /* selector  */
+  YYSYMBOL_tableList = 85,                 /* tableList  */
+  YYSYMBOL_opt_order_clause = 86,          /* opt_order_clause  */
+  YYSYMBOL_order_clause = 87,              /* order_clause  */
+  YYSYMBOL_opt_asc_desc = 88,              /* opt_asc_desc  */
+  YYSYMBOL_tbName = 89,                    /* tbName  */
+  YYSYMBOL_colName = 90                    /* colName  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -306,7 +317,7 @@ typedef int yytype_uint16;
 
 
 /* Stored state numbers (used for stacks). */
-typedef yytype_int8 yy_state_t;
+typedef yytype_uint8 yy_state_t;
 
 /* State numbers in computations.  */
 typedef int yy_state_fast_t;
@@ -518,21 +529,21 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  39
+#define YYFINAL  44
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   112
+#define YYLAST   136
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  51
+#define YYNTOKENS  60
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  29
+#define YYNNTS  31
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  69
+#define YYNRULES  80
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  127
+#define YYNSTATES  151
 
 /* YYMAXUTOK -- Last valid token kind.  */
-#define YYMAXUTOK   296
+#define YYMAXUTOK   305
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
@@ -550,9 +561,9 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-      43,    44,    50,     2,    45,     2,    46,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,    42,
-      48,    47,    49,     2,     2,     2,     2,     2,     2,     2,
+      53,    54,    59,     2,    55,     2,    56,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    51,
+      57,    52,    58,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -575,20 +586,23 @@ static const yytype_int8 yytranslate[] =
        5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
       15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
-      35,    36,    37,    38,    39,    40,    41
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    48,    49,    50
 };
 
 #if YYDEBUG
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,    56,    56,    61,    66,    71,    79,    80,    81,    82,
-      86,    90,    94,    98,   105,   112,   116,   120,   124,   128,
-     135,   139,   143,   147,   154,   158,   165,   169,   176,   183,
-     187,   191,   198,   202,   209,   213,   217,   224,   231,   232,
-     239,   243,   250,   254,   261,   265,   272,   276,   280,   284,
-     288,   292,   299,   303,   310,   314,   321,   328,   332,   336,
-     340,   344,   351,   355,   359,   366,   367,   368,   371,   373
+       0,    59,    59,    64,    69,    74,    82,    83,    84,    85,
+      89,    93,    97,   101,   108,   112,   117,   121,   125,   132,
+     136,   140,   144,   148,   155,   159,   163,   167,   174,   178,
+     186,   191,   196,   202,   208,   213,   219,   223,   230,   237,
+     241,   245,   249,   256,   260,   267,   271,   275,   282,   289,
+     290,   297,   301,   308,   312,   319,   323,   330,   334,   338,
+     342,   346,   350,   357,   361,   368,   372,   379,   386,   390,
+     394,   398,   402,   409,   413,   417,   424,   425,   426,   429,
+     431
 };
 #endif
 
@@ -608,14 +622,17 @@ static const char *const yytname[] =
   "CREATE", "TABLE", "DROP", "DESC", "INSERT", "INTO", "VALUES", "DELETE",
   "FROM", "ASC", "ORDER", "BY", "WHERE", "UPDATE", "SET", "SELECT", "INT",
   "CHAR", "FLOAT", "INDEX", "AND", "JOIN", "EXIT", "HELP", "TXN_BEGIN",
-  "TXN_COMMIT", "TXN_ABORT", "TXN_ROLLBACK", "ORDER_BY", "LEQ", "NEQ",
-  "GEQ", "T_EOF", "IDENTIFIER", "VALUE_STRING", "VALUE_INT", "VALUE_FLOAT",
-  "';'", "'('", "')'", "','", "'.'", "'='", "'<'", "'>'", "'*'", "$accept",
-  "start", "stmt", "txnStmt", "dbStmt", "ddl", "dml", "fieldList",
-  "colNameList", "field", "type", "valueList", "value", "condition",
-  "optWhereClause", "whereClause", "col", "colList", "op", "expr",
-  "setClauses", "setClause", "selector", "tableList", "opt_order_clause",
-  "order_clause", "opt_asc_desc", "tbName", "colName", YY_NULLPTR
+  "TXN_COMMIT", "TXN_ABORT", "TXN_ROLLBACK", "ORDER_BY", "VARCHAR",
+  "FORMAT", "FIXED", "SLOTTED", "COMPACT", "BUFFER", "STATS",
+  "BUFFER_POOL_SIZE", "PAGE_SIZE", "LEQ", "NEQ", "GEQ", "T_EOF",
+  "IDENTIFIER", "VALUE_STRING", "VALUE_INT", "VALUE_FLOAT", "';'", "'='",
+  "'('", "')'", "','", "'.'", "'<'", "'>'", "'*'", "$accept", "start",
+  "stmt", "txnStmt", "dbStmt", "ddl", "dml", "fieldList",
+  "optTableOptions", "optPageSize", "colNameList", "field", "type",
+  "valueList", "value", "condition", "optWhereClause", "whereClause",
+  "col", "colList", "op", "expr", "setClauses", "setClause", "selector",
+  "tableList", "opt_order_clause", "order_clause", "opt_asc_desc",
+  "tbName", "colName", YY_NULLPTR
 };
 
 static const char *
@@ -630,7 +647,7 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-69)
+#define YYTABLE_NINF (-80)
 
 #define yytable_value_is_error(Yyn) \
   0
@@ -639,19 +656,22 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int8 yypact[] =
 {
-      42,    21,     5,     8,    -2,    32,    31,    -2,   -26,   -75,
-     -75,   -75,   -75,   -75,   -75,   -75,    52,     6,   -75,   -75,
-     -75,   -75,   -75,    -2,    -2,    -2,    -2,   -75,   -75,    -2,
-      -2,    34,    13,   -75,   -75,    16,    55,    39,   -75,   -75,
-     -75,    43,    44,   -75,    45,    78,    73,    53,    54,    -2,
-      53,    53,    53,    53,    50,    54,   -75,   -75,    -4,   -75,
-      51,   -75,    -7,   -75,   -75,   -11,   -75,    -5,    22,   -75,
-      33,    24,   -75,    74,    48,    53,   -75,    24,    -2,    -2,
-      85,   -75,    53,   -75,    58,   -75,   -75,   -75,    53,   -75,
-     -75,   -75,   -75,    36,   -75,    54,   -75,   -75,   -75,   -75,
-     -75,   -75,    17,   -75,   -75,   -75,   -75,    86,   -75,   -75,
-      63,   -75,   -75,    24,   -75,   -75,   -75,   -75,    54,    60,
-     -75,     1,   -75,   -75,   -75,   -75,   -75
+      36,    10,    -4,    11,   -42,     6,    18,   -42,     1,   -41,
+     -75,   -75,   -75,   -75,   -75,   -75,   -42,   -75,    51,   -15,
+     -75,   -75,   -75,   -75,   -75,    -2,   -42,   -42,   -42,   -42,
+     -75,   -75,   -42,   -42,    39,    29,    31,   -75,   -75,    43,
+      86,    44,   -75,   -75,   -75,   -75,   -75,    48,    50,   -75,
+      52,    93,    89,    61,    58,    62,   -42,    61,    61,    61,
+      61,    57,    62,   -75,   -75,     2,   -75,    59,   -75,   -75,
+      -5,   -75,   -75,    15,   -75,    54,    24,   -75,    38,    41,
+     -75,    87,    28,    61,   -75,    41,   -42,   -42,    98,   -75,
+      61,   -75,    63,   -75,    64,   -75,    72,    61,   -75,   -75,
+     -75,   -75,    40,   -75,    62,   -75,   -75,   -75,   -75,   -75,
+     -75,    12,   -75,   -75,   -75,   -75,    99,   -75,   -20,   -75,
+      69,    70,    68,   -75,   -75,   -75,    41,   -75,   -75,   -75,
+     -75,    62,    71,    73,    67,    74,    75,   -75,    20,   -75,
+      60,    77,   -75,   -75,   -75,   -75,   -75,   -75,   -75,   -75,
+     -75
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -659,113 +679,129 @@ static const yytype_int8 yypact[] =
    means the default is an error.  */
 static const yytype_int8 yydefact[] =
 {
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     4,
-       3,    10,    11,    12,    13,     5,     0,     0,     9,     6,
-       7,     8,    14,     0,     0,     0,     0,    68,    17,     0,
-       0,     0,    69,    57,    44,    58,     0,     0,    43,     1,
-       2,     0,     0,    16,     0,     0,    38,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,    21,    69,    38,    54,
-       0,    45,    38,    59,    42,     0,    24,     0,     0,    26,
-       0,     0,    40,    39,     0,     0,    22,     0,     0,     0,
-      63,    15,     0,    29,     0,    31,    28,    18,     0,    19,
-      36,    34,    35,     0,    32,     0,    50,    49,    51,    46,
-      47,    48,     0,    55,    56,    61,    60,     0,    23,    25,
-       0,    27,    20,     0,    41,    52,    53,    37,     0,     0,
-      33,    67,    62,    30,    66,    65,    64
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       4,     3,    10,    11,    12,    13,    17,     5,     0,     0,
+       9,     6,     7,     8,    14,     0,     0,     0,     0,     0,
+      79,    21,     0,     0,     0,     0,    80,    68,    55,    69,
+       0,     0,    54,    18,     1,     2,    15,     0,     0,    20,
+       0,     0,    49,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,    25,    80,    49,    65,     0,    16,    56,
+      49,    70,    53,     0,    28,     0,     0,    36,     0,     0,
+      51,    50,     0,     0,    26,     0,     0,     0,    74,    33,
+       0,    39,     0,    42,     0,    38,    35,     0,    23,    47,
+      45,    46,     0,    43,     0,    61,    60,    62,    57,    58,
+      59,     0,    66,    67,    72,    71,     0,    27,    19,    29,
+       0,     0,     0,    22,    37,    24,     0,    52,    63,    64,
+      48,     0,     0,     0,     0,     0,     0,    44,    78,    73,
+       0,     0,    40,    41,    34,    77,    76,    75,    31,    32,
+      30
 };
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int8 yypgoto[] =
 {
-     -75,   -75,   -75,   -75,   -75,   -75,   -75,   -75,    56,    23,
-     -75,   -75,   -74,    11,   -27,   -75,    -8,   -75,   -75,   -75,
-     -75,    37,   -75,   -75,   -75,   -75,   -75,    -3,   -45
+     -75,   -75,   -75,   -75,   -75,   -75,   -75,   -75,   -75,   -75,
+      76,    37,   -75,   -75,   -74,    25,   -38,   -75,    -9,   -75,
+     -75,   -75,   -75,    47,   -75,   -75,   -75,   -75,   -75,    -3,
+     -50
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int8 yydefgoto[] =
+static const yytype_uint8 yydefgoto[] =
 {
-       0,    16,    17,    18,    19,    20,    21,    65,    68,    66,
-      86,    93,    94,    72,    56,    73,    74,    35,   102,   117,
-      58,    59,    36,    62,   108,   122,   126,    37,    38
+       0,    18,    19,    20,    21,    22,    23,    73,   118,   123,
+      76,    74,    95,   102,   103,    80,    63,    81,    82,    39,
+     111,   130,    65,    66,    40,    70,   117,   139,   147,    41,
+      42
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
    positive, shift that token.  If negative, reduce the rule whose
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
-static const yytype_int8 yytable[] =
+static const yytype_int16 yytable[] =
 {
-      34,    28,    60,   104,    31,    64,    67,    69,    69,   124,
-      55,    23,    32,    55,    25,   125,    83,    84,    85,    78,
-      41,    42,    43,    44,    33,    22,    45,    46,   115,    24,
-      60,    76,    26,    81,    82,    80,    27,    67,    79,   120,
-      61,    75,    29,   111,    30,     1,    63,     2,    40,     3,
-       4,     5,    39,    47,     6,    32,    90,    91,    92,   -68,
-       7,    48,     8,    90,    91,    92,    87,    88,    49,     9,
-      10,    11,    12,    13,    14,   105,   106,    89,    88,    15,
-     112,   113,    96,    97,    98,    50,    51,    52,    53,    54,
-      55,    57,    32,    71,   116,    99,   100,   101,    77,    95,
-     107,   110,   118,   119,   123,   109,   114,     0,     0,    70,
-     121,     0,   103
+      38,    31,    26,    67,    34,    30,    36,    72,    75,    77,
+      77,   113,    62,    43,    24,   132,    32,    28,    37,    62,
+      27,    86,   133,    47,    48,    49,    50,    84,   145,    51,
+      52,    33,    88,    67,   146,    29,    45,   128,    46,     1,
+      75,     2,    35,     3,     4,     5,    69,   124,     6,    25,
+      87,    44,   137,    71,     7,     8,     9,    83,    53,    36,
+      99,   100,   101,    10,    11,    12,    13,    14,    15,    89,
+      90,   105,   106,   107,    16,    91,    92,    93,    96,    97,
+     108,    54,    17,   114,   115,   109,   110,   -79,    94,    99,
+     100,   101,    98,    97,   125,   126,   148,   149,    55,    56,
+      57,    58,   129,    59,    61,    60,    62,    68,    64,    36,
+      79,    85,   104,   116,   122,   131,   120,   121,   134,   135,
+     136,   142,   138,   140,   144,   141,   150,   119,   143,   127,
+     112,     0,     0,     0,     0,     0,    78
 };
 
-static const yytype_int8 yycheck[] =
+static const yytype_int16 yycheck[] =
 {
-       8,     4,    47,    77,     7,    50,    51,    52,    53,     8,
-      17,     6,    38,    17,     6,    14,    21,    22,    23,    26,
-      23,    24,    25,    26,    50,     4,    29,    30,   102,    24,
-      75,    58,    24,    44,    45,    62,    38,    82,    45,   113,
-      48,    45,    10,    88,    13,     3,    49,     5,    42,     7,
-       8,     9,     0,    19,    12,    38,    39,    40,    41,    46,
-      18,    45,    20,    39,    40,    41,    44,    45,    13,    27,
-      28,    29,    30,    31,    32,    78,    79,    44,    45,    37,
-      44,    45,    34,    35,    36,    46,    43,    43,    43,    11,
-      17,    38,    38,    43,   102,    47,    48,    49,    47,    25,
-      15,    43,    16,    40,    44,    82,    95,    -1,    -1,    53,
-     118,    -1,    75
+       9,     4,     6,    53,     7,    47,    47,    57,    58,    59,
+      60,    85,    17,    16,     4,    35,    10,     6,    59,    17,
+      24,    26,    42,    26,    27,    28,    29,    65,     8,    32,
+      33,    13,    70,    83,    14,    24,    51,   111,    40,     3,
+      90,     5,    41,     7,     8,     9,    55,    97,    12,    39,
+      55,     0,   126,    56,    18,    19,    20,    55,    19,    47,
+      48,    49,    50,    27,    28,    29,    30,    31,    32,    54,
+      55,    43,    44,    45,    38,    21,    22,    23,    54,    55,
+      52,    52,    46,    86,    87,    57,    58,    56,    34,    48,
+      49,    50,    54,    55,    54,    55,    36,    37,    55,    13,
+      56,    53,   111,    53,    11,    53,    17,    49,    47,    47,
+      53,    52,    25,    15,    42,    16,    53,    53,    49,    49,
+      52,    54,   131,    52,    49,    52,    49,    90,    54,   104,
+      83,    -1,    -1,    -1,    -1,    -1,    60
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
    state STATE-NUM.  */
 static const yytype_int8 yystos[] =
 {
-       0,     3,     5,     7,     8,     9,    12,    18,    20,    27,
-      28,    29,    30,    31,    32,    37,    52,    53,    54,    55,
-      56,    57,     4,     6,    24,     6,    24,    38,    78,    10,
-      13,    78,    38,    50,    67,    68,    73,    78,    79,     0,
-      42,    78,    78,    78,    78,    78,    78,    19,    45,    13,
-      46,    43,    43,    43,    11,    17,    65,    38,    71,    72,
-      79,    67,    74,    78,    79,    58,    60,    79,    59,    79,
-      59,    43,    64,    66,    67,    45,    65,    47,    26,    45,
-      65,    44,    45,    21,    22,    23,    61,    44,    45,    44,
-      39,    40,    41,    62,    63,    25,    34,    35,    36,    47,
-      48,    49,    69,    72,    63,    78,    78,    15,    75,    60,
-      43,    79,    44,    45,    64,    63,    67,    70,    16,    40,
-      63,    67,    76,    44,     8,    14,    77
+       0,     3,     5,     7,     8,     9,    12,    18,    19,    20,
+      27,    28,    29,    30,    31,    32,    38,    46,    61,    62,
+      63,    64,    65,    66,     4,    39,     6,    24,     6,    24,
+      47,    89,    10,    13,    89,    41,    47,    59,    78,    79,
+      84,    89,    90,    89,     0,    51,    40,    89,    89,    89,
+      89,    89,    89,    19,    52,    55,    13,    56,    53,    53,
+      53,    11,    17,    76,    47,    82,    83,    90,    49,    78,
+      85,    89,    90,    67,    71,    90,    70,    90,    70,    53,
+      75,    77,    78,    55,    76,    52,    26,    55,    76,    54,
+      55,    21,    22,    23,    34,    72,    54,    55,    54,    48,
+      49,    50,    73,    74,    25,    43,    44,    45,    52,    57,
+      58,    80,    83,    74,    89,    89,    15,    86,    68,    71,
+      53,    53,    42,    69,    90,    54,    55,    75,    74,    78,
+      81,    16,    35,    42,    49,    49,    52,    74,    78,    87,
+      52,    52,    54,    54,    49,     8,    14,    88,    36,    37,
+      49
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
-       0,    51,    52,    52,    52,    52,    53,    53,    53,    53,
-      54,    54,    54,    54,    55,    56,    56,    56,    56,    56,
-      57,    57,    57,    57,    58,    58,    59,    59,    60,    61,
-      61,    61,    62,    62,    63,    63,    63,    64,    65,    65,
-      66,    66,    67,    67,    68,    68,    69,    69,    69,    69,
-      69,    69,    70,    70,    71,    71,    72,    73,    73,    74,
-      74,    74,    75,    75,    76,    77,    77,    77,    78,    79
+       0,    60,    61,    61,    61,    61,    62,    62,    62,    62,
+      63,    63,    63,    63,    64,    64,    64,    64,    64,    65,
+      65,    65,    65,    65,    66,    66,    66,    66,    67,    67,
+      68,    68,    68,    68,    69,    69,    70,    70,    71,    72,
+      72,    72,    72,    73,    73,    74,    74,    74,    75,    76,
+      76,    77,    77,    78,    78,    79,    79,    80,    80,    80,
+      80,    80,    80,    81,    81,    82,    82,    83,    84,    84,
+      85,    85,    85,    86,    86,    87,    88,    88,    88,    89,
+      90
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     2,     6,     3,     2,     6,     6,
-       7,     4,     5,     6,     1,     3,     1,     3,     2,     1,
-       4,     1,     1,     3,     1,     1,     1,     3,     0,     2,
-       1,     3,     3,     1,     1,     3,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     3,     3,     1,     1,     1,
-       3,     3,     3,     0,     2,     1,     1,     0,     1,     1
+       1,     1,     1,     1,     2,     3,     4,     1,     2,     7,
+       3,     2,     7,     6,     7,     4,     5,     6,     1,     3,
+       4,     4,     4,     0,     3,     0,     1,     3,     2,     1,
+       4,     4,     1,     1,     3,     1,     1,     1,     3,     0,
+       2,     1,     3,     3,     1,     1,     3,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     3,     3,     1,     1,
+       1,     3,     3,     3,     0,     2,     1,     1,     0,     1,
+       1
 };
 
 
@@ -1621,489 +1657,580 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* start: stmt ';'  */
-#line 57 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+#line 60 "yacc.y"
     {
         parse_tree = (yyvsp[-1].sv_node);
         YYACCEPT;
     }
-#line 1630 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1666 "yacc.tab.cpp"
     break;
 
   case 3: /* start: HELP  */
-#line 62 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+#line 65 "yacc.y"
     {
         parse_tree = std::make_shared<Help>();
         YYACCEPT;
     }
-#line 1639 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1675 "yacc.tab.cpp"
     break;
 
   case 4: /* start: EXIT  */
-#line 67 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+#line 70 "yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1648 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1684 "yacc.tab.cpp"
     break;
 
   case 5: /* start: T_EOF  */
-#line 72 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+#line 75 "yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1657 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1693 "yacc.tab.cpp"
     break;
 
   case 10: /* txnStmt: TXN_BEGIN  */
-#line 87 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+#line 90 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnBegin>();
     }
-#line 1665 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1701 "yacc.tab.cpp"
     break;
 
   case 11: /* txnStmt: TXN_COMMIT  */
-#line 91 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+#line 94 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnCommit>();
     }
-#line 1673 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1709 "yacc.tab.cpp"
     break;
 
   case 12: /* txnStmt: TXN_ABORT  */
-#line 95 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+#line 98 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnAbort>();
     }
-#line 1681 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1717 "yacc.tab.cpp"
     break;
 
   case 13: /* txnStmt: TXN_ROLLBACK  */
-#line 99 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+#line 102 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnRollback>();
     }
-#line 1689 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1725 "yacc.tab.cpp"
     break;
 
   case 14: /* dbStmt: SHOW TABLES  */
-#line 106 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+#line 109 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<ShowTables>();
     }
-#line 1697 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1733 "yacc.tab.cpp"
     break;
 
-  case 15: /* ddl: CREATE TABLE tbName '(' fieldList ')'  */
-#line 113 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 15: /* dbStmt: SHOW BUFFER STATS  */
+#line 113 "yacc.y"
     {
-        (yyval.sv_node) = std::make_shared<CreateTable>((yyvsp[-3].sv_str), (yyvsp[-1].sv_fields));
+        (yyval.sv_node) = std::make_shared<ShowBufferStats>();
     }
-#line 1705 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1741 "yacc.tab.cpp"
     break;
 
-  case 16: /* ddl: DROP TABLE tbName  */
-#line 117 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 16: /* dbStmt: SET BUFFER_POOL_SIZE '=' VALUE_INT  */
+#line 118 "yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<SetBufferPoolSize>((yyvsp[0].sv_int));
+    }
+#line 1749 "yacc.tab.cpp"
+    break;
+
+  case 17: /* dbStmt: COMPACT  */
+#line 122 "yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<Compact>("");
+    }
+#line 1757 "yacc.tab.cpp"
+    break;
+
+  case 18: /* dbStmt: COMPACT tbName  */
+#line 126 "yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<Compact>((yyvsp[0].sv_str));
+    }
+#line 1765 "yacc.tab.cpp"
+    break;
+
+  case 19: /* ddl: CREATE TABLE tbName '(' fieldList ')' optTableOptions  */
+#line 133 "yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<CreateTable>((yyvsp[-4].sv_str), (yyvsp[-2].sv_fields), (yyvsp[0].sv_table_options));
+    }
+#line 1773 "yacc.tab.cpp"
+    break;
+
+  case 20: /* ddl: DROP TABLE tbName  */
+#line 137 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropTable>((yyvsp[0].sv_str));
     }
-#line 1713 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1781 "yacc.tab.cpp"
     break;
 
-  case 17: /* ddl: DESC tbName  */
-#line 121 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 21: /* ddl: DESC tbName  */
+#line 141 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DescTable>((yyvsp[0].sv_str));
     }
-#line 1721 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1789 "yacc.tab.cpp"
     break;
 
-  case 18: /* ddl: CREATE INDEX tbName '(' colNameList ')'  */
-#line 125 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 22: /* ddl: CREATE INDEX tbName '(' colNameList ')' optPageSize  */
+#line 145 "yacc.y"
     {
-        (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
+        (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-4].sv_str), (yyvsp[-2].sv_strs), (yyvsp[0].sv_int));
     }
-#line 1729 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1797 "yacc.tab.cpp"
     break;
 
-  case 19: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
-#line 129 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 23: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
+#line 149 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
     }
-#line 1737 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1805 "yacc.tab.cpp"
     break;
 
-  case 20: /* dml: INSERT INTO tbName VALUES '(' valueList ')'  */
-#line 136 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 24: /* dml: INSERT INTO tbName VALUES '(' valueList ')'  */
+#line 156 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<InsertStmt>((yyvsp[-4].sv_str), (yyvsp[-1].sv_vals));
     }
-#line 1745 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1813 "yacc.tab.cpp"
     break;
 
-  case 21: /* dml: DELETE FROM tbName optWhereClause  */
-#line 140 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 25: /* dml: DELETE FROM tbName optWhereClause  */
+#line 160 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DeleteStmt>((yyvsp[-1].sv_str), (yyvsp[0].sv_conds));
     }
-#line 1753 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1821 "yacc.tab.cpp"
     break;
 
-  case 22: /* dml: UPDATE tbName SET setClauses optWhereClause  */
-#line 144 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 26: /* dml: UPDATE tbName SET setClauses optWhereClause  */
+#line 164 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<UpdateStmt>((yyvsp[-3].sv_str), (yyvsp[-1].sv_set_clauses), (yyvsp[0].sv_conds));
     }
-#line 1761 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1829 "yacc.tab.cpp"
     break;
 
-  case 23: /* dml: SELECT selector FROM tableList optWhereClause opt_order_clause  */
-#line 148 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 27: /* dml: SELECT selector FROM tableList optWhereClause opt_order_clause  */
+#line 168 "yacc.y"
     {
         (yyval.sv_node) = std::make_shared<SelectStmt>((yyvsp[-4].sv_cols), (yyvsp[-2].sv_strs), (yyvsp[-1].sv_conds), (yyvsp[0].sv_orderby));
     }
-#line 1769 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1837 "yacc.tab.cpp"
     break;
 
-  case 24: /* fieldList: field  */
-#line 155 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 28: /* fieldList: field  */
+#line 175 "yacc.y"
     {
         (yyval.sv_fields) = std::vector<std::shared_ptr<Field>>{(yyvsp[0].sv_field)};
     }
-#line 1777 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1845 "yacc.tab.cpp"
     break;
 
-  case 25: /* fieldList: fieldList ',' field  */
-#line 159 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 29: /* fieldList: fieldList ',' field  */
+#line 179 "yacc.y"
     {
         (yyval.sv_fields).push_back((yyvsp[0].sv_field));
     }
-#line 1785 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1853 "yacc.tab.cpp"
+    break;
+
+  case 30: /* optTableOptions: optTableOptions PAGE_SIZE '=' VALUE_INT  */
+#line 187 "yacc.y"
+    {
+        (yyval.sv_table_options) = (yyvsp[-3].sv_table_options);
+        (yyval.sv_table_options).page_size_kb = (yyvsp[0].sv_int);
+    }
+#line 1862 "yacc.tab.cpp"
+    break;
+
+  case 31: /* optTableOptions: optTableOptions FORMAT '=' FIXED  */
+#line 192 "yacc.y"
+    {
+        (yyval.sv_table_options) = (yyvsp[-3].sv_table_options);
+        (yyval.sv_table_options).format = "FIXED";
+    }
+#line 1871 "yacc.tab.cpp"
+    break;
+
+  case 32: /* optTableOptions: optTableOptions FORMAT '=' SLOTTED  */
+#line 197 "yacc.y"
+    {
+        (yyval.sv_table_options) = (yyvsp[-3].sv_table_options);
+        (yyval.sv_table_options).format = "SLOTTED";
+    }
+#line 1880 "yacc.tab.cpp"
+    break;
+
+  case 33: /* optTableOptions: %empty  */
+#line 202 "yacc.y"
+    {
+        (yyval.sv_table_options) = TableOptions();
+    }
+#line 1888 "yacc.tab.cpp"
+    break;
+
+  case 34: /* optPageSize: PAGE_SIZE '=' VALUE_INT  */
+#line 209 "yacc.y"
+    {
+        (yyval.sv_int) = (yyvsp[0].sv_int);
+    }
+#line 1896 "yacc.tab.cpp"
     break;
 
-  case 26: /* colNameList: colName  */
-#line 166 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 35: /* optPageSize: %empty  */
+#line 213 "yacc.y"
+    {
+        (yyval.sv_int) = 0;
+    }
+#line 1904 "yacc.tab.cpp"
+    break;
+
+  case 36: /* colNameList: colName  */
+#line 220 "yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{(yyvsp[0].sv_str)};
     }
-#line 1793 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1912 "yacc.tab.cpp"
     break;
 
-  case 27: /* colNameList: colNameList ',' colName  */
-#line 170 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 37: /* colNameList: colNameList ',' colName  */
+#line 224 "yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 1801 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1920 "yacc.tab.cpp"
     break;
 
-  case 28: /* field: colName type  */
-#line 177 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 38: /* field: colName type  */
+#line 231 "yacc.y"
     {
         (yyval.sv_field) = std::make_shared<ColDef>((yyvsp[-1].sv_str), (yyvsp[0].sv_type_len));
     }
-#line 1809 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1928 "yacc.tab.cpp"
     break;
 
-  case 29: /* type: INT  */
-#line 184 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 39: /* type: INT  */
+#line 238 "yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_INT, sizeof(int));
     }
-#line 1817 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1936 "yacc.tab.cpp"
     break;
 
-  case 30: /* type: CHAR '(' VALUE_INT ')'  */
-#line 188 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 40: /* type: CHAR '(' VALUE_INT ')'  */
+#line 242 "yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_STRING, (yyvsp[-1].sv_int));
     }
-#line 1825 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1944 "yacc.tab.cpp"
+    break;
+
+  case 41: /* type: VARCHAR '(' VALUE_INT ')'  */
+#line 246 "yacc.y"
+    {
+        (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_STRING, (yyvsp[-1].sv_int), true);
+    }
+#line 1952 "yacc.tab.cpp"
     break;
 
-  case 31: /* type: FLOAT  */
-#line 192 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 42: /* type: FLOAT  */
+#line 250 "yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_FLOAT, sizeof(float));
     }
-#line 1833 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1960 "yacc.tab.cpp"
     break;
 
-  case 32: /* valueList: value  */
-#line 199 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 43: /* valueList: value  */
+#line 257 "yacc.y"
     {
         (yyval.sv_vals) = std::vector<std::shared_ptr<Value>>{(yyvsp[0].sv_val)};
     }
-#line 1841 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1968 "yacc.tab.cpp"
     break;
 
-  case 33: /* valueList: valueList ',' value  */
-#line 203 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 44: /* valueList: valueList ',' value  */
+#line 261 "yacc.y"
     {
         (yyval.sv_vals).push_back((yyvsp[0].sv_val));
     }
-#line 1849 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1976 "yacc.tab.cpp"
     break;
 
-  case 34: /* value: VALUE_INT  */
-#line 210 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 45: /* value: VALUE_INT  */
+#line 268 "yacc.y"
     {
         (yyval.sv_val) = std::make_shared<IntLit>((yyvsp[0].sv_int));
     }
-#line 1857 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1984 "yacc.tab.cpp"
     break;
 
-  case 35: /* value: VALUE_FLOAT  */
-#line 214 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 46: /* value: VALUE_FLOAT  */
+#line 272 "yacc.y"
     {
         (yyval.sv_val) = std::make_shared<FloatLit>((yyvsp[0].sv_float));
     }
-#line 1865 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 1992 "yacc.tab.cpp"
     break;
 
-  case 36: /* value: VALUE_STRING  */
-#line 218 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 47: /* value: VALUE_STRING  */
+#line 276 "yacc.y"
     {
         (yyval.sv_val) = std::make_shared<StringLit>((yyvsp[0].sv_str));
     }
-#line 1873 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2000 "yacc.tab.cpp"
     break;
 
-  case 37: /* condition: col op expr  */
-#line 225 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 48: /* condition: col op expr  */
+#line 283 "yacc.y"
     {
         (yyval.sv_cond) = std::make_shared<BinaryExpr>((yyvsp[-2].sv_col), (yyvsp[-1].sv_comp_op), (yyvsp[0].sv_expr));
     }
-#line 1881 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2008 "yacc.tab.cpp"
     break;
 
-  case 38: /* optWhereClause: %empty  */
-#line 231 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 49: /* optWhereClause: %empty  */
+#line 289 "yacc.y"
                       { /* ignore*/ }
-#line 1887 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2014 "yacc.tab.cpp"
     break;
 
-  case 39: /* optWhereClause: WHERE whereClause  */
-#line 233 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 50: /* optWhereClause: WHERE whereClause  */
+#line 291 "yacc.y"
     {
         (yyval.sv_conds) = (yyvsp[0].sv_conds);
     }
-#line 1895 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2022 "yacc.tab.cpp"
     break;
 
-  case 40: /* whereClause: condition  */
-#line 240 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 51: /* whereClause: condition  */
+#line 298 "yacc.y"
     {
         (yyval.sv_conds) = std::vector<std::shared_ptr<BinaryExpr>>{(yyvsp[0].sv_cond)};
     }
-#line 1903 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2030 "yacc.tab.cpp"
     break;
 
-  case 41: /* whereClause: whereClause AND condition  */
-#line 244 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 52: /* whereClause: whereClause AND condition  */
+#line 302 "yacc.y"
     {
         (yyval.sv_conds).push_back((yyvsp[0].sv_cond));
     }
-#line 1911 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2038 "yacc.tab.cpp"
     break;
 
-  case 42: /* col: tbName '.' colName  */
-#line 251 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 53: /* col: tbName '.' colName  */
+#line 309 "yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>((yyvsp[-2].sv_str), (yyvsp[0].sv_str));
     }
-#line 1919 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2046 "yacc.tab.cpp"
     break;
 
-  case 43: /* col: colName  */
-#line 255 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 54: /* col: colName  */
+#line 313 "yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", (yyvsp[0].sv_str));
     }
-#line 1927 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2054 "yacc.tab.cpp"
     break;
 
-  case 44: /* colList: col  */
-#line 262 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 55: /* colList: col  */
+#line 320 "yacc.y"
     {
         (yyval.sv_cols) = std::vector<std::shared_ptr<Col>>{(yyvsp[0].sv_col)};
     }
-#line 1935 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2062 "yacc.tab.cpp"
     break;
 
-  case 45: /* colList: colList ',' col  */
-#line 266 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 56: /* colList: colList ',' col  */
+#line 324 "yacc.y"
     {
         (yyval.sv_cols).push_back((yyvsp[0].sv_col));
     }
-#line 1943 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2070 "yacc.tab.cpp"
     break;
 
-  case 46: /* op: '='  */
-#line 273 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 57: /* op: '='  */
+#line 331 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_EQ;
     }
-#line 1951 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2078 "yacc.tab.cpp"
     break;
 
-  case 47: /* op: '<'  */
-#line 277 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 58: /* op: '<'  */
+#line 335 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LT;
     }
-#line 1959 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2086 "yacc.tab.cpp"
     break;
 
-  case 48: /* op: '>'  */
-#line 281 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 59: /* op: '>'  */
+#line 339 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GT;
     }
-#line 1967 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2094 "yacc.tab.cpp"
     break;
 
-  case 49: /* op: NEQ  */
-#line 285 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 60: /* op: NEQ  */
+#line 343 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_NE;
     }
-#line 1975 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2102 "yacc.tab.cpp"
     break;
 
-  case 50: /* op: LEQ  */
-#line 289 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 61: /* op: LEQ  */
+#line 347 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LE;
     }
-#line 1983 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2110 "yacc.tab.cpp"
     break;
 
-  case 51: /* op: GEQ  */
-#line 293 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 62: /* op: GEQ  */
+#line 351 "yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GE;
     }
-#line 1991 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2118 "yacc.tab.cpp"
     break;
 
-  case 52: /* expr: value  */
-#line 300 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 63: /* expr: value  */
+#line 358 "yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_val));
     }
-#line 1999 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2126 "yacc.tab.cpp"
     break;
 
-  case 53: /* expr: col  */
-#line 304 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 64: /* expr: col  */
+#line 362 "yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_col));
     }
-#line 2007 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2134 "yacc.tab.cpp"
     break;
 
-  case 54: /* setClauses: setClause  */
-#line 311 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 65: /* setClauses: setClause  */
+#line 369 "yacc.y"
     {
         (yyval.sv_set_clauses) = std::vector<std::shared_ptr<SetClause>>{(yyvsp[0].sv_set_clause)};
     }
-#line 2015 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2142 "yacc.tab.cpp"
     break;
 
-  case 55: /* setClauses: setClauses ',' setClause  */
-#line 315 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 66: /* setClauses: setClauses ',' setClause  */
+#line 373 "yacc.y"
     {
         (yyval.sv_set_clauses).push_back((yyvsp[0].sv_set_clause));
     }
-#line 2023 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2150 "yacc.tab.cpp"
     break;
 
-  case 56: /* setClause: colName '=' value  */
-#line 322 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 67: /* setClause: colName '=' value  */
+#line 380 "yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>((yyvsp[-2].sv_str), (yyvsp[0].sv_val));
     }
-#line 2031 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2158 "yacc.tab.cpp"
     break;
 
-  case 57: /* selector: '*'  */
-#line 329 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 68: /* selector: '*'  */
+#line 387 "yacc.y"
     {
         (yyval.sv_cols) = {};
     }
-#line 2039 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2166 "yacc.tab.cpp"
     break;
 
-  case 59: /* tableList: tbName  */
-#line 337 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 70: /* tableList: tbName  */
+#line 395 "yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{(yyvsp[0].sv_str)};
     }
-#line 2047 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2174 "yacc.tab.cpp"
     break;
 
-  case 60: /* tableList: tableList ',' tbName  */
-#line 341 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 71: /* tableList: tableList ',' tbName  */
+#line 399 "yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 2055 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2182 "yacc.tab.cpp"
     break;
 
-  case 61: /* tableList: tableList JOIN tbName  */
-#line 345 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 72: /* tableList: tableList JOIN tbName  */
+#line 403 "yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 2063 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2190 "yacc.tab.cpp"
     break;
 
-  case 62: /* opt_order_clause: ORDER BY order_clause  */
-#line 352 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 73: /* opt_order_clause: ORDER BY order_clause  */
+#line 410 "yacc.y"
     { 
         (yyval.sv_orderby) = (yyvsp[0].sv_orderby); 
     }
-#line 2071 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2198 "yacc.tab.cpp"
     break;
 
-  case 63: /* opt_order_clause: %empty  */
-#line 355 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 74: /* opt_order_clause: %empty  */
+#line 413 "yacc.y"
                       { /* ignore*/ }
-#line 2077 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2204 "yacc.tab.cpp"
     break;
 
-  case 64: /* order_clause: col opt_asc_desc  */
-#line 360 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 75: /* order_clause: col opt_asc_desc  */
+#line 418 "yacc.y"
     { 
         (yyval.sv_orderby) = std::make_shared<OrderBy>((yyvsp[-1].sv_col), (yyvsp[0].sv_orderby_dir));
     }
-#line 2085 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2212 "yacc.tab.cpp"
     break;
 
-  case 65: /* opt_asc_desc: ASC  */
-#line 366 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 76: /* opt_asc_desc: ASC  */
+#line 424 "yacc.y"
                  { (yyval.sv_orderby_dir) = OrderBy_ASC;     }
-#line 2091 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2218 "yacc.tab.cpp"
     break;
 
-  case 66: /* opt_asc_desc: DESC  */
-#line 367 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 77: /* opt_asc_desc: DESC  */
+#line 425 "yacc.y"
                  { (yyval.sv_orderby_dir) = OrderBy_DESC;    }
-#line 2097 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2224 "yacc.tab.cpp"
     break;
 
-  case 67: /* opt_asc_desc: %empty  */
-#line 368 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+  case 78: /* opt_asc_desc: %empty  */
+#line 426 "yacc.y"
             { (yyval.sv_orderby_dir) = OrderBy_DEFAULT; }
-#line 2103 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2230 "yacc.tab.cpp"
     break;
 
 
-#line 2107 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.tab.cpp"
+#line 2234 "yacc.tab.cpp"
 
       default: break;
     }
@@ -2332,5 +2459,5 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 374 "/mnt/c/Users/HBW/Desktop/rucbase-lab/src/parser/yacc.y"
+#line 432 "yacc.y"
 
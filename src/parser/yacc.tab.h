@@ -85,14 +85,23 @@ extern int yydebug;
     TXN_ABORT = 286,               /* TXN_ABORT  */
     TXN_ROLLBACK = 287,            /* TXN_ROLLBACK  */
     ORDER_BY = 288,                /* ORDER_BY  */
-    LEQ = 289,                     /* LEQ  */
-    NEQ = 290,                     /* NEQ  */
-    GEQ = 291,                     /* GEQ  */
-    T_EOF = 292,                   /* T_EOF  */
-    IDENTIFIER = 293,              /* IDENTIFIER  */
-    VALUE_STRING = 294,            /* VALUE_STRING  */
-    VALUE_INT = 295,               /* VALUE_INT  */
-    VALUE_FLOAT = 296              /* VALUE_FLOAT  */
+    VARCHAR = 289,                 /* VARCHAR  */
+    FORMAT = 290,                  /* FORMAT  */
+    FIXED = 291,                   /* FIXED  */
+    SLOTTED = 292,                 /* SLOTTED  */
+    COMPACT = 293,                 /* COMPACT  */
+    BUFFER = 294,                  /* BUFFER  */
+    STATS = 295,                   /* STATS  */
+    BUFFER_POOL_SIZE = 296,        /* BUFFER_POOL_SIZE  */
+    PAGE_SIZE = 297,               /* PAGE_SIZE  */
+    LEQ = 298,                     /* LEQ  */
+    NEQ = 299,                     /* NEQ  */
+    GEQ = 300,                     /* GEQ  */
+    T_EOF = 301,                   /* T_EOF  */
+    IDENTIFIER = 302,              /* IDENTIFIER  */
+    VALUE_STRING = 303,            /* VALUE_STRING  */
+    VALUE_INT = 304,               /* VALUE_INT  */
+    VALUE_FLOAT = 305              /* VALUE_FLOAT  */
   };
   typedef enum yytokentype yytoken_kind_t;
 #endif
@@ -23,6 +23,7 @@ using namespace ast;
 // keywords
 %token SHOW TABLES CREATE TABLE DROP DESC INSERT INTO VALUES DELETE FROM ASC ORDER BY
 WHERE UPDATE SET SELECT INT CHAR FLOAT INDEX AND JOIN EXIT HELP TXN_BEGIN TXN_COMMIT TXN_ABORT TXN_ROLLBACK ORDER_BY
+VARCHAR FORMAT FIXED SLOTTED COMPACT BUFFER STATS BUFFER_POOL_SIZE PAGE_SIZE
 // non-keywords
 %token LEQ NEQ GEQ T_EOF
 
@@ -50,6 +51,8 @@ WHERE UPDATE SET SELECT INT CHAR FLOAT INDEX AND JOIN EXIT HELP TXN_BEGIN TXN_CO
 %type <sv_conds> whereClause optWhereClause
 %type <sv_orderby>  order_clause opt_order_clause
 %type <sv_orderby_dir> opt_asc_desc
+%type <sv_int> optPageSize
+%type <sv_table_options> optTableOptions
 
 %%
 start:
@@ -106,12 +109,29 @@ dbStmt:
     {
         $$ = std::make_shared<ShowTables>();
     }
+    |   SHOW BUFFER STATS
+    {
+        $$ = std::make_shared<ShowBufferStats>();
+    }
+    // 缓冲池大小以MB为单位
+    |   SET BUFFER_POOL_SIZE '=' VALUE_INT
+    {
+        $$ = std::make_shared<SetBufferPoolSize>($4);
+    }
+    |   COMPACT
+    {
+        $$ = std::make_shared<Compact>("");
+    }
+    |   COMPACT tbName
+    {
+        $$ = std::make_shared<Compact>($2);
+    }
     ;
 
 ddl:
-        CREATE TABLE tbName '(' fieldList ')'
+        CREATE TABLE tbName '(' fieldList ')' optTableOptions
     {
-        $$ = std::make_shared<CreateTable>($3, $5);
+        $$ = std::make_shared<CreateTable>($3, $5, $7);
     }
     |   DROP TABLE tbName
     {
@@ -121,9 +141,9 @@ ddl:
     {
         $$ = std::make_shared<DescTable>($2);
     }
-    |   CREATE INDEX tbName '(' colNameList ')'
+    |   CREATE INDEX tbName '(' colNameList ')' optPageSize
     {
-        $$ = std::make_shared<CreateIndex>($3, $5);
+        $$ = std::make_shared<CreateIndex>($3, $5, $7);
     }
     |   DROP INDEX tbName '(' colNameList ')'
     {
@@ -161,6 +181,40 @@ fieldList:
     }
     ;
 
+// 页面大小以KB为单位
+optTableOptions:
+        optTableOptions PAGE_SIZE '=' VALUE_INT
+    {
+        $$ = $1;
+        $$.page_size_kb = $4;
+    }
+    |   optTableOptions FORMAT '=' FIXED
+    {
+        $$ = $1;
+        $$.format = "FIXED";
+    }
+    |   optTableOptions FORMAT '=' SLOTTED
+    {
+        $$ = $1;
+        $$.format = "SLOTTED";
+    }
+    |   /* epsilon */
+    {
+        $$ = TableOptions();
+    }
+    ;
+
+optPageSize:
+        PAGE_SIZE '=' VALUE_INT
+    {
+        $$ = $3;
+    }
+    |   /* epsilon */
+    {
+        $$ = 0;
+    }
+    ;
+
 colNameList:
         colName
     {
@@ -188,6 +242,10 @@ type:
     {
         $$ = std::make_shared<TypeLen>(SV_TYPE_STRING, $3);
     }
+    |   VARCHAR '(' VALUE_INT ')'
+    {
+        $$ = std::make_shared<TypeLen>(SV_TYPE_STRING, $3, true);
+    }
     |   FLOAT
     {
         $$ = std::make_shared<TypeLen>(SV_TYPE_FLOAT, sizeof(float));
@@ -0,0 +1,68 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "bitmap.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BITMAP_AVX2
+#endif
+
+bool Bitmap::has_avx2() {
+#ifdef BITMAP_AVX2
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+#else
+    return false;
+#endif
+}
+
+#ifdef BITMAP_AVX2
+/**
+ * @description: 从第byte_no个字节开始，以32字节为单位跳过没有bit位的块
+ * @return {int} 第一个含有bit位的块的起始字节；都没有时返回剩下不足32字节的部分的起始字节
+ */
+__attribute__((target("avx2"))) int Bitmap::skip_avx2(const char *bm, int byte_no, int num_bytes, bool bit) {
+    // 找1时跳过全0的块，找0时跳过全1的块
+    __m256i skip = bit ? _mm256_setzero_si256() : _mm256_set1_epi8(-1);
+    for (; byte_no + BITMAP_SIMD_BYTES <= num_bytes; byte_no += BITMAP_SIMD_BYTES) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bm + byte_no));
+        if (!_mm256_testc_si256(_mm256_cmpeq_epi8(block, skip), _mm256_set1_epi8(-1))) return byte_no;
+    }
+    return byte_no;
+}
+
+/**
+ * @description: 统计前num_bytes个字节中为1的位的个数，num_bytes是32的倍数
+ * 每个字节拆成高低两个4位，查表得到各自为1的位数，再用sad把每8个字节的位数加到一个64位整数中
+ */
+__attribute__((target("avx2"))) int Bitmap::count_avx2(const char *bm, int num_bytes) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i total = _mm256_setzero_si256();
+    for (int byte_no = 0; byte_no < num_bytes; byte_no += BITMAP_SIMD_BYTES) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bm + byte_no));
+        __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(block, low_mask));
+        __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(block, 4), low_mask));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    return static_cast<int>(_mm256_extract_epi64(total, 0) + _mm256_extract_epi64(total, 1) +
+                            _mm256_extract_epi64(total, 2) + _mm256_extract_epi64(total, 3));
+}
+#else
+int Bitmap::skip_avx2(const char *, int byte_no, int, bool) { return byte_no; }
+
+int Bitmap::count_avx2(const char *bm, int num_bytes) {
+    int num_set = 0;
+    for (int byte_no = 0; byte_no < num_bytes; byte_no++) num_set += __builtin_popcount(static_cast<unsigned char>(bm[byte_no]));
+    return num_set;
+}
+#endif
@@ -10,12 +10,21 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstring>
 
 static constexpr int BITMAP_WIDTH = 8;
 static constexpr unsigned BITMAP_HIGHEST_BIT = 0x80u;  // 128 (2^7)
+static constexpr int BITMAP_WORD_BITS = 64;            // 按64位的字查找和计数
+static constexpr int BITMAP_WORD_BYTES = BITMAP_WORD_BITS / BITMAP_WIDTH;
+static constexpr int BITMAP_SIMD_BYTES = 32;           // AVX2一次处理的字节数，剩下至少这么多字节时才使用AVX2
 
+/**
+ * 位图，每个字节的最高位是第一位(见get_bit)，这一布局是数据文件格式的一部分
+ * 查找和计数按64位的字进行：把8个字节按大端序读成一个字后，位图中的第i位就是字的第63-i位，
+ * 因此字中第一个为1的位就是前导0的个数(clz)，CPU支持AVX2时大位图先以32字节为单位跳过全0(或全1)的部分
+ */
 class Bitmap {
    public:
     // 从地址bm开始的size个字节全部置0
@@ -36,19 +45,74 @@ class Bitmap {
      * @param bm 要找的起始地址为bm
      * @param max_n 要找的从起始地址开始的偏移为[curr+1,max_n)
      * @param curr 要找的从起始地址开始的偏移为[curr+1,max_n)
+     * @param use_simd 为false时不使用AVX2，用于测试和比较
      * @return 找到了就返回偏移位置，没找到就返回max_n
+     * @note 不会读取bm的前(max_n+7)/8个字节之外的内存
      */
-    static int next_bit(bool bit, const char *bm, int max_n, int curr) {
-        for (int i = curr + 1; i < max_n; i++) {
-            if (is_set(bm, i) == bit) {
-                return i;
+    static int next_bit(bool bit, const char *bm, int max_n, int curr, bool use_simd = true) {
+        int pos = curr + 1;
+        if (pos >= max_n) return max_n;
+        // 位图较满(找1)或较空(找0)时下一位往往就是要找的位，先单独测试
+        if (is_set(bm, pos) == bit) return pos;
+        int num_bytes = get_bucket(max_n + BITMAP_WIDTH - 1);
+        int word_no = pos / BITMAP_WORD_BITS;
+        uint64_t word = load_word(bm, word_no, num_bytes, bit) & (~0ull >> (pos % BITMAP_WORD_BITS));
+        while (word == 0) {
+            word_no++;
+            int byte_no = word_no * BITMAP_WORD_BYTES;
+            if (byte_no >= num_bytes) return max_n;
+            if (use_simd && num_bytes - byte_no >= BITMAP_SIMD_BYTES && has_avx2()) {
+                word_no = skip_avx2(bm, byte_no, num_bytes, bit) / BITMAP_WORD_BYTES;
             }
+            word = load_word(bm, word_no, num_bytes, bit);
         }
-        return max_n;
+        // 最后一个字节中max_n之后的位可能被找到，这时返回max_n
+        return std::min(word_no * BITMAP_WORD_BITS + __builtin_clzll(word), max_n);
     }
 
     // 找第一个为0 or 1的位
-    static int first_bit(bool bit, const char *bm, int max_n) { return next_bit(bit, bm, max_n, -1); }
+    static int first_bit(bool bit, const char *bm, int max_n, bool use_simd = true) {
+        return next_bit(bit, bm, max_n, -1, use_simd);
+    }
+
+    // 统计[0,max_n)中为1的位的个数
+    static int count(const char *bm, int max_n, bool use_simd = true) {
+        int num_full = get_bucket(max_n);  // 不含最后一个不完整的字节
+        int byte_no = 0, num_set = 0;
+        if (use_simd && num_full >= BITMAP_SIMD_BYTES && has_avx2()) {
+            byte_no = num_full / BITMAP_SIMD_BYTES * BITMAP_SIMD_BYTES;
+            num_set = count_avx2(bm, byte_no);
+        }
+        for (; byte_no + BITMAP_WORD_BYTES <= num_full; byte_no += BITMAP_WORD_BYTES) {
+            num_set += __builtin_popcountll(load_word(bm, byte_no / BITMAP_WORD_BYTES, num_full, true));
+        }
+        for (; byte_no < num_full; byte_no++) num_set += __builtin_popcount(static_cast<unsigned char>(bm[byte_no]));
+        if (max_n % BITMAP_WIDTH != 0) {
+            unsigned last = static_cast<unsigned char>(bm[num_full]) >> (BITMAP_WIDTH - max_n % BITMAP_WIDTH);
+            num_set += __builtin_popcount(last);
+        }
+        return num_set;
+    }
+
+    /**
+     * @brief 按从小到大的顺序对[0,max_n)中每个为1的位调用f(pos)，每个字只读一次
+     */
+    template <typename F>
+    static void for_each_set(const char *bm, int max_n, F &&f) {
+        int num_bytes = get_bucket(max_n + BITMAP_WIDTH - 1);
+        for (int word_no = 0; word_no * BITMAP_WORD_BYTES < num_bytes; word_no++) {
+            uint64_t word = load_word(bm, word_no, num_bytes, true);
+            while (word != 0) {
+                int pos = word_no * BITMAP_WORD_BITS + __builtin_clzll(word);
+                if (pos >= max_n) return;
+                f(pos);
+                word &= ~((1ull << (BITMAP_WORD_BITS - 1)) >> __builtin_clzll(word));  // 去掉刚找到的位
+            }
+        }
+    }
+
+    // CPU是否支持AVX2
+    static bool has_avx2();
 
     // for example:
     // rid_.slot_no = Bitmap::next_bit(true, page_handle.bitmap, file_handle_->file_hdr_.num_records_per_page,
@@ -58,4 +122,25 @@ class Bitmap {
     static int get_bucket(int pos) { return pos / BITMAP_WIDTH; }
 
     static char get_bit(int pos) { return BITMAP_HIGHEST_BIT >> static_cast<char>(pos % BITMAP_WIDTH); }
+
+    /**
+     * @brief 读出第word_no个字，位图中的第一位在字的最高位；num_bytes之后的字节按0读，bit为false时取反
+     */
+    static uint64_t load_word(const char *bm, int word_no, int num_bytes, bool bit) {
+        uint64_t word = 0;
+        int byte_no = word_no * BITMAP_WORD_BYTES;
+        if (num_bytes - byte_no >= BITMAP_WORD_BYTES) {
+            memcpy(&word, bm + byte_no, BITMAP_WORD_BYTES);
+        } else {
+            memcpy(&word, bm + byte_no, num_bytes - byte_no);
+        }
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+        return bit ? word : ~word;
+    }
+
+    static int skip_avx2(const char *bm, int byte_no, int num_bytes, bool bit);
+
+    static int count_avx2(const char *bm, int num_bytes);
 };
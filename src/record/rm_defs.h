@@ -17,26 +17,73 @@ constexpr int RM_NO_PAGE = -1;
 constexpr int RM_FILE_HDR_PAGE = 0;
 constexpr int RM_FIRST_RECORD_PAGE = 1;
 constexpr int RM_MAX_RECORD_SIZE = 512;
+constexpr int RM_MAX_VAR_FIELDS = 64;
+constexpr int RM_FSM_BUCKETS = 16;      // 空闲空间表中页面空闲空间的档位数：0档放不下一条最长的记录，1到15档按空闲空间的比例划分
+constexpr int RM_FSM_SPREAD = 4;        // 插入时从最多这么多个有空闲空间的页面中按线程选一个，把并发的插入分散到不同页面
+
+/* 表数据文件的记录格式，创建表时指定，之后保持不变 */
+enum RmRecordFormat : int {
+    RM_FORMAT_FIXED = 0,    // 定长记录：每个slot的长度都是record_size，字符串按最大长度存储
+    RM_FORMAT_SLOTTED = 1,  // 变长记录：页面中有slot目录，字符串字段去掉末尾的'\0'后存储
+};
+
+/* 变长记录格式中按实际长度存储的字段在定长记录中的位置 */
+struct RmVarField {
+    int offset;
+    int len;
+};
 
 /* 文件头，记录表数据文件的元信息，写入磁盘中文件的第0号页面 */
 struct RmFileHdr {
     int record_size;            // 表中每条记录的大小，由于不包含变长字段，因此当前字段初始化后保持不变
     int num_pages;              // 文件中分配的页面个数（初始化为1）
     int num_records_per_page;   // 每个页面最多能存储的元组个数
-    int first_free_page_no;     // 文件中当前第一个包含空闲空间的页面号（初始化为-1）
+    int first_free_page_no;     // 保留：旧版本空闲页面链表的表头，空闲空间改由RmFreeSpaceMap管理（初始化为-1）
     int bitmap_size;            // 每个页面bitmap大小
+    int page_size;              // 文件的页面大小，创建表时指定，之后保持不变（为0时是PAGE_SIZE）
+    int format;                 // 记录格式RmRecordFormat，旧文件中没有该字段，读出来是0即RM_FORMAT_FIXED
+    int num_var_fields;         // 变长记录格式中按实际长度存储的字段个数
+    RmVarField var_fields[RM_MAX_VAR_FIELDS];   // 按offset从小到大排列
 };
 
 /* 表数据文件中每个页面的页头，记录每个页面的元信息 */
 struct RmPageHdr {
-    int next_free_page_no;  // 当前页面满了之后，下一个包含空闲空间的页面号（初始化为-1）
+    int next_free_page_no;  // 保留：旧版本空闲页面链表中的下一个页面号（初始化为-1）
     int num_records;        // 当前页面中当前已经存储的记录个数（初始化为0）
 };
 
+/* 变长记录格式的页面在bitmap之后的页头，之后是slot目录，记录从页面末尾向前存放 */
+struct RmSlottedPageHdr {
+    int num_slots;      // slot目录中的slot个数，不超过num_records_per_page
+    int free_end;       // 记录区的起始偏移，slot目录末尾到free_end之间是连续的空闲空间
+    int frag_bytes;     // 删除或缩短记录后留下的空洞的字节数，整理页面后变成连续的空闲空间
+    int in_free_list;   // 保留：旧版本中页面是否在空闲页面链表中
+};
+
+/* 空闲空间表的页面：[page lsn][RmFsmPageHdr][每个数据页面一个字节的档位] */
+struct RmFsmPageHdr {
+    int num_avail;      // 本页中档位不为0的数据页面个数，为0时查找直接跳过本页
+};
+
+/* slot的状态 */
+enum RmSlotFlag : short {
+    RM_SLOT_FREE = 0,       // 空闲
+    RM_SLOT_NORMAL = 1,     // 存放一条记录
+    RM_SLOT_FORWARD = 2,    // 记录更新后变长，本页放不下，移到了其他页面，slot中存放记录新位置的Rid
+    RM_SLOT_MOVED = 3,      // 存放从其他页面移过来的记录，只能通过原来slot的Rid访问，扫描时跳过
+};
+
+/* 变长记录格式的页面中slot目录的一项 */
+struct RmSlot {
+    int offset;     // 记录在页面中的偏移
+    short len;      // 记录编码后的长度
+    short flag;     // RmSlotFlag
+};
+
 /* 表中的记录 */
 struct RmRecord {
-    char* data;  // 记录的数据
-    int size;    // 记录的大小
+    char* data = nullptr;  // 记录的数据
+    int size = 0;          // 记录的大小
     bool allocated_ = false;    // 是否已经为数据分配空间
 
     RmRecord() = default;
@@ -48,21 +95,43 @@ struct RmRecord {
         allocated_ = true;
     };
 
+    // 移动时直接接管other的数据，other不再拥有数据
+    RmRecord(RmRecord&& other) noexcept : data(other.data), size(other.size), allocated_(other.allocated_) {
+        other.data = nullptr;
+        other.allocated_ = false;
+    }
+
+    // 已经分配的空间大小相同时直接覆盖，否则先释放原来的数据，避免泄漏
     RmRecord &operator=(const RmRecord& other) {
+        if (this == &other) return *this;
+        if (!allocated_ || size != other.size) {
+            if (allocated_) delete[] data;
+            data = new char[other.size];
+            allocated_ = true;
+        }
         size = other.size;
-        data = new char[size];
         memcpy(data, other.data, size);
-        allocated_ = true;
         return *this;
     };
 
+    RmRecord &operator=(RmRecord&& other) noexcept {
+        if (this == &other) return *this;
+        if (allocated_) delete[] data;
+        data = other.data;
+        size = other.size;
+        allocated_ = other.allocated_;
+        other.data = nullptr;
+        other.allocated_ = false;
+        return *this;
+    }
+
     RmRecord(int size_) {
         size = size_;
         data = new char[size_];
         allocated_ = true;
     }
 
-    RmRecord(int size_, char* data_) {
+    RmRecord(int size_, const char* data_) {
         size = size_;
         data = new char[size_];
         memcpy(data, data_, size_);
@@ -79,6 +148,7 @@ struct RmRecord {
             delete[] data;
         }
         data = new char[size];
+        allocated_ = true;
         memcpy(data, data_ + sizeof(int), size);
     }
 
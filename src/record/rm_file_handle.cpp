@@ -10,6 +10,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "rm_file_handle.h"
 
+#include <vector>
+
 /**
  * @description: 获取当前表中记录号为rid的记录
  * @param {Rid&} rid 记录号，指定记录的位置
@@ -21,11 +23,36 @@ std::unique_ptr<RmRecord> RmFileHandle::get_record(const Rid& rid, Context* cont
     // 1. 获取指定记录所在的page handle
     // 2. 初始化一个指向RmRecord的指针（赋值其内部的data和size）
     context->lock_mgr_->lock_shared_on_record(context->txn_, rid, fd_);
-    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
-    char* data = page_handle.get_slot(rid.slot_no);
-    RmRecord* record = new RmRecord(page_handle.file_hdr->record_size, data);
+    auto record = std::make_unique<RmRecord>(file_hdr_.record_size);
+    read_record(rid, record->data);
+    return record;
+}
 
-    return std::unique_ptr<RmRecord>(record);
+/**
+ * @description: 把记录号为rid的记录读到rec中，长度为record_size
+ * @note 变长记录格式的记录解码成定长记录；记录被移到其他页面时先释放原来的页面再去读新位置，任何时候只latch一个页面
+ */
+void RmFileHandle::read_record(const Rid& rid, char* rec) const {
+    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    if (!is_slotted()) {
+        memcpy(rec, page_handle.get_slot(rid.slot_no), file_hdr_.record_size);
+        return;
+    }
+    Rid target;
+    {
+        RmSlottedPage page(page_handle);
+        RmSlot* slot = rid.slot_no < page.num_slots() ? page.get_slot(rid.slot_no) : nullptr;
+        if (slot == nullptr || slot->flag != RM_SLOT_FORWARD) {
+            rm_decode_record(&file_hdr_, slot ? page.get_data(slot) : nullptr, slot ? slot->len : 0, rec);
+            return;
+        }
+        memcpy(&target, page.get_data(slot), sizeof(Rid));
+    }
+    page_handle.guard.drop();
+    RmPageHandle target_handle = fetch_page_handle(target.page_no);
+    RmSlottedPage target_page(target_handle);
+    RmSlot* slot = target_page.get_slot(target.slot_no);
+    rm_decode_record(&file_hdr_, target_page.get_data(slot), slot->len, rec);
 }
 
 /**
@@ -40,28 +67,48 @@ Rid RmFileHandle::insert_record(char* buf, Context* context) {
     // 2. 在page handle中找到空闲slot位置
     // 3. 将buf复制到空闲slot位置
     // 4. 更新page_handle.page_hdr中的数据结构
-    // 注意考虑插入一条记录后页面已满的情况，需要更新file_hdr_.first_free_page_no
-    RmPageHandle page_handle = create_page_handle();
+    // 注意考虑插入一条记录后页面已满的情况，需要更新空闲空间表
+    if (is_slotted()) {
+        std::vector<char> data(rm_max_encoded_size(&file_hdr_));
+        int len = rm_encode_record(&file_hdr_, buf, data.data());
+        return insert_slotted(data.data(), len, RM_SLOT_NORMAL, context);
+    }
+    int fsm_bucket;
+    RmPageHandle page_handle = create_page_handle(&fsm_bucket);
     int bitmap_size = page_handle.file_hdr->num_records_per_page;
     char* bitmap = page_handle.bitmap;
     int slot_no = Bitmap::first_bit(0, bitmap, bitmap_size);
     Rid rid = {page_handle.page->get_page_id().page_no, slot_no};
-    if (context->txn_ && !context->lock_mgr_->lock_exclusive_on_record(context->txn_, rid, fd_)) {
-        return {-1, -1};
-    }
+    if (context->txn_ && !context->lock_mgr_->lock_exclusive_on_record(context->txn_, rid, fd_)) return {-1, -1};
     memcpy(page_handle.get_slot(slot_no), buf, file_hdr_.record_size);
 
     Bitmap::set(bitmap, slot_no);
     page_handle.page_hdr->num_records++;
-    if (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page) {
-        if (page_handle.page_hdr->next_free_page_no == -1) {
-            file_hdr_.first_free_page_no = -1;
-        } else {
-            RmPageHdr* page_hdr = page_handle.page_hdr;
-            file_hdr_.first_free_page_no = page_hdr->next_free_page_no;
-        }
-    }
+    update_free_space(page_handle, fsm_bucket);
+    return rid;
+}
 
+/**
+ * @description: 在变长记录格式的表中插入一条编码后的记录，通过空闲空间表找一个放得下最长的记录的页面
+ * @param {RmSlotFlag} flag RM_SLOT_NORMAL是新插入的记录；RM_SLOT_MOVED是更新后从原页面移过来的记录，不加锁，扫描时不可见
+ * @return {Rid} 插入的位置，加锁失败时返回{-1, -1}
+ */
+Rid RmFileHandle::insert_slotted(const char* data, int len, RmSlotFlag flag, Context* context) {
+    int fsm_bucket;
+    RmPageHandle page_handle = create_page_handle(&fsm_bucket);
+    RmSlottedPage page(page_handle);
+    int slot_no = page.find_free_slot();
+    Rid rid = {page_handle.page->get_page_id().page_no, slot_no};
+    if (flag == RM_SLOT_NORMAL && context->txn_ &&
+        !context->lock_mgr_->lock_exclusive_on_record(context->txn_, rid, fd_)) {
+        return {-1, -1};
+    }
+    page.put(slot_no, data, len, flag);
+    if (flag == RM_SLOT_NORMAL) {
+        Bitmap::set(page_handle.bitmap, slot_no);
+        page_handle.page_hdr->num_records++;
+    }
+    update_free_space(page_handle, fsm_bucket);
     return rid;
 }
 
@@ -71,10 +118,21 @@ Rid RmFileHandle::insert_record(char* buf, Context* context) {
  * @param {char*} buf 要插入记录的数据
  */
 void RmFileHandle::insert_record(const Rid& rid, char* buf) {
-    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    RmPageHandle page_handle = fetch_write_page_handle(rid.page_no);
+    int old_bucket = free_space_bucket(page_handle);
     char* bitmap = page_handle.bitmap;
+    if (is_slotted()) {
+        std::vector<char> data(rm_max_encoded_size(&file_hdr_));
+        int len = rm_encode_record(&file_hdr_, buf, data.data());
+        if (!RmSlottedPage(page_handle).put(rid.slot_no, data.data(), len, RM_SLOT_NORMAL)) {
+            throw InternalError("RmFileHandle::insert_record: no room for the record in page " +
+                                std::to_string(rid.page_no));
+        }
+    }
+    if (!Bitmap::is_set(bitmap, rid.slot_no)) page_handle.page_hdr->num_records++;
     Bitmap::set(bitmap, rid.slot_no);
-    memcpy(page_handle.get_slot(rid.slot_no), buf, page_handle.file_hdr->record_size);
+    if (!is_slotted()) memcpy(page_handle.get_slot(rid.slot_no), buf, page_handle.file_hdr->record_size);
+    update_free_space(page_handle, old_bucket);
 }
 
 /**
@@ -86,15 +144,40 @@ bool RmFileHandle::delete_record(const Rid& rid, Context* context) {
     // Todo:
     // 1. 获取指定记录所在的page handle
     // 2. 更新page_handle.page_hdr中的数据结构
-    // 注意考虑删除一条记录后页面未满的情况，需要调用release_page_handle()
+    // 注意考虑删除一条记录后页面未满的情况，需要调用update_free_space()
     if (!context->lock_mgr_->lock_exclusive_on_record(context->txn_, rid, fd_)) return false;
-    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    RmPageHandle page_handle = fetch_write_page_handle(rid.page_no);
+    int old_bucket = free_space_bucket(page_handle);
     char* bitmap = page_handle.bitmap;
     Bitmap::reset(bitmap, rid.slot_no);
-    release_page_handle(page_handle);
+    if (!is_slotted()) {
+        page_handle.page_hdr->num_records--;
+        update_free_space(page_handle, old_bucket);
+        return true;
+    }
+    // 被移到其他页面的记录也要删除，释放原来的页面之后再去latch记录所在的页面
+    RmSlottedPage page(page_handle);
+    RmSlot* slot = page.get_slot(rid.slot_no);
+    Rid target = {RM_NO_PAGE, -1};
+    if (slot->flag == RM_SLOT_FORWARD) memcpy(&target, page.get_data(slot), sizeof(Rid));
+    page.erase(rid.slot_no);
+    page_handle.page_hdr->num_records--;
+    update_free_space(page_handle, old_bucket);
+    page_handle.guard.drop();
+    if (target.page_no != RM_NO_PAGE) erase_moved(target);
     return true;
 }
 
+/**
+ * @description: 删除更新时从其他页面移过来的记录
+ */
+void RmFileHandle::erase_moved(const Rid& rid) {
+    RmPageHandle page_handle = fetch_write_page_handle(rid.page_no);
+    int old_bucket = free_space_bucket(page_handle);
+    RmSlottedPage(page_handle).erase(rid.slot_no);
+    update_free_space(page_handle, old_bucket);
+}
+
 /**
  * @description: 更新记录文件中记录号为rid的记录
  * @param {Rid&} rid 要更新的记录的记录号（位置）
@@ -106,27 +189,79 @@ bool RmFileHandle::update_record(const Rid& rid, char* buf, Context* context) {
     // 1. 获取指定记录所在的page handle
     // 2. 更新记录
     if (!context->lock_mgr_->lock_exclusive_on_record(context->txn_, rid, fd_)) return false;
-    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    if (is_slotted()) return update_slotted(rid, buf);
+    RmPageHandle page_handle = fetch_write_page_handle(rid.page_no);
     memcpy(page_handle.get_slot(rid.slot_no), buf, page_handle.file_hdr->record_size);
     return true;
 }
 
+/**
+ * @description: 更新变长记录格式的表中的记录。原来的页面放得下新记录时在页面内更新(必要时整理页面)，
+ * 否则把记录移到其他页面，原来的slot改为存放新位置的转发slot，记录号保持不变，索引不需要修改
+ * @note 转发只有一层：再次更新时先尝试放回原来的页面，再尝试原地更新移过去的记录，都放不下时重新找页面
+ */
+bool RmFileHandle::update_slotted(const Rid& rid, char* buf) {
+    std::vector<char> data(rm_max_encoded_size(&file_hdr_));
+    int len = rm_encode_record(&file_hdr_, buf, data.data());
+    Rid target = {RM_NO_PAGE, -1};
+    {
+        RmPageHandle page_handle = fetch_write_page_handle(rid.page_no);
+        int old_bucket = free_space_bucket(page_handle);
+        RmSlottedPage page(page_handle);
+        RmSlot* slot = page.get_slot(rid.slot_no);
+        if (slot->flag == RM_SLOT_FORWARD) memcpy(&target, page.get_data(slot), sizeof(Rid));
+        if (page.put(rid.slot_no, data.data(), len, RM_SLOT_NORMAL)) {
+            update_free_space(page_handle, old_bucket);
+            page_handle.guard.drop();
+            if (target.page_no != RM_NO_PAGE) erase_moved(target);
+            return true;
+        }
+    }
+    if (target.page_no != RM_NO_PAGE) {
+        RmPageHandle page_handle = fetch_write_page_handle(target.page_no);
+        int old_bucket = free_space_bucket(page_handle);
+        RmSlottedPage page(page_handle);
+        bool moved = page.put(target.slot_no, data.data(), len, RM_SLOT_MOVED);
+        if (!moved) page.erase(target.slot_no);
+        update_free_space(page_handle, old_bucket);
+        if (moved) return true;
+    }
+    target = insert_slotted(data.data(), len, RM_SLOT_MOVED, nullptr);
+    // 每条记录至少占sizeof(Rid)字节，转发的Rid总能原地写入
+    RmPageHandle page_handle = fetch_write_page_handle(rid.page_no);
+    int old_bucket = free_space_bucket(page_handle);
+    RmSlottedPage(page_handle).put(rid.slot_no, reinterpret_cast<const char*>(&target), sizeof(Rid), RM_SLOT_FORWARD);
+    update_free_space(page_handle, old_bucket);
+    return true;
+}
+
 /**
  * 以下函数为辅助函数，仅提供参考，可以选择完成如下函数，也可以删除如下函数，在单元测试中不涉及如下函数接口的直接调用
  */
 /**
- * @description: 获取指定页面的页面句柄
+ * @description: 获取指定页面的只读页面句柄
  * @param {int} page_no 页面号
- * @return {RmPageHandle} 指定页面的句柄
+ * @param {BufferAccessStrategy*} strategy 缓冲池访问策略, 为nullptr时使用整个缓冲池
+ * @return {RmPageHandle} 指定页面的句柄，句柄析构时unpin页面
  */
-RmPageHandle RmFileHandle::fetch_page_handle(int page_no) const {
+RmPageHandle RmFileHandle::fetch_page_handle(int page_no, BufferAccessStrategy *strategy) const {
     // Todo:
     // 使用缓冲池获取指定页面，并生成page_handle返回给上层
     // if page_no is invalid, throw PageNotExistError exception
     PageId page_id = {fd_, page_no};
     if (page_no == INVALID_PAGE_ID) throw PageNotExistError("DBMS", page_no);
-    Page* page = buffer_pool_manager_->fetch_page(page_id);
-    return RmPageHandle(&file_hdr_, page);
+    return RmPageHandle(&file_hdr_, buffer_pool_manager_->fetch_page_read(page_id, strategy));
+}
+
+/**
+ * @description: 获取指定页面的可写页面句柄
+ * @param {int} page_no 页面号
+ * @return {RmPageHandle} 指定页面的句柄，句柄析构时unpin页面并将其标记为脏页
+ */
+RmPageHandle RmFileHandle::fetch_write_page_handle(int page_no) const {
+    PageId page_id = {fd_, page_no};
+    if (page_no == INVALID_PAGE_ID) throw PageNotExistError("DBMS", page_no);
+    return RmPageHandle(&file_hdr_, buffer_pool_manager_->fetch_page_write(page_id));
 }
 
 /**
@@ -139,42 +274,80 @@ RmPageHandle RmFileHandle::create_new_page_handle() {
     // 2.更新page handle中的相关信息
     // 3.更新file_hdr_
     PageId page_id = {.fd = fd_, .page_no = INVALID_PAGE_ID};
-    Page* page = buffer_pool_manager_->new_page(&page_id);
-    file_hdr_.num_pages++;
-    file_hdr_.first_free_page_no = page_id.page_no;
-    char* data = page->get_data();
+    WritePageGuard guard = buffer_pool_manager_->new_page_guarded(&page_id);
+    // 新页面可能复用了文件中已释放的页面，num_pages是文件中页面个数的上界
+    {
+        std::scoped_lock lock{num_pages_latch_};
+        file_hdr_.num_pages = std::max(file_hdr_.num_pages, page_id.page_no + 1);
+    }
+    char* data = guard.get_data();
     *((int*)data) = -1;
-    return RmPageHandle(&file_hdr_, page);
+    RmPageHandle page_handle(&file_hdr_, std::move(guard));
+    page_handle.page_hdr->next_free_page_no = RM_NO_PAGE;
+    if (is_slotted()) RmSlottedPage(page_handle).init();
+    return page_handle;
 }
 
 /**
  * @brief 创建或获取一个空闲的page handle
+ * 从空闲空间表中找一个有空闲空间的页面，latch之后确认页面确实有空间，档位过时时改正档位再找下一个；
+ * 空闲空间表中没有这样的页面时创建新页面
  *
- * @return RmPageHandle 返回生成的空闲page handle
- * @note pin the page, remember to unpin it outside!
+ * @param fsm_bucket 返回空闲空间表中页面的档位，插入后用来判断是否需要更新空闲空间表；新页面返回-1
+ * @return RmPageHandle 返回生成的空闲page handle，句柄析构时unpin页面并将其标记为脏页
  */
-RmPageHandle RmFileHandle::create_page_handle() {
-    // Todo:
-    // 1. 判断file_hdr_中是否还有空闲页
-    //     1.1 没有空闲页：使用缓冲池来创建一个新page；可直接调用create_new_page_handle()
-    //     1.2 有空闲页：直接获取第一个空闲页
-    // 2. 生成page handle并返回给上层
-    Page* page = nullptr;
-    if (file_hdr_.first_free_page_no != -1) {
-        PageId page_id = {.fd = fd_, .page_no = file_hdr_.first_free_page_no};
-        page = buffer_pool_manager_->fetch_page(page_id);
-        return RmPageHandle(&file_hdr_, page);
+RmPageHandle RmFileHandle::create_page_handle(int* fsm_bucket) {
+    int page_no;
+    while ((page_no = fsm_->find(file_hdr_.num_pages, fsm_bucket)) != RM_NO_PAGE) {
+        RmPageHandle page_handle = fetch_write_page_handle(page_no);
+        if (free_space_bucket(page_handle) > 0) return page_handle;
+        // 页面在查找之后被其他线程插满了
+        fsm_->set(page_no, 0);
     }
+    // 新页面可能复用了已回收的页面，无论空闲空间表中原来是什么档位都要更新
+    *fsm_bucket = -1;
     return create_new_page_handle();
 }
 
 bool RmFileHandle::getRecord(char* buf, const Rid& rid, Context* context, int len, bool is_read) {
     if (is_read && !context->lock_mgr_->lock_shared_on_record(context->txn_, rid, fd_)) return false;
+    if (is_slotted()) {
+        std::vector<char> rec(file_hdr_.record_size);
+        read_record(rid, rec.data());
+        memcpy(buf, rec.data(), std::min(len, file_hdr_.record_size));
+        return true;
+    }
     auto page_handle = fetch_page_handle(rid.page_no);
     memcpy(buf, page_handle.get_slot(rid.slot_no), len);
     return true;
 }
 
+/**
+ * @description: 获取记录号为rid的记录的只读视图，is_read为true时先对记录加共享锁
+ * @return {bool} 加锁失败时返回false，ref不变
+ */
+bool RmFileHandle::get_record_ref(RecordRef* ref, const Rid& rid, Context* context, bool is_read) const {
+    if (is_read && !context->lock_mgr_->lock_shared_on_record(context->txn_, rid, fd_)) return false;
+    *ref = get_record_ref(rid);
+    return true;
+}
+
+/**
+ * @description: 获取记录号为rid的记录的只读视图，不加锁
+ * @note 定长记录格式的视图直接指向页面中的记录并持有页面的读latch；变长记录格式的视图拥有解码后的副本，
+ *       每次调用都要分配内存并解码整条记录，扫描整张表时用RmScan::next_batch按页批量取出
+ */
+RecordRef RmFileHandle::get_record_ref(const Rid& rid) const {
+    if (is_slotted()) {
+        std::vector<char> rec(file_hdr_.record_size);
+        read_record(rid, rec.data());
+        return RecordRef(std::move(rec));
+    }
+    RmPageHandle page_handle = fetch_page_handle(rid.page_no);
+    const char* data = page_handle.get_slot(rid.slot_no);
+    return RecordRef(std::move(page_handle.guard), data, file_hdr_.record_size);
+}
+
 bool RmFileHandle::checkGapLock(std::vector<ColMeta>& cols, std::vector<Value>& values, Context* context) {
     auto& gap_lock = context->lock_mgr_->gap_lock[fd_];
     for (size_t i = 0; i < values.size(); i++) {
@@ -206,19 +379,73 @@ bool RmFileHandle::checkVal(Range& rg, Value& val) {
 }
 
 /**
- * @description: 当一个页面从没有空闲空间的状态变为有空闲空间状态时，更新文件头和页头中空闲页面相关的元数据
+ * @description: 计算页面在空闲空间表中的档位：放不下一条最长的记录时为0，否则按空闲空间占页面的比例落在1到RM_FSM_BUCKETS-1
+ * @note 定长记录格式按bitmap统计空闲slot，不依赖页头中的num_records
  */
-void RmFileHandle::release_page_handle(RmPageHandle& page_handle) {
-    // Todo:
-    // 当page从已满变成未满，考虑如何更新：
-    // 1. page_handle.page_hdr->next_free_page_no
-    // 2. file_hdr_.first_free_page_no
-    page_handle.page_hdr->num_records--;
-    page_id_t page_no = page_handle.page->get_page_id().page_no;
-    if (file_hdr_.first_free_page_no != -1) {
-        RmPageHandle free_page_handle = fetch_page_handle(file_hdr_.first_free_page_no);
-        free_page_handle.page_hdr->next_free_page_no = page_no;
+int RmFileHandle::free_space_bucket(const RmPageHandle& page_handle) const {
+    int free, total;
+    if (is_slotted()) {
+        RmSlottedPage page(page_handle);
+        if (!page.has_room(rm_max_encoded_size(&file_hdr_))) return 0;
+        free = page.free_space();
+        total = page.capacity();
+    } else {
+        total = file_hdr_.num_records_per_page;
+        free = total - Bitmap::count(page_handle.bitmap, total);
+        if (free == 0) return 0;
+    }
+    return std::min(RM_FSM_BUCKETS - 1, 1 + (free - 1) * (RM_FSM_BUCKETS - 1) / total);
+}
+
+/**
+ * @description: 页面中的空间变化后更新空闲空间表，档位不变时不访问空闲空间表，大部分插入和删除只latch记录所在的页面
+ * @param {int} old_bucket 修改前页面的档位
+ * @note 调用时持有页面的写latch，同一个页面的档位按页面latch的顺序更新
+ */
+void RmFileHandle::update_free_space(const RmPageHandle& page_handle, int old_bucket) {
+    int bucket = free_space_bucket(page_handle);
+    if (bucket != old_bucket) fsm_->set(page_handle.page->get_page_id().page_no, bucket);
+}
+
+/**
+ * @description: 重新统计所有页面的记录个数和档位，重建空闲空间表，已回收的页面档位为0
+ * @param {bool} compact_pages 是否同时整理变长记录格式的页面，回收删除和缩短记录留下的空洞
+ * @note 用于整理表和打开没有空闲空间表的旧表，调用者需要保证没有并发的插入和删除
+ */
+void RmFileHandle::rebuild_free_space_map(bool compact_pages) {
+    int num_slots = file_hdr_.num_records_per_page;
+    std::vector<uint8_t> buckets(file_hdr_.num_pages, 0);
+    for (int page_no = RM_FIRST_RECORD_PAGE; page_no < file_hdr_.num_pages; page_no++) {
+        if (disk_manager_->is_free_page(fd_, page_no)) continue;
+        RmPageHandle page_handle = fetch_write_page_handle(page_no);
+        page_handle.page_hdr->num_records = Bitmap::count(page_handle.bitmap, num_slots);
+        if (compact_pages && is_slotted()) RmSlottedPage(page_handle).compact();
+        buckets[page_no] = free_space_bucket(page_handle);
+    }
+    fsm_->load(buckets);
+}
+
+/**
+ * @description: 回收表中不含记录的页面，截断文件末尾的空闲页面，并按剩余页面重建空闲空间表
+ * @return {int} 截断后文件中的页面个数
+ * @note 调用者需要持有表上的排他锁：被回收的页面可能被其他页面复用，不能再有事务通过回滚把记录写回这些页面
+ */
+int RmFileHandle::compact() {
+    int num_slots = file_hdr_.num_records_per_page;
+    for (int page_no = RM_FIRST_RECORD_PAGE; page_no < file_hdr_.num_pages; page_no++) {
+        if (disk_manager_->is_free_page(fd_, page_no)) continue;
+        RmPageHandle page_handle = fetch_page_handle(page_no);
+        PageId page_id = page_handle.page->get_page_id();
+        bool empty = is_slotted() ? RmSlottedPage(page_handle).empty()
+                                  : Bitmap::first_bit(true, page_handle.bitmap, num_slots) == num_slots;
+        page_handle.guard.drop();
+        // 仍被固定的页面无法从缓冲池删除，留到下次回收
+        if (empty && buffer_pool_manager_->delete_page(page_id)) disk_manager_->deallocate_page(fd_, page_no);
     }
+    file_hdr_.num_pages = disk_manager_->truncate_free_pages(fd_);
+    // 已回收的页面在空闲空间表中的档位清0，变长记录格式的页面顺便整理页面
+    rebuild_free_space_map(true);
+    return file_hdr_.num_pages;
 }
 int RmFileHandle::checkStr(std::string str1, std::string str2) {
     auto len = std::min(str1.size(), str2.size());
@@ -14,26 +14,31 @@ See the Mulan PSL v2 for more details. */
 #include <error.h>
 
 #include <memory>
+#include <mutex>
 
 #include "bitmap.h"
 #include "common/common.h"
 #include "common/context.h"
 #include "rm_defs.h"
+#include "rm_free_space_map.h"
+#include "rm_slotted_page.h"
 #include "system/sm_meta.h"
 
 class RmManager;
 
-/* 对表数据文件中的页面进行封装 */
+/* 对表数据文件中的页面进行封装，句柄持有页面的pin和读/写latch，析构时自动释放，因此只能移动不能复制 */
 struct RmPageHandle {
     const RmFileHdr *file_hdr;  // 当前页面所在文件的文件头指针
+    PageGuard guard;            // 页面的守卫，写句柄unpin时将页面标记为脏页
     Page *page;                 // 页面的实际数据，包括页面存储的数据、元信息等
     RmPageHdr *page_hdr;        // page->data的第一部分，存储页面元信息，指针指向首地址，长度为sizeof(RmPageHdr)
     char *bitmap;               // page->data的第二部分，存储页面的bitmap，指针指向首地址，长度为file_hdr->bitmap_size
-    char *slots;                // page->data的第三部分，存储表的记录，指针指向首地址，每个slot的长度为file_hdr->record_size
+    char *slots;                // page->data的第三部分，存储表的记录，指针指向首地址，每个slot的长度为file_hdr->record_size；
+                                // 变长记录格式中是RmSlottedPageHdr和slot目录的首地址，见RmSlottedPage
 
-    RmPageHandle(const RmFileHdr *fhdr_, Page *page_) : file_hdr(fhdr_), page(page_) {
+    RmPageHandle(const RmFileHdr *fhdr_, PageGuard guard_)
+        : file_hdr(fhdr_), guard(std::move(guard_)), page(guard.get_page()) {
         page_hdr = reinterpret_cast<RmPageHdr *>(page->get_data() + page->OFFSET_PAGE_HDR);
-        page_hdr->next_free_page_no = -1;
         bitmap = page->get_data() + sizeof(RmPageHdr) + page->OFFSET_PAGE_HDR;
         slots = bitmap + file_hdr->bitmap_size;
     }
@@ -44,6 +49,57 @@ struct RmPageHandle {
     }
 };
 
+/**
+ * 记录的只读视图，用于扫描、谓词求值和提取索引键，避免逐行分配内存和复制
+ * 定长记录格式中直接指向缓冲池页面中的记录，视图持有页面的pin和读latch，析构时释放，因此只能移动不能复制；
+ * 变长记录格式的记录需要解码，视图拥有一份解码后的副本，不占用页面，每次获取都要分配内存并复制整条记录，
+ * 因此只适合按rid零散地取记录(如索引扫描)，顺序扫描整张表应使用RmScan::next_batch
+ * @note 视图存在期间当前线程不能再对同一页面加写latch，需要修改记录或长期保存时用to_record()复制出来
+ */
+class RecordRef {
+   public:
+    RecordRef() = default;
+
+    RecordRef(PageGuard guard, const char *data, int size) : guard_(std::move(guard)), data_(data), size_(size) {}
+
+    explicit RecordRef(std::vector<char> copy)
+        : copy_(std::move(copy)), data_(copy_.data()), size_(static_cast<int>(copy_.size())) {}
+
+    RecordRef(RecordRef &&other) noexcept { *this = std::move(other); }
+
+    RecordRef &operator=(RecordRef &&other) noexcept {
+        if (this == &other) return *this;
+        guard_ = std::move(other.guard_);
+        copy_ = std::move(other.copy_);
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        return *this;
+    }
+
+    const char *data() const { return data_; }
+
+    int size() const { return size_; }
+
+    // 物化：把记录复制到新的RmRecord中
+    std::unique_ptr<RmRecord> to_record() const { return std::make_unique<RmRecord>(size_, data_); }
+
+    // 提前释放视图占用的页面
+    void reset() {
+        guard_.drop();
+        copy_.clear();
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+   private:
+    PageGuard guard_;
+    std::vector<char> copy_;
+    const char *data_ = nullptr;
+    int size_ = 0;
+};
+
 /* 每个RmFileHandle对应一个表的数据文件，里面有多个page，每个page的数据封装在RmPageHandle中 */
 class RmFileHandle {      
     friend class RmScan;    
@@ -54,21 +110,31 @@ class RmFileHandle {
     BufferPoolManager *buffer_pool_manager_;
     int fd_;        // 打开文件后产生的文件句柄
     RmFileHdr file_hdr_;    // 文件头，维护当前表文件的元数据
+    std::unique_ptr<RmFreeSpaceMap> fsm_;   // 空闲空间表，插入时用来找有空闲空间的页面
+    std::mutex num_pages_latch_;            // 并发插入同时创建新页面时保护file_hdr_.num_pages
 
    public:
-    RmFileHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd)
+    RmFileHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd, int fsm_fd)
         : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), fd_(fd) {
         // 注意：这里从磁盘中读出文件描述符为fd的文件的file_hdr，读到内存中
         // 这里实际就是初始化file_hdr，只不过是从磁盘中读出进行初始化
         // init file_hdr_
         disk_manager_->read_page(fd, RM_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_));
+        // 第0页总是从文件开头读取，读到文件头后才能确定其余页面的位置
+        if (file_hdr_.page_size == 0) file_hdr_.page_size = PAGE_SIZE;
+        disk_manager_->set_page_size(fd, file_hdr_.page_size);
         // disk_manager管理的fd对应的文件中，设置从file_hdr_.num_pages开始分配page_no
         disk_manager_->set_fd2pageno(fd, file_hdr_.num_pages);
+        fsm_ = std::make_unique<RmFreeSpaceMap>(disk_manager, buffer_pool_manager, fsm_fd, file_hdr_.page_size);
     }
 
     RmFileHdr get_file_hdr() { return file_hdr_; }
     int GetFd() { return fd_; }
 
+    RmFreeSpaceMap *get_free_space_map() const { return fsm_.get(); }
+
+    bool is_slotted() const { return file_hdr_.format == RM_FORMAT_SLOTTED; }
+
     /* 判断指定位置上是否已经存在一条记录，通过Bitmap来判断 */
     bool is_record(const Rid &rid) const {
         RmPageHandle page_handle = fetch_page_handle(rid.page_no);
@@ -87,15 +153,35 @@ class RmFileHandle {
 
     RmPageHandle create_new_page_handle();
 
-    RmPageHandle fetch_page_handle(int page_no) const;
+    RmPageHandle fetch_page_handle(int page_no, BufferAccessStrategy *strategy = nullptr) const;
+
+    RmPageHandle fetch_write_page_handle(int page_no) const;
 
     bool getRecord(char *buf, const Rid &rid, Context *context, int len, bool is_read);
 
+    bool get_record_ref(RecordRef *ref, const Rid &rid, Context *context, bool is_read) const;
+
+    RecordRef get_record_ref(const Rid &rid) const;
+
     bool checkGapLock(std::vector<ColMeta>& cols, std::vector<Value>& values, Context *context);
+
+    int compact();
    private:
     bool checkVal(Range& rg, Value& val);
-    RmPageHandle create_page_handle();
+    RmPageHandle create_page_handle(int *fsm_bucket);
+
+    void read_record(const Rid &rid, char *rec) const;
+
+    Rid insert_slotted(const char *data, int len, RmSlotFlag flag, Context *context);
+
+    bool update_slotted(const Rid &rid, char *buf);
+
+    void erase_moved(const Rid &rid);
+
+    int free_space_bucket(const RmPageHandle &page_handle) const;
+
+    void update_free_space(const RmPageHandle &page_handle, int old_bucket);
 
-    void release_page_handle(RmPageHandle &page_handle);
+    void rebuild_free_space_map(bool compact_pages);
     int checkStr(std::string basicString, std::string basicString1);
 };
\ No newline at end of file
@@ -0,0 +1,113 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "rm_free_space_map.h"
+
+#include <algorithm>
+
+namespace {
+
+// 当前线程的编号，插入时据此在候选页面中选择，不同线程落在不同页面上
+int thread_slot() {
+    static std::atomic<int> next_slot{0};
+    thread_local int slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+}  // namespace
+
+RmFreeSpaceMap::RmFreeSpaceMap(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd,
+                               int page_size)
+    : buffer_pool_manager_(buffer_pool_manager),
+      fd_(fd),
+      entries_per_page_(page_size - static_cast<int>(Page::OFFSET_PAGE_HDR + sizeof(RmFsmPageHdr))) {
+    disk_manager->set_page_size(fd, page_size);
+}
+
+/**
+ * @description: 获取数据页面page_no的档位
+ */
+int RmFreeSpaceMap::get(int page_no) const {
+    ReadPageGuard guard = buffer_pool_manager_->fetch_page_read({fd_, page_no / entries_per_page_});
+    return get_entries(guard.get_page()->get_data())[page_no % entries_per_page_];
+}
+
+/**
+ * @description: 设置数据页面page_no的档位，同时维护FSM页面中档位不为0的页面个数
+ */
+void RmFreeSpaceMap::set(int page_no, int bucket) {
+    WritePageGuard guard = buffer_pool_manager_->fetch_page_write({fd_, page_no / entries_per_page_});
+    char *data = guard.get_data();
+    uint8_t &entry = get_entries(data)[page_no % entries_per_page_];
+    get_hdr(data)->num_avail += (bucket != 0) - (entry != 0);
+    entry = static_cast<uint8_t>(bucket);
+}
+
+/**
+ * @description: 在前num_pages个数据页面中找一个有空闲空间的页面。从上次找到的页面开始往后找，到末尾后回到开头，
+ * 最多收集RM_FSM_SPREAD个档位不为0的页面，按当前线程的编号选择其中一个，使并发的插入分散到不同页面
+ * @param {int*} bucket 返回找到的页面的档位
+ * @return {int} 找到的页面号，没有时返回RM_NO_PAGE
+ */
+int RmFreeSpaceMap::find(int num_pages, int *bucket) {
+    int num_fsm_pages = (num_pages + entries_per_page_ - 1) / entries_per_page_;
+    if (num_fsm_pages == 0) return RM_NO_PAGE;
+    int start = next_page_no_.load(std::memory_order_relaxed);
+    if (start >= num_pages) start = 0;
+    int candidates[RM_FSM_SPREAD];
+    uint8_t buckets[RM_FSM_SPREAD];
+    int n = 0;
+    // 第一轮从start所在的FSM页面的start处开始，最后一轮回到这个FSM页面，查找start之前的部分
+    for (int i = 0; i <= num_fsm_pages && n < RM_FSM_SPREAD; i++) {
+        int fsm_page_no = (start / entries_per_page_ + i) % num_fsm_pages;
+        ReadPageGuard guard = buffer_pool_manager_->fetch_page_read({fd_, fsm_page_no});
+        char *data = guard.get_page()->get_data();
+        if (get_hdr(data)->num_avail == 0) continue;
+        const uint8_t *entries = get_entries(data);
+        int base = fsm_page_no * entries_per_page_;
+        int begin = i == 0 ? start - base : 0;
+        int end = std::min(entries_per_page_, num_pages - base);
+        if (i == num_fsm_pages) end = std::min(end, start - base);
+        for (int j = begin; j < end && n < RM_FSM_SPREAD; j++) {
+            // 整8个字节都是0时一起跳过
+            uint64_t word;
+            if (j + 8 <= end && (memcpy(&word, entries + j, sizeof(word)), word == 0)) {
+                j += 7;
+                continue;
+            }
+            if (entries[j] == 0) continue;
+            candidates[n] = base + j;
+            buckets[n++] = entries[j];
+        }
+    }
+    if (n == 0) return RM_NO_PAGE;
+    next_page_no_.store(candidates[0], std::memory_order_relaxed);
+    int k = thread_slot() % n;
+    *bucket = buckets[k];
+    return candidates[k];
+}
+
+/**
+ * @description: 用buckets重建前buckets.size()个数据页面的档位，覆盖到的FSM页面中其余的档位清0
+ * @note 用于打开没有FSM的旧表和整理表，调用者需要保证没有并发的插入和删除
+ */
+void RmFreeSpaceMap::load(const std::vector<uint8_t> &buckets) {
+    int num_pages = static_cast<int>(buckets.size());
+    for (int base = 0; base < num_pages; base += entries_per_page_) {
+        WritePageGuard guard = buffer_pool_manager_->fetch_page_write({fd_, base / entries_per_page_});
+        char *data = guard.get_data();
+        uint8_t *entries = get_entries(data);
+        int n = std::min(entries_per_page_, num_pages - base);
+        memcpy(entries, buckets.data() + base, n);
+        memset(entries + n, 0, entries_per_page_ - n);
+        get_hdr(data)->num_avail = static_cast<int>(n - std::count(entries, entries + n, 0));
+    }
+    next_page_no_.store(0, std::memory_order_relaxed);
+}
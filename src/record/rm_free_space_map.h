@@ -0,0 +1,53 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "rm_defs.h"
+
+/**
+ * 表的空闲空间表(FSM)，存放在单独的文件<表名>+FREE_SPACE_MAP_SUFFIX中，通过缓冲池访问
+ * 每个数据页面对应一个字节的档位，表示页面的空闲空间，见RM_FSM_BUCKETS；第i个FSM页面存放第i*E到(i+1)*E-1个数据页面的档位，
+ * E为entries_per_page()。文件末尾之后的页面读出来是全0，即页面没有空闲空间，因此FSM页面不需要分配
+ * 档位只是提示：插入时在数据页面上确认有空间，不一致时改正档位，因此FSM页面不写日志
+ * @note 加latch的顺序是先数据页面后FSM页面，持有FSM页面的latch时不会再去latch数据页面
+ */
+class RmFreeSpaceMap {
+   public:
+    RmFreeSpaceMap(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd, int page_size);
+
+    int get_fd() const { return fd_; }
+
+    int entries_per_page() const { return entries_per_page_; }
+
+    int get(int page_no) const;
+
+    void set(int page_no, int bucket);
+
+    int find(int num_pages, int *bucket);
+
+    void load(const std::vector<uint8_t> &buckets);
+
+   private:
+    BufferPoolManager *buffer_pool_manager_;
+    int fd_;
+    int entries_per_page_;
+    std::atomic<int> next_page_no_{0};  // 上次找到的数据页面，下次从这里开始找，不需要每次从文件开头扫描
+
+    static uint8_t *get_entries(char *data) { return reinterpret_cast<uint8_t *>(get_hdr(data) + 1); }
+
+    static RmFsmPageHdr *get_hdr(char *data) {
+        return reinterpret_cast<RmFsmPageHdr *>(data + Page::OFFSET_PAGE_HDR);
+    }
+};
@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #include "bitmap.h"
 #include "rm_defs.h"
 #include "rm_file_handle.h"
+#include "rm_slotted_page.h"
 
 /* 记录管理器，用于管理表的数据文件，进行文件的创建、打开、删除、关闭 */
 class RmManager {
@@ -30,11 +31,17 @@ class RmManager {
      * @description: 创建表的数据文件并初始化相关信息
      * @param {string&} filename 要创建的文件名称
      * @param {int} record_size 表中记录的大小
+     * @param {int} page_size 文件的页面大小，PAGE_SIZE到MAX_PAGE_SIZE之间的2的幂
+     * @param {RmRecordFormat} format 记录格式
+     * @param {vector<RmVarField>&} var_fields 变长记录格式中按实际长度存储的字段，按offset从小到大排列，
+     * 超过RM_MAX_VAR_FIELDS个时其余的字段按定长存储
      */
-    int create_file(const std::string& filename, int record_size) {
+    int create_file(const std::string& filename, int record_size, int page_size = PAGE_SIZE,
+                    RmRecordFormat format = RM_FORMAT_FIXED, const std::vector<RmVarField>& var_fields = {}) {
         if (record_size < 1 || record_size > RM_MAX_RECORD_SIZE) {
             throw InvalidRecordSizeError(record_size);
         }
+        assert(is_valid_page_size(page_size));
         disk_manager_->create_file(filename);
         int fd = disk_manager_->open_file(filename);
 
@@ -43,10 +50,26 @@ class RmManager {
         file_hdr.record_size = record_size;
         file_hdr.num_pages = 1;
         file_hdr.first_free_page_no = RM_NO_PAGE;
-        // We have: sizeof(hdr) + (n + 7) / 8 + n * record_size <= PAGE_SIZE
-        file_hdr.num_records_per_page =
-            (BITMAP_WIDTH * (PAGE_SIZE - 1 - (int)sizeof(RmFileHdr)) + 1) / (1 + record_size * BITMAP_WIDTH);
-        file_hdr.bitmap_size = (file_hdr.num_records_per_page + BITMAP_WIDTH - 1) / BITMAP_WIDTH;
+        file_hdr.page_size = page_size;
+        file_hdr.format = format;
+        int page_hdr_size = Page::OFFSET_PAGE_HDR + sizeof(RmPageHdr);
+        if (format == RM_FORMAT_FIXED) {
+            // We have: page_hdr_size + (n + 7) / 8 + n * record_size <= page_size
+            file_hdr.num_records_per_page =
+                (BITMAP_WIDTH * (page_size - 1 - page_hdr_size) + 1) / (1 + record_size * BITMAP_WIDTH);
+            file_hdr.bitmap_size = (file_hdr.num_records_per_page + BITMAP_WIDTH - 1) / BITMAP_WIDTH;
+        } else {
+            file_hdr.num_var_fields = std::min(static_cast<int>(var_fields.size()), RM_MAX_VAR_FIELDS);
+            std::copy_n(var_fields.begin(), file_hdr.num_var_fields, file_hdr.var_fields);
+            // 每条记录至少占一个slot和sizeof(Rid)字节，slot目录按所有记录都取最短长度时的个数分配
+            // bitmap补齐到4字节，使之后的RmSlottedPageHdr和slot目录对齐
+            int min_space = std::max(rm_min_encoded_size(&file_hdr), static_cast<int>(sizeof(Rid)));
+            int avail = page_size - page_hdr_size - static_cast<int>(sizeof(RmSlottedPageHdr)) - 3;
+            file_hdr.num_records_per_page =
+                BITMAP_WIDTH * avail / (1 + (min_space + static_cast<int>(sizeof(RmSlot))) * BITMAP_WIDTH);
+            file_hdr.bitmap_size = (file_hdr.num_records_per_page + BITMAP_WIDTH - 1) / BITMAP_WIDTH;
+            file_hdr.bitmap_size = (file_hdr.bitmap_size + 3) / 4 * 4;
+        }
 
         // 将file header写入磁盘文件（名为file name，文件描述符为fd）中的第0页
         // head page直接写入磁盘，没有经过缓冲区的NewPage，那么也就不需要FlushPage
@@ -57,20 +80,35 @@ class RmManager {
     }
 
     /**
-     * @description: 删除表的数据文件
+     * @description: 删除表的数据文件和空闲空间表
      * @param {string&} filename 要删除的文件名称
      */    
-    int destroy_file(const std::string& filename) { return disk_manager_->destroy_file(filename); }
+    int destroy_file(const std::string& filename) {
+        std::string fsm_name = filename + FREE_SPACE_MAP_SUFFIX;
+        if (disk_manager_->is_file(fsm_name)) {
+            buffer_pool_manager_->reset_file_counters(disk_manager_->destroy_file(fsm_name));
+        }
+        int fd = disk_manager_->destroy_file(filename);
+        buffer_pool_manager_->reset_file_counters(fd);
+        return fd;
+    }
 
     // 注意这里打开文件，创建并返回了record file handle的指针
     /**
-     * @description: 打开表的数据文件，并返回文件句柄
+     * @description: 打开表的数据文件和空闲空间表，并返回文件句柄
      * @param {string&} filename 要打开的文件名称
      * @return {unique_ptr<RmFileHandle>} 文件句柄的指针
+     * @note 旧版本创建的表没有空闲空间表，打开时扫描所有页面建立
      */
     std::unique_ptr<RmFileHandle> open_file(const std::string& filename) {
         int fd = disk_manager_->open_file(filename);
-        return std::make_unique<RmFileHandle>(disk_manager_, buffer_pool_manager_, fd);
+        std::string fsm_name = filename + FREE_SPACE_MAP_SUFFIX;
+        bool rebuild = !disk_manager_->is_file(fsm_name);
+        if (rebuild) disk_manager_->create_file(fsm_name);
+        int fsm_fd = disk_manager_->open_file(fsm_name);
+        auto file_handle = std::make_unique<RmFileHandle>(disk_manager_, buffer_pool_manager_, fd, fsm_fd);
+        if (rebuild) file_handle->rebuild_free_space_map(false);
+        return file_handle;
     }
     /**
      * @description: 关闭表的数据文件
@@ -81,5 +119,9 @@ class RmManager {
                                   sizeof(file_handle->file_hdr_));
         // 缓冲区的所有页刷到磁盘，注意这句话必须写在close_file前面
         buffer_pool_manager_->flush_all_pages(file_handle->fd_);
+        buffer_pool_manager_->flush_all_pages(file_handle->fsm_->get_fd());
+        disk_manager_->flush_free_pages(file_handle->fd_);
+        buffer_pool_manager_->reset_file_counters(file_handle->fd_);
+        buffer_pool_manager_->reset_file_counters(file_handle->fsm_->get_fd());
     }
 };
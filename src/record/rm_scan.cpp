@@ -18,41 +18,34 @@ See the Mulan PSL v2 for more details. */
 RmScan::RmScan(const RmFileHandle *file_handle) : file_handle_(file_handle) {
     // Todo:
     // 初始化file_handle和rid（指向第一个存放了记录的位置）
-    for (int i = 1; i <= file_handle_->file_hdr_.num_pages; i ++ ) {
-        RmPageHandle page_handle = file_handle_->fetch_page_handle(i);
-        if (page_handle.page_hdr->num_records) {
-            char* bitmap = page_handle.bitmap;
-            int slot_no = Bitmap::first_bit(1, bitmap, file_handle->file_hdr_.num_records_per_page);
-            rid_ = {i, slot_no};
-            break;
-        }
+    // 表的大小超过缓冲池的BUFFER_RING_SCAN_PERCENT%时，扫描只在一个小的环形缓冲区中循环使用帧，不挤掉其他查询的热点页面
+    size_t pool_size = file_handle_->buffer_pool_manager_->get_pool_size();
+    if (static_cast<size_t>(file_handle_->file_hdr_.num_pages) > pool_size * BUFFER_RING_SCAN_PERCENT / 100) {
+        strategy_ = std::make_unique<BufferAccessStrategy>();
     }
+    rid_ = {RM_FIRST_RECORD_PAGE, -1};
+    next();
 }
 
 /**
  * @brief 找到文件中下一个存放了记录的位置
+ * @note 页面句柄离开作用域时立即unpin，扫描大表时页面可以被淘汰；页面按页号顺序访问，缓冲池据此预读后续页面
  */
 void RmScan::next() {
     // Todo:
     // 找到文件中下一个存放了记录的非空闲位置，用rid_来指向这个位置
-    RmPageHandle page_handle = file_handle_->fetch_page_handle(rid_.page_no);
-    char* bitmap = page_handle.bitmap;
-    int slot_no = Bitmap::next_bit(1, bitmap, file_handle_->file_hdr_.num_records_per_page, rid_.slot_no);
-    if (slot_no == file_handle_->file_hdr_.num_records_per_page) {
-        rid_.page_no ++ ;
-        if (rid_.page_no == file_handle_->file_hdr_.num_pages) {
-            rid_.slot_no = 0;
-            return ;
-        }
-        RmPageHandle now_page_handle = file_handle_->fetch_page_handle(rid_.page_no);
-        if (page_handle.page_hdr->num_records) {
-            char* now_bitmap = now_page_handle.bitmap;
-            int now_slot_no = Bitmap::first_bit(1, now_bitmap, file_handle_->file_hdr_.num_records_per_page);
-            rid_.slot_no = now_slot_no;
+    int num_records_per_page = file_handle_->file_hdr_.num_records_per_page;
+    while (rid_.page_no < file_handle_->file_hdr_.num_pages) {
+        RmPageHandle page_handle = file_handle_->fetch_page_handle(rid_.page_no, strategy_.get());
+        int slot_no = Bitmap::next_bit(true, page_handle.bitmap, num_records_per_page, rid_.slot_no);
+        if (slot_no < num_records_per_page) {
+            rid_.slot_no = slot_no;
+            return;
         }
-    } else {
-        rid_.slot_no = slot_no;
+        rid_.page_no++;
+        rid_.slot_no = -1;
     }
+    rid_.slot_no = 0;
 }
 
 /**
@@ -68,4 +61,91 @@ bool RmScan::is_end() const {
  */
 Rid RmScan::rid() const {
     return rid_;
-}
\ No newline at end of file
+}
+/**
+ * @brief 批量扫描：pin下一个有记录的页面一次，取出页面上所有记录的slot号，然后移到下一个页面
+ * @return {bool} 已经扫描完整个文件时返回false
+ * @note 批量接口从当前rid所在的页面开始，之后rid指向下一个页面，不能再与next()混用
+ */
+bool RmScan::next_batch(RmPageBatch *batch) {
+    int num_records_per_page = file_handle_->file_hdr_.num_records_per_page;
+    batch->slot_nos.clear();
+    batch->record_size = file_handle_->file_hdr_.record_size;
+    while (batch->slot_nos.empty() && rid_.page_no < file_handle_->file_hdr_.num_pages) {
+        RmPageHandle page_handle = file_handle_->fetch_page_handle(rid_.page_no, strategy_.get());
+        batch->page_no = rid_.page_no;
+        Bitmap::for_each_set(page_handle.bitmap, num_records_per_page,
+                             [&](int slot_no) { batch->slot_nos.push_back(slot_no); });
+        rid_ = {rid_.page_no + 1, -1};
+    }
+    return !batch->slot_nos.empty();
+}
+
+/**
+ * @brief 批量扫描：pin下一个有记录的页面一次，把页面上满足谓词pred的记录复制到batch中，然后移到下一个页面
+ * @param pred 下推的谓词，为空时取出所有记录；定长记录格式中直接在页面上求值，不满足的记录不复制
+ * @return {bool} 已经扫描完整个文件时返回false
+ * @note 变长记录格式中被移到其他页面的记录在释放当前页面后再读取，任何时候只latch一个页面
+ */
+bool RmScan::next_batch(RmPageBatch *batch, const RmScanPredicate &pred) {
+    const RmFileHdr &file_hdr = file_handle_->file_hdr_;
+    int num_records_per_page = file_hdr.num_records_per_page;
+    int record_size = file_hdr.record_size;
+    batch->slot_nos.clear();
+    batch->record_size = record_size;
+    // 一次分配好一个页面的记录所需的空间，之后的批次复用
+    batch->records.resize(static_cast<size_t>(num_records_per_page) * record_size);
+    while (batch->slot_nos.empty() && rid_.page_no < file_hdr.num_pages) {
+        std::vector<std::pair<size_t, Rid>> forwards;  // 被移到其他页面的记录在batch中的位置和新位置
+        {
+            RmPageHandle page_handle = file_handle_->fetch_page_handle(rid_.page_no, strategy_.get());
+            batch->page_no = rid_.page_no;
+            Bitmap::for_each_set(page_handle.bitmap, num_records_per_page, [&](int slot_no) {
+                Rid rid = {rid_.page_no, slot_no};
+                char *rec = batch->records.data() + batch->slot_nos.size() * record_size;
+                if (!file_handle_->is_slotted()) {
+                    const char *data = page_handle.get_slot(slot_no);
+                    if (pred && !pred(rid, data)) return;
+                    memcpy(rec, data, record_size);
+                } else {
+                    RmSlottedPage page(page_handle);
+                    RmSlot *slot = page.get_slot(slot_no);
+                    if (slot->flag == RM_SLOT_FORWARD) {
+                        Rid target;
+                        memcpy(&target, page.get_data(slot), sizeof(Rid));
+                        forwards.emplace_back(batch->slot_nos.size(), target);
+                    } else {
+                        rm_decode_record(&file_hdr, page.get_data(slot), slot->len, rec);
+                        if (pred && !pred(rid, rec)) return;
+                    }
+                }
+                batch->slot_nos.push_back(slot_no);
+            });
+        }
+        if (!forwards.empty()) {
+            // 读出移走的记录后再求值，把不满足谓词的记录从batch中去掉
+            size_t num_kept = 0;
+            auto forward = forwards.begin();
+            for (size_t i = 0; i < batch->slot_nos.size(); i++) {
+                char *rec = batch->records.data() + i * record_size;
+                if (forward != forwards.end() && forward->first == i) {
+                    RmPageHandle target_handle = file_handle_->fetch_page_handle(forward->second.page_no);
+                    RmSlottedPage target_page(target_handle);
+                    RmSlot *slot = target_page.get_slot(forward->second.slot_no);
+                    rm_decode_record(&file_hdr, target_page.get_data(slot), slot->len, rec);
+                    forward++;
+                    target_handle.guard.drop();
+                    if (pred && !pred({batch->page_no, batch->slot_nos[i]}, rec)) continue;
+                }
+                if (num_kept != i) {
+                    memcpy(batch->records.data() + num_kept * record_size, rec, record_size);
+                    batch->slot_nos[num_kept] = batch->slot_nos[i];
+                }
+                num_kept++;
+            }
+            batch->slot_nos.resize(num_kept);
+        }
+        rid_ = {rid_.page_no + 1, -1};
+    }
+    return !batch->slot_nos.empty();
+}
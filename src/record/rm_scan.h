@@ -10,13 +10,34 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
 #include "rm_defs.h"
 
 class RmFileHandle;
 
+/* 批量扫描一次取出的一个页面上的记录 */
+struct RmPageBatch {
+    int page_no = -1;           // 记录所在的页面
+    int record_size = 0;        // 每条记录的长度
+    std::vector<int> slot_nos;  // 页面上存放了记录(且满足谓词)的slot号，按slot号递增
+    std::vector<char> records;  // 与slot_nos一一对应的记录数据，每条record_size字节；只取slot号时不使用
+
+    size_t size() const { return slot_nos.size(); }
+
+    Rid rid(size_t i) const { return {page_no, slot_nos[i]}; }
+
+    const char *get_record(size_t i) const { return records.data() + i * record_size; }
+};
+
+// 批量扫描时下推的谓词，参数为记录号和记录数据，返回是否保留这条记录
+using RmScanPredicate = std::function<bool(const Rid &rid, const char *rec)>;
+
 class RmScan : public RecScan {
     const RmFileHandle *file_handle_;
     Rid rid_;
+    std::unique_ptr<BufferAccessStrategy> strategy_;  // 扫描大表时使用的环形缓冲区，小表为nullptr
 public:
     RmScan(const RmFileHandle *file_handle);
 
@@ -25,4 +46,8 @@ public:
     bool is_end() const override;
 
     Rid rid() const override;
+
+    bool next_batch(RmPageBatch *batch);
+
+    bool next_batch(RmPageBatch *batch, const RmScanPredicate &pred);
 };
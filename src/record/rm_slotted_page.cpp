@@ -0,0 +1,173 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "rm_slotted_page.h"
+
+#include <vector>
+
+#include "rm_file_handle.h"
+
+/**
+ * @description: 把record_size字节的定长记录编码成变长记录
+ * @return {int} 编码后的长度，不超过rm_max_encoded_size
+ */
+int rm_encode_record(const RmFileHdr *file_hdr, const char *rec, char *out) {
+    int pos = 0, len = 0;
+    for (int i = 0; i < file_hdr->num_var_fields; i++) {
+        const RmVarField &field = file_hdr->var_fields[i];
+        memcpy(out + len, rec + pos, field.offset - pos);
+        len += field.offset - pos;
+        uint16_t n = field.len;
+        while (n > 0 && rec[field.offset + n - 1] == '\0') n--;
+        memcpy(out + len, &n, sizeof(n));
+        memcpy(out + len + sizeof(n), rec + field.offset, n);
+        len += sizeof(n) + n;
+        pos = field.offset + field.len;
+    }
+    memcpy(out + len, rec + pos, file_hdr->record_size - pos);
+    return len + file_hdr->record_size - pos;
+}
+
+/**
+ * @description: 把编码后长度为len的变长记录解码成record_size字节的定长记录
+ * @note 长度字段越界时截断，不会读写data和rec之外的内存；len为0时得到全0的记录
+ */
+void rm_decode_record(const RmFileHdr *file_hdr, const char *data, int len, char *rec) {
+    memset(rec, 0, file_hdr->record_size);
+    int pos = 0, in = 0;
+    for (int i = 0; i < file_hdr->num_var_fields && in < len; i++) {
+        const RmVarField &field = file_hdr->var_fields[i];
+        int n = std::min(field.offset - pos, len - in);
+        memcpy(rec + pos, data + in, n);
+        in += n;
+        uint16_t var_len = 0;
+        if (in + static_cast<int>(sizeof(var_len)) <= len) memcpy(&var_len, data + in, sizeof(var_len));
+        in += sizeof(var_len);
+        n = std::max(0, std::min({static_cast<int>(var_len), field.len, len - in}));
+        memcpy(rec + field.offset, data + in, n);
+        in += var_len;
+        pos = field.offset + field.len;
+    }
+    if (in < len) memcpy(rec + pos, data + in, std::min(file_hdr->record_size - pos, len - in));
+}
+
+int rm_min_encoded_size(const RmFileHdr *file_hdr) {
+    int len = file_hdr->record_size;
+    for (int i = 0; i < file_hdr->num_var_fields; i++) {
+        len -= file_hdr->var_fields[i].len - static_cast<int>(sizeof(uint16_t));
+    }
+    return len;
+}
+
+RmSlottedPage::RmSlottedPage(const RmPageHandle &page_handle) {
+    page_ = page_handle.page->get_data();
+    hdr_ = reinterpret_cast<RmSlottedPageHdr *>(page_handle.slots);
+    slots_ = reinterpret_cast<RmSlot *>(page_handle.slots + sizeof(RmSlottedPageHdr));
+    page_size_ = page_handle.page->get_page_size();
+    max_slots_ = page_handle.file_hdr->num_records_per_page;
+}
+
+/**
+ * @description: 初始化新页面的slot目录和记录区
+ */
+void RmSlottedPage::init() {
+    hdr_->num_slots = 0;
+    hdr_->free_end = page_size_;
+    hdr_->frag_bytes = 0;
+    hdr_->in_free_list = 0;
+}
+
+/**
+ * @description: 返回第一个空闲slot的slot号，没有空闲slot时返回目录末尾之后的slot号，目录已满时返回-1
+ */
+int RmSlottedPage::find_free_slot() const {
+    for (int slot_no = 0; slot_no < hdr_->num_slots; slot_no++) {
+        if (slots_[slot_no].flag == RM_SLOT_FREE) return slot_no;
+    }
+    return hdr_->num_slots < max_slots_ ? hdr_->num_slots : -1;
+}
+
+/**
+ * @description: slot_no中的内容换成长度为len的数据后能否放进页面，slot_no可以在目录末尾之后
+ */
+bool RmSlottedPage::fits(int slot_no, int len) const {
+    if (slot_no >= max_slots_) return false;
+    int old_space = 0, dir_space = 0;
+    if (slot_no < hdr_->num_slots) {
+        if (slots_[slot_no].flag != RM_SLOT_FREE) old_space = space(slots_[slot_no].len);
+    } else {
+        dir_space = (slot_no + 1 - hdr_->num_slots) * static_cast<int>(sizeof(RmSlot));
+    }
+    return space(len) + dir_space <= contiguous() + hdr_->frag_bytes + old_space;
+}
+
+/**
+ * @description: 把slot_no中的内容换成长度为len的数据，原来的空间够用时原地覆盖，否则在记录区分配新的空间，
+ * 连续的空闲空间不够时先整理页面
+ * @return {bool} 页面放不下时返回false，页面不变
+ */
+bool RmSlottedPage::put(int slot_no, const char *data, int len, RmSlotFlag flag) {
+    if (!fits(slot_no, len)) return false;
+    if (slot_no < hdr_->num_slots) {
+        RmSlot *slot = slots_ + slot_no;
+        if (slot->flag != RM_SLOT_FREE && space(len) <= space(slot->len)) {
+            memcpy(page_ + slot->offset, data, len);
+            hdr_->frag_bytes += space(slot->len) - space(len);
+            slot->len = static_cast<short>(len);
+            slot->flag = flag;
+            return true;
+        }
+        if (slot->flag != RM_SLOT_FREE) hdr_->frag_bytes += space(slot->len);
+        *slot = {0, 0, RM_SLOT_FREE};
+    }
+    int dir_space = std::max(0, slot_no + 1 - hdr_->num_slots) * static_cast<int>(sizeof(RmSlot));
+    if (contiguous() < space(len) + dir_space) compact();
+    while (hdr_->num_slots <= slot_no) slots_[hdr_->num_slots++] = {0, 0, RM_SLOT_FREE};
+    hdr_->free_end -= space(len);
+    memcpy(page_ + hdr_->free_end, data, len);
+    slots_[slot_no] = {hdr_->free_end, static_cast<short>(len), flag};
+    return true;
+}
+
+/**
+ * @description: 释放slot_no，记录占用的空间变成空洞，整理页面时回收
+ */
+void RmSlottedPage::erase(int slot_no) {
+    hdr_->frag_bytes += space(slots_[slot_no].len);
+    slots_[slot_no] = {0, 0, RM_SLOT_FREE};
+}
+
+/**
+ * @description: 整理页面，把所有记录紧挨着移到页面末尾，回收空洞和目录末尾的空闲slot，slot号不变
+ */
+void RmSlottedPage::compact() {
+    while (hdr_->num_slots > 0 && slots_[hdr_->num_slots - 1].flag == RM_SLOT_FREE) hdr_->num_slots--;
+    std::vector<char> copy(page_ + hdr_->free_end, page_ + page_size_);
+    int base = hdr_->free_end;
+    hdr_->free_end = page_size_;
+    for (int slot_no = 0; slot_no < hdr_->num_slots; slot_no++) {
+        RmSlot *slot = slots_ + slot_no;
+        if (slot->flag == RM_SLOT_FREE) continue;
+        hdr_->free_end -= space(slot->len);
+        memcpy(page_ + hdr_->free_end, copy.data() + slot->offset - base, slot->len);
+        slot->offset = hdr_->free_end;
+    }
+    hdr_->frag_bytes = 0;
+}
+
+/**
+ * @description: 页面中是否没有任何记录，包括从其他页面移过来的记录
+ */
+bool RmSlottedPage::empty() const {
+    for (int slot_no = 0; slot_no < hdr_->num_slots; slot_no++) {
+        if (slots_[slot_no].flag != RM_SLOT_FREE) return false;
+    }
+    return true;
+}
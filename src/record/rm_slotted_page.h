@@ -0,0 +1,92 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+
+#include "rm_defs.h"
+
+struct RmPageHandle;
+
+/**
+ * 变长记录格式的编码：定长字段按原来的位置和长度存储，变长字段存储2字节的实际长度和去掉末尾'\0'后的内容
+ * 上层看到的仍是record_size字节的定长记录，解码时变长字段末尾补'\0'
+ */
+int rm_encode_record(const RmFileHdr *file_hdr, const char *rec, char *out);
+
+void rm_decode_record(const RmFileHdr *file_hdr, const char *data, int len, char *rec);
+
+// 编码后记录的最大长度，所有变长字段都取最大长度
+inline int rm_max_encoded_size(const RmFileHdr *file_hdr) {
+    return file_hdr->record_size + file_hdr->num_var_fields * static_cast<int>(sizeof(uint16_t));
+}
+
+// 编码后记录的最小长度，所有变长字段都为空
+int rm_min_encoded_size(const RmFileHdr *file_hdr);
+
+/**
+ * 变长记录格式的页面：[RmPageHdr][bitmap][RmSlottedPageHdr][slot目录 ->    空闲空间    <- 记录区]
+ * bitmap中的位表示slot是否存放一条可见的记录(RM_SLOT_NORMAL或RM_SLOT_FORWARD)，RmScan和compact不需要区分两种格式
+ * slot号就是Rid中的slot_no，记录在页面内移动(整理页面)时slot号不变；每条记录至少占sizeof(Rid)字节，保证总能原地改成转发的Rid
+ */
+class RmSlottedPage {
+   public:
+    explicit RmSlottedPage(const RmPageHandle &page_handle);
+
+    void init();
+
+    int num_slots() const { return hdr_->num_slots; }
+
+    RmSlot *get_slot(int slot_no) const { return slots_ + slot_no; }
+
+    char *get_data(const RmSlot *slot) const { return page_ + slot->offset; }
+
+    int find_free_slot() const;
+
+    bool fits(int slot_no, int len) const;
+
+    // 页面能否再插入一条编码后长度为len的记录
+    bool has_room(int len) const {
+        int slot_no = find_free_slot();
+        return slot_no >= 0 && fits(slot_no, len);
+    }
+
+    // 页面中的空闲空间，包括连续的空闲空间和空洞
+    int free_space() const { return contiguous() + hdr_->frag_bytes; }
+
+    // slot目录和记录区总共可用的空间
+    int capacity() const { return page_size_ - static_cast<int>(reinterpret_cast<char *>(slots_) - page_); }
+
+    bool put(int slot_no, const char *data, int len, RmSlotFlag flag);
+
+    void erase(int slot_no);
+
+    void compact();
+
+    bool empty() const;
+
+    RmSlottedPageHdr *hdr() const { return hdr_; }
+
+   private:
+    char *page_;
+    RmSlottedPageHdr *hdr_;
+    RmSlot *slots_;
+    int page_size_;
+    int max_slots_;
+
+    // 记录占用的空间，不足sizeof(Rid)时按sizeof(Rid)算
+    static int space(int len) { return std::max(len, static_cast<int>(sizeof(Rid))); }
+
+    // slot目录末尾到记录区之间连续的空闲空间
+    int contiguous() const {
+        return hdr_->free_end - static_cast<int>(reinterpret_cast<char *>(slots_ + hdr_->num_slots) - page_);
+    }
+};
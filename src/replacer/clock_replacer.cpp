@@ -0,0 +1,83 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "clock_replacer.h"
+
+ClockReplacer::ClockReplacer(size_t num_pages) : states_(new std::atomic<uint8_t>[num_pages]), max_size_(num_pages) {
+    for (size_t i = 0; i < max_size_; i++) states_[i].store(0, std::memory_order_relaxed);
+}
+
+ClockReplacer::~ClockReplacer() = default;
+
+/**
+ * @description: 使用CLOCK策略选择一个victim frame，并返回该frame的id
+ * @param {frame_id_t*} frame_id 被移除的frame的id
+ * @return {bool} 如果成功淘汰了一个页面则返回true，否则返回false
+ * @note 扫描过程中其他线程可能并发地pin/unpin, 状态的修改都通过CAS完成; 最多扫描三圈,
+ *       前两圈足以清掉所有引用位, 第三圈仍找不到说明可淘汰的帧都被并发pin走了
+ */
+bool ClockReplacer::victim(frame_id_t *frame_id) {
+    std::scoped_lock lock{hand_latch_};
+    for (size_t step = 0; step < 3 * max_size_ && size_.load() > 0; step++) {
+        size_t pos = hand_;
+        hand_ = (hand_ + 1) % max_size_;
+        uint8_t state = states_[pos].load();
+        if (!(state & EVICTABLE)) continue;
+        if (state & REFERENCED) {
+            // 给一次机会: 清除引用位, 失败说明状态被并发修改, 下一圈再看
+            states_[pos].compare_exchange_strong(state, state & ~REFERENCED);
+            continue;
+        }
+        if (states_[pos].compare_exchange_strong(state, 0)) {
+            size_.fetch_sub(1);
+            *frame_id = static_cast<frame_id_t>(pos);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @description: 固定指定的frame，即该页面无法被淘汰
+ * @param {frame_id_t} 需要固定的frame的id
+ */
+void ClockReplacer::pin(frame_id_t frame_id) {
+    uint8_t old_state = states_[frame_id].fetch_and(static_cast<uint8_t>(~(EVICTABLE | REFERENCED)));
+    if (old_state & EVICTABLE) size_.fetch_sub(1);
+}
+
+/**
+ * @description: 取消固定一个frame，代表该页面可以被淘汰，同时设置其引用位
+ * @param {frame_id_t} frame_id 取消固定的frame的id
+ */
+void ClockReplacer::unpin(frame_id_t frame_id) {
+    uint8_t old_state = states_[frame_id].fetch_or(EVICTABLE | REFERENCED);
+    if (!(old_state & EVICTABLE)) size_.fetch_add(1);
+}
+
+/**
+ * @description: 改变replacer可以存储的帧数, 保留编号小于num_pages的帧的状态
+ * @param {size_t} num_pages 新的帧数
+ */
+void ClockReplacer::resize(size_t num_pages) {
+    std::scoped_lock lock{hand_latch_};
+    std::unique_ptr<std::atomic<uint8_t>[]> states(new std::atomic<uint8_t>[num_pages]);
+    for (size_t i = 0; i < num_pages; i++) {
+        states[i].store(i < max_size_ ? states_[i].load() : 0, std::memory_order_relaxed);
+    }
+    states_ = std::move(states);
+    max_size_ = num_pages;
+    hand_ %= max_size_;
+}
+
+/**
+ * @description: 获取当前replacer中可以被淘汰的页面数量
+ */
+size_t ClockReplacer::Size() { return size_.load(); }
@@ -0,0 +1,54 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "common/config.h"
+#include "replacer/replacer.h"
+
+/*
+ClockReplacer实现了CLOCK(二次机会)替换策略
+每个帧用一个原子状态字节记录"是否可淘汰"和"引用位", pin/unpin只对该字节做一次原子操作, 不加锁;
+victim由时钟指针扫描各帧, 引用位为1的帧清零后跳过, 引用位为0且可淘汰的帧被选为victim
+*/
+class ClockReplacer : public Replacer {
+   public:
+    /**
+     * @description: 创建一个新的ClockReplacer
+     * @param {size_t} num_pages ClockReplacer最多需要存储的page数量
+     */
+    explicit ClockReplacer(size_t num_pages);
+
+    ~ClockReplacer();
+
+    bool victim(frame_id_t *frame_id);
+
+    void pin(frame_id_t frame_id);
+
+    void unpin(frame_id_t frame_id);
+
+    void resize(size_t num_pages);
+
+    size_t Size();
+
+   private:
+    static constexpr uint8_t EVICTABLE = 1;  // 帧在replacer中, 可以被淘汰
+    static constexpr uint8_t REFERENCED = 2; // 引用位, 最近被访问过
+
+    std::unique_ptr<std::atomic<uint8_t>[]> states_;    // 各帧的状态
+    std::atomic<size_t> size_{0};   // 可淘汰帧的个数
+    std::mutex hand_latch_;         // 只保护时钟指针, 仅在victim中使用
+    size_t hand_ = 0;               // 时钟指针
+    size_t max_size_;               // 最大容量（与缓冲池的容量相同）
+};
@@ -0,0 +1,115 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "lru_k_replacer.h"
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k)
+    : k_(k), history_(num_pages * k), access_count_(num_pages, 0), evictable_(num_pages, false) {}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+/**
+ * @description: 记录一次对frame_id的访问
+ * @param {bool} pinned 帧是否已经被其他线程pin住
+ * @note 帧已经被pin住时的访问(多个线程同时访问同一页面)和与上一次访问相隔不超过LRUK_CORRELATED_PERIOD的访问
+ * (扫描时逐条记录地重复pin同一页面)是相关访问, 只更新最近一次访问的时间, 不算新的访问,
+ * 否则一次扫描就会让页面看起来像热点页面
+ */
+void LRUKReplacer::record_access(frame_id_t frame_id, bool pinned) {
+    size_t count = access_count_[frame_id];
+    uint64_t &last = history_[frame_id * k_ + (count + k_ - 1) % k_];
+    current_timestamp_++;
+    if (count > 0 && (pinned || current_timestamp_ - last <= LRUK_CORRELATED_PERIOD)) {
+        last = current_timestamp_;
+        return;
+    }
+    history_[frame_id * k_ + count % k_] = current_timestamp_;
+    access_count_[frame_id]++;
+}
+
+/**
+ * @description: 使用LRU-K策略删除一个victim frame，并返回该frame的id
+ * @param {frame_id_t*} frame_id 被移除的frame的id
+ * @return {bool} 如果成功淘汰了一个页面则返回true，否则返回false
+ */
+bool LRUKReplacer::victim(frame_id_t *frame_id) {
+    std::scoped_lock lock{latch_};
+    auto &candidates = history_set_.empty() ? cache_set_ : history_set_;
+    if (candidates.empty()) return false;
+
+    *frame_id = candidates.begin()->second;
+    candidates.erase(candidates.begin());
+    evictable_[*frame_id] = false;
+    // 帧将装入新的页面, 清空访问历史
+    access_count_[*frame_id] = 0;
+    return true;
+}
+
+/**
+ * @description: 固定指定的frame，即该页面无法被淘汰，并记为一次访问
+ * @param {frame_id_t} 需要固定的frame的id
+ */
+void LRUKReplacer::pin(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    // 访问历史在淘汰和移除时清空, 有访问历史又不可淘汰的帧正被pin住
+    bool pinned = !evictable_[frame_id] && access_count_[frame_id] > 0;
+    if (evictable_[frame_id]) {
+        auto key = evict_key(frame_id);
+        (access_count_[frame_id] < k_ ? history_set_ : cache_set_).erase(key);
+        evictable_[frame_id] = false;
+    }
+    record_access(frame_id, pinned);
+}
+
+/**
+ * @description: 取消固定一个frame，代表该页面可以被淘汰
+ * @param {frame_id_t} frame_id 取消固定的frame的id
+ */
+void LRUKReplacer::unpin(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    if (evictable_[frame_id]) return;
+
+    // 没有经过pin直接unpin的帧, 以本次unpin作为第一次访问
+    if (access_count_[frame_id] == 0) record_access(frame_id);
+    (access_count_[frame_id] < k_ ? history_set_ : cache_set_).insert(evict_key(frame_id));
+    evictable_[frame_id] = true;
+}
+
+/**
+ * @description: 移除一个将要装入其他页面的帧，并清空其访问历史
+ * @param {frame_id_t} frame_id 被移除的frame的id
+ */
+void LRUKReplacer::remove(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    if (evictable_[frame_id]) {
+        (access_count_[frame_id] < k_ ? history_set_ : cache_set_).erase(evict_key(frame_id));
+        evictable_[frame_id] = false;
+    }
+    access_count_[frame_id] = 0;
+}
+
+/**
+ * @description: 改变replacer可以存储的帧数, 保留编号小于num_pages的帧的访问历史
+ * @param {size_t} num_pages 新的帧数
+ */
+void LRUKReplacer::resize(size_t num_pages) {
+    std::scoped_lock lock{latch_};
+    history_.resize(num_pages * k_);
+    access_count_.resize(num_pages, 0);
+    evictable_.resize(num_pages, false);
+}
+
+/**
+ * @description: 获取当前replacer中可以被淘汰的页面数量
+ */
+size_t LRUKReplacer::Size() {
+    std::scoped_lock lock{latch_};
+    return history_set_.size() + cache_set_.size();
+}
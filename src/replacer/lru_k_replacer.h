@@ -0,0 +1,68 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "replacer/replacer.h"
+
+/*
+LRUKReplacer实现了LRU-K替换策略
+每次pin记为一次访问, 淘汰时选择"倒数第K次访问"最早的帧; 访问次数不足K次的帧视为距离无穷大, 优先淘汰,
+它们之间按第一次访问的先后淘汰。只被全表扫描访问过一次的页面因此会先于热点页面被淘汰。
+相隔不超过LRUK_CORRELATED_PERIOD的相关访问合并为一次访问, 见record_access
+*/
+class LRUKReplacer : public Replacer {
+   public:
+    /**
+     * @description: 创建一个新的LRUKReplacer
+     * @param {size_t} num_pages LRUKReplacer最多需要存储的page数量
+     * @param {size_t} k 参与比较的历史访问次数
+     */
+    explicit LRUKReplacer(size_t num_pages, size_t k = LRUK_REPLACER_K);
+
+    ~LRUKReplacer();
+
+    bool victim(frame_id_t *frame_id);
+
+    void pin(frame_id_t frame_id);
+
+    void unpin(frame_id_t frame_id);
+
+    void resize(size_t num_pages);
+
+    void remove(frame_id_t frame_id);
+
+    size_t Size();
+
+   private:
+    void record_access(frame_id_t frame_id, bool pinned = false);
+
+    // 可淘汰帧在history_set_或cache_set_中的排序键
+    std::pair<uint64_t, frame_id_t> evict_key(frame_id_t frame_id) const {
+        const uint64_t *history = &history_[frame_id * k_];
+        // 访问次数不足K次时取第一次访问的时间, 否则取倒数第K次访问的时间(即环形数组中下一个要被覆盖的位置)
+        return {access_count_[frame_id] < k_ ? history[0] : history[access_count_[frame_id] % k_], frame_id};
+    }
+
+    std::mutex latch_;                  // 互斥锁
+    size_t k_;
+    uint64_t current_timestamp_ = 0;    // 逻辑时钟, 每次访问加一
+    std::vector<uint64_t> history_;     // 每个帧最近K次访问的时间戳, 以环形数组存放, 大小为num_pages*k_
+    std::vector<size_t> access_count_;  // 每个帧自装入以来的访问次数
+    std::vector<bool> evictable_;       // 帧是否在replacer中
+    std::set<std::pair<uint64_t, frame_id_t>> history_set_;    // 访问次数不足K次的可淘汰帧, 按第一次访问时间排序
+    std::set<std::pair<uint64_t, frame_id_t>> cache_set_;      // 访问次数达到K次的可淘汰帧, 按倒数第K次访问时间排序
+};
@@ -35,6 +35,7 @@ bool LRUReplacer::victim(frame_id_t* frame_id) {
 
     auto it = std::prev(LRUlist_.end());
     *frame_id = *it;
+    LRUhash_.erase(*it);
     LRUlist_.erase(it);
 
     return true;
@@ -50,16 +51,10 @@ void LRUReplacer::pin(frame_id_t frame_id) {
     // 固定指定id的frame
     // 在数据结构中移除该frame
 
-    auto iter = LRUlist_.end();
-    for (auto it  = LRUlist_.begin(); it != LRUlist_.end(); it ++ )
-        if (frame_id == *it) {
-            iter = it;
-            break;
-        }
-
-    if (iter != LRUlist_.end()) {
-        LRUlist_.erase(iter);
-        LRUhash_.erase(frame_id);
+    auto iter = LRUhash_.find(frame_id);
+    if (iter != LRUhash_.end()) {
+        LRUlist_.erase(iter->second);
+        LRUhash_.erase(iter);
     }
 }
 
@@ -74,12 +69,20 @@ void LRUReplacer::unpin(frame_id_t frame_id) {
 
     std::scoped_lock lock{latch_};
 
-    for (auto it : LRUlist_)
-        if (it == frame_id)
-            return ;
+    if (LRUhash_.count(frame_id))
+        return ;
 
     LRUlist_.push_front(frame_id);
-    LRUhash_[frame_id] = std::prev(LRUlist_.end());
+    LRUhash_[frame_id] = LRUlist_.begin();
+}
+
+/**
+ * @description: 改变replacer可以存储的帧数
+ * @param {size_t} num_pages 新的帧数
+ */
+void LRUReplacer::resize(size_t num_pages) {
+    std::scoped_lock lock{latch_};
+    max_size_ = num_pages;
 }
 
 /**
@@ -37,6 +37,8 @@ class LRUReplacer : public Replacer {
 
     void unpin(frame_id_t frame_id);
 
+    void resize(size_t num_pages);
+
     size_t Size();
 
    private:
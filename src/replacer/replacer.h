@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/config.h"
 
+struct PageId;
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -33,12 +35,35 @@ class Replacer {
      */
     virtual void pin(frame_id_t frame_id) = 0;
 
+    /**
+     * Tells the replacer which page a frame now holds. Called when a page is loaded into the frame, before the
+     * pin() or unpin() that follows. Policies that remember evicted pages (the A1out queue of 2Q) use it to
+     * recognise a page that comes back; the default ignores it.
+     * @param frame_id the id of the frame
+     * @param page_id the page loaded into the frame
+     */
+    virtual void set_page(frame_id_t /*frame_id*/, const PageId &/*page_id*/) {}
+
     /**
      * Unpins a frame, indicating that it can now be victimized.
      * @param frame_id the id of the frame to unpin
      */
     virtual void unpin(frame_id_t frame_id) = 0;
 
+    /**
+     * Removes a frame that is about to hold another page without going through victim(), and forgets
+     * its access history. The frame is not evictable afterwards.
+     * @param frame_id the id of the frame to remove
+     */
+    virtual void remove(frame_id_t frame_id) { pin(frame_id); }
+
+    /**
+     * Changes the number of frames the replacer can track when the buffer pool is resized. Frames at or beyond
+     * num_pages must already have been removed, and the caller holds the buffer pool latch.
+     * @param num_pages the new number of frames
+     */
+    virtual void resize(size_t num_pages) = 0;
+
     /** @return the number of elements in the replacer that can be victimized */
     virtual size_t Size() = 0;
 };
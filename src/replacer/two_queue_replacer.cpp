@@ -0,0 +1,194 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "two_queue_replacer.h"
+
+#include <algorithm>
+
+TwoQueueReplacer::TwoQueueReplacer(size_t num_pages)
+    : kin_(std::max<size_t>(1, num_pages / 4)),
+      kout_(std::max<size_t>(1, num_pages / 2)),
+      queue_(num_pages, NONE),
+      evictable_(num_pages, false),
+      page_(num_pages),
+      prev_(num_pages, INVALID_FRAME_ID),
+      next_(num_pages, INVALID_FRAME_ID) {}
+
+TwoQueueReplacer::~TwoQueueReplacer() = default;
+
+/**
+ * @description: 把frame_id加到queue的表尾
+ */
+void TwoQueueReplacer::link_tail(Queue queue, frame_id_t frame_id) {
+    prev_[frame_id] = tail_[queue];
+    next_[frame_id] = INVALID_FRAME_ID;
+    if (tail_[queue] != INVALID_FRAME_ID)
+        next_[tail_[queue]] = frame_id;
+    else
+        head_[queue] = frame_id;
+    tail_[queue] = frame_id;
+    length_[queue]++;
+}
+
+/**
+ * @description: 把frame_id从queue中摘下
+ */
+void TwoQueueReplacer::unlink(Queue queue, frame_id_t frame_id) {
+    if (prev_[frame_id] != INVALID_FRAME_ID)
+        next_[prev_[frame_id]] = next_[frame_id];
+    else
+        head_[queue] = next_[frame_id];
+    if (next_[frame_id] != INVALID_FRAME_ID)
+        prev_[next_[frame_id]] = prev_[frame_id];
+    else
+        tail_[queue] = prev_[frame_id];
+    length_[queue]--;
+}
+
+/**
+ * @description: 帧中装入了新的页面: 页面在A1out中时从A1out取出并进入Am, 否则进入A1in的表尾
+ * @param {bool} check_a1out 是否查找A1out; 预读装入的页面不算访问, 不因为在A1out中而进入Am
+ */
+void TwoQueueReplacer::load(frame_id_t frame_id, bool check_a1out) {
+    auto it = check_a1out ? a1out_index_.find(page_[frame_id]) : a1out_index_.end();
+    if (it != a1out_index_.end()) {
+        a1out_.erase(it->second);
+        a1out_index_.erase(it);
+        queue_[frame_id] = AM;
+        return;
+    }
+    queue_[frame_id] = A1;
+    link_tail(A1, frame_id);
+}
+
+/**
+ * @description: 把从A1in淘汰的页面记入A1out, 超过kout_项时丢掉最早的记录
+ */
+void TwoQueueReplacer::remember(const PageId &page_id) {
+    if (page_id.page_no == INVALID_PAGE_ID || a1out_index_.count(page_id)) return;
+    a1out_index_.emplace(page_id, a1out_.insert(a1out_.end(), page_id));
+    trim_a1out();
+}
+
+void TwoQueueReplacer::trim_a1out() {
+    while (a1out_.size() > kout_) {
+        a1out_index_.erase(a1out_.front());
+        a1out_.pop_front();
+    }
+}
+
+/**
+ * @description: 使用2Q策略删除一个victim frame，并返回该frame的id
+ * @param {frame_id_t*} frame_id 被移除的frame的id
+ * @return {bool} 如果成功淘汰了一个页面则返回true，否则返回false
+ */
+bool TwoQueueReplacer::victim(frame_id_t *frame_id) {
+    std::scoped_lock lock{latch_};
+    // A1in超过目标长度或Am中没有可淘汰的帧时从A1in淘汰, 否则从Am淘汰
+    if ((length_[A1] > kin_ && a1_evictable_ > 0) || length_[AM] == 0) {
+        if (a1_evictable_ == 0) return false;
+        // 按装入顺序找第一个没有被pin住的帧, 被pin住的帧通常很少
+        frame_id_t frame = head_[A1];
+        while (!evictable_[frame]) frame = next_[frame];
+        unlink(A1, frame);
+        a1_evictable_--;
+        remember(page_[frame]);
+        *frame_id = frame;
+    } else {
+        *frame_id = head_[AM];
+        unlink(AM, *frame_id);
+    }
+    evictable_[*frame_id] = false;
+    queue_[*frame_id] = NONE;
+    return true;
+}
+
+/**
+ * @description: 固定指定的frame，即该页面无法被淘汰；新装入的页面按是否在A1out中进入Am或A1in，
+ * 驻留期间的再次访问不会把帧从A1in晋升到Am
+ * @param {frame_id_t} 需要固定的frame的id
+ */
+void TwoQueueReplacer::pin(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    if (queue_[frame_id] == NONE) {
+        load(frame_id, true);
+    } else if (evictable_[frame_id]) {
+        if (queue_[frame_id] == AM)
+            unlink(AM, frame_id);
+        else
+            a1_evictable_--;
+    }
+    evictable_[frame_id] = false;
+}
+
+/**
+ * @description: 记录帧中装入的页面，之后的pin据此查找A1out
+ */
+void TwoQueueReplacer::set_page(frame_id_t frame_id, const PageId &page_id) {
+    std::scoped_lock lock{latch_};
+    page_[frame_id] = page_id;
+}
+
+/**
+ * @description: 取消固定一个frame，代表该页面可以被淘汰；Am中的帧移到表尾，A1in中的帧保持装入时的位置
+ * @param {frame_id_t} frame_id 取消固定的frame的id
+ */
+void TwoQueueReplacer::unpin(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    if (evictable_[frame_id]) return;
+
+    // 没有经过pin直接unpin的帧(预读装入的页面)
+    if (queue_[frame_id] == NONE) load(frame_id, false);
+    if (queue_[frame_id] == AM)
+        link_tail(AM, frame_id);
+    else
+        a1_evictable_++;
+    evictable_[frame_id] = true;
+}
+
+/**
+ * @description: 移除一个将要装入其他页面的帧，不把这次操作当作访问，页面也不记入A1out
+ * @param {frame_id_t} frame_id 被移除的frame的id
+ */
+void TwoQueueReplacer::remove(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    if (queue_[frame_id] == A1) {
+        unlink(A1, frame_id);
+        if (evictable_[frame_id]) a1_evictable_--;
+    } else if (queue_[frame_id] == AM && evictable_[frame_id]) {
+        unlink(AM, frame_id);
+    }
+    evictable_[frame_id] = false;
+    queue_[frame_id] = NONE;
+}
+
+/**
+ * @description: 改变replacer可以存储的帧数, A1in和A1out的长度随之调整
+ * @param {size_t} num_pages 新的帧数
+ */
+void TwoQueueReplacer::resize(size_t num_pages) {
+    std::scoped_lock lock{latch_};
+    kin_ = std::max<size_t>(1, num_pages / 4);
+    kout_ = std::max<size_t>(1, num_pages / 2);
+    trim_a1out();
+    queue_.resize(num_pages, NONE);
+    evictable_.resize(num_pages, false);
+    page_.resize(num_pages);
+    prev_.resize(num_pages, INVALID_FRAME_ID);
+    next_.resize(num_pages, INVALID_FRAME_ID);
+}
+
+/**
+ * @description: 获取当前replacer中可以被淘汰的页面数量
+ */
+size_t TwoQueueReplacer::Size() {
+    std::scoped_lock lock{latch_};
+    return a1_evictable_ + length_[AM];
+}
@@ -0,0 +1,82 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "replacer/replacer.h"
+#include "storage/page.h"
+
+/*
+TwoQueueReplacer实现了2Q替换策略(完整版本)
+第一次装入的页面进入A1in队列(FIFO), 驻留期间的再次访问不改变它的位置, 因此扫描时对同一页面的多次pin、
+多个线程并发的pin都不会把页面晋升; A1in中的帧数超过kin_时优先从A1in淘汰, 被淘汰页面的页号记入A1out。
+A1out是只记录页号、不占用帧的幽灵队列(FIFO, 最多kout_项), 页面被淘汰后再次装入时如果还在A1out中, 说明它
+在短时间之后又被访问, 才进入Am队列(LRU)。一次全表扫描只会在A1in中轮转, 不会冲掉Am中的热点页面
+帧所在的队列建立在帧号数组上的侵入式双向链表上: A1in按装入顺序链接所有驻留的帧(包括被pin住的),
+Am只链接可以淘汰的帧
+*/
+class TwoQueueReplacer : public Replacer {
+   public:
+    /**
+     * @description: 创建一个新的TwoQueueReplacer
+     * @param {size_t} num_pages TwoQueueReplacer最多需要存储的page数量
+     */
+    explicit TwoQueueReplacer(size_t num_pages);
+
+    ~TwoQueueReplacer();
+
+    bool victim(frame_id_t *frame_id);
+
+    void pin(frame_id_t frame_id);
+
+    void set_page(frame_id_t frame_id, const PageId &page_id);
+
+    void unpin(frame_id_t frame_id);
+
+    void resize(size_t num_pages);
+
+    void remove(frame_id_t frame_id);
+
+    size_t Size();
+
+   private:
+    enum Queue : uint8_t { NONE = 0, A1 = 1, AM = 2 };
+
+    void link_tail(Queue queue, frame_id_t frame_id);
+
+    void unlink(Queue queue, frame_id_t frame_id);
+
+    void load(frame_id_t frame_id, bool check_a1out);
+
+    void remember(const PageId &page_id);
+
+    void trim_a1out();
+
+    std::mutex latch_;                  // 互斥锁
+    size_t kin_;                        // A1in队列的目标长度
+    size_t kout_;                       // A1out队列的最大长度
+    size_t a1_evictable_ = 0;           // A1in中可以淘汰的帧数
+    std::vector<Queue> queue_;          // 帧所属的队列
+    std::vector<bool> evictable_;       // 帧是否可以被淘汰
+    std::vector<PageId> page_;          // 帧中装入的页面, 由set_page设置
+    std::vector<frame_id_t> prev_;      // 链表前驱, 表头为INVALID_FRAME_ID
+    std::vector<frame_id_t> next_;      // 链表后继, 表尾为INVALID_FRAME_ID
+    frame_id_t head_[3] = {INVALID_FRAME_ID, INVALID_FRAME_ID, INVALID_FRAME_ID};   // 各队列的表头(最早进入)
+    frame_id_t tail_[3] = {INVALID_FRAME_ID, INVALID_FRAME_ID, INVALID_FRAME_ID};   // 各队列的表尾(最近进入)
+    size_t length_[3] = {0, 0, 0};      // 各队列链表中的帧数: A1in是驻留的帧数, Am是可以淘汰的帧数
+    std::list<PageId> a1out_;           // A1out队列, 表头是最早被淘汰的页面
+    std::unordered_map<PageId, std::list<PageId>::iterator, PageIdHash> a1out_index_;   // A1out中页面的位置
+};
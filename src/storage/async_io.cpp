@@ -0,0 +1,301 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/async_io.h"
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "errors.h"
+
+/**
+ * @description: 创建AsyncIo, 优先使用io_uring, 内核不支持或被禁用时退回到线程池
+ * @param {size_t} queue_depth 同时在途的请求数上限
+ * @param {bool} use_io_uring 是否尝试使用io_uring
+ */
+std::unique_ptr<AsyncIo> AsyncIo::create(size_t queue_depth, bool use_io_uring) {
+    if (use_io_uring) {
+        auto io_uring = std::make_unique<IoUringAsyncIo>(queue_depth);
+        if (io_uring->is_valid()) return io_uring;
+    }
+    return std::make_unique<ThreadPoolAsyncIo>(queue_depth);
+}
+
+/**
+ * @description: 在已经完成result字节的基础上同步补齐剩余的读写
+ * @return {int} 成功时返回num_bytes, 失败时返回-errno
+ * @note 读到文件末尾时剩余部分填0; result为0时即为一次完整的同步读写
+ */
+int AsyncIo::finish_short_io(const Request &request, int result) {
+    if (result == -EINTR || result == -EAGAIN) result = 0;
+    if (result < 0) return result;
+    while (result < request.num_bytes) {
+        ssize_t ret = request.is_write ? pwrite(request.fd, request.buf + result, request.num_bytes - result,
+                                                request.offset + result)
+                                       : pread(request.fd, request.buf + result, request.num_bytes - result,
+                                               request.offset + result);
+        if (ret < 0 && errno == EINTR) continue;
+        if (ret < 0) return -errno;
+        if (ret == 0) {
+            if (request.is_write) return -EIO;
+            memset(request.buf + result, 0, request.num_bytes - result);
+            break;
+        }
+        result += ret;
+    }
+    return request.num_bytes;
+}
+
+IoUringAsyncIo::IoUringAsyncIo(size_t queue_depth) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int ring_fd = syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth), &params);
+    if (ring_fd < 0) return;
+
+    sq_entries_ = params.sq_entries;
+    cq_entries_ = params.cq_entries;
+    sq_ring_size_ = params.sq_off.array + sq_entries_ * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + cq_entries_ * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+    sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                    IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+        close(ring_fd);
+        return;
+    }
+    cq_ring_ = single_mmap ? sq_ring_
+                           : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                                  IORING_OFF_CQ_RING);
+    sqes_ = mmap(nullptr, sq_entries_ * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                 ring_fd, IORING_OFF_SQES);
+    if (cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+        if (cq_ring_ != MAP_FAILED && !single_mmap) munmap(cq_ring_, cq_ring_size_);
+        if (sqes_ != MAP_FAILED) munmap(sqes_, sq_entries_ * sizeof(io_uring_sqe));
+        munmap(sq_ring_, sq_ring_size_);
+        close(ring_fd);
+        return;
+    }
+
+    char *sq = static_cast<char *>(sq_ring_);
+    char *cq = static_cast<char *>(cq_ring_);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = cq + params.cq_off.cqes;
+
+    requests_.resize(sq_entries_);
+    for (unsigned i = 0; i < sq_entries_; i++) free_slots_.push_back(sq_entries_ - 1 - i);
+    ring_fd_ = ring_fd;
+}
+
+IoUringAsyncIo::~IoUringAsyncIo() {
+    if (ring_fd_ < 0) return;
+    // 等待所有在途的请求结束, 否则内核可能在调用者释放缓冲区之后还在读写
+    while (in_flight_ > ready_.size()) {
+        flush();
+        enter(0, 1);
+        IoCompletion completion;
+        while (reap(&completion, 1) == 1) ready_.push_back(completion);
+    }
+    munmap(sqes_, sq_entries_ * sizeof(io_uring_sqe));
+    if (cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_size_);
+    munmap(sq_ring_, sq_ring_size_);
+    close(ring_fd_);
+}
+
+/**
+ * @description: 调用io_uring_enter提交to_submit个请求, 并等待至少min_complete个请求完成
+ * @return {int} 内核接受的请求个数
+ */
+int IoUringAsyncIo::enter(unsigned to_submit, unsigned min_complete) {
+    while (true) {
+        int ret = syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete,
+                          min_complete > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+        if (ret >= 0) return ret;
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            throw InternalError("IoUringAsyncIo::enter Error - io_uring_enter failed");
+        }
+        if (to_submit == 0 && min_complete == 0) return 0;
+    }
+}
+
+/**
+ * @description: 从CQ中取出最多max_completions个完成的请求
+ */
+int IoUringAsyncIo::reap(IoCompletion *completions, int max_completions) {
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    int count = 0;
+    while (head != tail && count < max_completions) {
+        io_uring_cqe *cqe = &static_cast<io_uring_cqe *>(cqes_)[head & *cq_mask_];
+        unsigned slot = static_cast<unsigned>(cqe->user_data);
+        const Request &request = requests_[slot];
+        completions[count++] = {request.user_data, finish_short_io(request, cqe->res)};
+        free_slots_.push_back(slot);
+        head++;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    return count;
+}
+
+void IoUringAsyncIo::submit(const Request &request) {
+    // 没有空闲的请求槽位时, 先收割已完成的请求放到ready_中
+    while (free_slots_.empty()) {
+        flush();
+        enter(0, 1);
+        IoCompletion completion;
+        while (reap(&completion, 1) == 1) ready_.push_back(completion);
+    }
+    unsigned slot = free_slots_.back();
+    free_slots_.pop_back();
+    requests_[slot] = request;
+
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & *sq_mask_;
+    io_uring_sqe *sqe = &static_cast<io_uring_sqe *>(sqes_)[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = request.is_write ? IORING_OP_WRITE : IORING_OP_READ;
+    sqe->fd = request.fd;
+    sqe->off = request.offset;
+    sqe->addr = reinterpret_cast<uint64_t>(request.buf);
+    sqe->len = request.num_bytes;
+    sqe->user_data = slot;
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    to_submit_++;
+    in_flight_++;
+}
+
+void IoUringAsyncIo::submit_read(int fd, page_id_t page_no, char *buf, int num_bytes, uint64_t user_data) {
+    submit({fd, static_cast<off_t>(page_no) * num_bytes, buf, num_bytes, false, user_data});
+}
+
+void IoUringAsyncIo::submit_write(int fd, page_id_t page_no, const char *buf, int num_bytes, uint64_t user_data) {
+    submit({fd, static_cast<off_t>(page_no) * num_bytes, const_cast<char *>(buf), num_bytes, true, user_data});
+}
+
+/**
+ * @description: 把已经放入SQ的请求一次性交给内核
+ */
+void IoUringAsyncIo::flush() {
+    while (to_submit_ > 0) {
+        to_submit_ -= enter(to_submit_, 0);
+    }
+}
+
+/**
+ * @description: 收割已完成的请求
+ * @return {int} 收割的请求个数
+ * @param {IoCompletion*} completions 存放完成的请求
+ * @param {int} max_completions 最多收割的个数
+ * @param {int} min_completions 至少收割的个数, 在途请求不足时以在途请求数为准
+ */
+int IoUringAsyncIo::complete(IoCompletion *completions, int max_completions, int min_completions) {
+    flush();
+    int count = 0;
+    while (count < max_completions && !ready_.empty()) {
+        completions[count++] = ready_.front();
+        ready_.pop_front();
+    }
+    count += reap(completions + count, max_completions - count);
+    while (count < min_completions && count < max_completions && in_flight_ > static_cast<size_t>(count)) {
+        enter(0, 1);
+        count += reap(completions + count, max_completions - count);
+    }
+    in_flight_ -= count;
+    return count;
+}
+
+ThreadPoolAsyncIo::ThreadPoolAsyncIo(size_t queue_depth) : queue_depth_(std::max<size_t>(1, queue_depth)) {
+    size_t num_workers = std::min<size_t>(queue_depth_, ASYNC_IO_MAX_THREADS);
+    for (size_t i = 0; i < num_workers; i++) workers_.emplace_back(&ThreadPoolAsyncIo::worker, this);
+}
+
+ThreadPoolAsyncIo::~ThreadPoolAsyncIo() {
+    flush();
+    {
+        std::scoped_lock lock{latch_};
+        shutdown_ = true;
+    }
+    request_cv_.notify_all();
+    for (auto &worker : workers_) worker.join();
+}
+
+void ThreadPoolAsyncIo::worker() {
+    std::unique_lock<std::mutex> lock{latch_};
+    while (true) {
+        // 退出前把已经提交的请求做完
+        request_cv_.wait(lock, [&] { return shutdown_ || !requests_.empty(); });
+        if (requests_.empty()) return;
+        Request request = requests_.front();
+        requests_.pop_front();
+        lock.unlock();
+        int result = finish_short_io(request, 0);
+        lock.lock();
+        completions_.push_back({request.user_data, result});
+        completion_cv_.notify_one();
+    }
+}
+
+void ThreadPoolAsyncIo::submit(const Request &request) {
+    pending_.push_back(request);
+    in_flight_++;
+}
+
+void ThreadPoolAsyncIo::submit_read(int fd, page_id_t page_no, char *buf, int num_bytes, uint64_t user_data) {
+    submit({fd, static_cast<off_t>(page_no) * num_bytes, buf, num_bytes, false, user_data});
+}
+
+void ThreadPoolAsyncIo::submit_write(int fd, page_id_t page_no, const char *buf, int num_bytes,
+                                     uint64_t user_data) {
+    submit({fd, static_cast<off_t>(page_no) * num_bytes, const_cast<char *>(buf), num_bytes, true, user_data});
+}
+
+/**
+ * @description: 把排队的请求交给工作线程
+ */
+void ThreadPoolAsyncIo::flush() {
+    if (pending_.empty()) return;
+    {
+        std::scoped_lock lock{latch_};
+        requests_.insert(requests_.end(), pending_.begin(), pending_.end());
+    }
+    pending_.clear();
+    request_cv_.notify_all();
+}
+
+/**
+ * @description: 收割已完成的请求, 参数与IoUringAsyncIo::complete相同
+ */
+int ThreadPoolAsyncIo::complete(IoCompletion *completions, int max_completions, int min_completions) {
+    flush();
+    size_t wait_for = std::min<size_t>({static_cast<size_t>(std::max(min_completions, 0)),
+                                        static_cast<size_t>(max_completions), in_flight_});
+    std::unique_lock<std::mutex> lock{latch_};
+    completion_cv_.wait(lock, [&] { return completions_.size() >= wait_for; });
+    int count = 0;
+    while (count < max_completions && !completions_.empty()) {
+        completions[count++] = completions_.front();
+        completions_.pop_front();
+    }
+    in_flight_ -= count;
+    return count;
+}
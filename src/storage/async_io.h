@@ -0,0 +1,163 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/config.h"
+
+/**
+ * @description: 一个异步I/O请求完成后的结果
+ */
+struct IoCompletion {
+    uint64_t user_data;  // 提交请求时由调用者传入的标识
+    int result;          // 成功时为读写的字节数，失败时为-errno
+};
+
+/**
+ * @description: 页面的异步读写接口
+ * 调用者先用submit_read/submit_write把请求放入队列，flush把排队的请求一次性交给后端，
+ * 再用complete收割已经完成的请求; queue_depth是后端同时执行的请求数上限。
+ * 一个AsyncIo对象只能由一个线程使用，需要并发读写的线程各自创建自己的AsyncIo。
+ * 读到文件末尾时与DiskManager::read_page一样把剩余部分填0，短读写会在完成时同步补齐;
+ * 每个请求读写一个完整的页面, num_bytes即文件的页面大小, 页面从文件的page_no * num_bytes处开始
+ */
+class AsyncIo {
+   public:
+    virtual ~AsyncIo() = default;
+
+    virtual void submit_read(int fd, page_id_t page_no, char *buf, int num_bytes, uint64_t user_data) = 0;
+
+    virtual void submit_write(int fd, page_id_t page_no, const char *buf, int num_bytes, uint64_t user_data) = 0;
+
+    virtual void flush() = 0;
+
+    virtual int complete(IoCompletion *completions, int max_completions, int min_completions) = 0;
+
+    virtual size_t in_flight() const = 0;
+
+    virtual const char *backend_name() const = 0;
+
+    static std::unique_ptr<AsyncIo> create(size_t queue_depth, bool use_io_uring = ASYNC_IO_USE_IO_URING);
+
+   protected:
+    struct Request {
+        int fd;
+        off_t offset;
+        char *buf;
+        int num_bytes;
+        bool is_write;
+        uint64_t user_data;
+    };
+
+    static int finish_short_io(const Request &request, int result);
+};
+
+/**
+ * @description: 基于Linux io_uring的AsyncIo，直接使用io_uring_setup/io_uring_enter系统调用，不依赖liburing
+ */
+class IoUringAsyncIo : public AsyncIo {
+   public:
+    explicit IoUringAsyncIo(size_t queue_depth);
+
+    ~IoUringAsyncIo();
+
+    bool is_valid() const { return ring_fd_ >= 0; }
+
+    void submit_read(int fd, page_id_t page_no, char *buf, int num_bytes, uint64_t user_data) override;
+
+    void submit_write(int fd, page_id_t page_no, const char *buf, int num_bytes, uint64_t user_data) override;
+
+    void flush() override;
+
+    int complete(IoCompletion *completions, int max_completions, int min_completions) override;
+
+    size_t in_flight() const override { return in_flight_; }
+
+    const char *backend_name() const override { return "io_uring"; }
+
+   private:
+    void submit(const Request &request);
+
+    int enter(unsigned to_submit, unsigned min_complete);
+
+    int reap(IoCompletion *completions, int max_completions);
+
+    int ring_fd_ = -1;
+    unsigned sq_entries_ = 0;
+    unsigned cq_entries_ = 0;
+    size_t sq_ring_size_ = 0;
+    size_t cq_ring_size_ = 0;
+    void *sq_ring_ = nullptr;
+    void *cq_ring_ = nullptr;
+    void *sqes_ = nullptr;
+
+    // 映射到用户态的环形队列字段
+    unsigned *sq_tail_ = nullptr;
+    unsigned *sq_mask_ = nullptr;
+    unsigned *sq_array_ = nullptr;
+    unsigned *cq_head_ = nullptr;
+    unsigned *cq_tail_ = nullptr;
+    unsigned *cq_mask_ = nullptr;
+    void *cqes_ = nullptr;
+
+    unsigned to_submit_ = 0;            // 已经放入SQ但还没有交给内核的请求数
+    size_t in_flight_ = 0;              // 已提交但还没有被complete收割的请求数
+    std::vector<Request> requests_;     // 以SQ下标索引的请求, 用于处理短读写
+    std::vector<unsigned> free_slots_;  // 空闲的请求下标
+    std::deque<IoCompletion> ready_;    // 为腾出队列空间而提前收割的请求
+};
+
+/**
+ * @description: 没有io_uring时的AsyncIo，用一组工作线程执行pread/pwrite来模拟异步I/O
+ */
+class ThreadPoolAsyncIo : public AsyncIo {
+   public:
+    explicit ThreadPoolAsyncIo(size_t queue_depth);
+
+    ~ThreadPoolAsyncIo();
+
+    void submit_read(int fd, page_id_t page_no, char *buf, int num_bytes, uint64_t user_data) override;
+
+    void submit_write(int fd, page_id_t page_no, const char *buf, int num_bytes, uint64_t user_data) override;
+
+    void flush() override;
+
+    int complete(IoCompletion *completions, int max_completions, int min_completions) override;
+
+    size_t in_flight() const override { return in_flight_; }
+
+    const char *backend_name() const override { return "thread_pool"; }
+
+   private:
+    void submit(const Request &request);
+
+    void worker();
+
+    size_t queue_depth_;
+    size_t in_flight_ = 0;              // 已提交但还没有被complete收割的请求数, 只由调用线程访问
+    std::vector<Request> pending_;      // 等待flush的请求, 只由调用线程访问
+    std::mutex latch_;
+    std::condition_variable request_cv_;
+    std::condition_variable completion_cv_;
+    std::deque<Request> requests_;
+    std::deque<IoCompletion> completions_;
+    bool shutdown_ = false;
+    std::vector<std::thread> workers_;
+};
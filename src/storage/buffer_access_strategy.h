@@ -0,0 +1,66 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "page.h"
+
+/**
+ * @description: 一个缓冲池分区中属于某个BufferAccessStrategy的环形缓冲区, 记录通过该策略装入分区的页面
+ * 环满之后, 新的页面优先复用环中最早装入的页面所在的帧, 而不是让replacer淘汰其他页面
+ */
+struct BufferRing {
+    std::vector<PageId> pages;  // 环中的页面, 不超过capacity个
+    size_t capacity = 1;
+    size_t current = 0;         // 环满时下一个被复用的位置
+
+    bool full() const { return pages.size() == capacity; }
+
+    // 环满时返回下一个被复用的页面
+    const PageId &next_victim() const { return pages[current]; }
+
+    // 记录新装入的页面, 环满时替换next_victim()的位置
+    void push(PageId page_id) {
+        if (!full()) {
+            pages.push_back(page_id);
+            return;
+        }
+        pages[current] = page_id;
+        current = (current + 1) % capacity;
+    }
+};
+
+/**
+ * @description: 缓冲池访问策略, 大表的顺序扫描、批量导入和建索引等一次性访问大量页面的操作各自持有一个,
+ * 传给BufferPoolManager::fetch_page/new_page后, 这些操作装入的页面只在一个很小的私有环中循环使用帧,
+ * 不会把其他查询的热点页面(如B+树的内部结点)挤出缓冲池
+ * 环按缓冲池分区拆分, 每个分区ring_size/num_instances个帧; 一个策略对象只能由一个线程使用
+ */
+class BufferAccessStrategy {
+   private:
+    size_t ring_size_;
+    std::vector<BufferRing> rings_;  // 每个分区一个环, 第一次使用时根据分区个数创建
+
+   public:
+    explicit BufferAccessStrategy(size_t ring_size = BUFFER_RING_SIZE) : ring_size_(ring_size) {}
+
+    size_t get_ring_size() const { return ring_size_; }
+
+    BufferRing *get_ring(size_t instance_index, size_t num_instances) {
+        if (rings_.empty()) {
+            rings_.resize(num_instances);
+            for (auto &ring : rings_) ring.capacity = std::max<size_t>(1, ring_size_ / num_instances);
+        }
+        return &rings_[instance_index];
+    }
+};
@@ -0,0 +1,934 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "buffer_pool_instance.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @description: 从free_list或replacer中得到可淘汰帧页的 *frame_id
+ * @return {bool} true: 可替换帧查找成功 , false: 可替换帧查找失败
+ * @param {frame_id_t*} frame_id 帧页id指针,返回成功找到的可替换帧id
+ * @param {PageId*} writeback_page_id 被淘汰的页面为脏页时返回其PageId, 调用者需要在释放latch后将帧中的数据写回;
+ *        否则返回的page_no为INVALID_PAGE_ID
+ * @param {BufferRing*} ring 访问策略在当前分区的环, 环满时优先复用环中最早装入且没有被固定的页面所在的帧
+ */
+bool BufferPoolInstance::find_victim_page(frame_id_t *frame_id, PageId *writeback_page_id, BufferRing *ring)
+{
+    // Todo:
+    // 1 使用BufferPoolInstance::free_list_判断缓冲池是否已满需要淘汰页面
+    // 1.1 未满获得frame
+    // 1.2 已满使用lru_replacer中的方法选择淘汰页面
+    writeback_page_id->page_no = INVALID_PAGE_ID;
+    Page *page;
+    if (ring != nullptr && ring->full() && page_table_.find(ring->next_victim(), frame_id) &&
+        pages_[*frame_id]->pin_count_ == 0 && !retired(*frame_id))
+    {
+        // 环中的页面可能已经被其他线程淘汰或正在使用，此时退回到普通的淘汰方式
+        replacer_->remove(*frame_id);
+        page = pages_[*frame_id];
+    }
+    else
+    {
+        if (free_list_.size())
+        {
+            *frame_id = *(free_list_.begin());
+            free_list_.pop_front();
+            return true;
+        }
+
+        do
+        {
+            if (!replacer_->victim(frame_id))
+                return false;
+            page = pages_[*frame_id];
+            // 页面清理线程正在写回该帧，写完后会把它重新放回replacer; 正在腾空的帧留给drain_frames处理
+        } while (page->pin_count_ > 0 || retired(*frame_id));
+    }
+
+    PageId page_id = page->id_;
+    page_table_.erase(page_id);
+    if (page->is_dirty())
+    {
+        // 写回完成之前，其他线程fetch该页需要等待，否则会从磁盘读到旧的数据
+        *writeback_page_id = page_id;
+        writing_back_.push_back(page_id);
+    }
+
+    return true;
+}
+
+/**
+ * @description: 把帧装入新页面: 更新page table和page元数据(is_dirty, page_id, pin_count), 并将帧标记为正在进行I/O
+ *               帧中原有的数据保留不动, 以便调用者在释放latch后写回被淘汰的脏页
+ * @param {Page*} page 帧对应的页指针
+ * @param {PageId} new_page_id 新的page_id
+ * @param {frame_id_t} new_frame_id 新的帧frame_id
+ */
+void BufferPoolInstance::update_page(Page *page, PageId new_page_id, frame_id_t new_frame_id)
+{
+    page_table_.insert(new_page_id, new_frame_id);
+    replacer_->set_page(new_frame_id, new_page_id);
+
+    page->pin_count_ = 1;
+    page->is_dirty_ = false;
+    // 先使版本号变为奇数再修改页号, 不加latch的读者读到新页号时一定验证失败
+    page->bump_version();
+    page->id_ = new_page_id;
+    publish(page);
+    io_pending_[new_frame_id] = true;
+    read_ahead_mark_[new_frame_id] = false;
+    deallocate_pending_[new_frame_id] = false;
+}
+
+/**
+ * @description: 帧上的I/O完成, 唤醒等待该帧或等待写回的线程
+ * @param {frame_id_t} frame_id 完成I/O的帧
+ * @param {PageId} writeback_page_id 本次写回的脏页, page_no为INVALID_PAGE_ID表示没有写回
+ */
+void BufferPoolInstance::finish_io(frame_id_t frame_id, PageId writeback_page_id)
+{
+    pages_[frame_id]->bump_version();
+    io_pending_[frame_id] = false;
+    if (writeback_page_id.page_no != INVALID_PAGE_ID)
+        writing_back_.erase(std::find(writing_back_.begin(), writing_back_.end(), writeback_page_id));
+    io_cv_.notify_all();
+}
+
+/**
+ * @description: 帧上的I/O失败, 撤销对帧的装入; 已经在等待该帧的线程醒来后发现页号不符会自行放弃
+ * @param {frame_id_t} frame_id 发生错误的帧
+ * @param {PageId} writeback_page_id 本次写回的脏页
+ */
+void BufferPoolInstance::abort_io(frame_id_t frame_id, PageId writeback_page_id)
+{
+    Page *page = pages_[frame_id];
+    PageId page_id = page->id_;
+    page_table_.erase(page->id_);
+    page->id_ = {-1, INVALID_PAGE_ID};
+    finish_io(frame_id, writeback_page_id);
+    if (--page->pin_count_ == 0)
+    {
+        free_frame(frame_id);
+        if (deallocate_pending_[frame_id])
+        {
+            deallocate_pending_[frame_id] = false;
+            disk_manager_->deallocate_page(page_id.fd, page_id.page_no);
+        }
+    }
+}
+
+/**
+ * @description: 等待page_id的写回完成
+ */
+void BufferPoolInstance::wait_for_writeback(std::unique_lock<std::mutex> &lock, PageId page_id)
+{
+    auto written_back = [&] {
+        return std::find(writing_back_.begin(), writing_back_.end(), page_id) == writing_back_.end();
+    };
+    if (written_back())
+        return;
+    count(page_id, &BufferPoolCounters::pin_waits);
+    io_cv_.wait(lock, written_back);
+}
+
+/**
+ * @description: 记录帧中原有页面的淘汰, 在update_page之前调用; 空闲帧中没有页面, 不计数
+ * @param {Page*} page find_victim_page选出的帧
+ * @param {PageId} writeback_page_id find_victim_page返回的需要写回的脏页
+ */
+void BufferPoolInstance::count_eviction(Page *page, PageId writeback_page_id)
+{
+    if (page->id_.page_no == INVALID_PAGE_ID)
+        return;
+    count(page->id_, &BufferPoolCounters::evictions);
+    if (writeback_page_id.page_no != INVALID_PAGE_ID)
+        count(writeback_page_id, &BufferPoolCounters::writebacks);
+}
+
+/**
+ * @description: 乐观读者获取已经读入缓冲池的页面: 不加latch, 不pin页面, 也不访问replacer,
+ *               只在提示表peek_table_中查一次, 读出帧的版本号后检查帧中是否为目标页
+ * @return {Page*} 页面所在的帧; 页面不在提示表中、正在读入或正被加写latch时返回nullptr, 由调用者改用fetch_page
+ * @param {PageId} page_id 需要获取的页的PageId
+ * @param {uint64_t*} version 帧的版本号, 返回帧时一定为偶数
+ * @note 返回之后帧随时可能被淘汰并装入其他页面, 调用者读完帧的内容后必须用version验证;
+ *       帧的Page对象不会被释放(见spare_chunks_), 读到的内容不一致时验证一定失败;
+ *       不修改任何共享状态, 这样的命中不计入访问计数
+ */
+Page *BufferPoolInstance::peek_page(PageId page_id, uint64_t *version)
+{
+    Page *page = peek_table_.load(std::memory_order_acquire)->slot(page_id).load(std::memory_order_acquire);
+    // 缓冲池改变帧中的页面时先使版本号变为奇数再修改页号, 读出偶数版本号之后读到的页号若被修改, 验证一定失败
+    if (page == nullptr || !page->read_version(version) || !(page->id_ == page_id))
+        return nullptr;
+    return page;
+}
+
+/**
+ * @description: 从buffer pool获取需要的页。
+ *              如果页表中存在page_id（说明该page在缓冲池中），并且pin_count++。
+ *              如果页表不存在page_id（说明该page在磁盘中），则找缓冲池victim page，将其替换为磁盘中读取的page，pin_count置1。
+ * @return {Page*} 若获得了需要的页则将其返回，否则返回nullptr
+ * @param {PageId} page_id 需要获取的页的PageId
+ * @param {bool*} read_ahead_trigger 不为nullptr时, 若目标页需要从磁盘读取或者是预读标记页则置为true,
+ *        由BufferPoolManager据此检测顺序访问; 缓冲池命中普通页面时不修改
+ * @param {BufferRing*} ring 不为nullptr时, 目标页需要从磁盘读取时在环中选择帧, 并把目标页加入环
+ * @note 脏页的写回和目标页的读取都在释放latch之后进行, 期间帧处于io_pending_状态, 其他线程fetch同一页面时等待I/O完成
+ */
+Page *BufferPoolInstance::fetch_page(PageId page_id, bool *read_ahead_trigger, BufferRing *ring)
+{
+    //  1.     从page_table_中搜寻目标页
+    //  1.1    若目标页有被page_table_记录，则将其所在frame固定(pin)，等待其I/O完成后返回目标页。
+    //  1.2    否则，尝试调用find_victim_page获得一个可用的frame，若失败则返回nullptr
+    //  2.     更新页表并固定目标页，释放latch
+    //  3.     若获得的可用frame存储的为dirty page，将其写回磁盘，再调用disk_manager_的read_page读取目标页到frame
+    //  4.     重新获得latch，结束I/O并返回目标页
+
+    std::unique_lock<std::mutex> lock{page_lock};
+    frame_id_t frame_id;
+    if (!page_table_.find(page_id, &frame_id))
+    {
+        // 该页的脏数据可能还在写回，等写回完成后再查一次页表(等待期间可能已被其他线程装入)
+        wait_for_writeback(lock, page_id);
+    }
+
+    if (page_table_.find(page_id, &frame_id))
+    {
+        Page *page = pages_[frame_id];
+        replacer_->pin(frame_id);
+        page->pin_count_++;
+        count(page_id, &BufferPoolCounters::hits);
+        // 提示表中的槽位可能已被冲突的页面占用, 重新登记, 之后的乐观读者可以不加latch找到它
+        publish(page);
+        if (read_ahead_mark_[frame_id])
+        {
+            read_ahead_mark_[frame_id] = false;
+            if (read_ahead_trigger)
+                *read_ahead_trigger = true;
+        }
+        if (io_pending_[frame_id])
+        {
+            count(page_id, &BufferPoolCounters::pin_waits);
+            io_cv_.wait(lock, [&] { return !io_pending_[frame_id]; });
+            if (!(page->id_ == page_id))
+            {
+                // 装入该页的线程读盘失败
+                if (--page->pin_count_ == 0)
+                    free_frame(frame_id);
+                return nullptr;
+            }
+        }
+        return page;
+    }
+
+    PageId writeback_page_id;
+    if (!find_victim_page(&frame_id, &writeback_page_id, ring))
+        return nullptr;
+    Page *page = pages_[frame_id];
+    count(page_id, &BufferPoolCounters::misses);
+    count_eviction(page, writeback_page_id);
+    update_page(page, page_id, frame_id);
+    replacer_->pin(frame_id);
+    if (ring != nullptr)
+        ring->push(page_id);
+    lock.unlock();
+    if (read_ahead_trigger)
+        *read_ahead_trigger = true;
+
+    try
+    {
+        if (writeback_page_id.page_no != INVALID_PAGE_ID)
+            disk_manager_->write_page(writeback_page_id.fd, writeback_page_id.page_no, page->data_, page_size_);
+        disk_manager_->read_page(page_id.fd, page_id.page_no, page->data_, page_size_);
+    }
+    catch (...)
+    {
+        lock.lock();
+        abort_io(frame_id, writeback_page_id);
+        throw;
+    }
+
+    lock.lock();
+    finish_io(frame_id, writeback_page_id);
+    return page;
+}
+
+/**
+ * @description: 取消固定pin_count>0的在缓冲池中的page
+ * @return {bool} 如果目标页的pin_count<=0则返回false，否则返回true
+ * @param {PageId} page_id 目标page的page_id
+ * @param {bool} is_dirty 若目标page应该被标记为dirty则为true，否则为false
+ */
+bool BufferPoolInstance::unpin_page(PageId page_id, bool is_dirty)
+{
+    // Todo:
+    // 0. lock latch
+    // 1. 尝试在page_table_中搜寻page_id对应的页P
+    // 1.1 P在页表中不存在 return false
+    // 1.2 P在页表中存在，获取其pin_count_
+    // 2.1 若pin_count_已经等于0，则返回false
+    // 2.2 若pin_count_大于0，则pin_count_自减一
+    // 2.2.1 若自减后等于0，则调用replacer_的Unpin
+    // 3 根据参数is_dirty，更改P的is_dirty_
+    std::scoped_lock lock{page_lock};
+    frame_id_t frame_id;
+    if (!page_table_.find(page_id, &frame_id))
+        return false;
+    Page *page = pages_[frame_id];
+
+    int &pin_count = page->pin_count_;
+    if (!pin_count)
+        return false;
+
+    pin_count--;
+
+    if (!page->is_dirty())
+        page->is_dirty_ = is_dirty;
+    if (!pin_count)
+        release_frame(frame_id);
+
+    return true;
+}
+
+/**
+ * @description: 将目标页写回磁盘，不考虑当前页面是否正在被使用
+ * @return {bool} 成功则返回true，否则返回false(只有page_table_中没有目标页时)
+ * @param {PageId} page_id 目标页的page_id，不能为INVALID_PAGE_ID
+ */
+bool BufferPoolInstance::flush_page(PageId page_id, bool is_locked)
+{
+    // Todo:
+    // 0. lock latch
+    // 1. 查找页表,尝试获取目标页P
+    // 1.1 目标页P没有被page_table_记录 ，返回false
+    // 2. 无论P是否为脏都将其写回磁盘。
+    // 3. 更新P的is_dirty_
+    std::unique_lock<std::mutex> lock(page_lock, std::defer_lock);
+    if (!is_locked) lock.lock();
+    frame_id_t frame_id;
+    if (!page_table_.find(page_id, &frame_id))
+        return false;
+    if (io_pending_[frame_id])
+    {
+        // 页面还没有读入，帧中不是该页的数据
+        if (is_locked)
+            return false;
+        io_cv_.wait(lock, [&] { return !io_pending_[frame_id]; });
+        if (!page_table_.find(page_id, &frame_id))
+            return false;
+    }
+    Page *page = pages_[frame_id];
+    disk_manager_->write_page(page_id.fd, page_id.page_no, page->data_, page_size_);
+    if (page->is_dirty_)
+        count(page_id, &BufferPoolCounters::writebacks);
+    page->is_dirty_ = false;
+
+    return true;
+}
+
+/**
+ * @description: 创建一个新的page，即从磁盘中移动一个新建的空page到缓冲池某个位置。
+ * @return {Page*} 返回新创建的page，若创建失败则返回nullptr
+ * @param {PageId*} page_id 当成功创建一个新的page时存储其page_id
+ * @param {bool} preallocated 为true时说明页号已经由BufferPoolManager分配好, 直接装入page_id指定的页
+ * @param {BufferRing*} ring 不为nullptr时在环中选择帧, 并把新页面加入环
+ */
+Page *BufferPoolInstance::new_page(PageId *page_id, bool preallocated, BufferRing *ring)
+{
+    // 1.   获得一个可用的frame，若无法获得则返回nullptr
+    // 2.   在fd对应的文件分配一个新的page_id
+    // 3.   将frame的数据写回磁盘
+    // 4.   固定frame，更新pin_count_
+    // 5.   返回获得的page
+
+    std::unique_lock<std::mutex> lock{page_lock};
+    if (!preallocated)
+        *page_id = {page_id->fd, disk_manager_->allocate_page(page_id->fd)};
+    if (Page *page = fetch_reused_page(lock, *page_id))
+        return page;
+
+    frame_id_t frame_id;
+    PageId writeback_page_id;
+    if (!find_victim_page(&frame_id, &writeback_page_id, ring))
+    {
+        disk_manager_->deallocate_page(page_id->fd, page_id->page_no);
+        return nullptr;
+    }
+
+    Page *page = pages_[frame_id];
+    count_eviction(page, writeback_page_id);
+    update_page(page, *page_id, frame_id);
+    replacer_->pin(frame_id);
+    if (ring != nullptr)
+        ring->push(*page_id);
+
+    if (writeback_page_id.page_no != INVALID_PAGE_ID)
+    {
+        lock.unlock();
+        try
+        {
+            disk_manager_->write_page(writeback_page_id.fd, writeback_page_id.page_no, page->data_, page_size_);
+        }
+        catch (...)
+        {
+            lock.lock();
+            abort_io(frame_id, writeback_page_id);
+            throw;
+        }
+        lock.lock();
+    }
+
+    page->reset_memory();
+    finish_io(frame_id, writeback_page_id);
+
+    return page;
+}
+
+/**
+ * @description: 新建页面时, 复用的空闲页面可能还有旧的副本在缓冲池中(被顺序扫描或预读读入), 此时直接使用这个帧
+ * @return {Page*} 已固定并清零的帧, 页面不在缓冲池中时返回nullptr
+ * @param {PageId} page_id 新建页面的页号
+ */
+Page *BufferPoolInstance::fetch_reused_page(std::unique_lock<std::mutex> &lock, PageId page_id)
+{
+    wait_for_writeback(lock, page_id);
+    frame_id_t frame_id;
+    if (!page_table_.find(page_id, &frame_id))
+        return nullptr;
+
+    Page *page = pages_[frame_id];
+    replacer_->pin(frame_id);
+    page->pin_count_++;
+    read_ahead_mark_[frame_id] = false;
+    if (io_pending_[frame_id])
+    {
+        io_cv_.wait(lock, [&] { return !io_pending_[frame_id]; });
+        if (!(page->id_ == page_id))
+        {
+            if (--page->pin_count_ == 0)
+                free_frame(frame_id);
+            return nullptr;
+        }
+    }
+    // 页面已被删除后重新分配, 之前的乐观读者必须验证失败
+    page->bump_version();
+    page->reset_memory();
+    page->bump_version();
+    return page;
+}
+
+/**
+ * @description: 从当前分区删除目标页
+ * @return {bool} 如果目标页不存在于当前分区或者成功被删除则返回true，若其存在于当前分区但无法删除则返回false
+ * @param {PageId} page_id 目标页
+ */
+bool BufferPoolInstance::delete_page(PageId page_id)
+{
+    // 1.   在page_table_中查找目标页，若不存在返回true
+    // 2.   若目标页的pin_count不为0，则返回false
+    // 3.   将目标页数据写回磁盘，从页表中删除目标页，重置其元数据，将其加入free_list_，返回true
+    std::scoped_lock lock{page_lock};
+    frame_id_t frame_id;
+    if (!page_table_.find(page_id, &frame_id))
+        return true;
+
+    Page *page = pages_[frame_id];
+
+    if (page->pin_count_)
+        return false;
+
+    flush_page(page_id, true);
+
+    page_table_.erase(page_id);
+    // 帧回到free_list_，需同时从replacer中移除，避免同一帧既能被victim又能从free_list_取出
+    replacer_->remove(frame_id);
+    free_frame(frame_id);
+
+    page->bump_version();
+    page->id_ = {-1, INVALID_PAGE_ID};
+    page->is_dirty_ = false;
+    page->reset_memory();
+    page->bump_version();
+
+    return true;
+}
+
+/**
+ * @description: 删除不再使用的页面, 并把它交还给磁盘管理器复用
+ * @param {PageId} page_id 目标页
+ * @note 页面仍被固定时(例如乐观下降的读者刚刚固定了它)不能立即删除, 记录下来, 最后一个固定释放时再删除并交还;
+ *       在此之前磁盘管理器不会把该页面分配出去, 不会有两个使用者共用一个页面, 页面也不会泄漏
+ */
+void BufferPoolInstance::deallocate_page(PageId page_id)
+{
+    std::unique_lock<std::mutex> lock{page_lock};
+    // 页面正在被写回时等待写回完成, 以免交还之后旧的写回覆盖复用该页面的新数据
+    wait_for_writeback(lock, page_id);
+    frame_id_t frame_id;
+    if (!page_table_.find(page_id, &frame_id))
+    {
+        disk_manager_->deallocate_page(page_id.fd, page_id.page_no);
+        return;
+    }
+    if (pages_[frame_id]->pin_count_ > 0)
+    {
+        deallocate_pending_[frame_id] = true;
+        return;
+    }
+    discard_page(frame_id);
+}
+
+/**
+ * @description: 帧的最后一个固定被释放: 页面等待删除时删除并交还给磁盘管理器, 否则把帧放回replacer
+ * @param {frame_id_t} frame_id pin_count_刚刚降为0的帧
+ */
+void BufferPoolInstance::release_frame(frame_id_t frame_id)
+{
+    if (deallocate_pending_[frame_id])
+        discard_page(frame_id);
+    else
+        replacer_->unpin(frame_id);
+}
+
+/**
+ * @description: 丢弃未被固定的帧中已被删除的页面, 不写回页面数据, 帧放回free_list_, 页面交还给磁盘管理器
+ * @param {frame_id_t} frame_id 目标帧
+ */
+void BufferPoolInstance::discard_page(frame_id_t frame_id)
+{
+    Page *page = pages_[frame_id];
+    PageId page_id = page->id_;
+    page_table_.erase(page_id);
+    replacer_->remove(frame_id);
+    free_frame(frame_id);
+
+    page->bump_version();
+    page->id_ = {-1, INVALID_PAGE_ID};
+    page->is_dirty_ = false;
+    page->reset_memory();
+    page->bump_version();
+    deallocate_pending_[frame_id] = false;
+    disk_manager_->deallocate_page(page_id.fd, page_id.page_no);
+}
+
+/**
+ * @description: 页面清理：把未被固定的脏页写回磁盘，使当前分区中干净的可淘汰帧不少于target个
+ * @return {size_t} 写回的页面个数
+ * @param {size_t} target 希望保持的干净可淘汰帧(包括空闲帧)的个数
+ * @param {size_t} max_pages 本次最多写回的页面个数
+ * @note 按page LSN从小到大选出需要写回的脏页，即先写最早修改的页面；写回期间帧被清理线程固定(只增加pin_count_，
+ *       不经过replacer，以免干扰LRU-K/2Q的访问历史)，find_victim_page会跳过这些帧；
+ *       选出的页面按页号排序后，页号连续的一段用一次write_pages写回
+ */
+size_t BufferPoolInstance::clean_pages(size_t target, size_t max_pages)
+{
+    std::unique_lock<std::mutex> lock{page_lock};
+    size_t clean = free_list_.size();
+    std::vector<Page *> dirty;
+    for (size_t i = 0; i < pages_.size(); i++)
+    {
+        Page *page = pages_[i];
+        if (page->pin_count_ > 0 || page->id_.page_no == INVALID_PAGE_ID)
+            continue;
+        if (page->is_dirty_)
+            dirty.push_back(page);
+        else
+            clean++;
+    }
+    if (clean >= target || dirty.empty())
+        return 0;
+
+    size_t num_pages = std::min({target - clean, max_pages, dirty.size()});
+    std::partial_sort(dirty.begin(), dirty.begin() + num_pages, dirty.end(),
+                      [](Page *a, Page *b) { return a->get_page_lsn() < b->get_page_lsn(); });
+    dirty.resize(num_pages);
+    for (Page *page : dirty)
+    {
+        page->pin_count_++;
+        page->is_dirty_ = false;
+    }
+    return write_back_pinned_pages(lock, dirty);
+}
+
+/**
+ * @description: 释放latch写回一组已被固定并清除了脏标记的页面, 写完后重新获得latch并释放对帧的固定
+ * @return {size_t} 写回的页面个数
+ * @param {unique_lock<mutex>&} lock 调用时持有的latch
+ * @param {vector<Page*>&} pages 要写回的页面, 会被重新排序
+ * @note 页面按页号排序后，页号连续的一段用一次write_pages写回, 写回期间对这一段页面加读latch;
+ *       写回失败时没有写成功的页面重新标记为脏页
+ * 调用者只选择pin_count_为0的页面, 没有线程持有它们的latch, 加读latch时最多等待之后才pin住页面的写者
+ */
+size_t BufferPoolInstance::write_back_pinned_pages(std::unique_lock<std::mutex> &lock, std::vector<Page *> &pages)
+{
+    lock.unlock();
+    std::sort(pages.begin(), pages.end(), [](const Page *a, const Page *b) {
+        return a->id_.fd != b->id_.fd ? a->id_.fd < b->id_.fd : a->id_.page_no < b->id_.page_no;
+    });
+    size_t written = 0;
+    std::vector<char *> run;
+    try
+    {
+        for (size_t i = 0; i < pages.size(); i++)
+        {
+            // 写回期间持有页面的读latch, 其他线程此时不能修改页面, 否则磁盘上可能留下修改了一半的页面
+            pages[i]->r_latch();
+            run.push_back(pages[i]->data_);
+            if (i + 1 == pages.size() || pages[i + 1]->id_.fd != pages[i]->id_.fd ||
+                pages[i + 1]->id_.page_no != pages[i]->id_.page_no + 1)
+            {
+                size_t first = i + 1 - run.size();
+                page_id_t start_page_no = pages[i]->id_.page_no - static_cast<page_id_t>(run.size()) + 1;
+                try
+                {
+                    disk_manager_->write_pages(pages[i]->id_.fd, start_page_no, run.data(), static_cast<int>(run.size()));
+                }
+                catch (...)
+                {
+                    for (size_t j = first; j <= i; j++)
+                        pages[j]->r_unlatch();
+                    throw;
+                }
+                for (size_t j = first; j <= i; j++)
+                    pages[j]->r_unlatch();
+                written += run.size();
+                run.clear();
+            }
+        }
+    }
+    catch (...)
+    {
+        lock.lock();
+        for (size_t i = written; i < pages.size(); i++)
+            pages[i]->is_dirty_ = true;
+        release_cleaned_pages(pages, written);
+        throw;
+    }
+
+    lock.lock();
+    release_cleaned_pages(pages, written);
+    return written;
+}
+
+/**
+ * @description: 释放页面清理线程对帧的固定，pin_count_降为0时把帧放回replacer
+ * @param {size_t} written pages中前written个页面已经写回磁盘
+ */
+void BufferPoolInstance::release_cleaned_pages(const std::vector<Page *> &pages, size_t written)
+{
+    for (size_t i = 0; i < written; i++)
+        count(pages[i]->id_, &BufferPoolCounters::writebacks);
+    for (Page *page : pages)
+    {
+        frame_id_t frame_id;
+        if (--page->pin_count_ == 0 && page_table_.find(page->id_, &frame_id))
+            release_frame(frame_id);
+    }
+}
+
+/**
+ * @description: 为预读page_id准备一个帧: 更新页表并将帧标记为正在进行I/O, 由调用者异步读入数据后调用end_read_ahead
+ * @return {Page*} 准备好的帧; 页面已在缓冲池中、正在写回或者没有干净的可用帧时返回nullptr
+ * @param {PageId} page_id 要预读的页面
+ * @param {bool} mark 是否把该页设为预读标记页
+ * @note 预读只使用空闲帧或干净的淘汰帧, 不为预读同步写回脏页; 帧只通过pin_count_固定, 不经过replacer,
+ *       预读的页面在被真正访问之前不算作一次访问
+ */
+Page *BufferPoolInstance::begin_read_ahead(PageId page_id, bool mark)
+{
+    std::scoped_lock lock{page_lock};
+    frame_id_t frame_id;
+    if (page_table_.find(page_id, &frame_id) ||
+        std::find(writing_back_.begin(), writing_back_.end(), page_id) != writing_back_.end())
+        return nullptr;
+
+    PageId writeback_page_id;
+    if (!find_victim_page(&frame_id, &writeback_page_id))
+        return nullptr;
+    Page *page = pages_[frame_id];
+    if (writeback_page_id.page_no != INVALID_PAGE_ID)
+    {
+        // 淘汰的是脏页, 把它原样放回, 留给页面清理线程写回
+        writing_back_.pop_back();
+        page_table_.insert(writeback_page_id, frame_id);
+        replacer_->unpin(frame_id);
+        return nullptr;
+    }
+
+    count_eviction(page, writeback_page_id);
+    update_page(page, page_id, frame_id);
+    read_ahead_mark_[frame_id] = mark;
+    return page;
+}
+
+/**
+ * @description: 预读的I/O完成, 释放begin_read_ahead对帧的固定
+ * @param {Page*} page begin_read_ahead返回的帧
+ * @param {bool} success 读盘是否成功, 失败时撤销对帧的装入
+ */
+void BufferPoolInstance::end_read_ahead(Page *page, bool success)
+{
+    std::scoped_lock lock{page_lock};
+    frame_id_t frame_id;
+    // 帧在I/O完成前一直被固定且处于io_pending_状态, 不会被淘汰或删除, 页表中一定能找到
+    bool found = page_table_.find(page->id_, &frame_id);
+    assert(found);
+    if (!found)
+        return;
+    PageId no_writeback = {-1, INVALID_PAGE_ID};
+    if (!success)
+    {
+        abort_io(frame_id, no_writeback);
+        return;
+    }
+    finish_io(frame_id, no_writeback);
+    if (--page->pin_count_ == 0)
+        release_frame(frame_id);
+}
+
+/**
+ * @description: 将当前分区中属于文件fd的所有页写回到磁盘
+ * @param {int} fd 文件句柄
+ * @note 页面按页号排序后，页号连续的一段页面用一次write_pages写回
+ */
+void BufferPoolInstance::flush_all_pages(int fd)
+{
+    std::scoped_lock lock{page_lock};
+    std::vector<Page *> pages;
+    for (size_t i = 0; i < pages_.size(); i++)
+    {
+        Page *page = pages_[i];
+        if (page->id_.page_no != INVALID_PAGE_ID && page->id_.fd == fd && !io_pending_[i])
+            pages.push_back(page);
+    }
+    std::sort(pages.begin(), pages.end(),
+              [](const Page *a, const Page *b) { return a->id_.page_no < b->id_.page_no; });
+
+    std::vector<char *> run;
+    for (size_t i = 0; i < pages.size(); i++)
+    {
+        run.push_back(pages[i]->data_);
+        if (pages[i]->is_dirty_)
+            count(pages[i]->id_, &BufferPoolCounters::writebacks);
+        pages[i]->is_dirty_ = false;
+        if (i + 1 == pages.size() || pages[i + 1]->id_.page_no != pages[i]->id_.page_no + 1)
+        {
+            page_id_t start_page_no = pages[i]->id_.page_no - static_cast<page_id_t>(run.size()) + 1;
+            disk_manager_->write_pages(fd, start_page_no, run.data(), static_cast<int>(run.size()));
+            run.clear();
+        }
+    }
+}
+
+/**
+ * @description: 获取当前分区的统计快照
+ */
+BufferPoolInstanceStats BufferPoolInstance::get_stats()
+{
+    std::scoped_lock lock{page_lock};
+    BufferPoolInstanceStats stats;
+    stats.pool_size = get_pool_size();
+    stats.page_size = page_size_;
+    stats.used_frames = page_table_.size();
+    for (size_t i = 0; i < pages_.size(); i++)
+    {
+        if (pages_[i]->is_dirty_)
+            stats.dirty_frames++;
+    }
+    stats.counters = counters_;
+    stats.file_counters = file_counters_;
+    return stats;
+}
+
+/**
+ * @description: 清空文件fd的访问计数
+ * @param {int} fd 文件句柄
+ * @note 文件关闭后文件句柄可能分配给之后打开的其他文件, 关闭文件时需要清空, 否则计数会算到新文件上
+ */
+void BufferPoolInstance::reset_file_counters(int fd)
+{
+    std::scoped_lock lock{page_lock};
+    if (fd >= 0 && static_cast<size_t>(fd) < file_counters_.size())
+        file_counters_[fd] = BufferPoolCounters();
+}
+
+/**
+ * @description: 获取当前分区中已经读入的页面, 正在读入的页面不计入
+ * @param {vector<PageId>*} page_ids 页面追加到page_ids的末尾
+ */
+void BufferPoolInstance::get_resident_pages(std::vector<PageId> *page_ids)
+{
+    std::scoped_lock lock{page_lock};
+    for (size_t i = 0; i < pages_.size(); i++)
+    {
+        if (pages_[i]->id_.page_no != INVALID_PAGE_ID && !io_pending_[i])
+            page_ids->push_back(pages_[i]->id_);
+    }
+}
+
+/**
+ * @description: 扩大当前分区: 先复用缩小时留下的块, 不够时在latch之外按块申请新的帧, 再把它们加入free_list_
+ * @param {size_t} pool_size 新的帧数, 不小于当前的帧数; 调用者保证没有正在进行的缩小
+ */
+void BufferPoolInstance::grow(size_t pool_size)
+{
+    // 不论帧的大小, 每块的字节数相同
+    size_t chunk_size = std::max<size_t>(1, BUFFER_POOL_CHUNK_SIZE * PAGE_SIZE / page_size_);
+    std::vector<std::unique_ptr<FrameChunk>> chunks;
+    size_t num_frames = get_pool_size();
+    {
+        // 优先复用缩小时留下的块
+        std::scoped_lock lock{page_lock};
+        while (!spare_chunks_.empty() && num_frames + spare_chunks_.back()->size <= pool_size)
+        {
+            num_frames += spare_chunks_.back()->size;
+            chunks.push_back(std::move(spare_chunks_.back()));
+            spare_chunks_.pop_back();
+        }
+    }
+    for (; num_frames < pool_size; num_frames += chunks.back()->size)
+        chunks.push_back(std::make_unique<FrameChunk>(std::min(chunk_size, pool_size - num_frames), page_size_));
+
+    std::scoped_lock lock{page_lock};
+    for (auto &chunk : chunks)
+    {
+        for (size_t i = 0; i < chunk->size; i++)
+        {
+            chunk->pages[i].data_ = chunk->memory.data() + i * page_size_;
+            chunk->pages[i].page_size_ = page_size_;
+            free_list_.push_back(static_cast<frame_id_t>(pages_.size()));
+            pages_.push_back(&chunk->pages[i]);
+        }
+        chunks_.push_back(std::move(chunk));
+    }
+    io_pending_.resize(pages_.size(), false);
+    read_ahead_mark_.resize(pages_.size(), false);
+    deallocate_pending_.resize(pages_.size(), false);
+    replacer_->resize(pages_.size());
+    page_table_.resize(pages_.size());
+    // 提示表太小时换一张更大的表并登记已装入的页面; 旧表留到析构时释放, 正在查找的读者仍可使用
+    PeekTable *peek_table = peek_table_.load(std::memory_order_relaxed);
+    if (peek_table == nullptr || peek_table->mask + 1 < pages_.size() * 2)
+    {
+        auto table = std::make_unique<PeekTable>(pages_.size());
+        for (Page *page : pages_)
+        {
+            if (page->id_.page_no != INVALID_PAGE_ID)
+                table->slot(page->id_).store(page, std::memory_order_relaxed);
+        }
+        peek_table_.store(table.get(), std::memory_order_release);
+        peek_tables_.push_back(std::move(table));
+    }
+    pool_size_ = pages_.size();
+}
+
+/**
+ * @description: 开始缩小当前分区: 末尾若干块中的帧不再装入新的页面, 之后由drain_frames把它们腾空并释放
+ * @return {size_t} 缩小后的帧数; 只能整块地释放帧, 因此不小于pool_size, 且至少保留一块
+ * @param {size_t} pool_size 希望缩小到的帧数
+ */
+size_t BufferPoolInstance::begin_shrink(size_t pool_size)
+{
+    std::scoped_lock lock{page_lock};
+    size_t num_frames = pages_.size();
+    for (size_t i = chunks_.size() - 1; i > 0 && num_frames - chunks_[i]->size >= pool_size; i--)
+        num_frames -= chunks_[i]->size;
+    pool_size_ = num_frames;
+    free_list_.remove_if([&](frame_id_t frame_id) { return retired(frame_id); });
+    return num_frames;
+}
+
+/**
+ * @description: 腾空缩小分区时退出的帧: 淘汰未被固定的干净页面, 写回未被固定的脏页;
+ *               被固定或正在I/O的帧留到下一次调用, 所有帧都腾空后释放它们所在的块的内存
+ * @return {bool} 退出的帧已经全部释放时返回true
+ * @note 退出的帧中的页面在腾空之前仍然可以被访问, 只是被淘汰之后会装入其他帧
+ */
+bool BufferPoolInstance::drain_frames()
+{
+    std::unique_lock<std::mutex> lock{page_lock};
+    bool drained = true;
+    std::vector<Page *> dirty;
+    for (size_t i = get_pool_size(); i < pages_.size(); i++)
+    {
+        Page *page = pages_[i];
+        if (page->id_.page_no == INVALID_PAGE_ID)
+            continue;
+        if (page->pin_count_ > 0 || io_pending_[i])
+        {
+            drained = false;
+            continue;
+        }
+        if (page->is_dirty_)
+        {
+            // 与页面清理线程一样固定帧并在latch之外写回, 下一次调用时再淘汰
+            page->pin_count_++;
+            page->is_dirty_ = false;
+            dirty.push_back(page);
+            drained = false;
+            continue;
+        }
+        count(page->id_, &BufferPoolCounters::evictions);
+        page_table_.erase(page->id_);
+        replacer_->remove(static_cast<frame_id_t>(i));
+        // 块的内存释放后读到的是全0, 之前的乐观读者必须验证失败
+        page->bump_version();
+        page->id_ = {-1, INVALID_PAGE_ID};
+        page->bump_version();
+    }
+    if (!dirty.empty())
+        write_back_pinned_pages(lock, dirty);
+    if (!drained)
+        return false;
+
+    // 块的内存在latch之外交还给操作系统, Page对象留在spare_chunks_中
+    std::vector<std::unique_ptr<FrameChunk>> chunks;
+    while (pages_.size() > get_pool_size())
+    {
+        pages_.resize(pages_.size() - chunks_.back()->size);
+        chunks.push_back(std::move(chunks_.back()));
+        chunks_.pop_back();
+    }
+    io_pending_.resize(pages_.size());
+    read_ahead_mark_.resize(pages_.size());
+    deallocate_pending_.resize(pages_.size());
+    replacer_->resize(pages_.size());
+    page_table_.resize(pages_.size());
+    lock.unlock();
+    for (auto &chunk : chunks)
+        chunk->memory.release();
+    lock.lock();
+    for (auto &chunk : chunks)
+        spare_chunks_.push_back(std::move(chunk));
+    return true;
+}
+
+/**
+ * @description: 放弃缩小当前分区: 还没有释放的帧重新变为可用, 空闲的帧放回free_list_,
+ *               装有未被固定页面的帧放回replacer(replacer在淘汰时已经把跳过的退出帧移除)
+ */
+void BufferPoolInstance::cancel_shrink()
+{
+    std::scoped_lock lock{page_lock};
+    for (size_t i = get_pool_size(); i < pages_.size(); i++)
+    {
+        frame_id_t frame_id = static_cast<frame_id_t>(i);
+        if (pages_[i]->id_.page_no == INVALID_PAGE_ID)
+            free_list_.push_back(frame_id);
+        else if (pages_[i]->pin_count_ == 0 && !io_pending_[i])
+            replacer_->unpin(frame_id);
+    }
+    pool_size_ = pages_.size();
+}
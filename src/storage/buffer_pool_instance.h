@@ -0,0 +1,200 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "buffer_access_strategy.h"
+#include "buffer_pool_stats.h"
+#include "disk_manager.h"
+#include "errors.h"
+#include "frame_memory.h"
+#include "page.h"
+#include "page_table.h"
+#include "replacer/clock_replacer.h"
+#include "replacer/lru_k_replacer.h"
+#include "replacer/lru_replacer.h"
+#include "replacer/replacer.h"
+#include "replacer/two_queue_replacer.h"
+
+/**
+ * @description: 缓冲池的一个分区, 拥有独立的页表、空闲帧链表、替换策略和latch
+ * BufferPoolManager根据PageId的哈希值把页面分配到某个分区, 不同分区之间的操作互不阻塞
+ */
+class BufferPoolInstance {
+   private:
+    // 帧按块申请和释放, 一块最多BUFFER_POOL_CHUNK_SIZE * PAGE_SIZE字节, 改变缓冲池大小时整块地增加或删除
+    struct FrameChunk {
+        FrameMemory memory;             // 块中各帧的数据
+        std::unique_ptr<Page[]> pages;  // 块中各帧的Page对象
+        size_t size;                    // 块中帧的个数
+
+        FrameChunk(size_t size, int page_size)
+            : memory(size * page_size, BUFFER_POOL_HUGE_PAGES), pages(new Page[size]), size(size) {}
+    };
+
+    // 乐观读者不加latch查找页面用的提示表: 按PageId的哈希值直接映射到最近装入该槽位的帧, 冲突时后装入的覆盖先装入的;
+    // 只在持有page_lock时写入, 读者读出帧之后用帧的版本号和页号验证, 查不到时退回fetch_page
+    struct PeekTable {
+        std::unique_ptr<std::atomic<Page *>[]> slots;
+        size_t mask;  // 槽位个数-1, 用于取模
+
+        explicit PeekTable(size_t pool_size) {
+            size_t capacity = 1;
+            while (capacity < pool_size * 2) capacity <<= 1;
+            slots.reset(new std::atomic<Page *>[capacity]);
+            for (size_t i = 0; i < capacity; i++) slots[i].store(nullptr, std::memory_order_relaxed);
+            mask = capacity - 1;
+        }
+
+        std::atomic<Page *> &slot(const PageId &page_id) { return slots[PageTable::mix(page_id) & mask]; }
+    };
+
+    int page_size_;                     // 分区中每一帧的大小, 分区只装入页面大小与之相同的文件的页面
+    std::atomic<size_t> pool_size_{0};  // 当前分区中可以装入页面的帧的个数; 缩小分区时编号不小于pool_size_的帧正在被腾空
+    std::vector<Page *> pages_;         // 帧号到Page对象的映射, 包括正在腾空的帧
+    std::vector<std::unique_ptr<FrameChunk>> chunks_;  // 帧所在的块, 帧号按块的顺序连续编号
+    // 缩小时释放的块: 只把内存交还给操作系统, Page对象一直保留, 不pin页面的乐观读者持有的Page指针始终有效;
+    // 扩大时优先复用这些块
+    std::vector<std::unique_ptr<FrameChunk>> spare_chunks_;
+    PageTable page_table_;  // 帧号和页面号的映射哈希表，用于根据页面的PageId定位该页面的帧编号
+    std::atomic<PeekTable *> peek_table_{nullptr};  // 当前使用的提示表
+    // 扩大分区时换用更大的提示表, 读者可能还在使用旧表, 旧表在分区析构时才释放
+    std::vector<std::unique_ptr<PeekTable>> peek_tables_;
+    std::list<frame_id_t> free_list_;   // 空闲帧编号的链表
+    DiskManager *disk_manager_;
+    Replacer *replacer_;    // 当前分区的置换策略，由REPLACER_TYPE决定
+    std::mutex page_lock;    // 用于当前分区共享数据结构的并发控制
+    std::condition_variable io_cv_;     // 帧上的I/O或脏页写回完成时通知等待的线程
+    std::vector<bool> io_pending_;      // 帧是否正在释放latch进行I/O，此时帧中的数据不可用
+    std::vector<PageId> writing_back_;  // 正在释放latch写回的脏页，写回完成前不能从磁盘读取这些页面
+    std::vector<bool> read_ahead_mark_; // 帧中的页面是否为预读标记页，访问到标记页时继续向后预读
+    std::vector<bool> deallocate_pending_;  // 帧中的页面已被deallocate_page删除但仍被固定，最后一个固定释放时再删除
+    BufferPoolCounters counters_;       // 当前分区的访问计数
+    std::vector<BufferPoolCounters> file_counters_;  // 当前分区中各个文件的访问计数，下标为文件句柄
+
+   public:
+    BufferPoolInstance(size_t pool_size, DiskManager *disk_manager, int page_size = PAGE_SIZE)
+        : page_size_(page_size), page_table_(pool_size), disk_manager_(disk_manager) {
+        // 根据REPLACER_TYPE选择置换策略，未知的类型使用LRU
+        if (REPLACER_TYPE == "CLOCK")
+            replacer_ = new ClockReplacer(pool_size);
+        else if (REPLACER_TYPE == "LRU-K")
+            replacer_ = new LRUKReplacer(pool_size);
+        else if (REPLACER_TYPE == "2Q")
+            replacer_ = new TwoQueueReplacer(pool_size);
+        else {
+            replacer_ = new LRUReplacer(pool_size);
+        }
+        // 初始化时，所有的帧都在free_list_中
+        grow(pool_size);
+    }
+
+    ~BufferPoolInstance() { delete replacer_; }
+
+    size_t get_pool_size() const { return pool_size_.load(std::memory_order_relaxed); }
+
+    int get_page_size() const { return page_size_; }
+
+   public:
+    Page* peek_page(PageId page_id, uint64_t* version);
+
+    Page* fetch_page(PageId page_id, bool* read_ahead_trigger = nullptr, BufferRing* ring = nullptr);
+
+    bool unpin_page(PageId page_id, bool is_dirty);
+
+    bool flush_page(PageId page_id, bool is_locked);
+
+    Page* new_page(PageId* page_id, bool preallocated = false, BufferRing* ring = nullptr);
+
+    bool delete_page(PageId page_id);
+
+    void deallocate_page(PageId page_id);
+
+    void flush_all_pages(int fd);
+
+    size_t clean_pages(size_t target, size_t max_pages);
+
+    Page* begin_read_ahead(PageId page_id, bool mark);
+
+    void end_read_ahead(Page* page, bool success);
+
+    BufferPoolInstanceStats get_stats();
+
+    void reset_file_counters(int fd);
+
+    void get_resident_pages(std::vector<PageId>* page_ids);
+
+    void grow(size_t pool_size);
+
+    size_t begin_shrink(size_t pool_size);
+
+    bool drain_frames();
+
+    void cancel_shrink();
+
+   private:
+    bool find_victim_page(frame_id_t* frame_id, PageId* writeback_page_id, BufferRing* ring = nullptr);
+
+    void update_page(Page* page, PageId new_page_id, frame_id_t new_frame_id);
+
+    void finish_io(frame_id_t frame_id, PageId writeback_page_id);
+
+    void abort_io(frame_id_t frame_id, PageId writeback_page_id);
+
+    void wait_for_writeback(std::unique_lock<std::mutex>& lock, PageId page_id);
+
+    Page* fetch_reused_page(std::unique_lock<std::mutex>& lock, PageId page_id);
+
+    size_t write_back_pinned_pages(std::unique_lock<std::mutex>& lock, std::vector<Page*>& pages);
+
+    void release_cleaned_pages(const std::vector<Page*>& pages, size_t written);
+
+    void release_frame(frame_id_t frame_id);
+
+    void discard_page(frame_id_t frame_id);
+
+    // 帧是否正在因为缩小分区而被腾空, 这样的帧不再装入新的页面
+    bool retired(frame_id_t frame_id) const { return static_cast<size_t>(frame_id) >= pool_size_; }
+
+    // 把不再使用的帧放回free_list_, 正在腾空的帧除外
+    void free_frame(frame_id_t frame_id) {
+        if (!retired(frame_id)) free_list_.push_back(frame_id);
+    }
+
+    /**
+     * @description: 对当前分区和page_id所在文件的计数执行同一个修改, 调用者需持有latch
+     * @param {PageId} page_id 被访问的页面
+     * @param {uint64_t BufferPoolCounters::*} counter 要增加的计数
+     * @param {uint64_t} n 增加的值
+     */
+    void count(PageId page_id, uint64_t BufferPoolCounters::*counter, uint64_t n = 1) {
+        counters_.*counter += n;
+        if (page_id.fd < 0) return;
+        if (static_cast<size_t>(page_id.fd) >= file_counters_.size()) file_counters_.resize(page_id.fd + 1);
+        file_counters_[page_id.fd].*counter += n;
+    }
+
+    void count_eviction(Page* page, PageId writeback_page_id);
+
+    // 把帧登记到提示表中帧内页面的槽位, 调用者需持有latch
+    void publish(Page* page) {
+        peek_table_.load(std::memory_order_relaxed)->slot(page->id_).store(page, std::memory_order_release);
+    }
+};
@@ -9,254 +9,434 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "buffer_pool_manager.h"
-#include <iostream>
-
-using namespace std;
-
-/**
- * @description: 从free_list或replacer中得到可淘汰帧页的 *frame_id
- * @return {bool} true: 可替换帧查找成功 , false: 可替换帧查找失败
- * @param {frame_id_t*} frame_id 帧页id指针,返回成功找到的可替换帧id
- */
-bool BufferPoolManager::find_victim_page(frame_id_t *frame_id)
-{
-    // Todo:
-    // 1 使用BufferPoolManager::free_list_判断缓冲池是否已满需要淘汰页面
-    // 1.1 未满获得frame
-    // 1.2 已满使用lru_replacer中的方法选择淘汰页面
-    if (free_list_.size())
-    {
-        *frame_id = *(free_list_.begin());
-        free_list_.pop_front();
-        return true;
-    }
 
-    if (!replacer_->victim(frame_id))
-        return false;
-
-    Page *page = frame_id2Page_[*frame_id];
-
-    PageId page_id = page->id_;
-    if (page->is_dirty())
-        flush_page(page_id, true);
-    page_table_.erase(page_id);
-    PageId2Page_.erase(page_id);
-    frame_id2Page_.erase(*frame_id);
-
-    return true;
-}
+#include <algorithm>
+#include <chrono>
+#include <iostream>
 
 /**
- * @description: 更新页面数据, 如果为脏页则需写入磁盘，再更新为新页面，更新page元数据(data, is_dirty, page_id)和page table
- * @param {Page*} page 写回页指针
- * @param {PageId} new_page_id 新的page_id
- * @param {frame_id_t} new_frame_id 新的帧frame_id
+ * @description: 乐观读者获取已在缓冲池中的页面, 不加latch, 不pin页面也不访问replacer, 读完之后必须用version验证
+ * @return {Page*} 页面所在的帧, 页面不在缓冲池中、正在读入或正被加写latch时返回nullptr
+ * @param {PageId} page_id 需要获取的页的PageId
+ * @param {uint64_t*} version 帧的版本号
  */
-void BufferPoolManager::update_page(Page *page, PageId new_page_id, frame_id_t new_frame_id)
-{
-    // Todo:
-    // 1 如果是脏页，写回磁盘，并且把dirty置为false
-    // 2 更新page table
-    // 3 重置page的data，更新page id
-    PageId page_id = page->get_page_id();
-    if (page->is_dirty())
-    {
-        flush_page(page_id, true);
-        page->is_dirty_ = false;
-    }
-
-    page_table_.erase(page_id);
-    PageId2Page_.erase(page_id);
-    page_table_[new_page_id] = new_frame_id;
-    PageId2Page_[new_page_id] = page;
-    frame_id2Page_[new_frame_id] = page;
-
-    page->pin_count_++;
-    page->reset_memory();
-    page->id_ = new_page_id;
+Page *BufferPoolManager::peek_page(PageId page_id, uint64_t *version) {
+    return get_instance(page_id)->peek_page(page_id, version);
 }
 
 /**
- * @description: 从buffer pool获取需要的页。
- *              如果页表中存在page_id（说明该page在缓冲池中），并且pin_count++。
- *              如果页表不存在page_id（说明该page在磁盘中），则找缓冲池victim page，将其替换为磁盘中读取的page，pin_count置1。
+ * @description: 从page_id所在的分区中获取需要的页
  * @return {Page*} 若获得了需要的页则将其返回，否则返回nullptr
  * @param {PageId} page_id 需要获取的页的PageId
+ * @param {BufferAccessStrategy*} strategy 访问策略, 为nullptr时使用整个缓冲池
+ * @note 启用预读时，从磁盘读取页面或访问到预读标记页后检测该文件是否在顺序访问
  */
-Page *BufferPoolManager::fetch_page(PageId page_id)
-{
-    // Todo:
-    //  1.     从page_table_中搜寻目标页
-    //  1.1    若目标页有被page_table_记录，则将其所在frame固定(pin)，并返回目标页。
-    //  1.2    否则，尝试调用find_victim_page获得一个可用的frame，若失败则返回nullptr
-    //  2.     若获得的可用frame存储的为dirty page，则须调用update_page将page写回到磁盘
-    //  3.     调用disk_manager_的read_page读取目标页到frame
-    //  4.     固定目标页，更新pin_count_
-    //  5.     返回目标页
-
-    std::scoped_lock lock{page_lock};
-    Page *page = PageId2Page_[page_id];
-
-    if (page_table_.count(page_id))
-    {
-        replacer_->pin(page_table_[page_id]);
-        page->pin_count_++;
-        return page;
-    }
-
-    page = new Page();
-    int frame_id = 0;
-    if (!find_victim_page(&frame_id))
-        return nullptr;
-    update_page(page, page_id, frame_id);
-
-    disk_manager_->read_page(page_id.fd, page_id.page_no, page->data_, PAGE_SIZE);
-
-    replacer_->pin(frame_id);
-
+Page *BufferPoolManager::fetch_page(PageId page_id, BufferAccessStrategy *strategy) {
+    auto &instances = get_instances(page_id.fd);
+    size_t index = get_instance_index(page_id);
+    BufferRing *ring = strategy != nullptr ? strategy->get_ring(index, num_instances_) : nullptr;
+    if (!enable_read_ahead_) return instances[index]->fetch_page(page_id, nullptr, ring);
+
+    bool read_ahead_trigger = false;
+    Page *page = instances[index]->fetch_page(page_id, &read_ahead_trigger, ring);
+    if (page != nullptr && read_ahead_trigger) on_read_ahead_access(page_id, strategy != nullptr);
     return page;
 }
 
 /**
- * @description: 取消固定pin_count>0的在缓冲池中的page
+ * @description: 取消固定page_id所在分区中的page
  * @return {bool} 如果目标页的pin_count<=0则返回false，否则返回true
  * @param {PageId} page_id 目标page的page_id
  * @param {bool} is_dirty 若目标page应该被标记为dirty则为true，否则为false
  */
-bool BufferPoolManager::unpin_page(PageId page_id, bool is_dirty)
-{
-    // Todo:
-    // 0. lock latch
-    // 1. 尝试在page_table_中搜寻page_id对应的页P
-    // 1.1 P在页表中不存在 return false
-    // 1.2 P在页表中存在，获取其pin_count_
-    // 2.1 若pin_count_已经等于0，则返回false
-    // 2.2 若pin_count_大于0，则pin_count_自减一
-    // 2.2.1 若自减后等于0，则调用replacer_的Unpin
-    // 3 根据参数is_dirty，更改P的is_dirty_
-    std::scoped_lock lock{page_lock};
-    Page *page = PageId2Page_[page_id];
-
-    if (!page)
-        return false;
-    int frame_id = page_table_[page_id];
-
-    int &pin_count = page->pin_count_;
-    if (!pin_count)
-        return false;
-
-    pin_count--;
-
-    if (!pin_count)
-        replacer_->unpin(frame_id);
-    if (!page->is_dirty())
-        page->is_dirty_ = is_dirty;
-
-    return true;
+bool BufferPoolManager::unpin_page(PageId page_id, bool is_dirty) {
+    return get_instance(page_id)->unpin_page(page_id, is_dirty);
 }
 
 /**
  * @description: 将目标页写回磁盘，不考虑当前页面是否正在被使用
- * @return {bool} 成功则返回true，否则返回false(只有page_table_中没有目标页时)
+ * @return {bool} 成功则返回true，否则返回false(只有目标页不在缓冲池中时)
  * @param {PageId} page_id 目标页的page_id，不能为INVALID_PAGE_ID
  */
-bool BufferPoolManager::flush_page(PageId page_id, bool is_locked)
-{
-    // Todo:
-    // 0. lock latch
-    // 1. 查找页表,尝试获取目标页P
-    // 1.1 目标页P没有被page_table_记录 ，返回false
-    // 2. 无论P是否为脏都将其写回磁盘。
-    // 3. 更新P的is_dirty_
-    std::unique_lock<std::mutex> lock(page_lock, std::defer_lock);
-    if (!is_locked) lock.lock();
-    Page *page = PageId2Page_[page_id];
-    if (!page)
-        return false;
-    disk_manager_->write_page(page_id.fd, page_id.page_no, page->data_, PAGE_SIZE);
-    page->is_dirty_ = false;
-
-    return true;
+bool BufferPoolManager::flush_page(PageId page_id, bool is_locked) {
+    return get_instance(page_id)->flush_page(page_id, is_locked);
 }
 
 /**
- * @description: 创建一个新的page，即从磁盘中移动一个新建的空page到缓冲池某个位置。
+ * @description: 创建一个新的page
  * @return {Page*} 返回新创建的page，若创建失败则返回nullptr
  * @param {PageId*} page_id 当成功创建一个新的page时存储其page_id
+ * @param {BufferAccessStrategy*} strategy 访问策略, 为nullptr时使用整个缓冲池
+ * @note 多个分区时需要先分配页号才能确定页面所在的分区；若分区中没有可用帧则返回nullptr，已分配的页号交还给磁盘管理器
  */
-Page *BufferPoolManager::new_page(PageId *page_id)
-{
-    // 1.   获得一个可用的frame，若无法获得则返回nullptr
-    // 2.   在fd对应的文件分配一个新的page_id
-    // 3.   将frame的数据写回磁盘
-    // 4.   固定frame，更新pin_count_
-    // 5.   返回获得的page
+Page *BufferPoolManager::new_page(PageId *page_id, BufferAccessStrategy *strategy) {
+    auto &instances = get_instances(page_id->fd);
+    if (num_instances_ == 1) {
+        return instances[0]->new_page(page_id, false, strategy != nullptr ? strategy->get_ring(0, 1) : nullptr);
+    }
 
-    std::scoped_lock lock{page_lock};
-    frame_id_t frame_id;
-    if (!find_victim_page(&frame_id))
-        return nullptr;
+    *page_id = {page_id->fd, disk_manager_->allocate_page(page_id->fd)};
+    size_t index = get_instance_index(*page_id);
+    return instances[index]->new_page(page_id, true,
+                                       strategy != nullptr ? strategy->get_ring(index, num_instances_) : nullptr);
+}
 
-    int fd = page_id->fd;
+/**
+ * @description: 从buffer_pool删除目标页
+ * @return {bool} 如果目标页不存在于buffer_pool或者成功被删除则返回true，若其存在于buffer_pool但无法删除则返回false
+ * @param {PageId} page_id 目标页
+ */
+bool BufferPoolManager::delete_page(PageId page_id) { return get_instance(page_id)->delete_page(page_id); }
 
-    Page *page = new Page();
+/**
+ * @description: 删除不再使用的页面并交还给磁盘管理器复用, 页面仍被固定时推迟到最后一个固定释放
+ * @param {PageId} page_id 目标页
+ */
+void BufferPoolManager::deallocate_page(PageId page_id) { get_instance(page_id)->deallocate_page(page_id); }
 
-    *page_id = {fd, disk_manager_->allocate_page(fd)};
-    replacer_->pin(frame_id);
+/**
+ * @description: 获取需要读取的页面，返回的守卫持有页面的读latch，析构时释放latch并unpin该页面
+ * @return {ReadPageGuard} 页面的守卫，没有可用的帧时不持有页面
+ * @param {PageId} page_id 需要获取的页的PageId
+ * @param {BufferAccessStrategy*} strategy 访问策略, 为nullptr时使用整个缓冲池
+ */
+ReadPageGuard BufferPoolManager::fetch_page_read(PageId page_id, BufferAccessStrategy *strategy) {
+    return ReadPageGuard(this, fetch_page(page_id, strategy));
+}
 
-    page->pin_count_++;
-    page->id_ = *page_id;
+/**
+ * @description: 获取需要修改的页面，返回的守卫持有页面的写latch，析构时释放latch并unpin该页面，将其标记为脏页
+ * @return {WritePageGuard} 页面的守卫，没有可用的帧时不持有页面
+ * @param {PageId} page_id 需要获取的页的PageId
+ * @param {BufferAccessStrategy*} strategy 访问策略, 为nullptr时使用整个缓冲池
+ */
+WritePageGuard BufferPoolManager::fetch_page_write(PageId page_id, BufferAccessStrategy *strategy) {
+    return WritePageGuard(this, fetch_page(page_id, strategy));
+}
 
-    page_table_[*page_id] = frame_id;
-    PageId2Page_[*page_id] = page;
-    frame_id2Page_[frame_id] = page;
+/**
+ * @description: 在文件中分配一个新页面，返回的守卫持有页面的写latch，析构时释放latch并unpin该页面，将其标记为脏页
+ * @return {WritePageGuard} 新页面的守卫，没有可用的帧时不持有页面
+ * @param {PageId*} page_id 指定新页面所在的文件，返回时page_no为新页面的页号
+ * @param {BufferAccessStrategy*} strategy 访问策略, 为nullptr时使用整个缓冲池
+ */
+WritePageGuard BufferPoolManager::new_page_guarded(PageId *page_id, BufferAccessStrategy *strategy) {
+    return WritePageGuard(this, new_page(page_id, strategy));
+}
 
-    return page;
+/**
+ * @description: 将buffer_pool中属于文件fd的所有页写回到磁盘
+ * @param {int} fd 文件句柄
+ */
+void BufferPoolManager::flush_all_pages(int fd) {
+    for (auto &instance : get_instances(fd)) instance->flush_all_pages(fd);
 }
 
 /**
- * @description: 从buffer_pool删除目标页
- * @return {bool} 如果目标页不存在于buffer_pool或者成功被删除则返回true，若其存在于buffer_pool但无法删除则返回false
- * @param {PageId} page_id 目标页
+ * @description: 获取各个分区的统计快照, 按帧大小从小到大, 同一帧大小的一组分区按分区下标排列
  */
-bool BufferPoolManager::delete_page(PageId page_id)
-{
-    // 1.   在page_table_中查找目标页，若不存在返回true
-    // 2.   若目标页的pin_count不为0，则返回false
-    // 3.   将目标页数据写回磁盘，从页表中删除目标页，重置其元数据，将其加入free_list_，返回true
-    std::scoped_lock lock{page_lock};
-    if (!page_table_.count(page_id))
-        return true;
+std::vector<BufferPoolInstanceStats> BufferPoolManager::get_stats() {
+    std::vector<BufferPoolInstanceStats> stats;
+    for (BufferPoolInstance *instance : get_all_instances()) stats.push_back(instance->get_stats());
+    return stats;
+}
 
-    Page *page = PageId2Page_[page_id];
+/**
+ * @description: 清空各个分区中文件fd的访问计数, 关闭文件时调用
+ * @param {int} fd 文件句柄
+ */
+void BufferPoolManager::reset_file_counters(int fd) {
+    for (BufferPoolInstance *instance : get_all_instances()) instance->reset_file_counters(fd);
+}
 
-    if (page->pin_count_)
-        return false;
+/**
+ * @description: 获取文件fd的页面所在的一组分区, 这组分区还没有创建时先创建
+ * @param {int} fd 文件句柄, 文件的页面大小在打开文件时已经设置
+ */
+std::vector<std::unique_ptr<BufferPoolInstance>> &BufferPoolManager::get_instances(int fd) {
+    int size_class = fd < 0 ? 0 : get_page_size_class(disk_manager_->get_page_size(fd));
+    if (size_class_ready_[size_class].load(std::memory_order_acquire)) return instances_[size_class];
+
+    std::scoped_lock lock{resize_latch_};
+    if (!size_class_ready_[size_class].load(std::memory_order_relaxed)) {
+        size_t pool_size = get_size_class_pool_size(size_class, get_pool_size());
+        int page_size = PAGE_SIZE << size_class;
+        for (size_t i = 0; i < num_instances_; ++i) {
+            instances_[size_class].emplace_back(
+                std::make_unique<BufferPoolInstance>(get_instance_size(i, pool_size), disk_manager_, page_size));
+        }
+        size_class_ready_[size_class].store(true, std::memory_order_release);
+    }
+    return instances_[size_class];
+}
 
-    int frame_id = page_table_[page_id];
+/**
+ * @description: 获取所有已经创建的分区
+ */
+std::vector<BufferPoolInstance *> BufferPoolManager::get_all_instances() {
+    std::vector<BufferPoolInstance *> instances;
+    for (int size_class = 0; size_class < NUM_PAGE_SIZE_CLASSES; size_class++) {
+        if (!size_class_ready_[size_class].load(std::memory_order_acquire)) continue;
+        for (auto &instance : instances_[size_class]) instances.push_back(instance.get());
+    }
+    return instances;
+}
 
-    flush_page(page_id, true);
+/**
+ * @description: 页面清理线程的主循环, 每隔PAGE_CLEANER_INTERVAL_MS毫秒检查一遍各个分区,
+ *               使每个分区中干净的可淘汰帧不少于PAGE_CLEANER_CLEAN_PERCENT%
+ */
+void BufferPoolManager::run_page_cleaner() {
+    std::unique_lock<std::mutex> lock{page_cleaner_latch_};
+    while (!page_cleaner_stop_) {
+        lock.unlock();
+        size_t written = 0;
+        for (BufferPoolInstance *instance : get_all_instances()) {
+            size_t target = std::max<size_t>(1, instance->get_pool_size() * PAGE_CLEANER_CLEAN_PERCENT / 100);
+            try {
+                written += instance->clean_pages(target, PAGE_CLEANER_MAX_BATCH);
+            } catch (RMDBError &e) {
+                // 写回失败的页面仍是脏页，留给淘汰或下一轮清理处理
+                std::cerr << e.what() << std::endl;
+            }
+        }
+        lock.lock();
+        // 本轮有页面需要写回说明负载较重，立即开始下一轮
+        if (written == 0) {
+            page_cleaner_cv_.wait_for(lock, std::chrono::milliseconds(PAGE_CLEANER_INTERVAL_MS),
+                                      [&] { return page_cleaner_stop_; });
+        }
+    }
+}
 
-    page_table_.erase(page_id);
-    PageId2Page_.erase(page_id);
-    frame_id2Page_.erase(frame_id);
-    free_list_.push_back(frame_id);
+/**
+ * @description: 根据对文件的访问更新顺序访问流的状态, 需要时向预读线程提交预读请求
+ * @param {PageId} page_id 从磁盘读取的页面或预读标记页
+ * @param {bool} os_cache_only 为true时访问来自使用环形缓冲区的扫描, 只让操作系统把后续页面读入页缓存,
+ *        不占用缓冲池的帧, 否则扫描的环形缓冲区就失去了意义
+ * @note 每个文件最多跟踪READ_AHEAD_MAX_STREAMS个顺序访问流, 多个扫描或者穿插的随机访问不会互相打断;
+ *       缺页的页号比某个流上一次访问的页面(或已预读的最后一页)大且相差不超过READ_AHEAD_MAX_GAP时视为该流的顺序访问
+ *       (按页号递增插入建立的B+树, 相邻叶子之间只夹着少量内部结点), 否则开始一个新的流;
+ *       流第一次被检测为顺序访问时预读READ_AHEAD_MIN_PAGES页, 之后每访问到一次标记页窗口翻倍,
+ *       直到READ_AHEAD_MAX_PAGES(预读到缓冲池时还不超过缓冲池大小的1/4); 每批预读的第一页作为下一个标记页,
+ *       第一页已在缓冲池中时这一批没有标记页, 访问越过这一批之后的缺页会继续这个流
+ */
+void BufferPoolManager::on_read_ahead_access(PageId page_id, bool os_cache_only) {
+    std::scoped_lock lock{read_ahead_latch_};
+    std::vector<ReadAheadStream> &streams = read_ahead_streams_[page_id.fd];
+    page_id_t page_no = page_id.page_no;
+    // 预读到缓冲池的页面不能多到在被访问之前就把彼此淘汰
+    int max_window = READ_AHEAD_MAX_PAGES;
+    if (!os_cache_only) {
+        size_t pool_size = get_size_class_pool_size(get_page_size_class(disk_manager_->get_page_size(page_id.fd)),
+                                                    get_pool_size());
+        max_window = std::max(1, std::min(max_window, static_cast<int>(pool_size / 4)));
+    }
 
-    page->id_ = {-1, INVALID_PAGE_ID};
-    page->is_dirty_ = false;
-    page->reset_memory();
+    auto it = streams.begin();
+    for (; it != streams.end(); ++it) {
+        // 同一页面被淘汰后再次读入, 不改变顺序访问状态
+        if (page_no == it->last_page_no) return;
+        page_id_t expected_page_no = std::max(it->last_page_no, it->end_page_no - 1);
+        if (it->window > 0 && page_no == it->mark_page_no) {
+            it->window = std::min(it->window * 2, max_window);
+            break;
+        }
+        if (it->window > 0 && page_no > it->last_page_no && page_no < it->end_page_no) {
+            // 预读还没有完成就访问到了已经提交预读的页面, 等访问越过预读的范围后再继续
+            it->last_page_no = page_no;
+            return;
+        }
+        if (page_no > it->last_page_no && page_no - expected_page_no <= READ_AHEAD_MAX_GAP) {
+            // 访问越过了上一批预读的范围(没有标记页或者预读跟不上)时同样扩大窗口
+            it->window = it->window > 0 ? std::min(it->window * 2, max_window)
+                                        : std::min(READ_AHEAD_MIN_PAGES, max_window);
+            break;
+        }
+    }
+    if (it == streams.end()) {
+        if (streams.size() == READ_AHEAD_MAX_STREAMS) {
+            // 优先淘汰还没有检测到顺序访问的流, 随机访问不会挤掉正在进行的扫描
+            auto victim = std::find_if(streams.begin(), streams.end(), [](const ReadAheadStream &stream) {
+                return stream.window == 0;
+            });
+            streams.erase(victim != streams.end() ? victim : streams.begin());
+        }
+        ReadAheadStream stream;
+        stream.last_page_no = page_no;
+        streams.push_back(stream);
+        return;
+    }
+    // 最近使用的流放在最后
+    std::rotate(it, it + 1, streams.end());
+    ReadAheadStream &stream = streams.back();
+    stream.last_page_no = page_no;
+
+    page_id_t start_page_no = std::max(stream.end_page_no, page_no + 1);
+    page_id_t end_page_no = page_no + 1 + stream.window;
+    if (start_page_no >= end_page_no) return;
+    stream.mark_page_no = start_page_no;
+    stream.end_page_no = end_page_no;
+    read_ahead_requests_.push_back({page_id.fd, start_page_no, end_page_no - start_page_no, os_cache_only, {}});
+    read_ahead_cv_.notify_one();
+}
 
-    return true;
+/**
+ * @description: 预读线程的主循环, 依次处理on_read_ahead_access提交的预读请求
+ */
+void BufferPoolManager::run_read_ahead() {
+    std::unique_ptr<AsyncIo> async_io = disk_manager_->create_async_io();
+    std::unique_lock<std::mutex> lock{read_ahead_latch_};
+    while (true) {
+        read_ahead_cv_.wait(lock, [&] { return read_ahead_stop_ || !read_ahead_requests_.empty(); });
+        if (read_ahead_stop_) break;
+        ReadAheadRequest request = read_ahead_requests_.front();
+        read_ahead_requests_.pop_front();
+        lock.unlock();
+        read_ahead(async_io.get(), request);
+        lock.lock();
+    }
 }
 
 /**
- * @description: 将buffer_pool中的所有页写回到磁盘
- * @param {int} fd 文件句柄
+ * @description: 异步读入一个预读请求中的页面, 等待全部完成后返回
+ * @note 只预读文件中已经写到磁盘上的页面: 超出文件末尾的页面可能已经分配但还只在缓冲池中, 或者即将由new_page分配
  */
-void BufferPoolManager::flush_all_pages(int fd)
-{
-    std::scoped_lock lock{page_lock};
-    int page_no = disk_manager_->get_fd2pageno(fd);
-    for (int i = 0; i < std::min(page_no, max_page); i++)
-        flush_page({fd, i}, true);
-}
\ No newline at end of file
+void BufferPoolManager::read_ahead(AsyncIo *async_io, const ReadAheadRequest &request) {
+    if (request.os_cache_only) {
+        disk_manager_->advise_will_need(request.fd, request.start_page_no, request.num_pages);
+        return;
+    }
+
+    int file_size = disk_manager_->get_file_size(request.fd);
+    if (file_size < 0) return;
+    int page_size = disk_manager_->get_page_size(request.fd);
+    page_id_t file_pages = file_size / page_size;
+
+    std::vector<Page *> pages;
+    auto submit_read = [&](page_id_t page_no, bool mark) {
+        PageId page_id = {request.fd, page_no};
+        Page *page = get_instance(page_id)->begin_read_ahead(page_id, mark);
+        if (page == nullptr) return;
+        async_io->submit_read(request.fd, page_no, page->get_data(), page_size, pages.size());
+        pages.push_back(page);
+    };
+    if (request.page_nos.empty()) {
+        page_id_t end_page_no = std::min(request.start_page_no + request.num_pages, file_pages);
+        for (page_id_t page_no = request.start_page_no; page_no < end_page_no; page_no++) {
+            submit_read(page_no, page_no == request.start_page_no);
+        }
+    } else {
+        for (page_id_t page_no : request.page_nos) {
+            if (page_no < file_pages) submit_read(page_no, false);
+        }
+    }
+    async_io->flush();
+
+    std::vector<IoCompletion> completions(pages.size());
+    size_t num_completed = 0;
+    while (num_completed < pages.size()) {
+        int n = async_io->complete(completions.data(), static_cast<int>(completions.size()), 1);
+        for (int i = 0; i < n; i++) {
+            Page *page = pages[completions[i].user_data];
+            get_instance(page->get_page_id())->end_read_ahead(page, completions[i].result >= 0);
+        }
+        num_completed += n;
+    }
+}
+
+/**
+ * @description: 获取缓冲池中已经读入的所有页面, 关闭数据库时保存下来用于下次启动时预热缓冲池
+ */
+std::vector<PageId> BufferPoolManager::get_resident_pages() {
+    std::vector<PageId> page_ids;
+    for (BufferPoolInstance *instance : get_all_instances()) instance->get_resident_pages(&page_ids);
+    return page_ids;
+}
+
+/**
+ * @description: 把一组页面读入缓冲池, 用于重启后预热缓冲池
+ * @param {vector<PageId>} page_ids 需要读入的页面, 最多读入缓冲池大小个
+ * @note 页面按文件和页号排序后每READ_AHEAD_MAX_PAGES个分为一批, 每批通过AsyncIo并发读入;
+ *       启用预读时交给预读线程在后台读入, 立即返回, 否则在当前线程中读完后返回;
+ *       已经在缓冲池中或超出文件末尾的页面会被跳过
+ */
+void BufferPoolManager::warm_up(std::vector<PageId> page_ids) {
+    if (page_ids.size() > get_pool_size()) page_ids.resize(get_pool_size());
+    std::sort(page_ids.begin(), page_ids.end(), [](const PageId &a, const PageId &b) {
+        return a.fd != b.fd ? a.fd < b.fd : a.page_no < b.page_no;
+    });
+
+    std::vector<ReadAheadRequest> requests;
+    for (const PageId &page_id : page_ids) {
+        if (requests.empty() || requests.back().fd != page_id.fd ||
+            requests.back().page_nos.size() == READ_AHEAD_MAX_PAGES) {
+            requests.push_back({page_id.fd, INVALID_PAGE_ID, 0, false, {}});
+        }
+        requests.back().page_nos.push_back(page_id.page_no);
+    }
+
+    if (read_ahead_thread_.joinable()) {
+        std::scoped_lock lock{read_ahead_latch_};
+        for (auto &request : requests) read_ahead_requests_.push_back(std::move(request));
+        read_ahead_cv_.notify_one();
+        return;
+    }
+    std::unique_ptr<AsyncIo> async_io = disk_manager_->create_async_io();
+    for (const auto &request : requests) read_ahead(async_io.get(), request);
+}
+
+/**
+ * @description: 在线调整缓冲池的大小, 调整期间其他线程可以照常访问缓冲池
+ * @return {size_t} 调整后实际达到的大小; 分区只能整块地释放帧, 缩小时实际大小可能略大于pool_size,
+ *                  超时放弃缩小的分区保持原来的大小
+ * @param {size_t} pool_size PAGE_SIZE一组分区新的帧数, 不小于分区个数; 其他帧大小的分区按比例一起调整
+ * @param {int} timeout_ms 缩小时等待被固定的页面释放的最长时间
+ * @note 扩大时各个分区在latch之外申请新的块后立即可用; 缩小时各个分区先停止向末尾的块装入页面,
+ *       再在resize_latch_之外反复腾空其中的帧, 被固定的页面等使用者释放后再淘汰, 全部腾空后释放这些块;
+ *       超过timeout_ms仍有帧没有腾空的分区放弃缩小, 避免页面一直被固定时resize无法返回
+ */
+size_t BufferPoolManager::resize(size_t pool_size, int timeout_ms) {
+    std::scoped_lock op_lock{resize_op_latch_};
+    pool_size = std::max(pool_size, num_instances_);
+    std::vector<BufferPoolInstance *> shrinking;
+    {
+        std::scoped_lock lock{resize_latch_};
+        for (int size_class = 0; size_class < NUM_PAGE_SIZE_CLASSES; size_class++) {
+            if (!size_class_ready_[size_class]) continue;
+            auto &instances = instances_[size_class];
+            size_t class_pool_size = get_size_class_pool_size(size_class, pool_size);
+            for (size_t i = 0; i < num_instances_; i++) {
+                size_t instance_size = get_instance_size(i, class_pool_size);
+                if (instance_size > instances[i]->get_pool_size()) {
+                    instances[i]->grow(instance_size);
+                } else if (instance_size < instances[i]->get_pool_size()) {
+                    instances[i]->begin_shrink(instance_size);
+                    shrinking.push_back(instances[i].get());
+                }
+            }
+        }
+        size_t new_pool_size = 0;
+        for (auto &instance : instances_[0]) new_pool_size += instance->get_pool_size();
+        pool_size_ = new_pool_size;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!shrinking.empty()) {
+        shrinking.erase(std::remove_if(shrinking.begin(), shrinking.end(),
+                                       [](BufferPoolInstance *instance) { return instance->drain_frames(); }),
+                        shrinking.end());
+        if (shrinking.empty()) break;
+        if (std::chrono::steady_clock::now() >= deadline) {
+            for (BufferPoolInstance *instance : shrinking) instance->cancel_shrink();
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(BUFFER_POOL_DRAIN_INTERVAL_MS));
+    }
+
+    std::scoped_lock lock{resize_latch_};
+    size_t new_pool_size = 0;
+    for (auto &instance : instances_[0]) new_pool_size += instance->get_pool_size();
+    pool_size_ = new_pool_size;
+    return new_pool_size;
+}
@@ -12,52 +12,107 @@ See the Mulan PSL v2 for more details. */
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <list>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
+#include "buffer_access_strategy.h"
+#include "buffer_pool_instance.h"
 #include "disk_manager.h"
 #include "errors.h"
 #include "page.h"
-#include "replacer/lru_replacer.h"
-#include "replacer/replacer.h"
+#include "page_guard.h"
 
+/**
+ * @description: 缓冲池管理器, 由num_instances个相互独立的BufferPoolInstance分区组成
+ * 每个页面根据PageId的哈希值固定落在某一个分区中, 各分区拥有自己的latch, 从而避免所有线程竞争同一把锁
+ * num_instances为1时与不分区的缓冲池行为完全一致
+ * 文件的页面大小可以是PAGE_SIZE到MAX_PAGE_SIZE之间的2的幂, 每种页面大小(帧大小类别)各有一组num_instances个分区;
+ * PAGE_SIZE的一组在构造时创建, 大小为pool_size, 其余的在第一次访问该页面大小的文件时创建,
+ * 每组占用PAGE_SIZE一组BUFFER_POOL_LARGE_PAGE_PERCENT%的内存
+ */
 class BufferPoolManager {
    private:
-    const int max_page = 4096;
-    size_t pool_size_;      // buffer_pool中可容纳页面的个数，即帧的个数
-    Page *pages_;           // buffer_pool中的Page对象数组，在构造空间中申请内存空间，在析构函数中释放，大小为BUFFER_POOL_SIZE
-    std::unordered_map<PageId, frame_id_t, PageIdHash> page_table_; // 帧号和页面号的映射哈希表，用于根据页面的PageId定位该页面的帧编号
-    std::unordered_map<PageId, Page*, PageIdHash> PageId2Page_;
-    std::unordered_map<frame_id_t, Page*> frame_id2Page_;
-    std::list<frame_id_t> free_list_;   // 空闲帧编号的链表
+    std::atomic<size_t> pool_size_;  // buffer_pool中可容纳页面的个数，即PAGE_SIZE一组所有分区的帧的个数之和
+    size_t num_instances_;  // 每组的分区个数
+    // 各个帧大小类别的分区, 下标为get_page_size_class的返回值; 一组分区创建之后不再增删, 只改变各个分区的大小
+    std::vector<std::unique_ptr<BufferPoolInstance>> instances_[NUM_PAGE_SIZE_CLASSES];
+    std::atomic<bool> size_class_ready_[NUM_PAGE_SIZE_CLASSES];  // 该类别的一组分区是否已经创建
+    std::mutex resize_latch_;   // 串行化对各个分区大小的修改和分区的创建, 缩小时腾空帧期间不持有
+    std::mutex resize_op_latch_;  // 串行化resize调用, 每次调用最多等待被固定的页面timeout_ms
     DiskManager *disk_manager_;
-    Replacer *replacer_;    // buffer_pool的置换策略，当前赛题中为LRU置换策略
-    std::mutex page_lock;    // 用于共享数据结构的并发控制
+
+    // 页面清理线程, 在后台写回脏页, 使淘汰页面时通常不需要同步写盘
+    std::thread page_cleaner_;
+    std::mutex page_cleaner_latch_;
+    std::condition_variable page_cleaner_cv_;
+    bool page_cleaner_stop_ = false;
+
+    // 顺序预读: 按文件检测顺序访问流, 由预读线程通过AsyncIo异步读入后续的页面
+    struct ReadAheadStream {
+        page_id_t last_page_no = INVALID_PAGE_ID;  // 该流上一次从磁盘读取或命中标记页的页号
+        page_id_t mark_page_no = INVALID_PAGE_ID;  // 最近一批预读的第一页, 访问到标记页时继续向后预读
+        page_id_t end_page_no = INVALID_PAGE_ID;   // 已经提交预读的页面的下一页
+        int window = 0;                            // 预读窗口, 为0表示还没有检测到顺序访问
+    };
+    struct ReadAheadRequest {
+        int fd;
+        page_id_t start_page_no;
+        int num_pages;
+        bool os_cache_only;  // 只让操作系统预读到页缓存
+        std::vector<page_id_t> page_nos;  // 非空时只读入这些页面(预热缓冲池), 不设置标记页, 忽略start_page_no和num_pages
+    };
+    bool enable_read_ahead_;
+    std::thread read_ahead_thread_;
+    std::mutex read_ahead_latch_;
+    std::condition_variable read_ahead_cv_;
+    // 各个文件的顺序访问流, 最近使用的在最后
+    std::unordered_map<int, std::vector<ReadAheadStream>> read_ahead_streams_;
+    std::deque<ReadAheadRequest> read_ahead_requests_;
+    bool read_ahead_stop_ = false;
 
    public:
-    BufferPoolManager(size_t pool_size, DiskManager *disk_manager)
-        : pool_size_(pool_size), disk_manager_(disk_manager) {
-        // 为buffer pool分配一块连续的内存空间
-        pages_ = new Page[pool_size_];
-        // 可以被Replacer改变
-        if (REPLACER_TYPE.compare("LRU"))
-            replacer_ = new LRUReplacer(pool_size_);
-        else if (REPLACER_TYPE.compare("CLOCK"))
-            replacer_ = new LRUReplacer(pool_size_);
-        else {
-            replacer_ = new LRUReplacer(pool_size_);
-        }
-        // 初始化时，所有的page都在free_list_中
-        for (size_t i = 0; i < pool_size_; ++i) {
-            free_list_.emplace_back(static_cast<frame_id_t>(i));  // static_cast转换数据类型
+    BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t num_instances = 1,
+                      bool enable_page_cleaner = false, bool enable_read_ahead = false)
+        : pool_size_(pool_size),
+          num_instances_(num_instances),
+          disk_manager_(disk_manager),
+          enable_read_ahead_(enable_read_ahead) {
+        assert(num_instances_ > 0 && num_instances_ <= pool_size);
+        // 将pool_size个帧尽量平均地分给各个分区
+        for (size_t i = 0; i < num_instances_; ++i) {
+            instances_[0].emplace_back(std::make_unique<BufferPoolInstance>(get_instance_size(i, pool_size), disk_manager_));
         }
+        size_class_ready_[0] = true;
+        for (int size_class = 1; size_class < NUM_PAGE_SIZE_CLASSES; size_class++) size_class_ready_[size_class] = false;
+        if (enable_page_cleaner) page_cleaner_ = std::thread(&BufferPoolManager::run_page_cleaner, this);
+        if (enable_read_ahead_) read_ahead_thread_ = std::thread(&BufferPoolManager::run_read_ahead, this);
     }
 
     ~BufferPoolManager() {
-        delete[] pages_;
-        delete replacer_;
+        if (page_cleaner_.joinable()) {
+            {
+                std::scoped_lock lock{page_cleaner_latch_};
+                page_cleaner_stop_ = true;
+            }
+            page_cleaner_cv_.notify_all();
+            page_cleaner_.join();
+        }
+        if (read_ahead_thread_.joinable()) {
+            {
+                std::scoped_lock lock{read_ahead_latch_};
+                read_ahead_stop_ = true;
+            }
+            read_ahead_cv_.notify_all();
+            read_ahead_thread_.join();
+        }
     }
 
     /**
@@ -66,21 +121,72 @@ class BufferPoolManager {
      */
     static void mark_dirty(Page* page) { page->is_dirty_ = true; }
 
-   public: 
-    Page* fetch_page(PageId page_id);
+    size_t get_pool_size() const { return pool_size_.load(std::memory_order_relaxed); }
+
+    size_t get_num_instances() const { return num_instances_; }
+
+   public:
+    Page* peek_page(PageId page_id, uint64_t* version);
+
+    Page* fetch_page(PageId page_id, BufferAccessStrategy* strategy = nullptr);
 
     bool unpin_page(PageId page_id, bool is_dirty);
 
     bool flush_page(PageId page_id, bool is_locked);
 
-    Page* new_page(PageId* page_id);
+    Page* new_page(PageId* page_id, BufferAccessStrategy* strategy = nullptr);
 
     bool delete_page(PageId page_id);
 
+    void deallocate_page(PageId page_id);
+
+    ReadPageGuard fetch_page_read(PageId page_id, BufferAccessStrategy* strategy = nullptr);
+
+    WritePageGuard fetch_page_write(PageId page_id, BufferAccessStrategy* strategy = nullptr);
+
+    WritePageGuard new_page_guarded(PageId* page_id, BufferAccessStrategy* strategy = nullptr);
+
     void flush_all_pages(int fd);
 
+    std::vector<BufferPoolInstanceStats> get_stats();
+
+    void reset_file_counters(int fd);
+
+    std::vector<PageId> get_resident_pages();
+
+    void warm_up(std::vector<PageId> page_ids);
+
+    size_t resize(size_t pool_size, int timeout_ms = BUFFER_POOL_RESIZE_TIMEOUT_MS);
+
    private:
-    bool find_victim_page(frame_id_t* frame_id);
+    void run_page_cleaner();
+
+    void on_read_ahead_access(PageId page_id, bool os_cache_only);
+
+    void run_read_ahead();
+
+    void read_ahead(AsyncIo *async_io, const ReadAheadRequest &request);
+
+    std::vector<std::unique_ptr<BufferPoolInstance>> &get_instances(int fd);
 
-    void update_page(Page* page, PageId new_page_id, frame_id_t new_frame_id);
-};
\ No newline at end of file
+    std::vector<BufferPoolInstance *> get_all_instances();
+
+    // 一组分区的帧数为pool_size时第index个分区的帧数
+    size_t get_instance_size(size_t index, size_t pool_size) const {
+        return pool_size / num_instances_ + (index < pool_size % num_instances_ ? 1 : 0);
+    }
+
+    // 缓冲池大小为pool_size时帧大小类别size_class的一组分区的帧数
+    size_t get_size_class_pool_size(int size_class, size_t pool_size) const {
+        if (size_class == 0) return pool_size;
+        size_t frames = (pool_size * BUFFER_POOL_LARGE_PAGE_PERCENT / 100) >> size_class;
+        return std::max({frames, BUFFER_POOL_MIN_CLASS_FRAMES, num_instances_});
+    }
+
+    // 根据PageId定位页面所在的分区在其所在的一组分区中的下标
+    size_t get_instance_index(PageId page_id) const { return PageIdHash()(page_id) % num_instances_; }
+
+    BufferPoolInstance *get_instance(PageId page_id) {
+        return get_instances(page_id.fd)[get_instance_index(page_id)].get();
+    }
+};
@@ -0,0 +1,148 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @description: 缓冲池的访问计数, 每个分区一份, 另外每个分区按文件句柄各记一份
+ * 计数只在持有分区latch时修改, 这些地方本来就要持有latch, 不需要额外的同步
+ */
+struct BufferPoolCounters {
+    uint64_t hits = 0;        // fetch_page时页面已在缓冲池中
+    uint64_t misses = 0;      // fetch_page时需要从磁盘读入页面
+    uint64_t evictions = 0;   // 为装入其他页面而淘汰的页面
+    uint64_t writebacks = 0;  // 写回磁盘的脏页, 包括淘汰时写回、页面清理线程写回和flush
+    uint64_t pin_waits = 0;   // fetch_page时页面正在被其他线程读入或写回, 需要等待I/O完成
+
+    BufferPoolCounters &operator+=(const BufferPoolCounters &other) {
+        hits += other.hits;
+        misses += other.misses;
+        evictions += other.evictions;
+        writebacks += other.writebacks;
+        pin_waits += other.pin_waits;
+        return *this;
+    }
+
+    bool empty() const { return hits == 0 && misses == 0 && evictions == 0 && writebacks == 0 && pin_waits == 0; }
+
+    double hit_ratio() const { return hits + misses == 0 ? 0 : static_cast<double>(hits) / (hits + misses); }
+};
+
+/**
+ * @description: 缓冲池分区的统计快照
+ */
+struct BufferPoolInstanceStats {
+    size_t pool_size = 0;     // 帧的个数
+    int page_size = 0;        // 帧的大小
+    size_t used_frames = 0;   // 装有页面的帧的个数
+    size_t dirty_frames = 0;  // 装有脏页的帧的个数
+    BufferPoolCounters counters;
+    std::vector<BufferPoolCounters> file_counters;  // 下标为文件句柄
+};
+
+/**
+ * @description: 延迟直方图的统计快照, 第i个桶记录延迟在[2^(i-1), 2^i)微秒之间的次数, 第0个桶记录不足1微秒的次数,
+ * 最后一个桶没有上界
+ */
+struct LatencySummary {
+    static constexpr int NUM_BUCKETS = 24;
+
+    uint64_t buckets[NUM_BUCKETS] = {};
+    uint64_t count = 0;     // 调用次数
+    uint64_t total_us = 0;  // 总耗时(微秒)
+    uint64_t pages = 0;     // 读写的页面个数
+
+    // 第i个桶的下界(微秒)
+    static uint64_t bucket_lower_bound(int i) { return i == 0 ? 0 : uint64_t{1} << (i - 1); }
+
+    double average_us() const { return count == 0 ? 0 : static_cast<double>(total_us) / count; }
+
+    /**
+     * @description: 估计延迟的分位数, 返回分位数所在桶的上界(微秒); 落在最后一个桶时返回它的下界
+     * @param {double} quantile 0到1之间的分位点, 如0.99
+     */
+    uint64_t percentile_us(double quantile) const {
+        if (count == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(quantile * count);
+        if (rank >= count) rank = count - 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < NUM_BUCKETS - 1; i++) {
+            seen += buckets[i];
+            if (seen > rank) return bucket_lower_bound(i + 1);
+        }
+        return bucket_lower_bound(NUM_BUCKETS - 1);
+    }
+};
+
+/**
+ * @description: 低开销的延迟直方图, 供多个线程在不持有任何latch的I/O路径上并发记录
+ * 每个线程固定写入一个按缓存行对齐的分片, 线程数不超过分片数时各线程之间不会争用同一缓存行;
+ * 读取时才把所有分片累加起来, 读到的是近似一致的快照
+ */
+class LatencyHistogram {
+   public:
+    /**
+     * @description: 记录一次I/O
+     * @param {uint64_t} micros 耗时(微秒)
+     * @param {int} num_pages 本次读写的页面个数
+     */
+    void record(uint64_t micros, int num_pages) {
+        Shard &shard = shards_[shard_index()];
+        shard.buckets[bucket_of(micros)].fetch_add(1, std::memory_order_relaxed);
+        shard.total_us.fetch_add(micros, std::memory_order_relaxed);
+        shard.pages.fetch_add(num_pages, std::memory_order_relaxed);
+    }
+
+    LatencySummary summary() const {
+        LatencySummary summary;
+        for (const Shard &shard : shards_) {
+            for (int i = 0; i < LatencySummary::NUM_BUCKETS; i++) {
+                uint64_t n = shard.buckets[i].load(std::memory_order_relaxed);
+                summary.buckets[i] += n;
+                summary.count += n;
+            }
+            summary.total_us += shard.total_us.load(std::memory_order_relaxed);
+            summary.pages += shard.pages.load(std::memory_order_relaxed);
+        }
+        return summary;
+    }
+
+   private:
+    static constexpr size_t NUM_SHARDS = 16;
+
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> buckets[LatencySummary::NUM_BUCKETS] = {};
+        std::atomic<uint64_t> total_us{0};
+        std::atomic<uint64_t> pages{0};
+    };
+
+    static int bucket_of(uint64_t micros) {
+        int bucket = 0;
+        while (micros > 0 && bucket < LatencySummary::NUM_BUCKETS - 1) {
+            micros >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    // 每个线程第一次记录时按顺序分配一个分片
+    static size_t shard_index() {
+        static std::atomic<size_t> next_shard{0};
+        thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % NUM_SHARDS;
+        return shard;
+    }
+
+    Shard shards_[NUM_SHARDS];
+};
@@ -11,13 +11,48 @@ See the Mulan PSL v2 for more details. */
 #include "storage/disk_manager.h"
 
 #include <assert.h>    // for assert
+#include <errno.h>     // for errno
+#include <fcntl.h>     // for posix_fadvise
+#include <limits.h>    // for IOV_MAX
 #include <string.h>    // for memset
 #include <sys/stat.h>  // for stat
+#include <sys/uio.h>   // for preadv, pwritev
 #include <unistd.h>    // for lseek
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
 #include "defs.h"
+#include "storage/page.h"
 
-DiskManager::DiskManager() { memset(fd2pageno_, 0, MAX_FD * (sizeof(std::atomic<page_id_t>) / sizeof(char))); }
+namespace {
+
+/**
+ * @description: 按PAGE_SIZE对齐申请中转缓冲区, 长度向上取整到PAGE_SIZE的倍数, 供O_DIRECT读写不对齐的数据时使用
+ */
+std::unique_ptr<char, decltype(&free)> alloc_aligned_buffer(int num_bytes, int *aligned_bytes) {
+    *aligned_bytes = (num_bytes + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+    char *buf = static_cast<char *>(aligned_alloc(PAGE_SIZE, *aligned_bytes));
+    if (buf == nullptr) {
+        throw InternalError("DiskManager Error - aligned buffer allocation failed");
+    }
+    return {buf, &free};
+}
+
+uint64_t elapsed_us(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+DiskManager::DiskManager(bool direct_io) : direct_io_(direct_io) {
+    memset(fd2pageno_, 0, MAX_FD * (sizeof(std::atomic<page_id_t>) / sizeof(char)));
+    memset(fd_direct_, 0, sizeof(fd_direct_));
+    std::fill(fd_page_size_, fd_page_size_ + MAX_FD, PAGE_SIZE);
+}
 
 /**
  * @description: 将数据写入文件的指定磁盘页面中
@@ -25,22 +60,30 @@ DiskManager::DiskManager() { memset(fd2pageno_, 0, MAX_FD * (sizeof(std::atomic<
  * @param {page_id_t} page_no 写入目标页面的page_id
  * @param {char} *offset 要写入磁盘的数据
  * @param {int} num_bytes 要写入磁盘的数据大小
+ * @note 使用pwrite按位置写, 不移动文件的读写指针, 多个线程可以并发地读写同一个文件
  */
 void DiskManager::write_page(int fd, page_id_t page_no, const char *offset, int num_bytes) {
-    // Todo:
-    // 1.lseek()定位到文件头，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
-    // 2.调用write()函数
-    // 注意write返回值与num_bytes不等时 throw InternalError("DiskManager::write_page Error");
-
-    off_t offset_in_file = page_no * PAGE_SIZE; // 假设PAGE_SIZE是页面大小
-    if (lseek(fd, offset_in_file, SEEK_SET) == -1) {
-        throw InternalError("DiskManager::write_page Error - lseek failed");
+    if (need_bounce_buffer(fd, offset, num_bytes)) {
+        // O_DIRECT下不对齐的写(如只写文件头): 先读出所在的完整页面, 修改后整页写回
+        int aligned_bytes;
+        auto buf = alloc_aligned_buffer(num_bytes, &aligned_bytes);
+        if (aligned_bytes != num_bytes) read_page(fd, page_no, buf.get(), aligned_bytes);
+        memcpy(buf.get(), offset, num_bytes);
+        write_page(fd, page_no, buf.get(), aligned_bytes);
+        return;
     }
-
-    ssize_t bytes_written = write(fd, offset, num_bytes);
-    if (bytes_written != num_bytes) {
-        throw InternalError("DiskManager::write_page Error - write failed");
+    auto start = std::chrono::steady_clock::now();
+    off_t offset_in_file = static_cast<off_t>(page_no) * fd_page_size_[fd];
+    int bytes_written = 0;
+    while (bytes_written < num_bytes) {
+        ssize_t ret = pwrite(fd, offset + bytes_written, num_bytes - bytes_written, offset_in_file + bytes_written);
+        if (ret < 0 && errno == EINTR) continue;
+        if (ret <= 0) {
+            throw InternalError("DiskManager::write_page Error - write failed");
+        }
+        bytes_written += ret;
     }
+    write_latency_.record(elapsed_us(start), 1);
 }
 
 /**
@@ -49,28 +92,279 @@ void DiskManager::write_page(int fd, page_id_t page_no, const char *offset, int
  * @param {page_id_t} page_no 指定的页面编号
  * @param {char} *offset 读取的内容写入到offset中
  * @param {int} num_bytes 读取的数据量大小
+ * @note 使用pread按位置读; 读到文件末尾时剩余部分填0(已分配但尚未写回磁盘的页面)
  */
 void DiskManager::read_page(int fd, page_id_t page_no, char *offset, int num_bytes) {
-    off_t offset_in_file = page_no * PAGE_SIZE;
-    if (lseek(fd, offset_in_file, SEEK_SET) == -1) {
-        throw InternalError("DiskManager::read_page Error - lseek failed");
+    if (need_bounce_buffer(fd, offset, num_bytes)) {
+        int aligned_bytes;
+        auto buf = alloc_aligned_buffer(num_bytes, &aligned_bytes);
+        read_page(fd, page_no, buf.get(), aligned_bytes);
+        memcpy(offset, buf.get(), num_bytes);
+        return;
     }
+    auto start = std::chrono::steady_clock::now();
+    off_t offset_in_file = static_cast<off_t>(page_no) * fd_page_size_[fd];
+    int bytes_read = 0;
+    while (bytes_read < num_bytes) {
+        ssize_t ret = pread(fd, offset + bytes_read, num_bytes - bytes_read, offset_in_file + bytes_read);
+        if (ret < 0 && errno == EINTR) continue;
+        if (ret < 0) {
+            throw InternalError("DiskManager::read_page Error - read failed");
+        }
+        if (ret == 0) {
+            memset(offset + bytes_read, 0, num_bytes - bytes_read);
+            break;
+        }
+        bytes_read += ret;
+    }
+    read_latency_.record(elapsed_us(start), 1);
+}
 
-    read(fd, (int*) offset, num_bytes);
+/**
+ * @description: 将连续的num_pages个页面一次写入文件, 从start_page_no开始
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} start_page_no 第一个页面的编号
+ * @param {char**} pages 各个页面的数据, 每个页面为文件的页面大小, 内存中不必连续
+ * @param {int} num_pages 页面个数
+ */
+void DiskManager::write_pages(int fd, page_id_t start_page_no, char *const *pages, int num_pages) {
+    rw_pages(fd, start_page_no, pages, num_pages, true);
 }
 
 /**
- * @description: 分配一个新的页号
- * @return {page_id_t} 分配的新页号
- * @param {int} fd 指定文件的文件句柄
+ * @description: 从文件中一次读取从start_page_no开始的连续num_pages个页面
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} start_page_no 第一个页面的编号
+ * @param {char**} pages 各个页面的读入位置, 每个页面为文件的页面大小, 内存中不必连续
+ * @param {int} num_pages 页面个数
+ * @note 读到文件末尾时剩余的页面填0
+ */
+void DiskManager::read_pages(int fd, page_id_t start_page_no, char *const *pages, int num_pages) {
+    rw_pages(fd, start_page_no, pages, num_pages, false);
+}
+
+/**
+ * @description: 提示操作系统即将读取文件中从start_page_no开始的num_pages个页面, 由内核异步读入页缓存
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} start_page_no 第一个页面的页号
+ * @param {int} num_pages 页面个数
+ * @note 只是提示, 失败时不做处理
+ */
+void DiskManager::advise_will_need(int fd, page_id_t start_page_no, int num_pages) {
+    int page_size = fd_page_size_[fd];
+    posix_fadvise(fd, static_cast<off_t>(start_page_no) * page_size, static_cast<off_t>(num_pages) * page_size,
+                  POSIX_FADV_WILLNEED);
+}
+
+/**
+ * @description: read_pages/write_pages的实现, 使用preadv/pwritev, 处理短读写和IOV_MAX的限制
+ */
+void DiskManager::rw_pages(int fd, page_id_t start_page_no, char *const *pages, int num_pages, bool is_write) {
+    int page_size = fd_page_size_[fd];
+    if (fd_direct_[fd]) {
+        // O_DIRECT下只要有一个页面的缓冲区不对齐, 就退化为逐页读写, 由read_page/write_page经中转缓冲区完成
+        for (int i = 0; i < num_pages; i++) {
+            if (need_bounce_buffer(fd, pages[i], page_size)) {
+                for (int j = 0; j < num_pages; j++) {
+                    if (is_write) {
+                        write_page(fd, start_page_no + j, pages[j], page_size);
+                    } else {
+                        read_page(fd, start_page_no + j, pages[j], page_size);
+                    }
+                }
+                return;
+            }
+        }
+    }
+    auto start = std::chrono::steady_clock::now();
+    off_t offset_in_file = static_cast<off_t>(start_page_no) * page_size;
+    std::vector<iovec> iov(std::min(num_pages, IOV_MAX));
+    int done_pages = 0;     // 已经完整读写的页面个数
+    while (done_pages < num_pages) {
+        int batch = std::min(num_pages - done_pages, IOV_MAX);
+        for (int i = 0; i < batch; i++) {
+            iov[i].iov_base = pages[done_pages + i];
+            iov[i].iov_len = page_size;
+        }
+        iovec *cur = iov.data();
+        int remain = batch;
+        off_t pos = offset_in_file + static_cast<off_t>(done_pages) * page_size;
+        while (remain > 0) {
+            ssize_t ret = is_write ? pwritev(fd, cur, remain, pos) : preadv(fd, cur, remain, pos);
+            if (ret < 0 && errno == EINTR) continue;
+            if (ret < 0 || (ret == 0 && is_write)) {
+                throw InternalError(is_write ? "DiskManager::write_pages Error - write failed"
+                                             : "DiskManager::read_pages Error - read failed");
+            }
+            if (ret == 0) {
+                // 文件末尾之后的页面填0
+                for (int i = 0; i < remain; i++) memset(cur[i].iov_base, 0, cur[i].iov_len);
+                break;
+            }
+            pos += ret;
+            // 跳过已经完成的iovec, 并调整部分完成的那一个
+            while (remain > 0 && static_cast<size_t>(ret) >= cur->iov_len) {
+                ret -= cur->iov_len;
+                cur++;
+                remain--;
+            }
+            if (remain > 0) {
+                cur->iov_base = static_cast<char *>(cur->iov_base) + ret;
+                cur->iov_len -= ret;
+            }
+        }
+        done_pages += batch;
+    }
+    (is_write ? write_latency_ : read_latency_).record(elapsed_us(start), num_pages);
+}
+
+/**
+ * @description: 在文件中分配一个页面
+ * @return {page_id_t} 分配的页号
+ * @param {int} fd 文件句柄
+ * @note 优先复用页号最小的空闲页面, 使数据集中在文件前部, 文件末尾的空闲页面可以被截断; 没有空闲页面时页号自增
  */
 page_id_t DiskManager::allocate_page(int fd) {
-    // 简单的自增分配策略，指定文件的页面编号加1
     assert(fd >= 0 && fd < MAX_FD);
+    {
+        std::scoped_lock lock{free_pages_latch_};
+        auto it = free_pages_.find(fd);
+        if (it != free_pages_.end() && !it->second.pages.empty()) {
+            page_id_t page_no = *it->second.pages.begin();
+            it->second.pages.erase(it->second.pages.begin());
+            // 磁盘上的空闲页面表已经过时, 必须在复用的页面写入数据之前删除, 否则崩溃后该页面会被重复分配
+            if (it->second.persisted) remove_free_page_map_file(fd);
+            return page_no;
+        }
+    }
     return fd2pageno_[fd]++;
 }
 
-void DiskManager::deallocate_page(__attribute__((unused)) page_id_t page_id) {}
+/**
+ * @description: 释放文件中的一个页面, 之后可以被allocate_page复用
+ * @param {int} fd 文件句柄
+ * @param {page_id_t} page_no 要释放的页号
+ * @note 调用者保证该页面已经不再被引用, 并且不在缓冲池中
+ */
+void DiskManager::deallocate_page(int fd, page_id_t page_no) {
+    assert(fd >= 0 && fd < MAX_FD && page_no >= 0 && page_no < fd2pageno_[fd]);
+    std::scoped_lock lock{free_pages_latch_};
+    free_pages_[fd].pages.insert(page_no);
+}
+
+/**
+ * @description: 判断文件中的页面是否已经被释放
+ */
+bool DiskManager::is_free_page(int fd, page_id_t page_no) {
+    std::scoped_lock lock{free_pages_latch_};
+    auto it = free_pages_.find(fd);
+    return it != free_pages_.end() && it->second.pages.count(page_no) != 0;
+}
+
+/**
+ * @description: 获取文件中空闲页面的个数
+ */
+int DiskManager::get_num_free_pages(int fd) {
+    std::scoped_lock lock{free_pages_latch_};
+    auto it = free_pages_.find(fd);
+    return it == free_pages_.end() ? 0 : static_cast<int>(it->second.pages.size());
+}
+
+/**
+ * @description: 设置文件的页面大小, 在打开文件后、读写第0页以外的页面之前调用
+ * @param {int} fd 文件句柄
+ * @param {int} page_size 页面大小, 由文件头中记录的页面大小决定
+ * @note 打开文件时读回的空闲页面表是按PAGE_SIZE过滤的, 这里丢弃超出文件末尾的页号
+ */
+void DiskManager::set_page_size(int fd, int page_size) {
+    assert(fd >= 0 && fd < MAX_FD && is_valid_page_size(page_size));
+    fd_page_size_[fd] = page_size;
+    if (page_size == PAGE_SIZE) return;
+    page_id_t file_pages = get_file_size(fd) / page_size;
+    std::scoped_lock lock{free_pages_latch_};
+    auto it = free_pages_.find(fd);
+    if (it != free_pages_.end()) it->second.pages.erase(it->second.pages.lower_bound(file_pages), it->second.pages.end());
+}
+
+/**
+ * @description: 截断文件末尾连续的空闲页面
+ * @return {page_id_t} 截断后文件中的页面个数
+ * @param {int} fd 文件句柄
+ * @note 调用者保证截断期间没有其他线程在该文件中分配页面
+ */
+page_id_t DiskManager::truncate_free_pages(int fd) {
+    std::scoped_lock lock{free_pages_latch_};
+    auto &free_pages = free_pages_[fd];
+    page_id_t num_pages = fd2pageno_[fd];
+    while (!free_pages.pages.empty() && *free_pages.pages.rbegin() == num_pages - 1) {
+        free_pages.pages.erase(std::prev(free_pages.pages.end()));
+        num_pages--;
+    }
+    if (num_pages == fd2pageno_[fd]) return num_pages;
+
+    if (free_pages.persisted) remove_free_page_map_file(fd);
+    fd2pageno_[fd] = num_pages;
+    off_t new_size = static_cast<off_t>(num_pages) * fd_page_size_[fd];
+    struct stat stat_buf;
+    if (fstat(fd, &stat_buf) == -1 || (stat_buf.st_size > new_size && ftruncate(fd, new_size) == -1)) {
+        throw UnixError();
+    }
+    return num_pages;
+}
+
+/**
+ * @description: 把文件的空闲页面表写入磁盘, 文件名为数据文件名加FREE_PAGE_MAP_SUFFIX, 下次打开文件时读回
+ * @param {int} fd 文件句柄
+ */
+void DiskManager::flush_free_pages(int fd) {
+    std::scoped_lock lock{free_pages_latch_};
+    auto it = free_pages_.find(fd);
+    if (it == free_pages_.end() || it->second.pages.empty() || !fd2path_.count(fd)) return;
+    std::ofstream ofs(fd2path_[fd] + FREE_PAGE_MAP_SUFFIX, std::ios::out | std::ios::binary | std::ios::trunc);
+    int num_free_pages = static_cast<int>(it->second.pages.size());
+    ofs.write(reinterpret_cast<const char *>(&num_free_pages), sizeof(num_free_pages));
+    for (page_id_t page_no : it->second.pages) ofs.write(reinterpret_cast<const char *>(&page_no), sizeof(page_no));
+    ofs.close();
+    if (!ofs) {
+        throw InternalError("DiskManager::flush_free_pages Error - write failed");
+    }
+    it->second.persisted = true;
+}
+
+/**
+ * @description: 打开文件时读回空闲页面表
+ * @note 读回后立即删除磁盘上的空闲页面表文件, 之后直到下次flush_free_pages之前崩溃, 最多只是泄漏空闲页面,
+ *       不会把正在使用的页面当作空闲页面; 超出文件大小的页号被丢弃
+ */
+void DiskManager::load_free_pages(int fd) {
+    std::string map_path = fd2path_[fd] + FREE_PAGE_MAP_SUFFIX;
+    std::ifstream ifs(map_path, std::ios::in | std::ios::binary);
+    if (!ifs) return;
+    page_id_t file_pages = get_file_size(fd) / PAGE_SIZE;
+    std::scoped_lock lock{free_pages_latch_};
+    auto &free_pages = free_pages_[fd];
+    int num_free_pages = 0;
+    ifs.read(reinterpret_cast<char *>(&num_free_pages), sizeof(num_free_pages));
+    for (int i = 0; i < num_free_pages && ifs; i++) {
+        page_id_t page_no;
+        if (ifs.read(reinterpret_cast<char *>(&page_no), sizeof(page_no)) && page_no > 0 && page_no < file_pages) {
+            free_pages.pages.insert(page_no);
+        }
+    }
+    ifs.close();
+    remove_free_page_map_file(fd);
+}
+
+/**
+ * @description: 删除磁盘上的空闲页面表文件, 调用者持有free_pages_latch_
+ */
+void DiskManager::remove_free_page_map_file(int fd) {
+    std::string map_path = fd2path_[fd] + FREE_PAGE_MAP_SUFFIX;
+    if (unlink(map_path.c_str()) == -1 && errno != ENOENT) {
+        throw UnixError();
+    }
+    free_pages_[fd].persisted = false;
+}
 
 bool DiskManager::is_dir(const std::string& path) {
     struct stat st;
@@ -127,7 +421,12 @@ int DiskManager::destroy_file(const std::string &path) {
     // 注意不能删除未关闭的文件
     if (unlink(path.c_str()) == -1)
         throw FileNotFoundError("DiskManager::create_file Error - File destroying failed");
-    return path2fd_[path];
+    unlink((path + FREE_PAGE_MAP_SUFFIX).c_str());
+    auto it = path2fd_.find(path);
+    if (it == path2fd_.end()) return -1;  // 文件没有打开，不能用operator[]插入一个fd为0的表项
+    std::scoped_lock lock{free_pages_latch_};
+    free_pages_.erase(it->second);
+    return it->second;
 }
 
 
@@ -136,7 +435,13 @@ int DiskManager::destroy_file(const std::string &path) {
  * @return {int} 返回打开的文件的文件句柄
  * @param {string} &path 文件所在路径
  */
-int DiskManager::open_file(const std::string &path) {
+int DiskManager::open_file(const std::string &path) { return open_file(path, direct_io_); }
+
+/**
+ * @description: 打开指定路径文件
+ * @param {bool} direct_io 是否尝试以O_DIRECT方式打开, 文件系统不支持时退回普通I/O
+ */
+int DiskManager::open_file(const std::string &path, bool direct_io) {
     // Todo:
     // 调用open()函数，使用O_RDWR模式
     // 注意不能重复打开相同文件，并且需要更新文件打开列表
@@ -144,7 +449,12 @@ int DiskManager::open_file(const std::string &path) {
         if (it.first == path)
             return it.second;
 
-    int fd = open(path.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+    int fd = open(path.c_str(), O_RDWR | (direct_io ? O_DIRECT : 0), S_IRUSR | S_IWUSR);
+    if (fd == -1 && direct_io && errno == EINVAL) {
+        // 文件系统(如tmpfs)不支持O_DIRECT
+        direct_io = false;
+        fd = open(path.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+    }
 
     if (fd == -1) {
         throw FileNotFoundError("DiskManager::create_file Error - File creation failed");
@@ -152,6 +462,9 @@ int DiskManager::open_file(const std::string &path) {
 
     path2fd_.insert({path, fd});
     fd2path_.insert({fd, path});
+    fd_direct_[fd] = direct_io;
+    fd_page_size_[fd] = PAGE_SIZE;
+    load_free_pages(fd);
 
     return fd;
 }
@@ -174,9 +487,16 @@ void DiskManager::close_file(int fd) {
         }
 
     if (flag) {
+        flush_free_pages(fd);
+        {
+            std::scoped_lock lock{free_pages_latch_};
+            free_pages_.erase(fd);
+        }
         auto path = fd2path_[fd];
         path2fd_.erase(path);
         fd2path_.erase(fd);
+        fd_direct_[fd] = false;
+        fd_page_size_[fd] = PAGE_SIZE;
     }
 }
 
@@ -192,6 +512,17 @@ int DiskManager::get_file_size(const std::string &file_name) {
     return rc == 0 ? stat_buf.st_size : -1;
 }
 
+/**
+ * @description: 获取已打开文件的大小
+ * @return {int} 文件大小，失败时返回-1
+ * @param {int} fd 文件句柄
+ */
+int DiskManager::get_file_size(int fd) {
+    struct stat stat_buf;
+    int rc = fstat(fd, &stat_buf);
+    return rc == 0 ? stat_buf.st_size : -1;
+}
+
 /**
  * @description: 根据文件句柄获得文件名
  * @return {string} 文件句柄对应文件的文件名
@@ -227,7 +558,7 @@ int DiskManager::get_file_fd(const std::string &file_name) {
 int DiskManager::read_log(char *log_data, int size, int offset) {
     // read log file from the previous end
     if (log_fd_ == -1) {
-        log_fd_ = open_file(LOG_FILE_NAME);
+        log_fd_ = open_file(LOG_FILE_NAME, false);
     }
     int file_size = get_file_size(LOG_FILE_NAME);
     if (offset > file_size) {
@@ -236,8 +567,7 @@ int DiskManager::read_log(char *log_data, int size, int offset) {
 
     size = std::min(size, file_size - offset);
     if(size == 0) return 0;
-    lseek(log_fd_, offset, SEEK_SET);
-    ssize_t bytes_read = read(log_fd_, log_data, size);
+    ssize_t bytes_read = pread(log_fd_, log_data, size, offset);
     assert(bytes_read == size);
     return bytes_read;
 }
@@ -250,7 +580,7 @@ int DiskManager::read_log(char *log_data, int size, int offset) {
  */
 void DiskManager::write_log(char *log_data, int size) {
     if (log_fd_ == -1) {
-        log_fd_ = open_file(LOG_FILE_NAME);
+        log_fd_ = open_file(LOG_FILE_NAME, false);
     }
 
     // write from the file_end
@@ -17,18 +17,25 @@ See the Mulan PSL v2 for more details. */
 #include <atomic>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <set>
 #include <string>
 #include <unordered_map>
 
 #include "common/config.h"
 #include "errors.h"
+#include "storage/async_io.h"
+#include "storage/buffer_pool_stats.h"
 
 /**
  * @description: DiskManager的作用主要是根据上层的需要对磁盘文件进行操作
  */
 class DiskManager {
    public:
-    explicit DiskManager();
+    /**
+     * @param {bool} direct_io 数据文件是否以O_DIRECT方式打开, 绕过操作系统页缓存; 日志文件总是使用普通I/O
+     */
+    explicit DiskManager(bool direct_io = false);
 
     ~DiskManager() = default;
 
@@ -36,9 +43,31 @@ class DiskManager {
 
     void read_page(int fd, page_id_t page_no, char *offset, int num_bytes);
 
+    void write_pages(int fd, page_id_t start_page_no, char *const *pages, int num_pages);
+
+    void read_pages(int fd, page_id_t start_page_no, char *const *pages, int num_pages);
+
+    void advise_will_need(int fd, page_id_t start_page_no, int num_pages);
+
+    /**
+     * @description: 创建一个异步I/O上下文, 用于同时发起多个页面的读写, 优先使用io_uring
+     * @param {size_t} queue_depth 同时在途的请求数上限
+     */
+    std::unique_ptr<AsyncIo> create_async_io(size_t queue_depth = ASYNC_IO_QUEUE_DEPTH) {
+        return AsyncIo::create(queue_depth);
+    }
+
     page_id_t allocate_page(int fd);
 
-    void deallocate_page(page_id_t page_id);
+    void deallocate_page(int fd, page_id_t page_no);
+
+    bool is_free_page(int fd, page_id_t page_no);
+
+    int get_num_free_pages(int fd);
+
+    page_id_t truncate_free_pages(int fd);
+
+    void flush_free_pages(int fd);
 
     /*目录操作*/
     bool is_dir(const std::string &path);
@@ -60,8 +89,12 @@ class DiskManager {
 
     int get_file_size(const std::string &file_name);
 
+    int get_file_size(int fd);
+
     std::string get_file_name(int fd);
 
+    bool is_file_open(int fd) const { return fd2path_.count(fd) != 0; }
+
     int get_file_fd(const std::string &file_name);
 
     /*日志操作*/
@@ -87,15 +120,59 @@ class DiskManager {
      */
     page_id_t get_fd2pageno(int fd) { return fd2pageno_[fd]; }
 
+    void set_page_size(int fd, int page_size);
+
+    /**
+     * @description: 获得文件的页面大小, 页号为page_no的页面从文件的page_no * 页面大小处开始
+     * @return {int} 页面大小, 打开文件后还没有设置时为PAGE_SIZE
+     * @param {int} fd 文件对应的句柄
+     */
+    int get_page_size(int fd) const { return fd_page_size_[fd]; }
+
     static constexpr int MAX_FD = 8192;
 
     int get_fd2path(const std::string& path) { return path2fd_[path]; }
 
+    // 数据页面读写的延迟统计, 每次read_page/read_pages调用记录一次, 写同理
+    LatencySummary get_read_latency() const { return read_latency_.summary(); }
+
+    LatencySummary get_write_latency() const { return write_latency_.summary(); }
+
    private:
+    void rw_pages(int fd, page_id_t start_page_no, char *const *pages, int num_pages, bool is_write);
+
+    int open_file(const std::string &path, bool direct_io);
+
+    void load_free_pages(int fd);
+
+    void remove_free_page_map_file(int fd);
+
+    /**
+     * @description: O_DIRECT要求缓冲区地址和读写长度都按块对齐, 判断对fd的这次读写是否需要经过对齐的中转缓冲区
+     */
+    bool need_bounce_buffer(int fd, const char *buf, int num_bytes) const {
+        return fd_direct_[fd] && (reinterpret_cast<uintptr_t>(buf) % PAGE_SIZE != 0 || num_bytes % PAGE_SIZE != 0);
+    }
+
+    bool direct_io_;  // 数据文件是否使用O_DIRECT
+
     // 文件打开列表，用于记录文件是否被打开
     std::unordered_map<std::string, int> path2fd_;  //<Page文件磁盘路径,Page fd>哈希表
     std::unordered_map<int, std::string> fd2path_;  //<Page fd,Page文件磁盘路径>哈希表
 
     int log_fd_ = -1;  // WAL日志文件的文件句柄，默认为-1，代表未打开日志文件
     std::atomic<page_id_t> fd2pageno_[MAX_FD]{-1};  // 文件中已经分配的页面个数，初始值为0
+    bool fd_direct_[MAX_FD];                        // 文件句柄是否以O_DIRECT方式打开
+    int fd_page_size_[MAX_FD];                      // 文件的页面大小, 由表和索引的文件头决定
+
+    /* 文件中已经释放、可以被allocate_page复用的页面 */
+    struct FreePageMap {
+        std::set<page_id_t> pages;
+        bool persisted = false;  // 磁盘上是否有与之对应的空闲页面表文件
+    };
+    std::mutex free_pages_latch_;                        // 保护free_pages_
+    std::unordered_map<int, FreePageMap> free_pages_;    // <Page fd, 空闲页面表>
+
+    LatencyHistogram read_latency_;
+    LatencyHistogram write_latency_;
 };
\ No newline at end of file
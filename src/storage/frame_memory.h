@@ -0,0 +1,56 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <sys/mman.h>
+
+#include <cstdint>
+
+#include "common/config.h"
+#include "errors.h"
+
+/**
+ * @description: 缓冲池所有帧共用的一块连续内存, 用mmap一次性申请, 起始地址按PAGE_SIZE对齐, 满足O_DIRECT对缓冲区地址的要求;
+ * use_huge_pages为true时区域按2MB对齐, 并用madvise(MADV_HUGEPAGE)建议内核使用透明大页, 减少大缓冲池的TLB缺失
+ */
+class FrameMemory {
+   private:
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    void *mapping_;        // mmap返回的地址, 为了对齐会比data_多申请一些
+    size_t mapping_size_;
+    char *data_;
+    size_t size_;
+
+   public:
+    FrameMemory(size_t size, bool use_huge_pages) : size_(size) {
+        size_t alignment = use_huge_pages ? HUGE_PAGE_SIZE : PAGE_SIZE;
+        mapping_size_ = size_ + alignment;
+        mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping_ == MAP_FAILED) throw UnixError();
+        uintptr_t addr = reinterpret_cast<uintptr_t>(mapping_);
+        data_ = reinterpret_cast<char *>((addr + alignment - 1) / alignment * alignment);
+        // 内核不支持透明大页时madvise失败, 仍然使用普通页面
+        if (use_huge_pages) madvise(data_, size_, MADV_HUGEPAGE);
+    }
+
+    ~FrameMemory() { munmap(mapping_, mapping_size_); }
+
+    FrameMemory(const FrameMemory &) = delete;
+    FrameMemory &operator=(const FrameMemory &) = delete;
+
+    char *data() const { return data_; }
+
+    // 把物理内存交还给操作系统, 映射仍然有效, 之后读到的是全0, 写入时重新分配
+    void release() { madvise(data_, size_, MADV_DONTNEED); }
+
+    size_t size() const { return size_; }
+};
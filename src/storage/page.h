@@ -10,6 +10,11 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <atomic>
+#include <cstring>
+#include <shared_mutex>
+#include <string>
+
 #include "common/config.h"
 
 /**
@@ -44,16 +49,33 @@ struct std::hash<PageId> {
     size_t operator()(const PageId &obj) const { return std::hash<int64_t>()(obj.Get()); }
 };
 
+/**
+ * @description: 判断page_size是否为合法的页面大小, 即PAGE_SIZE到MAX_PAGE_SIZE之间的2的幂
+ */
+inline bool is_valid_page_size(int page_size) {
+    return page_size >= PAGE_SIZE && page_size <= MAX_PAGE_SIZE && (page_size & (page_size - 1)) == 0;
+}
+
+/**
+ * @description: 页面大小对应的缓冲池帧大小类别, PAGE_SIZE为0, 之后每翻一倍加1
+ */
+inline int get_page_size_class(int page_size) {
+    int size_class = 0;
+    while ((PAGE_SIZE << size_class) < page_size) size_class++;
+    return size_class;
+}
+
 /**
  * @description: Page类声明, Page是RMDB数据块的单位、是负责数据操作Record模块的操作对象，
  * Page对象在磁盘上有文件存储, 若在Buffer中则有帧偏移, 并非特指Buffer或Disk上的数据
  */
 class Page {
     friend class BufferPoolManager;
+    friend class BufferPoolInstance;
 
    public:
     
-    Page() { reset_memory(); }
+    Page() = default;
 
     ~Page() = default;
 
@@ -61,8 +83,45 @@ class Page {
 
     inline char *get_data() { return data_; }
 
+    int get_page_size() const { return page_size_; }
+
     bool is_dirty() const { return is_dirty_; }
 
+    /**
+     * 帧的读写latch, 保护并发线程对页面内容的访问(堆文件的页面、B+树的结点)
+     * latch属于帧而不是页面, 持有latch期间必须保持页面被pin住, 否则帧可能被淘汰并装入其他页面
+     * 加写latch和释放写latch时各把版本号加一, 持有写latch期间版本号为奇数
+     */
+    void w_latch() {
+        rwlatch_.lock();
+        version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void w_unlatch() {
+        version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        rwlatch_.unlock();
+    }
+
+    void r_latch() { rwlatch_.lock_shared(); }
+
+    void r_unlatch() { rwlatch_.unlock_shared(); }
+
+    /**
+     * 乐观读(optimistic lock coupling): 不加latch, 只读取版本号, 不写帧的任何共享状态
+     * 读页面内容之前用read_version记下版本号, 页面正被加写latch时返回false;
+     * 读完之后用validate检查版本号是否变化, 变化说明读到的内容可能不一致, 必须丢弃重读
+     */
+    bool read_version(uint64_t *version) const {
+        *version = version_.load(std::memory_order_acquire);
+        return (*version & 1) == 0;
+    }
+
+    bool validate(uint64_t version) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return version_.load(std::memory_order_relaxed) == version;
+    }
+
     static constexpr size_t OFFSET_PAGE_START = 0;
     static constexpr size_t OFFSET_LSN = 0;
     static constexpr size_t OFFSET_PAGE_HDR = 4;
@@ -72,19 +131,37 @@ class Page {
     inline void set_page_lsn(lsn_t page_lsn) { memcpy(get_data() + OFFSET_LSN, &page_lsn, sizeof(lsn_t)); }
 
    private:
-    void reset_memory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }  // 将data_的PAGE_SIZE个字节填充为0
+    void reset_memory() { memset(data_, OFFSET_PAGE_START, page_size_); }  // 将data_的page_size_个字节填充为0
+
+    /**
+     * 缓冲池改变帧中的页面(装入、淘汰、删除)时把版本号加一, 使不pin页面的乐观读者之前读出的版本号失效;
+     * 开始装入时调用一次使版本号变为奇数, 装入完成后再调用一次, 调用时帧没有被固定, 没有线程持有写latch
+     */
+    void bump_version() {
+        version_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
 
     /** page的唯一标识符 */
     PageId id_;
 
     /** The actual data that is stored within a page.
-     *  该页面在bufferPool中的偏移地址
+     *  该页面在bufferPool中的偏移地址, 指向缓冲池帧内存(FrameMemory)中按PAGE_SIZE对齐的一帧, 由缓冲池在构造时设置
      */
-    char data_[PAGE_SIZE] = {};
+    char *data_ = nullptr;
+
+    /** 帧的大小, 即帧中页面所在文件的页面大小, 由缓冲池在构造时设置 */
+    int page_size_ = PAGE_SIZE;
 
     /** 脏页判断 */
     bool is_dirty_ = false;
 
     /** The pin count of this page. */
     int pin_count_ = 0;
+
+    /** 帧的读写latch */
+    std::shared_mutex rwlatch_;
+
+    /** 帧的版本号, 每次加/释放写latch以及帧中的页面改变时加一, 供乐观读验证 */
+    std::atomic<uint64_t> version_{0};
 };
\ No newline at end of file
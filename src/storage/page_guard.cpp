@@ -0,0 +1,48 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "page_guard.h"
+
+#include "buffer_pool_manager.h"
+
+PageGuard::PageGuard(BufferPoolManager *bpm, Page *page, bool is_dirty, LatchMode latch_mode)
+    : bpm_(bpm), page_(page), is_dirty_(is_dirty), latch_mode_(latch_mode) {
+    if (page_ == nullptr) return;
+    if (latch_mode_ == LatchMode::READ) page_->r_latch();
+    if (latch_mode_ == LatchMode::WRITE) page_->w_latch();
+}
+
+PageGuard::PageGuard(PageGuard &&other) noexcept
+    : bpm_(other.bpm_), page_(other.page_), is_dirty_(other.is_dirty_), latch_mode_(other.latch_mode_) {
+    other.page_ = nullptr;
+}
+
+PageGuard &PageGuard::operator=(PageGuard &&other) noexcept {
+    if (this != &other) {
+        drop();
+        bpm_ = other.bpm_;
+        page_ = other.page_;
+        is_dirty_ = other.is_dirty_;
+        latch_mode_ = other.latch_mode_;
+        other.page_ = nullptr;
+    }
+    return *this;
+}
+
+/**
+ * @description: 释放守卫持有的latch并unpin页面，守卫不持有页面时什么也不做
+ */
+void PageGuard::drop() {
+    if (page_ == nullptr) return;
+    if (latch_mode_ == LatchMode::READ) page_->r_unlatch();
+    if (latch_mode_ == LatchMode::WRITE) page_->w_unlatch();
+    bpm_->unpin_page(page_->get_page_id(), is_dirty_);
+    page_ = nullptr;
+}
@@ -0,0 +1,81 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "page.h"
+
+class BufferPoolManager;
+
+/**
+ * @description: 持有缓冲池中一个页面的一次pin, 析构时自动unpin该页面
+ * 守卫只能移动不能复制, 保证每次fetch_page/new_page恰好对应一次unpin_page;
+ * 被移动之后的守卫不再持有页面, 析构时什么也不做
+ * PageGuard本身不加latch, 由调用者自行管理页面的latch(如B+树的latch crabbing);
+ * ReadPageGuard/WritePageGuard在持有pin期间还持有页面的读/写latch, 先释放latch再unpin
+ */
+class PageGuard {
+   public:
+    PageGuard() = default;
+
+    PageGuard(BufferPoolManager *bpm, Page *page, bool is_dirty) : bpm_(bpm), page_(page), is_dirty_(is_dirty) {}
+
+    PageGuard(const PageGuard &) = delete;
+    PageGuard &operator=(const PageGuard &) = delete;
+
+    PageGuard(PageGuard &&other) noexcept;
+
+    PageGuard &operator=(PageGuard &&other) noexcept;
+
+    ~PageGuard() { drop(); }
+
+    // 提前释放latch并unpin页面, 之后守卫不再持有页面
+    void drop();
+
+    // 页面被修改过, unpin时标记为脏页
+    void mark_dirty() { is_dirty_ = true; }
+
+    // 是否持有页面, 缓冲池中没有可用的帧时fetch_page/new_page得到的守卫不持有页面
+    bool is_valid() const { return page_ != nullptr; }
+
+    Page *get_page() const { return page_; }
+
+    PageId get_page_id() const { return page_->get_page_id(); }
+
+    char *get_data() const { return page_->get_data(); }
+
+   protected:
+    enum class LatchMode { NONE, READ, WRITE };
+
+    PageGuard(BufferPoolManager *bpm, Page *page, bool is_dirty, LatchMode latch_mode);
+
+    BufferPoolManager *bpm_ = nullptr;
+    Page *page_ = nullptr;
+    bool is_dirty_ = false;
+    LatchMode latch_mode_ = LatchMode::NONE;  // 守卫持有的页面latch
+};
+
+/* 只读取页面内容的守卫, 持有页面的读latch, unpin时不标记脏页 */
+class ReadPageGuard : public PageGuard {
+   public:
+    ReadPageGuard() = default;
+
+    ReadPageGuard(BufferPoolManager *bpm, Page *page) : PageGuard(bpm, page, false, LatchMode::READ) {}
+
+    const char *get_data() const { return page_->get_data(); }
+};
+
+/* 会修改页面内容的守卫, 持有页面的写latch, unpin时总是标记为脏页 */
+class WritePageGuard : public PageGuard {
+   public:
+    WritePageGuard() = default;
+
+    WritePageGuard(BufferPoolManager *bpm, Page *page) : PageGuard(bpm, page, true, LatchMode::WRITE) {}
+};
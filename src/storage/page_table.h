@@ -0,0 +1,129 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "page.h"
+
+/**
+ * @description: 缓冲池的页表, 记录PageId到帧号的映射
+ * 使用线性探测的开放寻址哈希表, 槽位数组在构造时一次性分配, 大小为不小于2*pool_size的2的幂,
+ * 之后的查找、插入、删除都不会再申请内存(只有缓冲池改变大小时重新分配); 删除时使用后移(backward shift)而不是墓碑, 探测链长度不会随时间退化
+ */
+class PageTable {
+   private:
+    struct Slot {
+        PageId page_id;
+        frame_id_t frame_id = INVALID_FRAME_ID;  // 为INVALID_FRAME_ID表示槽位为空
+    };
+
+    std::vector<Slot> slots_;
+    size_t mask_;  // 槽位个数-1, 用于取模
+    size_t size_ = 0;
+
+   public:
+    explicit PageTable(size_t pool_size) { allocate(pool_size); }
+
+    size_t size() const { return size_; }
+
+    /**
+     * @description: 缓冲池大小改变时重新分配槽位数组, 把已有的映射重新插入
+     * @param {size_t} pool_size 新的缓冲池大小, 不能小于表中已有的映射个数
+     */
+    void resize(size_t pool_size) {
+        assert(size_ <= pool_size);
+        std::vector<Slot> old_slots;
+        old_slots.swap(slots_);
+        allocate(pool_size);
+        size_ = 0;
+        for (const Slot &slot : old_slots) {
+            if (slot.frame_id != INVALID_FRAME_ID) insert(slot.page_id, slot.frame_id);
+        }
+    }
+
+    /**
+     * @description: 查找page_id所在的帧
+     * @return {bool} 找到返回true, 否则返回false
+     * @param {PageId} page_id 目标页
+     * @param {frame_id_t*} frame_id 找到时存储目标页所在的帧号
+     */
+    bool find(const PageId &page_id, frame_id_t *frame_id) const {
+        for (size_t pos = hash(page_id);; pos = (pos + 1) & mask_) {
+            const Slot &slot = slots_[pos];
+            if (slot.frame_id == INVALID_FRAME_ID) return false;
+            if (slot.page_id == page_id) {
+                *frame_id = slot.frame_id;
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @description: 插入page_id到frame_id的映射, 调用者保证page_id不在表中
+     */
+    void insert(const PageId &page_id, frame_id_t frame_id) {
+        assert(size_ < slots_.size());
+        size_t pos = hash(page_id);
+        while (slots_[pos].frame_id != INVALID_FRAME_ID) pos = (pos + 1) & mask_;
+        slots_[pos].page_id = page_id;
+        slots_[pos].frame_id = frame_id;
+        size_++;
+    }
+
+    /**
+     * @description: 删除page_id的映射
+     * @return {bool} page_id在表中则返回true, 否则返回false
+     */
+    bool erase(const PageId &page_id) {
+        size_t pos = hash(page_id);
+        while (true) {
+            if (slots_[pos].frame_id == INVALID_FRAME_ID) return false;
+            if (slots_[pos].page_id == page_id) break;
+            pos = (pos + 1) & mask_;
+        }
+        // 把后续探测链上的元素前移填补空位, 保证每个元素到其理想位置之间没有空槽
+        size_t hole = pos;
+        for (size_t next = (hole + 1) & mask_; slots_[next].frame_id != INVALID_FRAME_ID; next = (next + 1) & mask_) {
+            size_t ideal = hash(slots_[next].page_id);
+            // ideal不在(hole, next]区间内时才能把next移到hole
+            if (((next - ideal) & mask_) >= ((next - hole) & mask_)) {
+                slots_[hole] = slots_[next];
+                hole = next;
+            }
+        }
+        slots_[hole].frame_id = INVALID_FRAME_ID;
+        size_--;
+        return true;
+    }
+
+    /**
+     * @description: PageId的哈希值, 对槽位个数取模之前的结果; 缓冲池中其他按PageId散列的表也使用它
+     */
+    static size_t mix(const PageId &page_id) {
+        uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(page_id.fd)) << 32) |
+                       static_cast<uint32_t>(page_id.page_no);
+        key *= 0x9E3779B97F4A7C15ULL;  // Fibonacci哈希, 使连续页号分散到不同的槽位
+        return static_cast<size_t>(key >> 32);
+    }
+
+   private:
+    void allocate(size_t pool_size) {
+        size_t capacity = 1;
+        while (capacity < pool_size * 2) capacity <<= 1;
+        slots_.assign(capacity, Slot());
+        mask_ = capacity - 1;
+    }
+
+    size_t hash(const PageId &page_id) const { return mix(page_id) & mask_; }
+};
@@ -13,7 +13,9 @@ See the Mulan PSL v2 for more details. */
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <cassert>
 #include <fstream>
+#include <map>
 
 #include "index/ix.h"
 #include "record/rm.h"
@@ -98,13 +100,14 @@ void SmManager::open_db(const std::string& db_name) {
             auto tab_ptr = rm_manager_->open_file(tab_name);
             fhs_[tab_name] = std::move(tab_ptr);
 
-            auto tab_meta = table.second;
+            const auto& tab_meta = table.second;
             for (const auto& idx_meta : tab_meta.indexes) {
                 auto idx_name = ix_manager_->get_index_name(tab_name, idx_meta.cols);
                 auto idx_ptr = ix_manager_->open_index(tab_name, idx_meta.cols);
                 ihs_[idx_name] = std::move(idx_ptr);
             }
         }
+        load_buffer_pool();
     }
 }
 
@@ -121,6 +124,7 @@ void SmManager::flush_meta() {
  * @description: 关闭数据库并把数据落盘
  */
 void SmManager::close_db() {
+    dump_buffer_pool();
     for (const auto& table : fhs_)
         rm_manager_->close_file(table.second.get());
     for (const auto& index : ihs_)
@@ -177,16 +181,22 @@ void SmManager::desc_table(const std::string& tab_name, Context* context) {
  * @param {string&} tab_name 表的名称
  * @param {vector<ColDef>&} col_defs 表的字段
  * @param {Context*} context 
+ * @param {int} page_size 数据文件的页面大小
+ * @param {RmRecordFormat} format 数据文件的记录格式，变长记录格式中字符串字段按实际长度存储
  */
-void SmManager::create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context) {
+void SmManager::create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context,
+                             int page_size, RmRecordFormat format) {
     if (db_.is_table(tab_name)) {
         throw TableExistsError(tab_name);
     }
+    check_page_size(page_size);
     // Create table meta
     int curr_offset = 0;
     TabMeta tab;
     tab.name = tab_name;
+    std::vector<RmVarField> var_fields;
     for (auto &col_def : col_defs) {
+        if (col_def.type == TYPE_STRING) var_fields.push_back({curr_offset, col_def.len});
         ColMeta col = {.tab_name = tab_name,
                        .name = col_def.name,
                        .type = col_def.type,
@@ -198,7 +208,7 @@ void SmManager::create_table(const std::string& tab_name, const std::vector<ColD
     }
     // Create & open record file
     int record_size = curr_offset;  // record_size就是col meta所占的大小（表的元数据也是以记录的形式进行存储的）
-    int fd = rm_manager_->create_file(tab_name, record_size);
+    int fd = rm_manager_->create_file(tab_name, record_size, page_size, format, var_fields);
     if (context)
         context->lock_mgr_->lock_exclusive_on_table(context->txn_, fd);
     db_.tabs_[tab_name] = tab;
@@ -208,6 +218,16 @@ void SmManager::create_table(const std::string& tab_name, const std::vector<ColD
     flush_meta();
 }
 
+/**
+ * @description: 检查create table/index指定的页面大小
+ */
+void SmManager::check_page_size(int page_size) {
+    if (!is_valid_page_size(page_size)) {
+        throw RMDBError("page_size must be a power of two between " + std::to_string(PAGE_SIZE / 1024) + " and " +
+                        std::to_string(MAX_PAGE_SIZE / 1024) + " KB");
+    }
+}
+
 /**
  * @description: 删除表
  * @param {string&} tab_name 表的名称
@@ -231,8 +251,11 @@ void SmManager::drop_table(const std::string& tab_name, Context* context) {
  * @param {string&} tab_name 表的名称
  * @param {vector<string>&} col_names 索引包含的字段名称
  * @param {Context*} context
+ * @param {int} page_size 索引文件的页面大小, 较大的页面使B+树的扇出更大、层数更少
  */
-void SmManager::create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context) {
+void SmManager::create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context,
+                             int page_size) {
+    check_page_size(page_size);
     auto& tab_meta = db_.get_table(tab_name);
     IndexMeta index_meta = {tab_name};
     std::vector<ColMeta> &col_meta = index_meta.cols;
@@ -244,10 +267,51 @@ void SmManager::create_index(const std::string& tab_name, const std::vector<std:
     }
     if (context && !context->lock_mgr_->lock_exclusive_on_table(context->txn_, disk_manager_->get_fd2path(tab_name)))
         throw TransactionAbortException(context->txn_->get_transaction_id(), AbortReason::LOCK_ON_SHIRINKING);
-    ix_manager_->create_index(tab_name, col_meta);
+    ix_manager_->create_index(tab_name, col_meta, page_size);
+    auto ih = ix_manager_->open_index(tab_name, col_meta);
+
+    // 表中已有的记录排序后自底向上批量加载到索引中，表上已加排他锁，不再对每条记录加锁
+    auto fh = fhs_.at(tab_name).get();
+    try {
+        IxBulkLoader loader(ih.get());
+        std::vector<char> key(index_meta.col_tot_len);
+        // 按页批量取出记录，每个页面只pin一次，变长记录格式解码到批次中复用的缓冲区，不逐条分配内存
+        RmScan scan(fh);
+        RmPageBatch batch;
+        while (scan.next_batch(&batch, RmScanPredicate())) {
+            for (size_t i = 0; i < batch.size(); i++) {
+                const char* rec = batch.get_record(i);
+                int offset = 0;
+                for (auto& col : col_meta) {
+                    memcpy(key.data() + offset, rec + col.offset, col.len);
+                    offset += col.len;
+                }
+                loader.add(key.data(), batch.rid(i));
+            }
+        }
+        loader.finish();
+    } catch (...) {
+        // 已有的记录中有重复的key等原因加载失败时删除建了一半的索引；loader析构时已经unpin了它的结点，
+        // 先把索引的页面从缓冲池中删除，以免之后复用这个文件句柄的文件读到它们
+        int fd = ih->get_fd();
+        bool deleted = true;
+        for (page_id_t page_no = 0; page_no < ih->get_num_pages(); page_no++) {
+            deleted = buffer_pool_manager_->delete_page({fd, page_no}) && deleted;
+        }
+        assert(deleted);
+        ih.reset();
+        if (deleted) {
+            // 关闭之后destroy_index找不到文件句柄，在这里清除它在缓冲池中的访问计数
+            buffer_pool_manager_->reset_file_counters(fd);
+            disk_manager_->close_file(fd);
+        }
+        // 仍有页面被固定时不关闭文件，文件句柄不会被其他文件复用，残留的页面也就不会被读到
+        ix_manager_->destroy_index(tab_name, col_meta);
+        throw;
+    }
+
     tab_meta.indexes.push_back(index_meta);
-    ihs_[ix_manager_->get_index_name(tab_name, col_meta)]
-        = ix_manager_->open_index(tab_name, col_meta);
+    ihs_[ix_manager_->get_index_name(tab_name, col_meta)] = std::move(ih);
 }
 
 /**
@@ -286,4 +350,220 @@ void SmManager::drop_index(const std::string& tab_name, const std::vector<ColMet
             if (indexs[i] == delete_index)
                 indexs.erase(indexs.begin() + i);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @description: 整理表的数据文件和索引文件：回收不含记录的数据页面，截断文件末尾的空闲页面
+ * @param {string&} tab_name 表名称，为空时整理所有表
+ * @param {Context*} context
+ * @note 整理期间持有表上的排他锁，可以在数据库运行时执行
+ */
+void SmManager::compact(const std::string& tab_name, Context* context) {
+    std::vector<std::string> tab_names;
+    if (tab_name.empty()) {
+        for (auto& entry : db_.tabs_) tab_names.push_back(entry.first);
+    } else {
+        db_.get_table(tab_name);
+        tab_names.push_back(tab_name);
+    }
+
+    std::vector<std::string> captions = {"File", "Pages Before", "Pages After", "Free Pages"};
+    RecordPrinter printer(captions.size());
+    printer.print_separator(context);
+    printer.print_record(captions, context);
+    printer.print_separator(context);
+    for (auto& name : tab_names) {
+        auto fh = fhs_.at(name).get();
+        if (context && !context->lock_mgr_->lock_exclusive_on_table(context->txn_, fh->GetFd()))
+            throw TransactionAbortException(context->txn_->get_transaction_id(), AbortReason::LOCK_ON_SHIRINKING);
+        int pages_before = fh->get_file_hdr().num_pages;
+        int pages_after = fh->compact();
+        printer.print_record({name, std::to_string(pages_before), std::to_string(pages_after),
+                              std::to_string(disk_manager_->get_num_free_pages(fh->GetFd()))},
+                             context);
+        for (auto& index : db_.get_table(name).indexes) {
+            auto idx_name = ix_manager_->get_index_name(name, index.cols);
+            auto ih = ihs_.at(idx_name).get();
+            pages_before = ih->get_num_pages();
+            pages_after = ih->compact();
+            printer.print_record({idx_name, std::to_string(pages_before), std::to_string(pages_after),
+                                  std::to_string(disk_manager_->get_num_free_pages(ih->get_fd()))},
+                                 context);
+        }
+    }
+    printer.print_separator(context);
+}
+
+namespace {
+
+std::string format_ratio(double ratio) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%.2f%%", ratio * 100);
+    return buf;
+}
+
+std::string format_average(double micros) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.1f", micros);
+    return buf;
+}
+
+std::vector<std::string> format_counters(std::string name, const BufferPoolCounters& counters) {
+    return {std::move(name),
+            std::to_string(counters.hits),
+            std::to_string(counters.misses),
+            format_ratio(counters.hit_ratio()),
+            std::to_string(counters.evictions),
+            std::to_string(counters.writebacks),
+            std::to_string(counters.pin_waits)};
+}
+
+}  // namespace
+
+/**
+ * @description: 把缓冲池中属于当前数据库的页面保存到BUFFER_POOL_DUMP_NAME, 下次打开数据库时用于预热缓冲池
+ * @note 只保存页号而不保存页面内容, 每个文件一行: 文件名 页面个数 页号...
+ */
+void SmManager::dump_buffer_pool() {
+    std::unordered_map<int, std::string> fd2name;
+    for (auto& entry : fhs_) fd2name[entry.second->GetFd()] = entry.first;
+    for (auto& entry : ihs_) fd2name[entry.second->get_fd()] = entry.first;
+    std::map<std::string, std::vector<page_id_t>> file_pages;
+    for (auto& page_id : buffer_pool_manager_->get_resident_pages()) {
+        auto it = fd2name.find(page_id.fd);
+        if (it != fd2name.end()) file_pages[it->second].push_back(page_id.page_no);
+    }
+
+    std::ofstream ofs(BUFFER_POOL_DUMP_NAME);
+    for (auto& entry : file_pages) {
+        ofs << entry.first << ' ' << entry.second.size();
+        for (page_id_t page_no : entry.second) ofs << ' ' << page_no;
+        ofs << '\n';
+    }
+}
+
+/**
+ * @description: 读取上次关闭数据库时保存的页面列表, 把这些页面重新读入缓冲池
+ * @note 启用预读时在后台读入, 不阻塞数据库的启动; 已经删除的文件中的页面会被跳过
+ */
+void SmManager::load_buffer_pool() {
+    std::ifstream ifs(BUFFER_POOL_DUMP_NAME);
+    if (!ifs) return;
+    std::unordered_map<std::string, int> name2fd;
+    for (auto& entry : fhs_) name2fd[entry.first] = entry.second->GetFd();
+    for (auto& entry : ihs_) name2fd[entry.first] = entry.second->get_fd();
+
+    std::vector<PageId> page_ids;
+    std::string name;
+    size_t num_pages;
+    while (ifs >> name >> num_pages) {
+        auto it = name2fd.find(name);
+        for (size_t i = 0; i < num_pages; i++) {
+            page_id_t page_no;
+            if (!(ifs >> page_no)) break;
+            if (it != name2fd.end()) page_ids.push_back({it->second, page_no});
+        }
+    }
+    buffer_pool_manager_->warm_up(std::move(page_ids));
+}
+
+/**
+ * @description: 显示缓冲池的统计信息：各个分区的帧使用情况和命中率、磁盘读写延迟分布、各个文件的命中率
+ * @param {Context*} context
+ * @note 计数器从数据库启动开始累计，统计快照不会阻塞其他查询
+ */
+void SmManager::show_buffer_stats(Context* context) {
+    auto pool_stats = buffer_pool_manager_->get_stats();
+
+    std::vector<std::string> captions = {"Pool",   "Page Size", "Frames",    "Used",        "Dirty",    "Hits",
+                                         "Misses", "Hit Ratio", "Evictions", "Write-backs", "Pin Waits"};
+    RecordPrinter printer(captions.size());
+    printer.print_separator(context);
+    printer.print_record(captions, context);
+    printer.print_separator(context);
+    size_t total_frames = 0, total_used = 0, total_dirty = 0;
+    BufferPoolCounters total;
+    std::vector<BufferPoolCounters> file_counters;
+    auto print_pool = [&](const std::string& name, const std::string& page_size, size_t frames, size_t used,
+                          size_t dirty, const BufferPoolCounters& counters) {
+        auto row = format_counters(name, counters);
+        row.insert(row.begin() + 1,
+                   {page_size, std::to_string(frames), std::to_string(used), std::to_string(dirty)});
+        printer.print_record(row, context);
+    };
+    // 每种页面大小的一组分区各自从0开始编号
+    size_t num_instances = buffer_pool_manager_->get_num_instances();
+    for (size_t i = 0; i < pool_stats.size(); i++) {
+        auto& stats = pool_stats[i];
+        print_pool(std::to_string(i % num_instances), std::to_string(stats.page_size / 1024) + "KB", stats.pool_size,
+                   stats.used_frames, stats.dirty_frames, stats.counters);
+        total_frames += stats.pool_size;
+        total_used += stats.used_frames;
+        total_dirty += stats.dirty_frames;
+        total += stats.counters;
+        if (file_counters.size() < stats.file_counters.size()) file_counters.resize(stats.file_counters.size());
+        for (size_t fd = 0; fd < stats.file_counters.size(); fd++) file_counters[fd] += stats.file_counters[fd];
+    }
+    printer.print_separator(context);
+    print_pool("total", "", total_frames, total_used, total_dirty, total);
+    printer.print_separator(context);
+
+    // 磁盘读写延迟的直方图，只显示非空的区间
+    LatencySummary reads = disk_manager_->get_read_latency();
+    LatencySummary writes = disk_manager_->get_write_latency();
+    RecordPrinter latency_printer(3);
+    latency_printer.print_separator(context);
+    latency_printer.print_record({"Latency (us)", "Reads", "Writes"}, context);
+    latency_printer.print_separator(context);
+    for (int i = 0; i < LatencySummary::NUM_BUCKETS; i++) {
+        if (reads.buckets[i] == 0 && writes.buckets[i] == 0) continue;
+        std::string range = i + 1 == LatencySummary::NUM_BUCKETS
+                                ? ">= " + std::to_string(LatencySummary::bucket_lower_bound(i))
+                                : "< " + std::to_string(LatencySummary::bucket_lower_bound(i + 1));
+        latency_printer.print_record({range, std::to_string(reads.buckets[i]), std::to_string(writes.buckets[i])},
+                                     context);
+    }
+    latency_printer.print_separator(context);
+    latency_printer.print_record({"total", std::to_string(reads.count), std::to_string(writes.count)}, context);
+    latency_printer.print_record({"pages", std::to_string(reads.pages), std::to_string(writes.pages)}, context);
+    latency_printer.print_record(
+        {"avg (us)", format_average(reads.average_us()), format_average(writes.average_us())}, context);
+    latency_printer.print_record(
+        {"p99 (us)", std::to_string(reads.percentile_us(0.99)), std::to_string(writes.percentile_us(0.99))},
+        context);
+    latency_printer.print_separator(context);
+
+    // 各个文件的命中率，只显示仍然打开的文件
+    RecordPrinter file_printer(7);
+    file_printer.print_separator(context);
+    file_printer.print_record({"File", "Hits", "Misses", "Hit Ratio", "Evictions", "Write-backs", "Pin Waits"},
+                              context);
+    file_printer.print_separator(context);
+    for (size_t fd = 0; fd < file_counters.size(); fd++) {
+        if (file_counters[fd].empty() || !disk_manager_->is_file_open(fd)) continue;
+        file_printer.print_record(format_counters(disk_manager_->get_file_name(fd), file_counters[fd]), context);
+    }
+    file_printer.print_separator(context);
+}
+
+/**
+ * @description: 在线调整缓冲池的大小, 显示调整前后的大小
+ * @param {int} size_mb 新的大小(MB)
+ * @param {Context*} context
+ * @note 缩小时需要等待被固定的页面释放, 语句在缓冲池腾空多余的帧之后才返回, 期间其他查询照常执行;
+ *       等待超时的分区保持原来的大小, 显示的是实际达到的大小
+ */
+void SmManager::set_buffer_pool_size(int size_mb, Context* context) {
+    if (size_mb <= 0) throw RMDBError("buffer_pool_size must be a positive number of MB");
+    size_t old_size = buffer_pool_manager_->get_pool_size();
+    size_t new_size = buffer_pool_manager_->resize(static_cast<size_t>(size_mb) * 1024 * 1024 / PAGE_SIZE);
+
+    auto format_size = [](size_t frames) { return std::to_string(frames * PAGE_SIZE / (1024 * 1024)); };
+    RecordPrinter printer(3);
+    printer.print_separator(context);
+    printer.print_record({"Buffer Pool", "Frames", "Size (MB)"}, context);
+    printer.print_separator(context);
+    printer.print_record({"before", std::to_string(old_size), format_size(old_size)}, context);
+    printer.print_record({"after", std::to_string(new_size), format_size(new_size)}, context);
+    printer.print_separator(context);
+}
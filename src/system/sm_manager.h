@@ -71,13 +71,28 @@ class SmManager {
 
     void desc_table(const std::string& tab_name, Context* context);
 
-    void create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context);
+    void create_table(const std::string& tab_name, const std::vector<ColDef>& col_defs, Context* context,
+                      int page_size = PAGE_SIZE, RmRecordFormat format = RM_FORMAT_FIXED);
 
     void drop_table(const std::string& tab_name, Context* context);
 
-    void create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context);
+    void create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context,
+                      int page_size = PAGE_SIZE);
 
     void drop_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context);
     
     void drop_index(const std::string& tab_name, const std::vector<ColMeta>& col_names, Context* context);
+
+    void compact(const std::string& tab_name, Context* context);
+
+    void show_buffer_stats(Context* context);
+
+    void set_buffer_pool_size(int size_mb, Context* context);
+
+   private:
+    void check_page_size(int page_size);
+
+    void dump_buffer_pool();
+
+    void load_buffer_pool();
 };
\ No newline at end of file
@@ -154,19 +154,17 @@ class BPlusTreeConcurrentTest : public ::testing::Test {
             }
             // Print leaves
             for (int i = 0; i < inner->get_size(); i++) {
-                IxNodeHandle *child_node = ih->fetch_node(inner->value_at(i));
-                ToGraph(ih, child_node, bpm, out);  // 继续递归
+                auto child_node = ih->fetch_node(inner->value_at(i));
+                ToGraph(ih, child_node.get(), bpm, out);  // 继续递归
                 if (i > 0) {
-                    IxNodeHandle *sibling_node = ih->fetch_node(inner->value_at(i - 1));
+                    auto sibling_node = ih->fetch_node(inner->value_at(i - 1));
                     if (!sibling_node->is_leaf_page() && !child_node->is_leaf_page()) {
                         out << "{rank=same " << internal_prefix << sibling_node->get_page_no() << " " << internal_prefix
                             << child_node->get_page_no() << "};\n";
                     }
-                    bpm->unpin_page(sibling_node->get_page_id(), false);
                 }
             }
         }
-        bpm->unpin_page(node->get_page_id(), false);
     }
 
     /**
@@ -179,8 +177,8 @@ class BPlusTreeConcurrentTest : public ::testing::Test {
         std::ofstream out(outf);
         out << "digraph G {" << std::endl;
 
-        IxNodeHandle *node = ih_->fetch_node(ih_->file_hdr_->root_page_);
-        ToGraph(ih_.get(), node, bpm, out);
+        auto node = ih_->fetch_node(ih_->file_hdr_->root_page_);
+        ToGraph(ih_.get(), node.get(), bpm, out);
         out << "}" << std::endl;
         out.close();
 
@@ -206,16 +204,13 @@ class BPlusTreeConcurrentTest : public ::testing::Test {
         // check leaf list
         page_id_t leaf_no = ih->file_hdr_->first_leaf_;
         while (leaf_no != IX_LEAF_HEADER_PAGE) {
-            IxNodeHandle *curr = ih->fetch_node(leaf_no);
-            IxNodeHandle *prev = ih->fetch_node(curr->get_prev_leaf());
-            IxNodeHandle *next = ih->fetch_node(curr->get_next_leaf());
+            auto curr = ih->fetch_node(leaf_no);
+            auto prev = ih->fetch_node(curr->get_prev_leaf());
+            auto next = ih->fetch_node(curr->get_next_leaf());
             // Ensure prev->next == curr && next->prev == curr
             ASSERT_EQ(prev->get_next_leaf(), leaf_no);
             ASSERT_EQ(next->get_prev_leaf(), leaf_no);
             leaf_no = curr->get_next_leaf();
-            buffer_pool_manager_->unpin_page(curr->get_page_id(), false);
-            buffer_pool_manager_->unpin_page(prev->get_page_id(), false);
-            buffer_pool_manager_->unpin_page(next->get_page_id(), false);
         }
     }
 
@@ -226,13 +221,12 @@ class BPlusTreeConcurrentTest : public ::testing::Test {
      * @param now_page_no 当前遍历到的结点
      */
     void check_tree(const IxIndexHandle *ih, int now_page_no) {
-        IxNodeHandle *node = ih->fetch_node(now_page_no);
+        auto node = ih->fetch_node(now_page_no);
         if (node->is_leaf_page()) {
-            buffer_pool_manager_->unpin_page(node->get_page_id(), false);
             return;
         }
         for (int i = 0; i < node->get_size(); i++) {                 // 遍历node的所有孩子
-            IxNodeHandle *child = ih->fetch_node(node->value_at(i));  // 第i个孩子
+            auto child = ih->fetch_node(node->value_at(i));  // 第i个孩子
             // check parent
             assert(child->get_parent_page_no() == now_page_no);
             // check first key
@@ -248,11 +242,9 @@ class BPlusTreeConcurrentTest : public ::testing::Test {
                 ASSERT_LT(child_last_key, node->key_at(i + 1));  // child_last_key < node->KeyAt(i + 1)
             }
 
-            buffer_pool_manager_->unpin_page(child->get_page_id(), false);
 
             check_tree(ih, node->value_at(i));  // 递归子树
         }
-        buffer_pool_manager_->unpin_page(node->get_page_id(), false);
     }
 
     /**
@@ -460,4 +452,172 @@ TEST_F(BPlusTreeConcurrentTest, MixScaleTest) {
         scan.next();
     }
     EXPECT_EQ(size, keys.size() - delete_keys.size());
-}
\ No newline at end of file
+}
+/**
+ * @brief 混合读写负载下的查找吞吐量：一个写线程在(scale, 2*scale]上反复插入和删除，读线程点查和范围查询1~scale
+ * 分别在加读latch和乐观读两种方式下测量不同读线程数的吞吐量并检查查询结果正确；
+ * 乐观读者命中缓冲池时不加任何latch，读线程最多时吞吐量必须高于加读latch的方式
+ */
+TEST_F(BPlusTreeConcurrentTest, MixedReadWriteThroughputTest) {
+    const int32_t scale = 10000;
+    const int32_t range_len = 100;
+    const auto duration = std::chrono::milliseconds(200);
+    const int max_threads = std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+
+    Transaction txn(0);
+    for (int32_t key = 1; key <= scale; key++) {
+        ih_->insert_entry((const char *)&key, {.page_no = 0, .slot_no = key}, &txn);
+    }
+
+    std::map<std::pair<bool, int>, double> throughputs;
+    int top_threads = 1;
+    for (bool optimistic : {false, true}) {
+        ih_->set_optimistic_read(optimistic);
+        for (int thread_num = 1; thread_num <= max_threads; thread_num *= 2) {
+            std::atomic<bool> stop{false};
+            std::atomic<bool> correct{true};
+            std::atomic<int64_t> lookups{0};
+
+            std::thread writer([&] {
+                Transaction writer_txn(0);
+                while (!stop) {
+                    for (int32_t key = scale + 1; key <= 2 * scale && !stop; key++) {
+                        ih_->insert_entry((const char *)&key, {.page_no = 0, .slot_no = key}, &writer_txn);
+                    }
+                    for (int32_t key = scale + 1; key <= 2 * scale && !stop; key++) {
+                        ih_->delete_entry((const char *)&key, &writer_txn);
+                    }
+                }
+            });
+
+            std::vector<std::thread> readers;
+            for (int i = 0; i < thread_num; i++) {
+                readers.emplace_back([&, i] {
+                    Transaction reader_txn(0);
+                    std::default_random_engine rng(i);
+                    std::uniform_int_distribution<int32_t> dist(1, scale - range_len + 1);
+                    std::vector<Rid> rids;
+                    int64_t n = 0;
+                    while (!stop) {
+                        int32_t key = dist(rng);
+                        rids.clear();
+                        if (!ih_->get_value((const char *)&key, &rids, &reader_txn) || rids[0].slot_no != key) {
+                            correct = false;
+                        }
+                        // 每64次点查做一次范围查询，检查沿叶子链表移动时没有漏掉或重复键值对
+                        if (++n % 64 == 0) {
+                            int32_t right_key = key + range_len - 1;
+                            rids.clear();
+                            ih_->range_query((const char *)&key, (const char *)&right_key, &rids, &reader_txn, true, true);
+                            if (rids.size() != range_len || rids.front().slot_no != key ||
+                                rids.back().slot_no != right_key) {
+                                correct = false;
+                            }
+                        }
+                    }
+                    lookups += n;
+                });
+            }
+
+            std::this_thread::sleep_for(duration);
+            stop = true;
+            for (auto &reader : readers) reader.join();
+            writer.join();
+            EXPECT_TRUE(correct) << (optimistic ? "optimistic" : "latched") << " readers, threads=" << thread_num;
+
+            double throughput = lookups * 1000.0 / duration.count();
+            throughputs[{optimistic, thread_num}] = throughput;
+            top_threads = thread_num;
+            printf("%-10s readers=%d lookups/s=%.0f speedup=%.2fx\n", optimistic ? "optimistic" : "latched", thread_num,
+                   throughput, throughput / throughputs[{optimistic, 1}]);
+        }
+    }
+    ih_->set_optimistic_read(IX_OPTIMISTIC_READ);
+
+    // 写线程停下之后树仍然完整，1~scale都还在
+    std::vector<Rid> rids;
+    int32_t lk = 1, rk = scale;
+    ih_->range_query((const char *)&lk, (const char *)&rk, &rids, &txn, true, true);
+    ASSERT_EQ(rids.size(), scale);
+    for (int32_t key = 1; key <= scale; key++) {
+        ASSERT_EQ(rids[key - 1].slot_no, key);
+    }
+
+    double optimistic_throughput = throughputs[{true, top_threads}];
+    double latched_throughput = throughputs[{false, top_threads}];
+    ASSERT_GT(optimistic_throughput, latched_throughput) << "readers=" << top_threads;
+}
+
+/**
+ * @brief 写线程在偶数key之间反复插入和删除奇数key，结点频繁分裂合并，读线程同时用IxRangeScan扫描整个范围：
+ * 每个偶数key都要恰好读到一次，读出的key严格递增；分别在加读latch和乐观读两种方式下检查
+ */
+TEST_F(BPlusTreeConcurrentTest, RangeScanUnderWritesTest) {
+    const int32_t scale = 5000;
+    const int order = 8;
+    const int thread_num = 4;
+    ih_->file_hdr_->btree_order_ = order;
+
+    Transaction txn(0);
+    for (int32_t key = 2; key <= 2 * scale; key += 2) {
+        ih_->insert_entry((const char *)&key, {.page_no = 0, .slot_no = key}, &txn);
+    }
+    std::vector<int32_t> odd_keys;
+    for (int32_t key = 1; key < 2 * scale; key += 2) odd_keys.push_back(key);
+    std::shuffle(odd_keys.begin(), odd_keys.end(), std::default_random_engine{});
+
+    for (bool optimistic : {false, true}) {
+        ih_->set_optimistic_read(optimistic);
+        std::atomic<bool> stop{false};
+        std::atomic<bool> correct{true};
+        std::atomic<int> scans{0};
+
+        std::thread writer([&] {
+            Transaction writer_txn(0);
+            while (!stop) {
+                for (int32_t key : odd_keys) ih_->insert_entry((const char *)&key, {.page_no = 0, .slot_no = key}, &writer_txn);
+                for (int32_t key : odd_keys) ih_->delete_entry((const char *)&key, &writer_txn);
+            }
+        });
+        std::vector<std::thread> readers;
+        for (int i = 0; i < thread_num; i++) {
+            readers.emplace_back([&] {
+                Transaction reader_txn(0);
+                int32_t lk = 0, rk = 2 * scale + 1;
+                for (int round = 0; round < 20; round++) {
+                    int32_t last_key = 0, next_even = 2;
+                    for (IxRangeScan scan(ih_.get(), (const char *)&lk, (const char *)&rk, true, true, &reader_txn);
+                         !scan.is_end(); scan.next()) {
+                        int32_t key = scan.rid().slot_no;
+                        if (key <= last_key || (key % 2 == 0 && key != next_even)) correct = false;
+                        if (key % 2 == 0) next_even = key + 2;
+                        last_key = key;
+                    }
+                    if (next_even != 2 * scale + 2) correct = false;
+                    scans++;
+                }
+            });
+        }
+        for (auto &reader : readers) reader.join();
+        stop = true;
+        writer.join();
+        EXPECT_TRUE(correct) << (optimistic ? "optimistic" : "latched") << " readers";
+        EXPECT_EQ(scans, thread_num * 20);
+    }
+    ih_->set_optimistic_read(IX_OPTIMISTIC_READ);
+
+    // 写线程停下之后只剩偶数key，检查开闭区间的边界
+    auto count = [&](int32_t lk, int32_t rk, bool le, bool ge) {
+        int n = 0;
+        for (IxRangeScan scan(ih_.get(), (const char *)&lk, (const char *)&rk, le, ge, &txn); !scan.is_end(); scan.next())
+            n++;
+        return n;
+    };
+    for (int32_t key : odd_keys) ih_->delete_entry((const char *)&key, &txn);
+    EXPECT_EQ(count(2, 10, true, true), 5);
+    EXPECT_EQ(count(2, 10, false, false), 3);
+    EXPECT_EQ(count(3, 9, true, true), 3);
+    EXPECT_EQ(count(10, 2, true, true), 0);
+    EXPECT_EQ(count(2 * scale, 2 * scale + 5, true, true), 1);
+    EXPECT_EQ(count(2 * scale + 1, 2 * scale + 5, true, true), 0);
+}
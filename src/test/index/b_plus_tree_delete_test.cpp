@@ -154,19 +154,17 @@ class BPlusTreeTests : public ::testing::Test {
             }
             // Print leaves
             for (int i = 0; i < inner->get_size(); i++) {
-                IxNodeHandle *child_node = ih->fetch_node(inner->value_at(i));
-                ToGraph(ih, child_node, bpm, out);  // 继续递归
+                auto child_node = ih->fetch_node(inner->value_at(i));
+                ToGraph(ih, child_node.get(), bpm, out);  // 继续递归
                 if (i > 0) {
-                    IxNodeHandle *sibling_node = ih->fetch_node(inner->value_at(i - 1));
+                    auto sibling_node = ih->fetch_node(inner->value_at(i - 1));
                     if (!sibling_node->is_leaf_page() && !child_node->is_leaf_page()) {
                         out << "{rank=same " << internal_prefix << sibling_node->get_page_no() << " " << internal_prefix
                             << child_node->get_page_no() << "};\n";
                     }
-                    bpm->unpin_page(sibling_node->get_page_id(), false);
                 }
             }
         }
-        bpm->unpin_page(node->get_page_id(), false);
     }
 
     /**
@@ -179,8 +177,8 @@ class BPlusTreeTests : public ::testing::Test {
         std::ofstream out(outf);
         out << "digraph G {" << std::endl;
 
-        IxNodeHandle *node = ih_->fetch_node(ih_->file_hdr_->root_page_);
-        ToGraph(ih_.get(), node, bpm, out);
+        auto node = ih_->fetch_node(ih_->file_hdr_->root_page_);
+        ToGraph(ih_.get(), node.get(), bpm, out);
         out << "}" << std::endl;
         out.close();
 
@@ -206,16 +204,13 @@ class BPlusTreeTests : public ::testing::Test {
         // check leaf list
         page_id_t leaf_no = ih->file_hdr_->first_leaf_;
         while (leaf_no != IX_LEAF_HEADER_PAGE) {
-            IxNodeHandle *curr = ih->fetch_node(leaf_no);
-            IxNodeHandle *prev = ih->fetch_node(curr->get_prev_leaf());
-            IxNodeHandle *next = ih->fetch_node(curr->get_next_leaf());
+            auto curr = ih->fetch_node(leaf_no);
+            auto prev = ih->fetch_node(curr->get_prev_leaf());
+            auto next = ih->fetch_node(curr->get_next_leaf());
             // Ensure prev->next == curr && next->prev == curr
             ASSERT_EQ(prev->get_next_leaf(), leaf_no);
             ASSERT_EQ(next->get_prev_leaf(), leaf_no);
             leaf_no = curr->get_next_leaf();
-            buffer_pool_manager_->unpin_page(curr->get_page_id(), false);
-            buffer_pool_manager_->unpin_page(prev->get_page_id(), false);
-            buffer_pool_manager_->unpin_page(next->get_page_id(), false);
         }
     }
 
@@ -226,13 +221,12 @@ class BPlusTreeTests : public ::testing::Test {
      * @param now_page_no 当前遍历到的结点
      */
     void check_tree(const IxIndexHandle *ih, int now_page_no) {
-        IxNodeHandle *node = ih->fetch_node(now_page_no);
+        auto node = ih->fetch_node(now_page_no);
         if (node->is_leaf_page()) {
-            buffer_pool_manager_->unpin_page(node->get_page_id(), false);
             return;
         }
         for (int i = 0; i < node->get_size(); i++) {                  // 遍历node的所有孩子
-            IxNodeHandle *child = ih->fetch_node(node->value_at(i));  // 第i个孩子
+            auto child = ih->fetch_node(node->value_at(i));  // 第i个孩子
             // check parent
             assert(child->get_parent_page_no() == now_page_no);
             // check first key
@@ -248,11 +242,9 @@ class BPlusTreeTests : public ::testing::Test {
                 ASSERT_LT(child_last_key, node->key_at(i + 1));  // child_last_key < node->KeyAt(i + 1)
             }
 
-            buffer_pool_manager_->unpin_page(child->get_page_id(), false);
 
             check_tree(ih, node->value_at(i));  // 递归子树
         }
-        buffer_pool_manager_->unpin_page(node->get_page_id(), false);
     }
 
     /**
@@ -492,4 +484,60 @@ TEST_F(BPlusTreeTests, LargeScaleTest) {
     }
     std::cout << "Insert keys count: " << add_cnt << '\n' << "Delete keys count: " << del_cnt << '\n';
     check_all(ih_.get(), mock);
-}
\ No newline at end of file
+}
+/**
+ * @brief 合并结点时释放的页面被之后的插入复用，compact截断文件末尾的空闲页面
+ */
+TEST_F(BPlusTreeTests, FreePageReuseTest) {
+    const int order = 32;
+    const int scale = 2000;
+    const int remain = 100;  // 删除时保留的键的个数
+
+    ASSERT_LE(order, ih_->file_hdr_->btree_order_);
+    ih_->file_hdr_->btree_order_ = order;
+    int fd = ih_->get_fd();
+
+    std::multimap<int, Rid> mock;
+    auto insert_keys = [&]() {
+        for (int key = remain; key < scale; key++) {
+            Rid rid = {.page_no = key, .slot_no = key};
+            bool insert_ret = ih_->insert_entry((const char *)&key, rid, txn_.get());
+            ASSERT_EQ(insert_ret, true);
+            mock.insert(std::make_pair(key, rid));
+        }
+    };
+    auto delete_keys = [&]() {
+        for (int key = remain; key < scale; key++) {
+            bool delete_ret = ih_->delete_entry((const char *)&key, txn_.get());
+            ASSERT_EQ(delete_ret, true);
+            mock.erase(key);
+        }
+    };
+
+    for (int key = 0; key < remain; key++) {
+        Rid rid = {.page_no = key, .slot_no = key};
+        bool insert_ret = ih_->insert_entry((const char *)&key, rid, txn_.get());
+        ASSERT_EQ(insert_ret, true);
+        mock.insert(std::make_pair(key, rid));
+    }
+    insert_keys();
+    int peak_pages = ih_->get_num_pages();
+
+    // 删除之后释放的页面交还给磁盘管理器
+    delete_keys();
+    check_all(ih_.get(), mock);
+    EXPECT_GT(disk_manager_->get_num_free_pages(fd), 0);
+
+    // 重新插入时复用释放的页面，文件不再增长
+    insert_keys();
+    check_all(ih_.get(), mock);
+    EXPECT_LE(ih_->get_num_pages(), peak_pages);
+
+    // 再次删除后截断文件末尾的空闲页面
+    delete_keys();
+    int num_pages = ih_->compact();
+    EXPECT_LT(num_pages, peak_pages);
+    EXPECT_EQ(num_pages, disk_manager_->get_fd2pageno(fd));
+    EXPECT_LE(disk_manager_->get_file_size(fd), num_pages * PAGE_SIZE);
+    check_all(ih_.get(), mock);
+}
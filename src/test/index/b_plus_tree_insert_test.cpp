@@ -152,19 +152,17 @@ class BPlusTreeTests : public ::testing::Test {
             }
             // Print leaves
             for (int i = 0; i < inner->get_size(); i++) {
-                IxNodeHandle *child_node = ih->fetch_node(inner->value_at(i));
-                ToGraph(ih, child_node, bpm, out);  // 继续递归
+                auto child_node = ih->fetch_node(inner->value_at(i));
+                ToGraph(ih, child_node.get(), bpm, out);  // 继续递归
                 if (i > 0) {
-                    IxNodeHandle *sibling_node = ih->fetch_node(inner->value_at(i - 1));
+                    auto sibling_node = ih->fetch_node(inner->value_at(i - 1));
                     if (!sibling_node->is_leaf_page() && !child_node->is_leaf_page()) {
                         out << "{rank=same " << internal_prefix << sibling_node->get_page_no() << " " << internal_prefix
                             << child_node->get_page_no() << "};\n";
                     }
-                    bpm->unpin_page(sibling_node->get_page_id(), false);
                 }
             }
         }
-        bpm->unpin_page(node->get_page_id(), false);
     }
 
     /**
@@ -177,8 +175,8 @@ class BPlusTreeTests : public ::testing::Test {
         std::ofstream out(outf);
         out << "digraph G {" << std::endl;
         
-        IxNodeHandle *node = ih_->fetch_node(ih_->file_hdr_->root_page_);
-        ToGraph(ih_.get(), node, bpm, out);
+        auto node = ih_->fetch_node(ih_->file_hdr_->root_page_);
+        ToGraph(ih_.get(), node.get(), bpm, out);
         out << "}" << std::endl;
         out.close();
 
@@ -204,16 +202,13 @@ class BPlusTreeTests : public ::testing::Test {
         // check leaf list
         page_id_t leaf_no = ih->file_hdr_->first_leaf_;
         while (leaf_no != IX_LEAF_HEADER_PAGE) {
-            IxNodeHandle *curr = ih->fetch_node(leaf_no);
-            IxNodeHandle *prev = ih->fetch_node(curr->get_prev_leaf());
-            IxNodeHandle *next = ih->fetch_node(curr->get_next_leaf());
+            auto curr = ih->fetch_node(leaf_no);
+            auto prev = ih->fetch_node(curr->get_prev_leaf());
+            auto next = ih->fetch_node(curr->get_next_leaf());
             // Ensure prev->next == curr && next->prev == curr
             ASSERT_EQ(prev->get_next_leaf(), leaf_no);
             ASSERT_EQ(next->get_prev_leaf(), leaf_no);
             leaf_no = curr->get_next_leaf();
-            buffer_pool_manager_->unpin_page(curr->get_page_id(), false);
-            buffer_pool_manager_->unpin_page(prev->get_page_id(), false);
-            buffer_pool_manager_->unpin_page(next->get_page_id(), false);
         }
     }
 
@@ -224,13 +219,12 @@ class BPlusTreeTests : public ::testing::Test {
      * @param now_page_no 当前遍历到的结点
      */
     void check_tree(const IxIndexHandle *ih, int now_page_no) {
-        IxNodeHandle *node = ih->fetch_node(now_page_no);
+        auto node = ih->fetch_node(now_page_no);
         if (node->is_leaf_page()) {
-            buffer_pool_manager_->unpin_page(node->get_page_id(), false);
             return;
         }
         for (int i = 0; i < node->get_size(); i++) {                 // 遍历node的所有孩子
-            IxNodeHandle *child = ih->fetch_node(node->value_at(i));  // 第i个孩子
+            auto child = ih->fetch_node(node->value_at(i));  // 第i个孩子
             // check parent
             assert(child->get_parent_page_no() == now_page_no);
             // check first key
@@ -246,11 +240,9 @@ class BPlusTreeTests : public ::testing::Test {
                 ASSERT_LT(child_last_key, node->key_at(i + 1));  // child_last_key < node->KeyAt(i + 1)
             }
 
-            buffer_pool_manager_->unpin_page(child->get_page_id(), false);
 
             check_tree(ih, node->value_at(i));  // 递归子树
         }
-        buffer_pool_manager_->unpin_page(node->get_page_id(), false);
     }
 
     /**
@@ -412,4 +404,109 @@ TEST_F(BPlusTreeTests, LargeScaleTest) {
         scan.next();
     }
     EXPECT_EQ(current_key, keys.size() + 1);
-}
\ No newline at end of file
+}
+/**
+ * @brief 批量加载不同数量的key，覆盖最后一个结点需要从左兄弟移入键值对和需要合并到左兄弟两种情况，
+ * 排序内存只够放100个键值对，强制多路归并临时文件中的有序段。
+ * 加载之后继续插入和删除，检查批量构建的树可以正常维护
+ */
+TEST_F(BPlusTreeTests, BulkLoadTest) {
+    std::vector<ColMeta> cols = {{.tab_name = "bulk", .name = "col1", .type = TYPE_INT, .len = 4, .offset = 0}};
+    int index_no = 0;
+    for (int order : {3, 4}) {
+        for (int scale : {0, 1, 2, 5, 6, 7, 13, 30, 61, 2000}) {
+            std::string tab_name = "bulk" + std::to_string(index_no++);
+            ix_manager_->create_index(tab_name, cols);
+            auto ih = ix_manager_->open_index(tab_name, cols);
+            ih->file_hdr_->btree_order_ = order;
+
+            std::vector<int> keys;
+            for (int key = 1; key <= scale; key++) keys.push_back(key);
+            std::shuffle(keys.begin(), keys.end(), std::default_random_engine{});
+
+            std::multimap<int, Rid> mock;
+            IxBulkLoader loader(ih.get(), IX_BULK_LOAD_FILL_PERCENT, 100 * (sizeof(int) + sizeof(Rid)));
+            for (int key : keys) {
+                Rid rid = {.page_no = 0, .slot_no = key};
+                loader.add((const char *)&key, rid);
+                mock.insert({key, rid});
+            }
+            ASSERT_EQ(loader.finish(), scale);
+            EXPECT_EQ(loader.num_runs(), scale > 100 ? static_cast<size_t>((scale + 99) / 100) : 0);
+            check_all(ih.get(), mock);
+
+            for (int key : keys) {
+                if (key % 3 == 0) {
+                    ASSERT_TRUE(ih->delete_entry((const char *)&key, txn_.get()));
+                    mock.erase(key);
+                }
+                int new_key = key + scale;
+                Rid rid = {.page_no = 0, .slot_no = new_key};
+                ih->insert_entry((const char *)&new_key, rid, txn_.get());
+                mock.insert({new_key, rid});
+            }
+            check_all(ih.get(), mock);
+            ix_manager_->close_index(ih.get());
+        }
+    }
+}
+
+/**
+ * @brief 批量加载的key有重复时finish()抛出IndexDuplicateKeyError，重复的key在内存中排序和多路归并时都能发现
+ */
+TEST_F(BPlusTreeTests, BulkLoadDuplicateKeyTest) {
+    std::vector<ColMeta> cols = {{.tab_name = "bulk_dup", .name = "col1", .type = TYPE_INT, .len = 4, .offset = 0}};
+    for (int scale : {2, 50, 2000}) {
+        std::string tab_name = "bulk_dup" + std::to_string(scale);
+        ix_manager_->create_index(tab_name, cols);
+        auto ih = ix_manager_->open_index(tab_name, cols);
+        {
+            IxBulkLoader loader(ih.get(), IX_BULK_LOAD_FILL_PERCENT, 100 * (sizeof(int) + sizeof(Rid)));
+            for (int key = 1; key <= scale; key++) loader.add((const char *)&key, {.page_no = 0, .slot_no = key});
+            int dup_key = scale / 2;
+            loader.add((const char *)&dup_key, {.page_no = 1, .slot_no = dup_key});
+            EXPECT_THROW(loader.finish(), IndexDuplicateKeyError);
+        }
+        ix_manager_->close_index(ih.get());
+    }
+}
+
+/**
+ * @brief 在已有记录的表上创建索引，索引中包含表中已有的所有记录
+ */
+TEST_F(BPlusTreeTests, CreateIndexOnExistingRowsTest) {
+    const int scale = 5000;
+    auto fh = sm_->fhs_.at(TEST_FILE_NAME).get();
+    Context context(nullptr, nullptr, nullptr);
+    std::vector<int> keys;
+    for (int key = 0; key < scale; key++) keys.push_back(key);
+    std::shuffle(keys.begin(), keys.end(), std::default_random_engine{});
+
+    std::multimap<int, Rid> mock;
+    for (int key : keys) {
+        int rec[2] = {key, scale - key};
+        Rid rid = fh->insert_record((char *)rec, &context);
+        mock.insert({scale - key, rid});
+    }
+    sm_->create_index(TEST_FILE_NAME, {"col2"}, nullptr);
+    auto ih = sm_->ihs_.at(ix_manager_->get_index_name(TEST_FILE_NAME, std::vector<std::string>{"col2"})).get();
+    check_all(ih, mock);
+}
+
+/**
+ * @brief 已有记录的索引列有重复值时创建索引失败，建了一半的索引文件被删除，表的元数据中没有这个索引
+ */
+TEST_F(BPlusTreeTests, CreateIndexDuplicateKeyTest) {
+    const int scale = 5000;
+    auto fh = sm_->fhs_.at(TEST_FILE_NAME).get();
+    Context context(nullptr, nullptr, nullptr);
+    for (int key = 0; key < scale; key++) {
+        int rec[2] = {key, key / 2};
+        fh->insert_record((char *)rec, &context);
+    }
+    std::vector<std::string> dup_col = {"col2"};
+    EXPECT_THROW(sm_->create_index(TEST_FILE_NAME, dup_col, nullptr), IndexDuplicateKeyError);
+    EXPECT_FALSE(ix_manager_->exists(TEST_FILE_NAME, dup_col));
+    EXPECT_EQ(sm_->ihs_.count(ix_manager_->get_index_name(TEST_FILE_NAME, dup_col)), 0u);
+    EXPECT_FALSE(sm_->db_.get_table(TEST_FILE_NAME).is_index(dup_col));
+}
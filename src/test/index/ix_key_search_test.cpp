@@ -0,0 +1,175 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "index/ix_index_handle.h"
+
+/**
+ * @brief 构造只有key类型信息的索引文件头
+ */
+IxFileHdr make_file_hdr(const std::vector<ColType> &types, const std::vector<int> &lens) {
+    IxFileHdr file_hdr;
+    file_hdr.col_num_ = static_cast<int>(types.size());
+    file_hdr.col_types_ = types;
+    file_hdr.col_lens_ = lens;
+    file_hdr.col_tot_len_ = 0;
+    for (int len : lens) file_hdr.col_tot_len_ += len;
+    return file_hdr;
+}
+
+/**
+ * @brief 用逐个ix_compare的顺序查找作为参照
+ */
+int reference_search(const char *keys, int num_key, const char *target, const IxFileHdr &file_hdr, bool upper) {
+    int i = 0;
+    while (i < num_key) {
+        int cmp = ix_compare(keys + i * file_hdr.col_tot_len_, target, file_hdr.col_types_, file_hdr.col_lens_);
+        if (upper ? cmp > 0 : cmp >= 0) break;
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @brief 用gen_key生成num_key个有序且不重复的key和若干个查找目标，检查选出的查找函数与参照结果一致
+ * 结点大小取0到num_key之间的各种值，覆盖二分之后剩下不足一次向量比较的情况
+ */
+template <typename GenKey>
+void check_search(const IxFileHdr &file_hdr, const IxKeySearch *search, int num_key, GenKey gen_key) {
+    int len = file_hdr.col_tot_len_;
+    std::vector<std::vector<char>> sorted;
+    std::default_random_engine rng(0);
+    for (int i = 0; i < num_key * 4; i++) {
+        std::vector<char> key(len);
+        gen_key(rng, key.data());
+        sorted.push_back(key);
+    }
+    auto less = [&](const std::vector<char> &a, const std::vector<char> &b) {
+        return ix_compare(a.data(), b.data(), file_hdr.col_types_, file_hdr.col_lens_) < 0;
+    };
+    auto equal = [&](const std::vector<char> &a, const std::vector<char> &b) { return !less(a, b) && !less(b, a); };
+    std::vector<std::vector<char>> targets = sorted;
+    std::sort(sorted.begin(), sorted.end(), less);
+    sorted.erase(std::unique(sorted.begin(), sorted.end(), equal), sorted.end());
+    // 隔一个取一个key放进结点，没取的key作为不在结点中的查找目标
+    std::vector<char> keys;
+    for (size_t i = 0; i < sorted.size() && static_cast<int>(keys.size()) < num_key * len; i += 2) {
+        keys.insert(keys.end(), sorted[i].begin(), sorted[i].end());
+    }
+    int total = static_cast<int>(keys.size()) / len;
+    // 向量比较可能读到最后一个key之后, 与页面中key数组之后还有rid数组一样, 留出空间
+    keys.resize(keys.size() + 64);
+
+    for (int n = 0; n <= total; n += (n < 40 ? 1 : 37)) {
+        for (auto &target : targets) {
+            ASSERT_EQ(search->lower_bound(keys.data(), n, target.data(), &file_hdr),
+                      reference_search(keys.data(), n, target.data(), file_hdr, false))
+                << search->name << " lower_bound, num_key=" << n;
+            ASSERT_EQ(search->upper_bound(keys.data(), n, target.data(), &file_hdr),
+                      reference_search(keys.data(), n, target.data(), file_hdr, true))
+                << search->name << " upper_bound, num_key=" << n;
+        }
+    }
+}
+
+TEST(IxKeySearchTest, IntKeyTest) {
+    auto file_hdr = make_file_hdr({TYPE_INT}, {4});
+    auto gen = [](std::default_random_engine &rng, char *key) {
+        *reinterpret_cast<int *>(key) = std::uniform_int_distribution<int>(-1000, 1000)(rng);
+    };
+    for (bool use_simd : {false, true}) {
+        check_search(file_hdr, ix_key_search_for(&file_hdr, use_simd), 300, gen);
+    }
+    EXPECT_STREQ(ix_key_search_for(&file_hdr, false)->name, "int");
+}
+
+TEST(IxKeySearchTest, FloatKeyTest) {
+    auto file_hdr = make_file_hdr({TYPE_FLOAT}, {4});
+    auto gen = [](std::default_random_engine &rng, char *key) {
+        *reinterpret_cast<float *>(key) = std::uniform_real_distribution<float>(-100, 100)(rng);
+    };
+    for (bool use_simd : {false, true}) {
+        check_search(file_hdr, ix_key_search_for(&file_hdr, use_simd), 300, gen);
+    }
+    EXPECT_STREQ(ix_key_search_for(&file_hdr, false)->name, "float");
+}
+
+TEST(IxKeySearchTest, StringKeyTest) {
+    auto file_hdr = make_file_hdr({TYPE_STRING}, {8});
+    auto gen = [](std::default_random_engine &rng, char *key) {
+        for (int i = 0; i < 8; i++) key[i] = static_cast<char>(std::uniform_int_distribution<int>('a', 'd')(rng));
+    };
+    check_search(file_hdr, ix_key_search_for(&file_hdr), 200, gen);
+    EXPECT_STREQ(ix_key_search_for(&file_hdr)->name, "string");
+}
+
+TEST(IxKeySearchTest, CompositeKeyTest) {
+    auto gen_int_int = [](std::default_random_engine &rng, char *key) {
+        // 第二个字段取负数和正数，检查低32位按有符号数比较
+        reinterpret_cast<int *>(key)[0] = std::uniform_int_distribution<int>(-5, 5)(rng);
+        reinterpret_cast<int *>(key)[1] = std::uniform_int_distribution<int>(INT32_MIN, INT32_MAX)(rng);
+    };
+    auto int_int = make_file_hdr({TYPE_INT, TYPE_INT}, {4, 4});
+    check_search(int_int, ix_key_search_for(&int_int), 200, gen_int_int);
+    EXPECT_STREQ(ix_key_search_for(&int_int)->name, "int+int");
+
+    auto gen_int_string = [](std::default_random_engine &rng, char *key) {
+        *reinterpret_cast<int *>(key) = std::uniform_int_distribution<int>(-5, 5)(rng);
+        for (int i = 4; i < 8; i++) key[i] = static_cast<char>(std::uniform_int_distribution<int>('a', 'd')(rng));
+    };
+    auto int_string = make_file_hdr({TYPE_INT, TYPE_STRING}, {4, 4});
+    check_search(int_string, ix_key_search_for(&int_string), 200, gen_int_string);
+    EXPECT_STREQ(ix_key_search_for(&int_string)->name, "generic");
+}
+
+/**
+ * @brief 比较int的key上通用查找与专门查找的速度，结点大小取4KB页面能放下的最多key数
+ */
+TEST(IxKeySearchTest, IntKeySearchSpeedTest) {
+    const int num_key = 340;
+    const int rounds = 2000000;
+    auto file_hdr = make_file_hdr({TYPE_INT}, {4});
+    std::vector<int> keys(num_key + 16);
+    for (int i = 0; i < num_key; i++) keys[i] = i * 2;
+    std::vector<int> targets(1024);
+    std::default_random_engine rng(0);
+    for (auto &target : targets) target = std::uniform_int_distribution<int>(0, num_key * 2)(rng);
+
+    // 原来的实现：二分查找，每次比较都调用ix_compare
+    auto generic_lower_bound = [](const char *k, int n, const char *t, const IxFileHdr *hdr) {
+        int l = 0, r = n;
+        while (l < r) {
+            int mid = (l + r) >> 1;
+            if (ix_compare(k + mid * hdr->col_tot_len_, t, hdr->col_types_, hdr->col_lens_) >= 0) r = mid;
+            else l = mid + 1;
+        }
+        return r;
+    };
+    const IxKeySearch generic = {"ix_compare", generic_lower_bound, nullptr};
+    int64_t checksum = 0;
+    auto measure = [&](const IxKeySearch *search, int rounds) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++) {
+            checksum += search->lower_bound(reinterpret_cast<const char *>(keys.data()), num_key,
+                                            reinterpret_cast<const char *>(&targets[i & 1023]), &file_hdr);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        printf("%-10s %.1f ns/search\n", search->name, elapsed.count() / rounds);
+    };
+    measure(&generic, rounds);
+    measure(ix_key_search_for(&file_hdr, false), rounds);
+    measure(ix_key_search_for(&file_hdr, true), rounds);
+    EXPECT_GT(checksum, 0);
+}
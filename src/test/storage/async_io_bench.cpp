@@ -0,0 +1,145 @@
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk_manager.h"
+
+constexpr int BENCH_NUM_PAGES = 4096;       // 测试文件中的页面个数(16MB)
+constexpr int BENCH_NUM_READS = 1 << 15;    // 每一轮随机读的页面个数
+constexpr int BENCH_QUEUE_DEPTH = 32;       // 异步读的队列深度
+const std::string TEST_DB_NAME = "AsyncIoBench_db";
+
+/**
+ * @brief 比较同步read_page与AsyncIo(io_uring和线程池两种后端)的随机读IOPS, 并检查读到的数据
+ */
+class AsyncIoBench : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    int fd_ = -1;
+    std::vector<page_id_t> page_nos_;  // 随机读的页号序列
+
+   public:
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        if (disk_manager_->is_dir(TEST_DB_NAME)) {
+            disk_manager_->destroy_dir(TEST_DB_NAME);
+        }
+        disk_manager_->create_dir(TEST_DB_NAME);
+        assert(disk_manager_->is_dir(TEST_DB_NAME));
+        if (chdir(TEST_DB_NAME.c_str()) < 0) {
+            throw UnixError();
+        }
+
+        // 生成测试文件，每个页面开头写入自己的页号
+        const std::string filename = "bench_file";
+        disk_manager_->create_file(filename);
+        fd_ = disk_manager_->open_file(filename);
+        char buf[PAGE_SIZE] = {0};
+        for (int page_no = 0; page_no < BENCH_NUM_PAGES; page_no++) {
+            snprintf(buf, sizeof(buf), "%d", page_no);
+            disk_manager_->write_page(fd_, page_no, buf, PAGE_SIZE);
+        }
+
+        std::mt19937 rng(0);
+        std::uniform_int_distribution<int> dist(0, BENCH_NUM_PAGES - 1);
+        for (int i = 0; i < BENCH_NUM_READS; i++) page_nos_.push_back(dist(rng));
+    }
+
+    void TearDown() override {
+        disk_manager_->close_file(fd_);
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+    };
+
+    static bool check_page(const char *data, page_id_t page_no) {
+        return std::to_string(page_no) == std::string(data);
+    }
+
+    /**
+     * @brief 逐页调用read_page, 返回IOPS
+     */
+    double run_sync() {
+        char buf[PAGE_SIZE];
+        auto begin = std::chrono::steady_clock::now();
+        for (page_id_t page_no : page_nos_) {
+            disk_manager_->read_page(fd_, page_no, buf, PAGE_SIZE);
+            EXPECT_TRUE(check_page(buf, page_no));
+        }
+        return BENCH_NUM_READS / std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    /**
+     * @brief 保持BENCH_QUEUE_DEPTH个读请求在途, 返回IOPS
+     */
+    double run_async(AsyncIo *async_io) {
+        std::vector<char> bufs(static_cast<size_t>(BENCH_QUEUE_DEPTH) * PAGE_SIZE);
+        std::vector<int> free_bufs;
+        for (int i = 0; i < BENCH_QUEUE_DEPTH; i++) free_bufs.push_back(i);
+        IoCompletion completions[BENCH_QUEUE_DEPTH];
+        // user_data的高32位为缓冲区下标, 低32位为页号
+        auto begin = std::chrono::steady_clock::now();
+        int next = 0, done = 0;
+        while (done < BENCH_NUM_READS) {
+            while (next < BENCH_NUM_READS && !free_bufs.empty()) {
+                int buf_no = free_bufs.back();
+                free_bufs.pop_back();
+                async_io->submit_read(fd_, page_nos_[next], &bufs[buf_no * PAGE_SIZE], PAGE_SIZE,
+                                      (static_cast<uint64_t>(buf_no) << 32) | page_nos_[next]);
+                next++;
+            }
+            int count = async_io->complete(completions, BENCH_QUEUE_DEPTH, 1);
+            for (int i = 0; i < count; i++) {
+                int buf_no = static_cast<int>(completions[i].user_data >> 32);
+                page_id_t page_no = static_cast<page_id_t>(completions[i].user_data & 0xffffffff);
+                EXPECT_EQ(PAGE_SIZE, completions[i].result);
+                EXPECT_TRUE(check_page(&bufs[buf_no * PAGE_SIZE], page_no));
+                free_bufs.push_back(buf_no);
+            }
+            done += count;
+        }
+        EXPECT_EQ(0, async_io->in_flight());
+        return BENCH_NUM_READS / std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+};
+
+TEST_F(AsyncIoBench, RandomReadIops) {
+    auto io_uring = AsyncIo::create(BENCH_QUEUE_DEPTH, true);
+    auto thread_pool = AsyncIo::create(BENCH_QUEUE_DEPTH, false);
+    EXPECT_STREQ("thread_pool", thread_pool->backend_name());
+
+    printf("%-24s%14s\n", "path", "kIOPS");
+    printf("%-24s%14.1f\n", "read_page", run_sync() / 1e3);
+    printf("%-24s%14.1f\n", io_uring->backend_name(), run_async(io_uring.get()) / 1e3);
+    printf("%-24s%14.1f\n", thread_pool->backend_name(), run_async(thread_pool.get()) / 1e3);
+}
+
+TEST_F(AsyncIoBench, WriteAndReadPastEnd) {
+    for (bool use_io_uring : {true, false}) {
+        auto async_io = AsyncIo::create(4, use_io_uring);
+        // 异步写入文件末尾之后的两个页面, 再读回, 同时读一个从未写过的页面
+        char write_buf[2][PAGE_SIZE], read_buf[3][PAGE_SIZE];
+        for (int i = 0; i < 2; i++) {
+            memset(write_buf[i], 'a' + i, PAGE_SIZE);
+            async_io->submit_write(fd_, BENCH_NUM_PAGES + i, write_buf[i], PAGE_SIZE, i);
+        }
+        IoCompletion completions[3];
+        EXPECT_EQ(2, async_io->complete(completions, 3, 2));
+        for (int i = 0; i < 3; i++) {
+            memset(read_buf[i], 'x', PAGE_SIZE);
+            async_io->submit_read(fd_, BENCH_NUM_PAGES + i + (i == 2 ? 8 : 0), read_buf[i], PAGE_SIZE, i);
+        }
+        EXPECT_EQ(3, async_io->complete(completions, 3, 3));
+        for (int i = 0; i < 3; i++) EXPECT_EQ(PAGE_SIZE, completions[i].result);
+        EXPECT_EQ(0, memcmp(read_buf[0], write_buf[0], PAGE_SIZE));
+        EXPECT_EQ(0, memcmp(read_buf[1], write_buf[1], PAGE_SIZE));
+        char zeros[PAGE_SIZE] = {0};
+        EXPECT_EQ(0, memcmp(read_buf[2], zeros, PAGE_SIZE));
+    }
+}
@@ -0,0 +1,106 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "record/bitmap.h"
+
+constexpr int BENCH_ROUNDS = 2000;  // 每种位图重复扫描的次数
+
+/**
+ * @brief 原来的实现：逐位测试
+ */
+int legacy_next_bit(bool bit, const char *bm, int max_n, int curr) {
+    for (int i = curr + 1; i < max_n; i++) {
+        if (Bitmap::is_set(bm, i) == bit) return i;
+    }
+    return max_n;
+}
+
+/**
+ * @brief 运行BENCH_ROUNDS次f，返回每次的平均纳秒数
+ */
+double time_ns(const std::function<int()> &f, int *result) {
+    auto begin = std::chrono::steady_clock::now();
+    int sum = 0;
+    for (int round = 0; round < BENCH_ROUNDS; round++) sum += f();
+    auto end = std::chrono::steady_clock::now();
+    *result = sum / BENCH_ROUNDS;
+    return std::chrono::duration<double, std::nano>(end - begin).count() / BENCH_ROUNDS;
+}
+
+/**
+ * @brief 位图扫描的耗时：页面中的位图大小从4KB页面存放较大的记录到64KB页面存放4字节的记录
+ * scan：遍历所有为1的位(顺序扫描)；first zero：找第一个为0的位(插入时找空闲slot)；count：统计为1的位数
+ * legacy为原来逐位测试的实现，word为按字查找且不使用AVX2，bulk为批量接口：scan使用for_each_set，其余使用AVX2
+ */
+TEST(BitmapBench, ScanTest) {
+    std::default_random_engine rng(0);
+    printf("%-8s %-8s %-10s %12s %12s %12s\n", "bits", "density", "op", "legacy ns", "word ns", "bulk ns");
+    for (int max_n : {128, 992, 15888}) {
+        for (double density : {0.05, 0.5, 0.95}) {
+            std::vector<char> bm((max_n + BITMAP_WIDTH - 1) / BITMAP_WIDTH);
+            std::bernoulli_distribution dist(density);
+            for (int i = 0; i < max_n; i++) {
+                if (dist(rng)) Bitmap::set(bm.data(), i);
+            }
+            // 位图的前90%都是1，模拟快要写满的页面中找空闲slot
+            std::vector<char> full(bm);
+            for (int i = 0; i < max_n * 9 / 10; i++) Bitmap::set(full.data(), i);
+            const char *data = bm.data();
+
+            int expected, word, simd;
+            auto scan = [&](auto next) {
+                return [&, next]() {
+                    int n = 0;
+                    for (int i = next(true, data, max_n, -1); i < max_n; i = next(true, data, max_n, i)) n++;
+                    return n;
+                };
+            };
+            double t0 = time_ns(scan(legacy_next_bit), &expected);
+            auto word_next_bit = [](bool bit, const char *m, int n, int curr) {
+                return Bitmap::next_bit(bit, m, n, curr, false);
+            };
+            double t1 = time_ns(scan(word_next_bit), &word);
+            double t2 = time_ns([&]() {
+                int n = 0;
+                Bitmap::for_each_set(data, max_n, [&](int) { n++; });
+                return n;
+            }, &simd);
+            ASSERT_EQ(word, expected);
+            ASSERT_EQ(simd, expected);
+            printf("%-8d %-8.2f %-10s %12.1f %12.1f %12.1f\n", max_n, density, "scan", t0, t1, t2);
+
+            t0 = time_ns([&]() { return legacy_next_bit(false, full.data(), max_n, -1); }, &expected);
+            t1 = time_ns([&]() { return Bitmap::first_bit(false, full.data(), max_n, false); }, &word);
+            t2 = time_ns([&]() { return Bitmap::first_bit(false, full.data(), max_n, true); }, &simd);
+            ASSERT_EQ(word, expected);
+            ASSERT_EQ(simd, expected);
+            printf("%-8d %-8.2f %-10s %12.1f %12.1f %12.1f\n", max_n, density, "first zero", t0, t1, t2);
+
+            t0 = time_ns([&]() {
+                int n = 0;
+                for (int i = 0; i < max_n; i++) n += Bitmap::is_set(data, i);
+                return n;
+            }, &expected);
+            t1 = time_ns([&]() { return Bitmap::count(data, max_n, false); }, &word);
+            t2 = time_ns([&]() { return Bitmap::count(data, max_n, true); }, &simd);
+            ASSERT_EQ(word, expected);
+            ASSERT_EQ(simd, expected);
+            printf("%-8d %-8.2f %-10s %12.1f %12.1f %12.1f\n", max_n, density, "count", t0, t1, t2);
+        }
+    }
+    printf("avx2: %s\n", Bitmap::has_avx2() ? "yes" : "no");
+}
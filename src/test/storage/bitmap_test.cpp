@@ -0,0 +1,88 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "record/bitmap.h"
+
+/**
+ * @brief 逐位查找，作为按字查找的参照
+ */
+int naive_next_bit(bool bit, const char *bm, int max_n, int curr) {
+    for (int i = curr + 1; i < max_n; i++) {
+        if (Bitmap::is_set(bm, i) == bit) return i;
+    }
+    return max_n;
+}
+
+/**
+ * @brief 生成max_n位的位图，每一位以density的概率为1；最后一个字节中max_n之后的位随机填充，查找和计数时应当忽略
+ */
+std::vector<char> make_bitmap(std::default_random_engine &rng, int max_n, double density) {
+    std::vector<char> bm((max_n + BITMAP_WIDTH - 1) / BITMAP_WIDTH);
+    std::bernoulli_distribution dist(density);
+    for (int i = 0; i < static_cast<int>(bm.size()) * BITMAP_WIDTH; i++) {
+        if (i < max_n ? dist(rng) : rng() % 2 == 0) Bitmap::set(bm.data(), i);
+    }
+    return bm;
+}
+
+TEST(BitmapTest, SetResetTest) {
+    char bm[4];
+    Bitmap::init(bm, sizeof(bm));
+    Bitmap::set(bm, 0);
+    Bitmap::set(bm, 9);
+    Bitmap::set(bm, 31);
+    // 每个字节的最高位是第一位
+    EXPECT_EQ(static_cast<unsigned char>(bm[0]), 0x80u);
+    EXPECT_EQ(static_cast<unsigned char>(bm[1]), 0x40u);
+    EXPECT_EQ(static_cast<unsigned char>(bm[3]), 0x01u);
+    EXPECT_EQ(Bitmap::first_bit(true, bm, 32), 0);
+    EXPECT_EQ(Bitmap::next_bit(true, bm, 32, 0), 9);
+    EXPECT_EQ(Bitmap::next_bit(true, bm, 32, 9), 31);
+    EXPECT_EQ(Bitmap::next_bit(true, bm, 31, 9), 31);
+    EXPECT_EQ(Bitmap::first_bit(false, bm, 32), 1);
+    EXPECT_EQ(Bitmap::count(bm, 32), 3);
+    EXPECT_EQ(Bitmap::count(bm, 31), 2);
+    Bitmap::reset(bm, 0);
+    EXPECT_EQ(Bitmap::first_bit(true, bm, 32), 9);
+    EXPECT_EQ(Bitmap::first_bit(false, bm, 32), 0);
+}
+
+/**
+ * @brief 不同长度和密度的位图上，next_bit、count和for_each_set的结果与逐位查找相同，使用和不使用AVX2都要测试
+ */
+TEST(BitmapTest, RandomTest) {
+    std::default_random_engine rng(0);
+    for (int max_n : {1, 7, 8, 63, 64, 65, 255, 256, 257, 1000, 4096, 20000}) {
+        for (double density : {0.0, 0.001, 0.1, 0.5, 0.999, 1.0}) {
+            std::vector<char> bm = make_bitmap(rng, max_n, density);
+            std::vector<int> expected;
+            for (int i = 0; i < max_n; i++) {
+                if (Bitmap::is_set(bm.data(), i)) expected.push_back(i);
+            }
+            for (bool use_simd : {false, true}) {
+                for (bool bit : {false, true}) {
+                    for (int curr = -1; curr < max_n; curr++) {
+                        ASSERT_EQ(Bitmap::next_bit(bit, bm.data(), max_n, curr, use_simd),
+                                  naive_next_bit(bit, bm.data(), max_n, curr))
+                            << "max_n=" << max_n << " density=" << density << " bit=" << bit << " curr=" << curr;
+                    }
+                }
+                ASSERT_EQ(Bitmap::count(bm.data(), max_n, use_simd), static_cast<int>(expected.size()));
+            }
+            std::vector<int> found;
+            Bitmap::for_each_set(bm.data(), max_n, [&](int pos) { found.push_back(pos); });
+            ASSERT_EQ(found, expected);
+        }
+    }
+}
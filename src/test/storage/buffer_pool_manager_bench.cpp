@@ -0,0 +1,120 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/buffer_pool_manager.h"
+
+constexpr int BENCH_NUM_PAGES = 1024;                 // 测试文件中的页面个数
+constexpr size_t BENCH_POOL_SIZE = BENCH_NUM_PAGES;   // 缓冲池能容纳全部页面，测试只衡量命中路径
+constexpr int BENCH_TOTAL_OPS = 1 << 16;              // 每一轮所有线程合计执行的fetch/unpin次数
+const std::string TEST_DB_NAME = "BufferPoolManagerBench_db";
+
+/**
+ * @brief 缓冲池多线程fetch/unpin吞吐测试
+ * @note 分别使用1个分区和多个分区的缓冲池，线程数从1增加到32，输出每秒完成的fetch/unpin次数
+ */
+class BufferPoolManagerBench : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    int fd_ = -1;
+
+   public:
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        if (disk_manager_->is_dir(TEST_DB_NAME)) {
+            disk_manager_->destroy_dir(TEST_DB_NAME);
+        }
+        disk_manager_->create_dir(TEST_DB_NAME);
+        assert(disk_manager_->is_dir(TEST_DB_NAME));
+        if (chdir(TEST_DB_NAME.c_str()) < 0) {
+            throw UnixError();
+        }
+
+        // 生成测试文件，每个页面开头写入自己的页号
+        const std::string filename = "bench_file";
+        disk_manager_->create_file(filename);
+        fd_ = disk_manager_->open_file(filename);
+        char buf[PAGE_SIZE] = {0};
+        for (int page_no = 0; page_no < BENCH_NUM_PAGES; page_no++) {
+            snprintf(buf, sizeof(buf), "%d", page_no);
+            disk_manager_->write_page(fd_, page_no, buf, PAGE_SIZE);
+        }
+        disk_manager_->set_fd2pageno(fd_, BENCH_NUM_PAGES);
+    }
+
+    void TearDown() override {
+        disk_manager_->close_file(fd_);
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+    };
+
+    /**
+     * @brief 使用num_threads个线程对缓冲池做随机的fetch/unpin，返回每秒完成的操作数
+     */
+    double run(BufferPoolManager *bpm, int num_threads) {
+        std::atomic<bool> start{false};
+        std::vector<std::thread> threads;
+        const int ops_per_thread = BENCH_TOTAL_OPS / num_threads;
+        for (int tid = 0; tid < num_threads; tid++) {
+            threads.emplace_back([&, tid]() {
+                std::mt19937 rng(tid);
+                std::uniform_int_distribution<int> dist(0, BENCH_NUM_PAGES - 1);
+                char expect[16];
+                while (!start.load()) std::this_thread::yield();
+                for (int i = 0; i < ops_per_thread; i++) {
+                    PageId page_id = {.fd = fd_, .page_no = dist(rng)};
+                    Page *page = bpm->fetch_page(page_id);
+                    ASSERT_NE(page, nullptr);
+                    if ((i & 1023) == 0) {
+                        snprintf(expect, sizeof(expect), "%d", page_id.page_no);
+                        EXPECT_EQ(0, strcmp(expect, page->get_data()));
+                    }
+                    bpm->unpin_page(page_id, false);
+                }
+            });
+        }
+        auto begin = std::chrono::steady_clock::now();
+        start.store(true);
+        for (auto &thread : threads) thread.join();
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        return static_cast<double>(ops_per_thread) * num_threads / seconds;
+    }
+};
+
+TEST_F(BufferPoolManagerBench, FetchUnpinScaling) {
+    const std::vector<size_t> instance_counts = {1, 16};
+    const std::vector<int> thread_counts = {1, 2, 4, 8, 16, 32};
+
+    printf("%-10s", "threads");
+    for (auto num_instances : instance_counts) printf("%14s", (std::to_string(num_instances) + " inst Mops").c_str());
+    printf("\n");
+
+    std::vector<std::vector<double>> result(thread_counts.size());
+    for (auto num_instances : instance_counts) {
+        auto bpm = std::make_unique<BufferPoolManager>(BENCH_POOL_SIZE, disk_manager_.get(), num_instances);
+        // 预热：把所有页面读入缓冲池
+        for (int page_no = 0; page_no < BENCH_NUM_PAGES; page_no++) {
+            ASSERT_NE(bpm->fetch_page(PageId{fd_, page_no}), nullptr);
+            bpm->unpin_page(PageId{fd_, page_no}, false);
+        }
+        for (size_t i = 0; i < thread_counts.size(); i++) {
+            result[i].push_back(run(bpm.get(), thread_counts[i]));
+        }
+    }
+
+    for (size_t i = 0; i < thread_counts.size(); i++) {
+        printf("%-10d", thread_counts[i]);
+        for (double ops : result[i]) printf("%14.2f", ops / 1e6);
+        printf("\n");
+    }
+}
@@ -1,6 +1,8 @@
 #include "storage/buffer_pool_manager.h"
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstring>
 #include <ctime>
 #include <string>
@@ -428,3 +430,646 @@ TEST_F(BufferPoolManagerTest, ConcurrencyTest) {
 
     disk_manager_->close_file(fd);
 }
+
+/**
+ * @brief 乐观读者获取页面：不pin页面；页面被淘汰后之前读出的版本号验证失败，不在缓冲池中的页面返回nullptr
+ */
+TEST_F(BufferPoolManagerTest, PeekPageTest) {
+    const int buffer_pool_size = 8;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    disk_manager->create_file("peek");
+    int fd = disk_manager->open_file("peek");
+
+    PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+    Page *page = bpm->new_page(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+
+    uint64_t version;
+    uint64_t hits = bpm->get_stats()[0].counters.hits;
+    EXPECT_EQ(page, bpm->peek_page(page_id, &version));
+    EXPECT_TRUE(page->validate(version));
+    // 没有pin住页面，也不计入命中次数
+    EXPECT_EQ(false, bpm->unpin_page(page_id, false));
+    EXPECT_EQ(hits, bpm->get_stats()[0].counters.hits);
+
+    // 加写latch期间获取不到页面，修改页面之后验证失败
+    page->w_latch();
+    uint64_t latched_version;
+    EXPECT_EQ(nullptr, bpm->peek_page(page_id, &latched_version));
+    page->w_unlatch();
+    EXPECT_FALSE(page->validate(version));
+    EXPECT_EQ(page, bpm->peek_page(page_id, &version));
+
+    // 页面被淘汰之后验证失败，之后获取不到该页面
+    for (int i = 0; i < buffer_pool_size; i++) {
+        PageId other_page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        ASSERT_NE(nullptr, bpm->new_page(&other_page_id));
+        EXPECT_EQ(true, bpm->unpin_page(other_page_id, false));
+    }
+    EXPECT_FALSE(page->validate(version));
+    EXPECT_EQ(nullptr, bpm->peek_page(page_id, &version));
+
+    bpm.reset();
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 删除仍被固定的页面：推迟到最后一个固定释放时再从缓冲池删除并交还给磁盘管理器，之前不会被重新分配
+ */
+TEST_F(BufferPoolManagerTest, DeallocatePinnedPageTest) {
+    const int buffer_pool_size = 8;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    disk_manager->create_file("deallocate");
+    int fd = disk_manager->open_file("deallocate");
+
+    PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+    ASSERT_NE(nullptr, bpm->new_page(&page_id));
+    ASSERT_NE(nullptr, bpm->fetch_page(page_id));
+
+    bpm->deallocate_page(page_id);
+    EXPECT_FALSE(disk_manager->is_free_page(fd, page_id.page_no));
+    EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+    EXPECT_FALSE(disk_manager->is_free_page(fd, page_id.page_no));
+    PageId other_page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+    ASSERT_NE(nullptr, bpm->new_page(&other_page_id));
+    EXPECT_NE(page_id.page_no, other_page_id.page_no);
+    EXPECT_EQ(true, bpm->unpin_page(other_page_id, false));
+
+    // 最后一个固定释放时删除页面，页面不再留在缓冲池中，之后可以被重新分配
+    EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    EXPECT_TRUE(disk_manager->is_free_page(fd, page_id.page_no));
+    std::vector<PageId> resident_pages = bpm->get_resident_pages();
+    EXPECT_EQ(resident_pages.end(), std::find(resident_pages.begin(), resident_pages.end(), page_id));
+    EXPECT_EQ(false, bpm->unpin_page(page_id, false));
+
+    // 未被固定的页面立即删除
+    bpm->deallocate_page(other_page_id);
+    EXPECT_TRUE(disk_manager->is_free_page(fd, other_page_id.page_no));
+
+    bpm.reset();
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 开启页面清理线程后，多个线程随机读写页面，页面内容始终与最后一次写入一致
+ * @note 缓冲池远小于页面个数，淘汰与后台写回交替发生
+ */
+TEST_F(BufferPoolManagerTest, PageCleanerTest) {
+    const int num_threads = 4;
+    const int num_pages = 200;
+    const int buffer_pool_size = 20;
+    const int num_ops = 5000;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager, 2, true);
+
+    const std::string filename = "page_cleaner_test";
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+    // 页面开头存放一个计数器，每次写入加一
+    for (int i = 0; i < num_pages; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        Page *page = bpm->new_page(&page_id);
+        ASSERT_NE(nullptr, page);
+        ASSERT_EQ(i, page_id.page_no);
+        EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+    }
+
+    // 每个线程只写自己的页面，各自记录期望的计数器值
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < num_threads; tid++) {
+        threads.emplace_back([&, tid]() {
+            std::vector<int> expected(num_pages / num_threads, 0);
+            srand(tid);
+            for (int op = 0; op < num_ops; op++) {
+                int idx = rand() % expected.size();
+                PageId page_id = {.fd = fd, .page_no = static_cast<page_id_t>(idx * num_threads + tid)};
+                Page *page = bpm->fetch_page(page_id);
+                if (page == nullptr) continue;
+                int *counter = reinterpret_cast<int *>(page->get_data() + Page::OFFSET_PAGE_HDR);
+                EXPECT_EQ(expected[idx], *counter);
+                bool write = rand() % 2;
+                if (write) {
+                    expected[idx] = ++*counter;
+                }
+                EXPECT_EQ(true, bpm->unpin_page(page_id, write));
+            }
+            for (size_t idx = 0; idx < expected.size(); idx++) {
+                PageId page_id = {.fd = fd, .page_no = static_cast<page_id_t>(idx * num_threads + tid)};
+                Page *page = nullptr;
+                while (page == nullptr) page = bpm->fetch_page(page_id);
+                EXPECT_EQ(expected[idx], *reinterpret_cast<int *>(page->get_data() + Page::OFFSET_PAGE_HDR));
+                bpm->unpin_page(page_id, false);
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+
+    // 全部写回后，磁盘上的内容与缓冲池中一致
+    bpm->flush_all_pages(fd);
+    char buf[PAGE_SIZE];
+    for (int i = 0; i < num_pages; i++) {
+        PageId page_id = {.fd = fd, .page_no = i};
+        Page *page = bpm->fetch_page(page_id);
+        ASSERT_NE(nullptr, page);
+        disk_manager->read_page(fd, i, buf, PAGE_SIZE);
+        EXPECT_EQ(0, memcmp(buf, page->get_data(), PAGE_SIZE));
+        bpm->unpin_page(page_id, false);
+    }
+
+    bpm.reset();
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 顺序扫描与随机访问同时进行时，预读的页面与磁盘或缓冲池中的脏页内容一致
+ */
+TEST_F(BufferPoolManagerTest, ReadAheadTest) {
+    const int num_pages = 512;
+    const int buffer_pool_size = 32;
+    const int num_modified = 8;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager, 4, false, true);
+
+    const std::string filename = "read_ahead_test";
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+    // 页面开头存放页号
+    char buf[PAGE_SIZE];
+    memset(buf, 0, PAGE_SIZE);
+    for (int i = 0; i < num_pages; i++) {
+        *reinterpret_cast<int *>(buf + Page::OFFSET_PAGE_HDR) = i;
+        disk_manager->write_page(fd, i, buf, PAGE_SIZE);
+    }
+    disk_manager->set_fd2pageno(fd, num_pages);
+
+    // 修改一部分页面但不写回，预读不能用磁盘上的旧数据覆盖它们
+    auto expected = [&](int page_no) {
+        return page_no >= num_pages / 2 && page_no < num_pages / 2 + num_modified ? -page_no : page_no;
+    };
+    for (int i = num_pages / 2; i < num_pages / 2 + num_modified; i++) {
+        PageId page_id = {.fd = fd, .page_no = i};
+        Page *page = bpm->fetch_page(page_id);
+        ASSERT_NE(nullptr, page);
+        *reinterpret_cast<int *>(page->get_data() + Page::OFFSET_PAGE_HDR) = -i;
+        EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+    }
+
+    auto check_page = [&](int page_no) {
+        PageId page_id = {.fd = fd, .page_no = page_no};
+        Page *page = nullptr;
+        while (page == nullptr) page = bpm->fetch_page(page_id);
+        EXPECT_EQ(expected(page_no), *reinterpret_cast<int *>(page->get_data() + Page::OFFSET_PAGE_HDR));
+        EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    };
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < 2; tid++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < num_pages; i++) check_page(i);
+        });
+    }
+    threads.emplace_back([&]() {
+        srand(0);
+        for (int op = 0; op < num_pages; op++) check_page(rand() % num_pages);
+    });
+    for (auto &thread : threads) thread.join();
+
+    bpm->flush_all_pages(fd);
+    for (int i = 0; i < num_pages; i++) {
+        disk_manager->read_page(fd, i, buf, PAGE_SIZE);
+        EXPECT_EQ(expected(i), *reinterpret_cast<int *>(buf + Page::OFFSET_PAGE_HDR));
+    }
+
+    bpm.reset();
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 使用BufferAccessStrategy的大量读写只在环形缓冲区中循环使用帧，不会淘汰其他页面
+ */
+TEST_F(BufferPoolManagerTest, BufferAccessStrategyTest) {
+    const int num_hot_pages = 32;
+    const int num_scan_pages = 512;
+    const int buffer_pool_size = 64;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager, 2);
+
+    disk_manager->create_file("hot");
+    disk_manager->create_file("scan");
+    disk_manager->create_file("load");
+    int hot_fd = disk_manager->open_file("hot");
+    int scan_fd = disk_manager->open_file("scan");
+    int load_fd = disk_manager->open_file("load");
+    char buf[PAGE_SIZE];
+    memset(buf, 0, PAGE_SIZE);
+    for (int i = 0; i < num_scan_pages; i++) disk_manager->write_page(scan_fd, i, buf, PAGE_SIZE);
+
+    // 热点页面都是脏页，被淘汰时会写回磁盘
+    for (int i = 0; i < num_hot_pages; i++) {
+        PageId page_id = {.fd = hot_fd, .page_no = INVALID_PAGE_ID};
+        Page *page = bpm->new_page(&page_id);
+        ASSERT_NE(nullptr, page);
+        *reinterpret_cast<int *>(page->get_data() + Page::OFFSET_PAGE_HDR) = i;
+        EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+    }
+
+    BufferAccessStrategy scan_strategy(8);
+    for (int i = 0; i < num_scan_pages; i++) {
+        PageId page_id = {.fd = scan_fd, .page_no = i};
+        ASSERT_NE(nullptr, bpm->fetch_page(page_id, &scan_strategy));
+        EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    }
+    BufferAccessStrategy load_strategy(8);
+    for (int i = 0; i < num_scan_pages; i++) {
+        PageId page_id = {.fd = load_fd, .page_no = INVALID_PAGE_ID};
+        Page *page = bpm->new_page(&page_id, &load_strategy);
+        ASSERT_NE(nullptr, page);
+        *reinterpret_cast<int *>(page->get_data() + Page::OFFSET_PAGE_HDR) = i;
+        EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+    }
+    EXPECT_EQ(0, disk_manager->get_file_size(hot_fd));
+
+    // 不使用访问策略的扫描会把热点页面挤出缓冲池
+    for (int i = 0; i < num_scan_pages; i++) {
+        PageId page_id = {.fd = scan_fd, .page_no = i};
+        ASSERT_NE(nullptr, bpm->fetch_page(page_id));
+        EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    }
+    EXPECT_EQ(num_hot_pages * PAGE_SIZE, disk_manager->get_file_size(hot_fd));
+
+    bpm->flush_all_pages(load_fd);
+    for (int i = 0; i < num_scan_pages; i++) {
+        disk_manager->read_page(load_fd, i, buf, PAGE_SIZE);
+        EXPECT_EQ(i, *reinterpret_cast<int *>(buf + Page::OFFSET_PAGE_HDR));
+    }
+
+    bpm.reset();
+    disk_manager->close_file(hot_fd);
+    disk_manager->close_file(scan_fd);
+    disk_manager->close_file(load_fd);
+}
+
+/**
+ * @brief 缓冲池统计信息：命中、未命中、淘汰、写回的计数，以及磁盘读写延迟的记录
+ */
+TEST_F(BufferPoolManagerTest, StatsTest) {
+    const int buffer_pool_size = 8;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+
+    disk_manager->create_file("stats");
+    int fd = disk_manager->open_file("stats");
+
+    // 前buffer_pool_size个新页面占用空闲帧，之后的每个新页面都淘汰一个脏页
+    for (int i = 0; i < 2 * buffer_pool_size; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        ASSERT_NE(nullptr, bpm->new_page(&page_id));
+        EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+    }
+    for (int i = buffer_pool_size; i < 2 * buffer_pool_size; i++) {
+        PageId page_id = {.fd = fd, .page_no = i};
+        ASSERT_NE(nullptr, bpm->fetch_page(page_id));
+        EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    }
+    PageId page_id = {.fd = fd, .page_no = 0};
+    ASSERT_NE(nullptr, bpm->fetch_page(page_id));
+    EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+
+    auto stats = bpm->get_stats();
+    ASSERT_EQ(1, stats.size());
+    EXPECT_EQ(buffer_pool_size, stats[0].pool_size);
+    EXPECT_EQ(buffer_pool_size, stats[0].used_frames);
+    EXPECT_EQ(buffer_pool_size - 1, stats[0].dirty_frames);
+    EXPECT_EQ(buffer_pool_size, stats[0].counters.hits);
+    EXPECT_EQ(1, stats[0].counters.misses);
+    EXPECT_EQ(buffer_pool_size + 1, stats[0].counters.evictions);
+    EXPECT_EQ(buffer_pool_size + 1, stats[0].counters.writebacks);
+    ASSERT_LT(fd, stats[0].file_counters.size());
+    EXPECT_EQ(stats[0].counters.hits, stats[0].file_counters[fd].hits);
+    EXPECT_EQ(stats[0].counters.evictions, stats[0].file_counters[fd].evictions);
+
+    // 只有脏页的写回才计数
+    bpm->flush_all_pages(fd);
+    bpm->flush_all_pages(fd);
+    stats = bpm->get_stats();
+    EXPECT_EQ(0, stats[0].dirty_frames);
+    EXPECT_EQ(2 * buffer_pool_size, stats[0].counters.writebacks);
+
+    LatencySummary reads = disk_manager->get_read_latency();
+    LatencySummary writes = disk_manager->get_write_latency();
+    EXPECT_EQ(1, reads.pages);
+    // flush_all_pages会写出文件在缓冲池中的所有页面，磁盘写入的页面数不区分脏页
+    EXPECT_EQ(3 * buffer_pool_size + 1, writes.pages);
+    uint64_t bucket_total = 0;
+    for (int i = 0; i < LatencySummary::NUM_BUCKETS; i++) bucket_total += writes.buckets[i];
+    EXPECT_EQ(writes.count, bucket_total);
+    EXPECT_GE(writes.percentile_us(0.99), writes.percentile_us(0.5));
+
+    // 关闭文件时清空它的计数，之后复用这个文件句柄的文件从0开始计数
+    bpm->reset_file_counters(fd);
+    stats = bpm->get_stats();
+    EXPECT_TRUE(stats[0].file_counters[fd].empty());
+    EXPECT_EQ(buffer_pool_size, stats[0].counters.hits);
+
+    bpm.reset();
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 保存缓冲池中的页面列表，用它预热另一个缓冲池，之后访问这些页面全部命中
+ */
+TEST_F(BufferPoolManagerTest, WarmUpTest) {
+    const int num_pages = 256;
+    const int buffer_pool_size = 64;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    disk_manager->create_file("warm_up");
+    int fd = disk_manager->open_file("warm_up");
+    char buf[PAGE_SIZE];
+    for (int i = 0; i < num_pages; i++) {
+        memset(buf, 0, PAGE_SIZE);
+        *reinterpret_cast<int *>(buf + Page::OFFSET_PAGE_HDR) = i;
+        disk_manager->write_page(fd, i, buf, PAGE_SIZE);
+    }
+
+    // 随机访问一部分页面
+    std::vector<PageId> hot_pages;
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager, 4);
+    for (int i = 0; i < buffer_pool_size / 2; i++) {
+        PageId page_id = {.fd = fd, .page_no = (i * 97) % num_pages};
+        ASSERT_NE(nullptr, bpm->fetch_page(page_id));
+        EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+        hot_pages.push_back(page_id);
+    }
+    std::vector<PageId> resident_pages = bpm->get_resident_pages();
+    EXPECT_EQ(hot_pages.size(), resident_pages.size());
+    bpm.reset();
+
+    // 超出文件末尾的页面被跳过
+    resident_pages.push_back({.fd = fd, .page_no = num_pages + 1});
+    bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager, 4);
+    bpm->warm_up(resident_pages);
+    for (auto &page_id : hot_pages) {
+        Page *page = bpm->fetch_page(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(page_id.page_no, *reinterpret_cast<int *>(page->get_data() + Page::OFFSET_PAGE_HDR));
+        EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    }
+    BufferPoolCounters total;
+    for (auto &stats : bpm->get_stats()) total += stats.counters;
+    EXPECT_EQ(hot_pages.size(), total.hits);
+    EXPECT_EQ(0, total.misses);
+
+    bpm.reset();
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 在线扩大和缩小缓冲池：扩大后新增的帧立即可用；缩小时等待被固定的页面释放，脏页写回后再释放帧
+ */
+TEST_F(BufferPoolManagerTest, ResizeTest) {
+    const int initial_size = 64;
+    const int grown_size = 256;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(initial_size, disk_manager, 2);
+    disk_manager->create_file("resize");
+    int fd = disk_manager->open_file("resize");
+
+    // 最后一个页面保持固定, 它位于扩大时新增的帧中
+    PageId pinned_page_id;
+    for (int i = 0; i < grown_size; i++) {
+        if (i == initial_size) {
+            EXPECT_EQ(grown_size, bpm->resize(grown_size));
+        }
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        Page *page = bpm->new_page(&page_id);
+        ASSERT_NE(nullptr, page);
+        *reinterpret_cast<int *>(page->get_data() + Page::OFFSET_PAGE_HDR) = i;
+        if (i + 1 < grown_size)
+            EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+        else
+            pinned_page_id = page_id;
+    }
+    EXPECT_EQ(grown_size, bpm->get_pool_size());
+    BufferPoolCounters total;
+    for (auto &stats : bpm->get_stats()) total += stats.counters;
+    EXPECT_EQ(0, total.evictions);
+
+    std::atomic<bool> released = false;
+    std::thread releaser([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        released = true;
+        bpm->unpin_page(pinned_page_id, true);
+    });
+    EXPECT_EQ(initial_size, bpm->resize(initial_size));
+    EXPECT_TRUE(released);
+    releaser.join();
+
+    size_t total_frames = 0;
+    for (auto &stats : bpm->get_stats()) total_frames += stats.pool_size;
+    EXPECT_EQ(initial_size, total_frames);
+    for (int i = 0; i < grown_size; i++) {
+        PageId page_id = {.fd = fd, .page_no = i};
+        Page *page = bpm->fetch_page(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(i, *reinterpret_cast<int *>(page->get_data() + Page::OFFSET_PAGE_HDR));
+        EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    }
+
+    bpm.reset();
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 缩小时页面一直被固定：等待超时后放弃缩小该页面所在的分区，返回实际达到的大小；退出的帧恢复可用
+ */
+TEST_F(BufferPoolManagerTest, ResizeTimeoutTest) {
+    const int initial_size = 64;
+    const int grown_size = 256;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(initial_size, disk_manager, 2);
+    disk_manager->create_file("resize_timeout");
+    int fd = disk_manager->open_file("resize_timeout");
+
+    // 固定的页面位于扩大时新增的块中, 缩小时要释放这个块
+    PageId pinned_page_id;
+    for (int i = 0; i < grown_size; i++) {
+        if (i == initial_size) {
+            EXPECT_EQ(grown_size, bpm->resize(grown_size));
+        }
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        ASSERT_NE(nullptr, bpm->new_page(&page_id));
+        if (i + 1 < grown_size)
+            EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+        else
+            pinned_page_id = page_id;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t size = bpm->resize(initial_size, 50);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    EXPECT_GT(size, initial_size);
+    EXPECT_LE(size, grown_size);
+    EXPECT_EQ(size, bpm->get_pool_size());
+    size_t total_frames = 0;
+    for (auto &stats : bpm->get_stats()) total_frames += stats.pool_size;
+    EXPECT_EQ(size, total_frames);
+
+    // 放弃缩小的分区中的帧可以照常装入页面
+    for (int i = 0; i < 2 * grown_size; i++) {
+        PageId page_id = {.fd = fd, .page_no = i % grown_size};
+        ASSERT_NE(nullptr, bpm->fetch_page(page_id));
+        EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+    }
+
+    EXPECT_EQ(true, bpm->unpin_page(pinned_page_id, true));
+    EXPECT_EQ(initial_size, bpm->resize(initial_size, 50));
+
+    bpm.reset();
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 不同页面大小的文件：页面按文件的页面大小装入对应帧大小的分区，按文件的页面大小定位和读写磁盘
+ */
+TEST_F(BufferPoolManagerTest, PageSizeTest) {
+    const int num_pages = 64;
+    const int large_page_size = 4 * PAGE_SIZE;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(32, disk_manager, 2);
+    disk_manager->create_file("small");
+    disk_manager->create_file("large");
+    int small_fd = disk_manager->open_file("small");
+    int large_fd = disk_manager->open_file("large");
+    disk_manager->set_page_size(large_fd, large_page_size);
+
+    // 每个页面的第一个和最后一个int都写入页号, 页面被截短或者错位时可以发现
+    for (int i = 0; i < num_pages; i++) {
+        for (int fd : {small_fd, large_fd}) {
+            PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+            Page *page = bpm->new_page(&page_id);
+            ASSERT_NE(nullptr, page);
+            ASSERT_EQ(disk_manager->get_page_size(fd), page->get_page_size());
+            *reinterpret_cast<int *>(page->get_data() + Page::OFFSET_PAGE_HDR) = i;
+            *reinterpret_cast<int *>(page->get_data() + page->get_page_size() - sizeof(int)) = i;
+            EXPECT_EQ(true, bpm->unpin_page(page_id, true));
+        }
+    }
+    bpm->flush_all_pages(small_fd);
+    bpm->flush_all_pages(large_fd);
+    EXPECT_EQ(num_pages * PAGE_SIZE, disk_manager->get_file_size(small_fd));
+    EXPECT_EQ(num_pages * large_page_size, disk_manager->get_file_size(large_fd));
+
+    // 16KB的页面在另一组分区中, 这组分区在第一次访问large时创建
+    std::vector<int> page_sizes;
+    for (auto &stats : bpm->get_stats()) {
+        page_sizes.push_back(stats.page_size);
+        if (stats.page_size == large_page_size) {
+            EXPECT_LE(BUFFER_POOL_MIN_CLASS_FRAMES / 2, stats.pool_size);
+        }
+    }
+    EXPECT_EQ((std::vector<int>{PAGE_SIZE, PAGE_SIZE, large_page_size, large_page_size}), page_sizes);
+
+    // 新的缓冲池从磁盘读回全部页面
+    bpm = std::make_unique<BufferPoolManager>(32, disk_manager, 2);
+    for (int i = 0; i < num_pages; i++) {
+        for (int fd : {small_fd, large_fd}) {
+            PageId page_id = {.fd = fd, .page_no = i};
+            Page *page = bpm->fetch_page(page_id);
+            ASSERT_NE(nullptr, page);
+            EXPECT_EQ(i, *reinterpret_cast<int *>(page->get_data() + Page::OFFSET_PAGE_HDR));
+            EXPECT_EQ(i, *reinterpret_cast<int *>(page->get_data() + page->get_page_size() - sizeof(int)));
+            EXPECT_EQ(true, bpm->unpin_page(page_id, false));
+        }
+    }
+
+    bpm.reset();
+    disk_manager->close_file(small_fd);
+    disk_manager->close_file(large_fd);
+}
+
+/**
+ * @brief 页面守卫：守卫析构或drop时unpin页面，写守卫同时标记脏页，被移动的守卫不会重复unpin
+ */
+TEST_F(BufferPoolManagerTest, PageGuardTest) {
+    const int buffer_pool_size = 4;
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+    disk_manager->create_file("guard");
+    int fd = disk_manager->open_file("guard");
+
+    // 守卫持有pin时所有帧都被固定，无法再分配新页面
+    std::vector<WritePageGuard> guards;
+    for (int i = 0; i < buffer_pool_size; i++) {
+        PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        WritePageGuard guard = bpm->new_page_guarded(&page_id);
+        ASSERT_TRUE(guard.is_valid());
+        EXPECT_EQ(i, guard.get_page_id().page_no);
+        *reinterpret_cast<int *>(guard.get_data() + Page::OFFSET_PAGE_HDR) = i;
+        guards.push_back(std::move(guard));
+        EXPECT_FALSE(guard.is_valid());
+    }
+    PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+    EXPECT_FALSE(bpm->new_page_guarded(&page_id).is_valid());
+
+    // 守卫析构之后页面可以被淘汰，淘汰时写回的是守卫标记的脏页
+    guards.clear();
+    for (int i = 0; i < buffer_pool_size; i++) {
+        page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+        ASSERT_TRUE(bpm->new_page_guarded(&page_id).is_valid());
+    }
+    for (int i = 0; i < buffer_pool_size; i++) {
+        ReadPageGuard guard = bpm->fetch_page_read(PageId{fd, i});
+        ASSERT_TRUE(guard.is_valid());
+        EXPECT_EQ(i, *reinterpret_cast<const int *>(guard.get_data() + Page::OFFSET_PAGE_HDR));
+    }
+
+    // 读守卫不标记脏页，写守卫在unpin时标记脏页；drop之后不再unpin
+    {
+        ReadPageGuard guard = bpm->fetch_page_read(PageId{fd, 0});
+        Page *page = guard.get_page();
+        guard.drop();
+        EXPECT_FALSE(page->is_dirty());
+        EXPECT_FALSE(bpm->unpin_page(PageId{fd, 0}, false));
+    }
+    {
+        WritePageGuard guard = bpm->fetch_page_write(PageId{fd, 0});
+        Page *page = guard.get_page();
+        WritePageGuard moved = std::move(guard);
+        moved.drop();
+        EXPECT_TRUE(page->is_dirty());
+        EXPECT_FALSE(bpm->unpin_page(PageId{fd, 0}, false));
+    }
+
+    bpm.reset();
+    disk_manager->close_file(fd);
+}
+
+/**
+ * @brief 页面latch：写守卫持有帧的写latch期间，其他线程的读守卫等待写守卫释放
+ */
+TEST_F(BufferPoolManagerTest, PageLatchTest) {
+    auto disk_manager = BufferPoolManagerTest::disk_manager_.get();
+    auto bpm = std::make_unique<BufferPoolManager>(4, disk_manager);
+    disk_manager->create_file("latch");
+    int fd = disk_manager->open_file("latch");
+
+    PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+    WritePageGuard write_guard = bpm->new_page_guarded(&page_id);
+    ASSERT_TRUE(write_guard.is_valid());
+    std::atomic<int> value{-1};
+    std::thread reader([&] {
+        ReadPageGuard read_guard = bpm->fetch_page_read(page_id);
+        value = *reinterpret_cast<const int *>(read_guard.get_data() + Page::OFFSET_PAGE_HDR);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(-1, value.load());
+    *reinterpret_cast<int *>(write_guard.get_data() + Page::OFFSET_PAGE_HDR) = 42;
+    write_guard.drop();
+    reader.join();
+    EXPECT_EQ(42, value.load());
+
+    bpm.reset();
+    disk_manager->close_file(fd);
+}
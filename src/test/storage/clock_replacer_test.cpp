@@ -0,0 +1,88 @@
+#include "replacer/clock_replacer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+/**
+ * @brief 简单测试ClockReplacer的基本功能
+ */
+TEST(ClockReplacerTest, SimpleTest) {
+    ClockReplacer clock_replacer(7);
+
+    // Scenario: unpin six elements, i.e. add them to the replacer.
+    clock_replacer.unpin(1);
+    clock_replacer.unpin(2);
+    clock_replacer.unpin(3);
+    clock_replacer.unpin(4);
+    clock_replacer.unpin(5);
+    clock_replacer.unpin(6);
+    clock_replacer.unpin(1);
+    EXPECT_EQ(6, clock_replacer.Size());
+
+    // Scenario: get three victims from the clock.
+    int value;
+    clock_replacer.victim(&value);
+    EXPECT_EQ(1, value);
+    clock_replacer.victim(&value);
+    EXPECT_EQ(2, value);
+    clock_replacer.victim(&value);
+    EXPECT_EQ(3, value);
+
+    // Scenario: pin elements in the replacer.
+    // Note that 3 has already been victimized, so pinning 3 should have no effect.
+    clock_replacer.pin(3);
+    clock_replacer.pin(4);
+    EXPECT_EQ(2, clock_replacer.Size());
+
+    // Scenario: unpin 4. We expect that the reference bit of 4 will be set to 1.
+    clock_replacer.unpin(4);
+
+    // Scenario: continue looking for victims. We expect these victims.
+    clock_replacer.victim(&value);
+    EXPECT_EQ(5, value);
+    clock_replacer.victim(&value);
+    EXPECT_EQ(6, value);
+    clock_replacer.victim(&value);
+    EXPECT_EQ(4, value);
+    EXPECT_EQ(false, clock_replacer.victim(&value));
+}
+
+/**
+ * @brief 多个线程并发地pin/unpin，结束后replacer中恰好是最后一次操作为unpin的帧
+ */
+TEST(ClockReplacerTest, ConcurrencyTest) {
+    const int num_threads = 8;
+    const int frames_per_thread = 128;
+    const int value_size = num_threads * frames_per_thread;
+    ClockReplacer clock_replacer(value_size);
+
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < num_threads; tid++) {
+        threads.emplace_back([tid, &clock_replacer]() {
+            // 每个线程只操作自己的帧，偶数帧最后一次操作为unpin
+            for (int round = 0; round < 100; round++) {
+                for (int i = 0; i < frames_per_thread; i++) {
+                    frame_id_t frame_id = tid * frames_per_thread + i;
+                    clock_replacer.unpin(frame_id);
+                    if (round == 99 && frame_id % 2 == 0) continue;
+                    clock_replacer.pin(frame_id);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    EXPECT_EQ(value_size / 2, clock_replacer.Size());
+
+    std::vector<int> out_values;
+    int result;
+    while (clock_replacer.victim(&result)) out_values.push_back(result);
+    std::sort(out_values.begin(), out_values.end());
+    ASSERT_EQ(value_size / 2, out_values.size());
+    for (int i = 0; i < value_size / 2; i++) EXPECT_EQ(2 * i, out_values[i]);
+}
@@ -148,3 +148,178 @@ TEST_F(DiskManagerTest, PageOperation) {
     disk_manager_->destroy_file(filename);
     EXPECT_EQ(disk_manager_->is_file(filename), false);
 }
+
+/**
+ * @brief 测试一次读写多个连续页面 read/write pages，以及读取文件末尾之后的页面
+ */
+TEST_F(DiskManagerTest, VectoredPageOperation) {
+    const std::string filename = "VectoredPageOperationTestFile";
+    if (disk_manager_->is_file(filename)) {
+        disk_manager_->destroy_file(filename);
+    }
+    disk_manager_->create_file(filename);
+    int fd = disk_manager_->open_file(filename);
+
+    // 每个页面单独分配，内存中不连续
+    const int num_pages = 16;
+    std::vector<std::vector<char>> data(num_pages, std::vector<char>(PAGE_SIZE));
+    std::vector<std::vector<char>> buf(num_pages, std::vector<char>(PAGE_SIZE));
+    std::vector<char *> data_ptrs, buf_ptrs;
+    for (int i = 0; i < num_pages; i++) {
+        rand_buf(data[i].data(), PAGE_SIZE);
+        data[i][0] = static_cast<char>(i);
+        data_ptrs.push_back(data[i].data());
+        buf_ptrs.push_back(buf[i].data());
+    }
+    disk_manager_->write_pages(fd, 2, data_ptrs.data(), num_pages);
+    disk_manager_->read_pages(fd, 2, buf_ptrs.data(), num_pages);
+    for (int i = 0; i < num_pages; i++) {
+        EXPECT_EQ(std::memcmp(buf[i].data(), data[i].data(), PAGE_SIZE), 0);
+    }
+
+    // 单页读取与批量写入的结果一致
+    char page[PAGE_SIZE];
+    disk_manager_->read_page(fd, 5, page, PAGE_SIZE);
+    EXPECT_EQ(std::memcmp(page, data[3].data(), PAGE_SIZE), 0);
+
+    // 跨过文件末尾读取，末尾之后的页面为全0
+    disk_manager_->read_pages(fd, num_pages, buf_ptrs.data(), 4);
+    EXPECT_EQ(std::memcmp(buf[0].data(), data[num_pages - 2].data(), PAGE_SIZE), 0);
+    EXPECT_EQ(std::memcmp(buf[1].data(), data[num_pages - 1].data(), PAGE_SIZE), 0);
+    std::vector<char> zeros(PAGE_SIZE, 0);
+    EXPECT_EQ(std::memcmp(buf[2].data(), zeros.data(), PAGE_SIZE), 0);
+    EXPECT_EQ(std::memcmp(buf[3].data(), zeros.data(), PAGE_SIZE), 0);
+    disk_manager_->read_page(fd, num_pages + 10, page, PAGE_SIZE);
+    EXPECT_EQ(std::memcmp(page, zeros.data(), PAGE_SIZE), 0);
+
+    disk_manager_->close_file(fd);
+    disk_manager_->destroy_file(filename);
+}
+
+/**
+ * @brief 测试O_DIRECT模式下的读写：页面对齐的批量读写，以及不对齐的缓冲区和只读写页面一部分(如文件头)的情况
+ */
+TEST_F(DiskManagerTest, DirectIoPageOperation) {
+    auto direct_disk_manager = std::make_unique<DiskManager>(true);
+    const std::string filename = "DirectIoPageOperationTestFile";
+    if (direct_disk_manager->is_file(filename)) {
+        direct_disk_manager->destroy_file(filename);
+    }
+    direct_disk_manager->create_file(filename);
+    int fd = direct_disk_manager->open_file(filename);
+
+    // 按页对齐的缓冲区
+    const int num_pages = 8;
+    std::vector<char *> data_ptrs, buf_ptrs;
+    for (int i = 0; i < num_pages; i++) {
+        data_ptrs.push_back(static_cast<char *>(aligned_alloc(PAGE_SIZE, PAGE_SIZE)));
+        buf_ptrs.push_back(static_cast<char *>(aligned_alloc(PAGE_SIZE, PAGE_SIZE)));
+        rand_buf(data_ptrs[i], PAGE_SIZE);
+        data_ptrs[i][0] = static_cast<char>(i);
+    }
+    direct_disk_manager->write_pages(fd, 1, data_ptrs.data(), num_pages);
+    direct_disk_manager->read_pages(fd, 1, buf_ptrs.data(), num_pages);
+    for (int i = 0; i < num_pages; i++) {
+        EXPECT_EQ(std::memcmp(buf_ptrs[i], data_ptrs[i], PAGE_SIZE), 0);
+    }
+
+    // 不对齐的缓冲区：vector的数据一般不按PAGE_SIZE对齐
+    std::vector<char> unaligned(PAGE_SIZE + 1);
+    direct_disk_manager->read_page(fd, 3, unaligned.data() + 1, PAGE_SIZE);
+    EXPECT_EQ(std::memcmp(unaligned.data() + 1, data_ptrs[2], PAGE_SIZE), 0);
+    std::vector<char *> unaligned_ptrs(num_pages, nullptr);
+    std::vector<std::vector<char>> unaligned_bufs(num_pages, std::vector<char>(PAGE_SIZE + 1));
+    for (int i = 0; i < num_pages; i++) unaligned_ptrs[i] = unaligned_bufs[i].data() + 1;
+    direct_disk_manager->read_pages(fd, 1, unaligned_ptrs.data(), num_pages);
+    for (int i = 0; i < num_pages; i++) {
+        EXPECT_EQ(std::memcmp(unaligned_ptrs[i], data_ptrs[i], PAGE_SIZE), 0);
+    }
+
+    // 只写页面开头的一部分，页面其余内容保持不变
+    char header[100];
+    rand_buf(header, sizeof(header));
+    direct_disk_manager->write_page(fd, 2, header, sizeof(header));
+    char header_read[100];
+    direct_disk_manager->read_page(fd, 2, header_read, sizeof(header_read));
+    EXPECT_EQ(std::memcmp(header_read, header, sizeof(header)), 0);
+    direct_disk_manager->read_page(fd, 2, buf_ptrs[0], PAGE_SIZE);
+    EXPECT_EQ(std::memcmp(buf_ptrs[0], header, sizeof(header)), 0);
+    EXPECT_EQ(std::memcmp(buf_ptrs[0] + sizeof(header), data_ptrs[1] + sizeof(header), PAGE_SIZE - sizeof(header)), 0);
+
+    // 普通I/O读到的内容和O_DIRECT写入的一致
+    direct_disk_manager->close_file(fd);
+    fd = disk_manager_->open_file(filename);
+    disk_manager_->read_page(fd, num_pages, buf_ptrs[0], PAGE_SIZE);
+    EXPECT_EQ(std::memcmp(buf_ptrs[0], data_ptrs[num_pages - 1], PAGE_SIZE), 0);
+    disk_manager_->close_file(fd);
+
+    for (int i = 0; i < num_pages; i++) {
+        free(data_ptrs[i]);
+        free(buf_ptrs[i]);
+    }
+    direct_disk_manager->destroy_file(filename);
+}
+
+/**
+ * @brief 测试页面的释放和复用 allocate/deallocate page，截断文件末尾的空闲页面，以及空闲页面表的持久化
+ */
+TEST_F(DiskManagerTest, FreePageOperation) {
+    const std::string filename = "FreePageOperationTestFile";
+    if (disk_manager_->is_file(filename)) {
+        disk_manager_->destroy_file(filename);
+    }
+    disk_manager_->create_file(filename);
+    int fd = disk_manager_->open_file(filename);
+    disk_manager_->set_fd2pageno(fd, 0);
+
+    const int num_pages = 10;
+    char page[PAGE_SIZE];
+    for (int i = 0; i < num_pages; i++) {
+        EXPECT_EQ(disk_manager_->allocate_page(fd), i);
+        memset(page, i, PAGE_SIZE);
+        disk_manager_->write_page(fd, i, page, PAGE_SIZE);
+    }
+
+    // 优先复用页号最小的空闲页面
+    disk_manager_->deallocate_page(fd, 7);
+    disk_manager_->deallocate_page(fd, 3);
+    EXPECT_EQ(disk_manager_->get_num_free_pages(fd), 2);
+    EXPECT_TRUE(disk_manager_->is_free_page(fd, 3));
+    EXPECT_EQ(disk_manager_->allocate_page(fd), 3);
+    EXPECT_EQ(disk_manager_->allocate_page(fd), 7);
+    EXPECT_EQ(disk_manager_->allocate_page(fd), num_pages);
+    EXPECT_FALSE(disk_manager_->is_free_page(fd, 3));
+
+    // 只截断文件末尾连续的空闲页面
+    disk_manager_->deallocate_page(fd, 2);
+    disk_manager_->deallocate_page(fd, num_pages);
+    disk_manager_->deallocate_page(fd, num_pages - 1);
+    disk_manager_->deallocate_page(fd, num_pages - 2);
+    EXPECT_EQ(disk_manager_->truncate_free_pages(fd), num_pages - 2);
+    EXPECT_EQ(disk_manager_->get_file_size(fd), (num_pages - 2) * PAGE_SIZE);
+    EXPECT_EQ(disk_manager_->get_num_free_pages(fd), 1);
+    EXPECT_EQ(disk_manager_->allocate_page(fd), 2);
+    EXPECT_EQ(disk_manager_->allocate_page(fd), num_pages - 2);
+
+    // 关闭文件时写入空闲页面表，重新打开时读回
+    disk_manager_->deallocate_page(fd, 5);
+    disk_manager_->deallocate_page(fd, 1);
+    disk_manager_->close_file(fd);
+    EXPECT_TRUE(disk_manager_->is_file(filename + FREE_PAGE_MAP_SUFFIX));
+    fd = disk_manager_->open_file(filename);
+    EXPECT_FALSE(disk_manager_->is_file(filename + FREE_PAGE_MAP_SUFFIX));
+    EXPECT_EQ(disk_manager_->get_num_free_pages(fd), 2);
+    EXPECT_TRUE(disk_manager_->is_free_page(fd, 1));
+    EXPECT_TRUE(disk_manager_->is_free_page(fd, 5));
+
+    // 再次写入空闲页面表之后复用页面，磁盘上过时的空闲页面表被删除
+    disk_manager_->flush_free_pages(fd);
+    EXPECT_TRUE(disk_manager_->is_file(filename + FREE_PAGE_MAP_SUFFIX));
+    disk_manager_->set_fd2pageno(fd, num_pages - 1);
+    EXPECT_EQ(disk_manager_->allocate_page(fd), 1);
+    EXPECT_FALSE(disk_manager_->is_file(filename + FREE_PAGE_MAP_SUFFIX));
+
+    disk_manager_->close_file(fd);
+    disk_manager_->destroy_file(filename);
+    EXPECT_FALSE(disk_manager_->is_file(filename + FREE_PAGE_MAP_SUFFIX));
+}
@@ -0,0 +1,109 @@
+#include "replacer/lru_k_replacer.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+/**
+ * @brief 简单测试LRUKReplacer的基本功能
+ */
+TEST(LRUKReplacerTest, SimpleTest) {
+    LRUKReplacer lru_k_replacer(7, 2);
+
+    // 帧1~6各访问一次，帧1、2再各访问一次
+    for (int i = 1; i <= 6; i++) {
+        lru_k_replacer.pin(i);
+        lru_k_replacer.unpin(i);
+    }
+    lru_k_replacer.pin(1);
+    lru_k_replacer.unpin(1);
+    lru_k_replacer.pin(2);
+    lru_k_replacer.unpin(2);
+    EXPECT_EQ(6, lru_k_replacer.Size());
+
+    // 访问不足两次的帧按第一次访问的先后淘汰
+    int value;
+    EXPECT_EQ(true, lru_k_replacer.victim(&value));
+    EXPECT_EQ(3, value);
+    EXPECT_EQ(true, lru_k_replacer.victim(&value));
+    EXPECT_EQ(4, value);
+
+    // 被pin的帧不能淘汰
+    lru_k_replacer.pin(5);
+    EXPECT_EQ(3, lru_k_replacer.Size());
+    EXPECT_EQ(true, lru_k_replacer.victim(&value));
+    EXPECT_EQ(6, value);
+
+    // 剩下的帧都访问过两次，按倒数第二次访问的先后淘汰
+    lru_k_replacer.unpin(5);
+    EXPECT_EQ(true, lru_k_replacer.victim(&value));
+    EXPECT_EQ(1, value);
+    EXPECT_EQ(true, lru_k_replacer.victim(&value));
+    EXPECT_EQ(2, value);
+    EXPECT_EQ(true, lru_k_replacer.victim(&value));
+    EXPECT_EQ(5, value);
+    EXPECT_EQ(false, lru_k_replacer.victim(&value));
+}
+
+/**
+ * @brief 一次顺序扫描不会把多次访问过的热点帧淘汰出去
+ */
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+    const int hot_frames = 16;
+    const int value_size = 64;
+    LRUKReplacer lru_k_replacer(value_size, 2);
+
+    // 热点帧被反复访问
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < hot_frames; i++) {
+            lru_k_replacer.pin(i);
+            lru_k_replacer.unpin(i);
+        }
+    }
+    // 扫描：其余帧各访问一次，随后被淘汰，淘汰的帧用来装入下一批扫描到的页面
+    for (int i = hot_frames; i < value_size; i++) {
+        lru_k_replacer.pin(i);
+        lru_k_replacer.unpin(i);
+    }
+    int value;
+    for (int i = 0; i < 4 * value_size; i++) {
+        ASSERT_EQ(true, lru_k_replacer.victim(&value));
+        EXPECT_GE(value, hot_frames);
+        lru_k_replacer.pin(value);
+        lru_k_replacer.unpin(value);
+    }
+}
+
+/**
+ * @brief 扫描时逐条记录地重复pin同一页面、多个线程同时pin同一页面是相关访问，只算一次，扫描过的页面不会被当成热点页面
+ */
+TEST(LRUKReplacerTest, CorrelatedAccessTest) {
+    const int hot_frames = 16;
+    const int value_size = 64;
+    LRUKReplacer lru_k_replacer(value_size, 2);
+
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < hot_frames; i++) {
+            lru_k_replacer.pin(i);
+            lru_k_replacer.unpin(i);
+        }
+    }
+    auto scan = [&](int frame_id) {
+        for (int j = 0; j < 4; j++) {
+            lru_k_replacer.pin(frame_id);
+            lru_k_replacer.unpin(frame_id);
+        }
+        lru_k_replacer.pin(frame_id);
+        lru_k_replacer.pin(frame_id);
+        lru_k_replacer.unpin(frame_id);
+    };
+    for (int i = hot_frames; i < value_size; i++) scan(i);
+    int value;
+    for (int i = 0; i < 4 * value_size; i++) {
+        ASSERT_EQ(true, lru_k_replacer.victim(&value));
+        EXPECT_GE(value, hot_frames);
+        scan(value);
+    }
+}
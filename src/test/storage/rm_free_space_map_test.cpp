@@ -0,0 +1,196 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <cstdio>
+#include <set>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "record/rm.h"
+#include "transaction/concurrency/lock_manager.h"
+
+const int RECORD_SIZE = 200;
+const std::vector<RmVarField> VAR_FIELDS = {{4, 196}};
+
+class RmFreeSpaceMapTest : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<RmManager> rm_manager_;
+    LockManager lock_manager_;
+    std::unique_ptr<Transaction> txn_;
+    std::unique_ptr<Context> context_;
+    std::string filename_ = "rm_free_space_map_test.tbl";
+
+    void SetUp() override {
+        start();
+        txn_ = std::make_unique<Transaction>(0);
+        context_ = std::make_unique<Context>(&lock_manager_, nullptr, txn_.get());
+        if (disk_manager_->is_file(filename_)) rm_manager_->destroy_file(filename_);
+        std::remove((filename_ + FREE_SPACE_MAP_SUFFIX).c_str());
+    }
+
+    void TearDown() override {
+        if (disk_manager_->is_file(filename_)) rm_manager_->destroy_file(filename_);
+    }
+
+    void start() {
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(256, disk_manager_.get());
+        rm_manager_ = std::make_unique<RmManager>(disk_manager_.get(), buffer_pool_manager_.get());
+    }
+
+    // 关闭表的数据文件和空闲空间表
+    void close(std::unique_ptr<RmFileHandle> fh) {
+        rm_manager_->close_file(fh.get());
+        disk_manager_->close_file(fh->get_free_space_map()->get_fd());
+        disk_manager_->close_file(fh->GetFd());
+    }
+
+    /**
+     * @brief 关闭表并丢弃缓冲池，模拟重启后重新打开表；drop_fsm为true时删除空闲空间表，模拟旧版本创建的表
+     */
+    std::unique_ptr<RmFileHandle> restart(std::unique_ptr<RmFileHandle> fh, bool drop_fsm = false) {
+        close(std::move(fh));
+        rm_manager_.reset();
+        buffer_pool_manager_.reset();
+        disk_manager_.reset();
+        if (drop_fsm) std::remove((filename_ + FREE_SPACE_MAP_SUFFIX).c_str());
+        start();
+        return rm_manager_->open_file(filename_);
+    }
+
+    static std::vector<int> get_buckets(RmFileHandle *fh) {
+        std::vector<int> buckets;
+        for (int page_no = 0; page_no < fh->get_file_hdr().num_pages; page_no++) {
+            buckets.push_back(fh->get_free_space_map()->get(page_no));
+        }
+        return buckets;
+    }
+
+    static int count_records(RmFileHandle *fh) {
+        int n = 0;
+        for (RmScan scan(fh); !scan.is_end(); scan.next()) n++;
+        return n;
+    }
+};
+
+/**
+ * @brief 删除记录后页面的空闲空间可以被之后的插入复用，不会分配新页面；空闲空间表中的档位与页面一致
+ */
+TEST_F(RmFreeSpaceMapTest, ReuseTest) {
+    for (auto format : {RM_FORMAT_FIXED, RM_FORMAT_SLOTTED}) {
+        rm_manager_->create_file(filename_, RECORD_SIZE, PAGE_SIZE, format, VAR_FIELDS);
+        auto fh = rm_manager_->open_file(filename_);
+        std::vector<char> buf(RECORD_SIZE, 'x');
+        std::vector<Rid> rids;
+        for (int i = 0; i < 2000; i++) rids.push_back(fh->insert_record(buf.data(), context_.get()));
+        int num_pages = fh->get_file_hdr().num_pages;
+        for (int page_no = RM_FIRST_RECORD_PAGE; page_no < num_pages - 1; page_no++) {
+            EXPECT_EQ(fh->get_free_space_map()->get(page_no), 0);
+        }
+
+        // 每个页面删掉一半记录，分散在所有页面中
+        for (size_t i = 0; i < rids.size(); i += 2) ASSERT_TRUE(fh->delete_record(rids[i], context_.get()));
+        for (int page_no = RM_FIRST_RECORD_PAGE; page_no < num_pages; page_no++) {
+            EXPECT_GT(fh->get_free_space_map()->get(page_no), 0);
+        }
+        for (int i = 0; i < 1000; i++) fh->insert_record(buf.data(), context_.get());
+        EXPECT_EQ(fh->get_file_hdr().num_pages, num_pages);
+        EXPECT_EQ(count_records(fh.get()), 2000);
+
+        close(std::move(fh));
+        rm_manager_->destroy_file(filename_);
+    }
+}
+
+/**
+ * @brief 空闲空间表写入磁盘，重新打开表后不变；删除空闲空间表后打开表时扫描页面重建
+ */
+TEST_F(RmFreeSpaceMapTest, PersistTest) {
+    for (bool drop_fsm : {false, true}) {
+        rm_manager_->create_file(filename_, RECORD_SIZE);
+        auto fh = rm_manager_->open_file(filename_);
+        std::vector<char> buf(RECORD_SIZE, 'x');
+        std::vector<Rid> rids;
+        for (int i = 0; i < 1000; i++) rids.push_back(fh->insert_record(buf.data(), context_.get()));
+        for (size_t i = 0; i < rids.size(); i += 3) ASSERT_TRUE(fh->delete_record(rids[i], context_.get()));
+        auto buckets = get_buckets(fh.get());
+
+        fh = restart(std::move(fh), drop_fsm);
+        EXPECT_EQ(get_buckets(fh.get()), buckets);
+        int num_pages = fh->get_file_hdr().num_pages;
+        for (size_t i = 0; i < rids.size(); i += 3) fh->insert_record(buf.data(), context_.get());
+        EXPECT_EQ(fh->get_file_hdr().num_pages, num_pages);
+        EXPECT_EQ(count_records(fh.get()), 1000);
+
+        close(std::move(fh));
+        rm_manager_->destroy_file(filename_);
+        EXPECT_FALSE(disk_manager_->is_file(filename_ + FREE_SPACE_MAP_SUFFIX));
+    }
+}
+
+/**
+ * @brief 空闲空间表中的档位过时(页面实际已满)时插入改正档位，换一个页面
+ */
+TEST_F(RmFreeSpaceMapTest, StaleEntryTest) {
+    rm_manager_->create_file(filename_, RECORD_SIZE);
+    auto fh = rm_manager_->open_file(filename_);
+    std::vector<char> buf(RECORD_SIZE, 'x');
+    for (int i = 0; i < 200; i++) fh->insert_record(buf.data(), context_.get());
+    int num_pages = fh->get_file_hdr().num_pages;
+    for (int page_no = RM_FIRST_RECORD_PAGE; page_no < num_pages - 1; page_no++) {
+        fh->get_free_space_map()->set(page_no, RM_FSM_BUCKETS - 1);
+    }
+    Rid rid = fh->insert_record(buf.data(), context_.get());
+    EXPECT_TRUE(rid.page_no == num_pages - 1 || rid.page_no == num_pages);
+    for (int page_no = RM_FIRST_RECORD_PAGE; page_no < num_pages - 1; page_no++) {
+        EXPECT_EQ(fh->get_free_space_map()->get(page_no), 0);
+    }
+    close(std::move(fh));
+}
+
+/**
+ * @brief 有多个页面有空闲空间时，不同线程找到不同的页面；并发插入的记录都在表中
+ */
+TEST_F(RmFreeSpaceMapTest, ConcurrentInsertTest) {
+    const int num_threads = RM_FSM_SPREAD;
+    const int num_records = 2000;
+    rm_manager_->create_file(filename_, RECORD_SIZE);
+    auto fh = rm_manager_->open_file(filename_);
+    std::vector<char> buf(RECORD_SIZE, 'x');
+    std::vector<Rid> rids;
+    for (int i = 0; i < 1000; i++) rids.push_back(fh->insert_record(buf.data(), context_.get()));
+    for (size_t i = 0; i < rids.size(); i += 2) ASSERT_TRUE(fh->delete_record(rids[i], context_.get()));
+
+    std::vector<int> pages(num_threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            int bucket;
+            pages[t] = fh->get_free_space_map()->find(fh->get_file_hdr().num_pages, &bucket);
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    EXPECT_EQ(std::set<int>(pages.begin(), pages.end()).size(), static_cast<size_t>(num_threads));
+
+    threads.clear();
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t] {
+            // 不加锁，只检查插入本身
+            Context context(&lock_manager_, nullptr, nullptr);
+            std::vector<char> rec(RECORD_SIZE, static_cast<char>('a' + t));
+            for (int i = 0; i < num_records; i++) fh->insert_record(rec.data(), &context);
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    EXPECT_EQ(count_records(fh.get()), 500 + num_threads * num_records);
+    close(std::move(fh));
+}
@@ -0,0 +1,276 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <map>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "record/rm.h"
+#include "transaction/concurrency/lock_manager.h"
+
+// 测试表：int(4) + char(120) + int(4) + char(40)，两个字符串字段在变长记录格式中按实际长度存储
+const int RECORD_SIZE = 168;
+const std::vector<RmVarField> VAR_FIELDS = {{4, 120}, {128, 40}};
+
+/**
+ * @brief 生成一条记录，字符串字段的长度随机，长度为0到max_len
+ */
+std::string make_record(std::default_random_engine &rng, int key, int max_len) {
+    std::string rec(RECORD_SIZE, '\0');
+    memcpy(&rec[0], &key, sizeof(int));
+    memcpy(&rec[124], &key, sizeof(int));
+    for (auto &field : VAR_FIELDS) {
+        int len = std::uniform_int_distribution<int>(0, std::min(max_len, field.len))(rng);
+        for (int i = 0; i < len; i++) rec[field.offset + i] = static_cast<char>('a' + (key + i) % 26);
+    }
+    return rec;
+}
+
+class RmSlottedPageTest : public ::testing::Test {
+   public:
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+    std::unique_ptr<RmManager> rm_manager_;
+    LockManager lock_manager_;
+    std::unique_ptr<Transaction> txn_;
+    std::unique_ptr<Context> context_;
+    std::string filename_ = "rm_slotted_page_test.tbl";
+    std::string fixed_filename_ = "rm_slotted_page_test_fixed.tbl";
+
+    void SetUp() override {
+        disk_manager_ = std::make_unique<DiskManager>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager>(64, disk_manager_.get());
+        rm_manager_ = std::make_unique<RmManager>(disk_manager_.get(), buffer_pool_manager_.get());
+        txn_ = std::make_unique<Transaction>(0);
+        context_ = std::make_unique<Context>(&lock_manager_, nullptr, txn_.get());
+        for (auto &filename : {filename_, fixed_filename_}) {
+            if (disk_manager_->is_file(filename)) rm_manager_->destroy_file(filename);
+        }
+    }
+
+    void TearDown() override {
+        for (auto &filename : {filename_, fixed_filename_}) {
+            if (disk_manager_->is_file(filename)) rm_manager_->destroy_file(filename);
+        }
+    }
+
+    std::unique_ptr<RmFileHandle> reopen(std::unique_ptr<RmFileHandle> fh) {
+        // 文件仍处于打开状态，重新读出写回磁盘的文件头
+        rm_manager_->close_file(fh.get());
+        return rm_manager_->open_file(filename_);
+    }
+
+    /**
+     * @brief 检查getRecord、get_record读到的记录和RmScan扫描到的记录与mock一致
+     */
+    void check_equal(RmFileHandle *fh, const std::map<std::pair<int, int>, std::string> &mock) {
+        std::vector<char> buf(RECORD_SIZE);
+        for (auto &[key, rec] : mock) {
+            Rid rid = {key.first, key.second};
+            ASSERT_TRUE(fh->is_record(rid));
+            fh->getRecord(buf.data(), rid, context_.get(), RECORD_SIZE, false);
+            ASSERT_EQ(std::string(buf.data(), RECORD_SIZE), rec) << "rid=(" << rid.page_no << "," << rid.slot_no << ")";
+            ASSERT_EQ(std::string(fh->get_record(rid, context_.get())->data, RECORD_SIZE), rec);
+        }
+        size_t num_records = 0;
+        for (RmScan scan(fh); !scan.is_end(); scan.next()) {
+            ASSERT_EQ(mock.count({scan.rid().page_no, scan.rid().slot_no}), 1u);
+            num_records++;
+        }
+        ASSERT_EQ(num_records, mock.size());
+
+        // 按页面批量扫描：只取slot号、取出所有记录、取出满足谓词的记录
+        RmPageBatch batch;
+        num_records = 0;
+        for (RmScan scan(fh); scan.next_batch(&batch);) {
+            for (size_t i = 0; i < batch.size(); i++) ASSERT_EQ(mock.count({batch.page_no, batch.slot_nos[i]}), 1u);
+            num_records += batch.size();
+        }
+        ASSERT_EQ(num_records, mock.size());
+        num_records = 0;
+        for (RmScan scan(fh); scan.next_batch(&batch, nullptr);) {
+            for (size_t i = 0; i < batch.size(); i++) {
+                ASSERT_EQ(std::string(batch.get_record(i), RECORD_SIZE), mock.at({batch.page_no, batch.slot_nos[i]}));
+            }
+            num_records += batch.size();
+        }
+        ASSERT_EQ(num_records, mock.size());
+        size_t num_even = 0;
+        for (auto &[key, rec] : mock) num_even += *reinterpret_cast<const int *>(rec.data()) % 2 == 0;
+        auto is_even = [](const Rid &rid, const char *rec) { return *reinterpret_cast<const int *>(rec) % 2 == 0; };
+        num_records = 0;
+        for (RmScan scan(fh); scan.next_batch(&batch, is_even);) {
+            ASSERT_GT(batch.size(), 0u);
+            for (size_t i = 0; i < batch.size(); i++) {
+                ASSERT_EQ(std::string(batch.get_record(i), RECORD_SIZE), mock.at({batch.page_no, batch.slot_nos[i]}));
+                ASSERT_TRUE(is_even(batch.rid(i), batch.get_record(i)));
+            }
+            num_records += batch.size();
+        }
+        ASSERT_EQ(num_records, num_even);
+    }
+};
+
+TEST_F(RmSlottedPageTest, EncodeDecodeTest) {
+    RmFileHdr file_hdr{};
+    file_hdr.record_size = RECORD_SIZE;
+    file_hdr.num_var_fields = static_cast<int>(VAR_FIELDS.size());
+    std::copy(VAR_FIELDS.begin(), VAR_FIELDS.end(), file_hdr.var_fields);
+    EXPECT_EQ(rm_min_encoded_size(&file_hdr), 4 + 2 + 4 + 2);
+    EXPECT_EQ(rm_max_encoded_size(&file_hdr), RECORD_SIZE + 4);
+
+    std::default_random_engine rng(0);
+    std::vector<char> encoded(rm_max_encoded_size(&file_hdr));
+    std::vector<char> decoded(RECORD_SIZE);
+    for (int i = 0; i < 1000; i++) {
+        std::string rec = make_record(rng, i, 200);
+        int len = rm_encode_record(&file_hdr, rec.data(), encoded.data());
+        int expected = rm_min_encoded_size(&file_hdr);
+        for (auto &field : VAR_FIELDS) expected += static_cast<int>(strnlen(rec.data() + field.offset, field.len));
+        ASSERT_EQ(len, expected);
+        rm_decode_record(&file_hdr, encoded.data(), len, decoded.data());
+        ASSERT_EQ(std::string(decoded.data(), RECORD_SIZE), rec);
+    }
+}
+
+/**
+ * @brief 随机插入、更新、删除，更新时记录长度可能变长很多，覆盖页面内整理、记录移到其他页面和移回原页面的情况
+ */
+TEST_F(RmSlottedPageTest, RandomOperationTest) {
+    rm_manager_->create_file(filename_, RECORD_SIZE, PAGE_SIZE, RM_FORMAT_SLOTTED, VAR_FIELDS);
+    auto fh = rm_manager_->open_file(filename_);
+    ASSERT_TRUE(fh->is_slotted());
+
+    std::default_random_engine rng(0);
+    std::map<std::pair<int, int>, std::string> mock;
+    for (int round = 0; round < 6000; round++) {
+        int dice = std::uniform_int_distribution<int>(0, 99)(rng);
+        // 短记录居多，更新时经常变成长记录
+        int max_len = std::uniform_int_distribution<int>(0, 3)(rng) == 0 ? 120 : 8;
+        std::string rec = make_record(rng, round, max_len);
+        if (mock.size() < 400 && (mock.empty() || dice < 50)) {
+            Rid rid = fh->insert_record(rec.data(), context_.get());
+            ASSERT_EQ(mock.count({rid.page_no, rid.slot_no}), 0u);
+            mock[{rid.page_no, rid.slot_no}] = rec;
+        } else {
+            auto it = std::next(mock.begin(), std::uniform_int_distribution<size_t>(0, mock.size() - 1)(rng));
+            Rid rid = {it->first.first, it->first.second};
+            if (dice < 80) {
+                ASSERT_TRUE(fh->update_record(rid, rec.data(), context_.get()));
+                it->second = rec;
+            } else {
+                ASSERT_TRUE(fh->delete_record(rid, context_.get()));
+                mock.erase(it);
+            }
+        }
+        if (round % 500 == 0) {
+            fh = reopen(std::move(fh));
+            check_equal(fh.get(), mock);
+        }
+    }
+    check_equal(fh.get(), mock);
+    int num_forward = 0;
+    for (int page_no = RM_FIRST_RECORD_PAGE; page_no < fh->get_file_hdr().num_pages; page_no++) {
+        RmPageHandle page_handle = fh->fetch_page_handle(page_no);
+        RmSlottedPage page(page_handle);
+        for (int slot_no = 0; slot_no < page.num_slots(); slot_no++) {
+            num_forward += page.get_slot(slot_no)->flag == RM_SLOT_FORWARD;
+        }
+    }
+    printf("pages: %d, forwarded records: %d\n", fh->get_file_hdr().num_pages, num_forward);
+    EXPECT_GT(num_forward, 0);
+
+    // 整理文件后记录号不变
+    fh->compact();
+    check_equal(fh.get(), mock);
+    for (auto &[key, rec] : mock) ASSERT_TRUE(fh->delete_record({key.first, key.second}, context_.get()));
+    mock.clear();
+    EXPECT_EQ(fh->compact(), RM_FIRST_RECORD_PAGE);
+    check_equal(fh.get(), mock);
+    rm_manager_->close_file(fh.get());
+}
+
+/**
+ * @brief 字符串大多很短时，变长记录格式的文件比定长记录格式的文件页面少得多
+ */
+TEST_F(RmSlottedPageTest, SpaceUsageTest) {
+    const int num_records = 5000;
+    int num_pages[2];
+    for (RmRecordFormat format : {RM_FORMAT_FIXED, RM_FORMAT_SLOTTED}) {
+        // 缓冲池中可能还有同一个fd之前的文件的页面，两种格式使用不同的文件
+        auto &filename = format == RM_FORMAT_FIXED ? fixed_filename_ : filename_;
+        rm_manager_->create_file(filename, RECORD_SIZE, PAGE_SIZE, format, VAR_FIELDS);
+        auto fh = rm_manager_->open_file(filename);
+        std::default_random_engine rng(0);
+        std::map<std::pair<int, int>, std::string> mock;
+        for (int i = 0; i < num_records; i++) {
+            std::string rec = make_record(rng, i, 16);
+            Rid rid = fh->insert_record(rec.data(), context_.get());
+            mock[{rid.page_no, rid.slot_no}] = rec;
+        }
+        check_equal(fh.get(), mock);
+        num_pages[format] = fh->get_file_hdr().num_pages;
+        rm_manager_->close_file(fh.get());
+    }
+    printf("fixed: %d pages, slotted: %d pages\n", num_pages[RM_FORMAT_FIXED], num_pages[RM_FORMAT_SLOTTED]);
+    EXPECT_LT(num_pages[RM_FORMAT_SLOTTED] * 3, num_pages[RM_FORMAT_FIXED]);
+}
+
+/**
+ * @brief 两种格式的记录视图与get_record读到的记录相同，定长记录格式的视图直接指向页面中的记录
+ */
+TEST_F(RmSlottedPageTest, RecordRefTest) {
+    for (RmRecordFormat format : {RM_FORMAT_FIXED, RM_FORMAT_SLOTTED}) {
+        auto &filename = format == RM_FORMAT_FIXED ? fixed_filename_ : filename_;
+        rm_manager_->create_file(filename, RECORD_SIZE, PAGE_SIZE, format, VAR_FIELDS);
+        auto fh = rm_manager_->open_file(filename);
+        std::default_random_engine rng(0);
+        std::map<std::pair<int, int>, std::string> mock;
+        for (int i = 0; i < 500; i++) {
+            std::string rec = make_record(rng, i, 120);
+            Rid rid = fh->insert_record(rec.data(), context_.get());
+            mock[{rid.page_no, rid.slot_no}] = rec;
+        }
+        for (auto &[key, rec] : mock) {
+            Rid rid = {key.first, key.second};
+            RecordRef ref;
+            ASSERT_TRUE(fh->get_record_ref(&ref, rid, context_.get(), true));
+            ASSERT_EQ(ref.size(), RECORD_SIZE);
+            ASSERT_EQ(std::string(ref.data(), RECORD_SIZE), rec);
+            if (format == RM_FORMAT_FIXED) {
+                RmPageHandle page_handle = fh->fetch_page_handle(rid.page_no);
+                ASSERT_EQ(ref.data(), page_handle.get_slot(rid.slot_no));
+            }
+            // 移动后视图仍然有效，物化得到独立的副本
+            RecordRef moved = std::move(ref);
+            ASSERT_EQ(ref.data(), nullptr);
+            auto copy = moved.to_record();
+            moved.reset();
+            ASSERT_EQ(std::string(copy->data, RECORD_SIZE), rec);
+        }
+        rm_manager_->close_file(fh.get());
+    }
+}
+
+TEST(RmRecordTest, AssignTest) {
+    RmRecord a(16, "aaaaaaaaaaaaaaa");
+    RmRecord b(8, "bbbbbbb");
+    b = a;
+    EXPECT_EQ(b.size, 16);
+    EXPECT_STREQ(b.data, "aaaaaaaaaaaaaaa");
+    EXPECT_NE(b.data, a.data);
+    b = b;
+    EXPECT_STREQ(b.data, "aaaaaaaaaaaaaaa");
+    RmRecord c(std::move(b));
+    EXPECT_EQ(b.data, nullptr);
+    EXPECT_STREQ(c.data, "aaaaaaaaaaaaaaa");
+    a = std::move(c);
+    EXPECT_STREQ(a.data, "aaaaaaaaaaaaaaa");
+}
@@ -0,0 +1,107 @@
+#include "replacer/two_queue_replacer.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// 把页面page_no装入帧frame_id, 连续访问times次
+void load(TwoQueueReplacer &replacer, frame_id_t frame_id, int page_no, int times = 1) {
+    replacer.set_page(frame_id, {0, page_no});
+    for (int i = 0; i < times; i++) {
+        replacer.pin(frame_id);
+        replacer.unpin(frame_id);
+    }
+}
+
+/**
+ * @brief 简单测试TwoQueueReplacer的基本功能
+ */
+TEST(TwoQueueReplacerTest, SimpleTest) {
+    // kin = 8 / 4 = 2, kout = 8 / 2 = 4
+    TwoQueueReplacer two_queue_replacer(8);
+
+    // 帧1~6分别装入页面1~6，进入A1in；帧1、2驻留期间再次访问，仍留在A1in中原来的位置
+    for (int i = 1; i <= 6; i++) load(two_queue_replacer, i, i);
+    load(two_queue_replacer, 1, 1, 3);
+    load(two_queue_replacer, 2, 2, 3);
+    EXPECT_EQ(6, two_queue_replacer.Size());
+
+    // A1in中有6个帧，超过kin，按FIFO淘汰直到只剩kin个，页面1~4记入A1out
+    int value;
+    for (int i = 1; i <= 4; i++) {
+        EXPECT_EQ(true, two_queue_replacer.victim(&value));
+        EXPECT_EQ(i, value);
+    }
+
+    // 页面1还在A1out中，再次装入时进入Am；页面7第一次装入，进入A1in
+    load(two_queue_replacer, 1, 1);
+    load(two_queue_replacer, 2, 7);
+    EXPECT_EQ(4, two_queue_replacer.Size());
+
+    // A1in(5, 6, 2)超过kin，先从A1in淘汰，之后从Am淘汰
+    EXPECT_EQ(true, two_queue_replacer.victim(&value));
+    EXPECT_EQ(5, value);
+    EXPECT_EQ(true, two_queue_replacer.victim(&value));
+    EXPECT_EQ(1, value);
+
+    // Am中没有可淘汰的帧，从A1in淘汰，跳过被pin的帧
+    two_queue_replacer.pin(6);
+    EXPECT_EQ(1, two_queue_replacer.Size());
+    EXPECT_EQ(true, two_queue_replacer.victim(&value));
+    EXPECT_EQ(2, value);
+    EXPECT_EQ(false, two_queue_replacer.victim(&value));
+
+    two_queue_replacer.unpin(6);
+    EXPECT_EQ(true, two_queue_replacer.victim(&value));
+    EXPECT_EQ(6, value);
+}
+
+/**
+ * @brief A1out只记录最近kout个从A1in淘汰的页面，更早淘汰的页面再次装入时仍进入A1in
+ */
+TEST(TwoQueueReplacerTest, A1outTest) {
+    // kin = 1, kout = 2
+    TwoQueueReplacer two_queue_replacer(4);
+    for (int i = 0; i < 4; i++) load(two_queue_replacer, i, i);
+    int value;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(true, two_queue_replacer.victim(&value));
+        EXPECT_EQ(i, value);
+    }
+    // A1out中是页面1、2，页面0已经被挤出
+    load(two_queue_replacer, 0, 0);
+    load(two_queue_replacer, 1, 2);
+    load(two_queue_replacer, 2, 1);
+    // A1in(3, 0)超过kin，先淘汰帧3；之后从Am按LRU淘汰帧1(页面2)和帧2(页面1)，Am空了再淘汰A1in中的帧0
+    for (int expected : {3, 1, 2, 0}) {
+        ASSERT_EQ(true, two_queue_replacer.victim(&value));
+        EXPECT_EQ(expected, value);
+    }
+}
+
+/**
+ * @brief 一次顺序扫描不会把热点帧淘汰出去，扫描时对同一页面的多次pin(逐条记录地访问)不会使页面晋升到Am
+ */
+TEST(TwoQueueReplacerTest, ScanResistanceTest) {
+    const int hot_frames = 16;
+    const int value_size = 64;
+    TwoQueueReplacer two_queue_replacer(value_size);
+
+    // 热点页面第一次装入后被淘汰到A1out，短时间内再次装入时进入Am
+    for (int i = 0; i < value_size; i++) load(two_queue_replacer, i, i);
+    int value;
+    for (int i = 0; i < hot_frames; i++) {
+        ASSERT_EQ(true, two_queue_replacer.victim(&value));
+        EXPECT_EQ(i, value);
+        load(two_queue_replacer, value, value);
+    }
+
+    // 扫描：每个新页面被连续pin多次，淘汰的帧用来装入下一个扫描到的页面
+    for (int i = 0; i < 4 * value_size; i++) {
+        ASSERT_EQ(true, two_queue_replacer.victim(&value));
+        EXPECT_GE(value, hot_frames);
+        load(two_queue_replacer, value, value_size + i, 4);
+    }
+}
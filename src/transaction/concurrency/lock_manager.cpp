@@ -138,6 +138,7 @@ bool LockManager::lock_IS_on_table(Transaction* txn, int tab_fd) {
     auto& tab_mode = tab_mode_table_[tab_fd];
     tab_mode.mode_set.insert(TableLockMode::IS);
     tab_mode.mode_ = *tab_mode.mode_set.rbegin();
+    return true;
 }
 
 /**
@@ -150,6 +151,7 @@ bool LockManager::lock_IX_on_table(Transaction* txn, int tab_fd) {
     auto& tab_mode = tab_mode_table_[tab_fd];
     tab_mode.mode_set.insert(TableLockMode::IX);
     tab_mode.mode_ = *tab_mode.mode_set.rbegin();
+    return true;
 }
 
 /**
@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 #include <memory>
 #include <unordered_set>
 
+#include "storage/page_guard.h"
 #include "txn_defs.h"
 
 class Transaction {
@@ -25,7 +26,7 @@ class Transaction {
         : state_(TransactionState::DEFAULT), isolation_level_(isolation_level), txn_id_(txn_id) {
         write_set_ = std::make_shared<std::deque<WriteRecord *>>();
         lock_set_ = std::make_shared<std::unordered_set<LockDataId>>();
-        index_latch_page_set_ = std::make_shared<std::deque<Page *>>();
+        index_latch_page_set_ = std::make_shared<std::deque<PageGuard>>();
         index_deleted_page_set_ = std::make_shared<std::deque<Page*>>();
         prev_lsn_ = INVALID_LSN;
         thread_id_ = std::this_thread::get_id();
@@ -57,8 +58,8 @@ class Transaction {
     inline std::shared_ptr<std::deque<Page*>> get_index_deleted_page_set() { return index_deleted_page_set_; }
     inline void append_index_deleted_page(Page* page) { index_deleted_page_set_->push_back(page); }
 
-    inline std::shared_ptr<std::deque<Page*>> get_index_latch_page_set() { return index_latch_page_set_; }
-    inline void append_index_latch_page_set(Page* page) { index_latch_page_set_->push_back(page); }
+    inline std::shared_ptr<std::deque<PageGuard>> get_index_latch_page_set() { return index_latch_page_set_; }
+    inline void append_index_latch_page_set(PageGuard guard) { index_latch_page_set_->push_back(std::move(guard)); }
     inline void pop_index_latch_page_set() { index_latch_page_set_->pop_back(); }
     inline void clear_index_latch_page_set() { index_latch_page_set_->clear(); }
 
@@ -76,6 +77,6 @@ class Transaction {
 
     std::shared_ptr<std::deque<WriteRecord *>> write_set_;  // 事务包含的所有写操作
     std::shared_ptr<std::unordered_set<LockDataId>> lock_set_;  // 事务申请的所有锁
-    std::shared_ptr<std::deque<Page*>> index_latch_page_set_;          // 维护事务执行过程中加锁的索引页面
+    std::shared_ptr<std::deque<PageGuard>> index_latch_page_set_;      // 维护事务执行过程中加锁的索引页面，集合持有页面的pin
     std::shared_ptr<std::deque<Page*>> index_deleted_page_set_;    // 维护事务执行过程中删除的索引页面
 };
@@ -118,7 +118,7 @@ void TransactionManager::abort(Transaction* txn, LogManager* log_manager) {
                     char* key = new char[index.col_tot_len];
                     int offset = 0;
                     for (size_t j = 0; j < index.col_num; ++j) {
-                        memcpy(key + offset, old_buf + index.cols[j].offset, index.cols[j].len);
+                        memcpy(key + offset, buf + index.cols[j].offset, index.cols[j].len);
                         offset += index.cols[j].len;
                     }
                     ih->insert_entry(key, write_record->GetRid(), txn);